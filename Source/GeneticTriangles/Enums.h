@@ -41,6 +41,49 @@ enum class EObstacleTraceBehaviour : uint8
 	CircleTracing UMETA(DisplayName = "CircleTracing")
 };
 
+/**
+* Delayed: A single generation is run once the delay between generations has passed
+* FixedPerTick: A fixed amount of generations is run every tick
+* TimeBudget: As many generations as fit in the time budget are run every tick
+* FrameSliced: A single generation is spread over multiple ticks, every phase processes a bounded amount of paths per tick
+*/
+UENUM(BlueprintType)
+enum class EGenerationRunMode : uint8
+{
+	Delayed UMETA(DisplayName = "Delayed"),
+	FixedPerTick UMETA(DisplayName = "FixedPerTick"),
+	TimeBudget UMETA(DisplayName = "TimeBudget"),
+	FrameSliced UMETA(DisplayName = "FrameSliced")
+};
+
+/**
+* Ring: Migrants always move on to the next island
+* Random: Migrants move to a random other island
+*/
+UENUM(BlueprintType)
+enum class EMigrationTopology : uint8
+{
+	Ring UMETA(DisplayName = "Ring"),
+	Random UMETA(DisplayName = "Random")
+};
+
+/**
+* None: The run has not met any of its termination criteria
+* MaxGenerations: The maximum amount of generations has been run
+* TargetFitnessFactor: The fitness factor of a generation reached the target
+* Stagnation: The best fitness has not improved for a number of generations
+* DiversityCollapse: The population has converged, its diversity dropped below the threshold
+*/
+UENUM(BlueprintType)
+enum class ETerminationReason : uint8
+{
+	None UMETA(DisplayName = "None"),
+	MaxGenerations UMETA(DisplayName = "MaxGenerations"),
+	TargetFitnessFactor UMETA(DisplayName = "TargetFitnessFactor"),
+	Stagnation UMETA(DisplayName = "Stagnation"),
+	DiversityCollapse UMETA(DisplayName = "DiversityCollapse")
+};
+
 UENUM(BlueprintType)
 enum class EAnimationControlState : uint8
 {
@@ -0,0 +1,116 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneticTriangles.h"
+#include "GeneticTermination.h"
+
+FGeneticTerminationMonitor::FGeneticTerminationMonitor(const FGeneticTerminationCriteria& inCriteria)
+	:
+	mCriteria(inCriteria)
+{
+}
+
+
+
+void FGeneticTerminationMonitor::Reset()
+{
+	mReason = ETerminationReason::None;
+	mGenerationCount = 0;
+	mBestFitness = -TNumericLimits<float>::Max();
+	mBestFitnessGeneration = 0;
+	mFitnessFactor = 0.0f;
+	mDiversity = 0.0f;
+}
+
+
+
+/**
+* Feeds the outcome of the generation that just finished, inGenerationCount being the amount of generations run so far
+* Returns the reason to stop the run, which sticks once set
+*/
+ETerminationReason FGeneticTerminationMonitor::Update(const int32 inGenerationCount, const float inBestFitness, const float inFitnessFactor, const float inDiversity)
+{
+	if (HasTerminated())
+		return mReason;
+
+	mGenerationCount = inGenerationCount;
+	mFitnessFactor = inFitnessFactor;
+	mDiversity = inDiversity;
+
+	if (inBestFitness > mBestFitness)
+	{
+		mBestFitness = inBestFitness;
+		mBestFitnessGeneration = inGenerationCount;
+	}
+
+	// Reaching the target is checked first, a run that converged onto a good solution has succeeded rather than stagnated
+	if (mCriteria.mTargetFitnessFactor > 0.0f && inFitnessFactor >= mCriteria.mTargetFitnessFactor)
+		mReason = ETerminationReason::TargetFitnessFactor;
+	else if (mCriteria.mStagnationWindow > 0 && inGenerationCount - mBestFitnessGeneration >= mCriteria.mStagnationWindow)
+		mReason = ETerminationReason::Stagnation;
+	else if (mCriteria.mMinDiversity > 0.0f && inDiversity < mCriteria.mMinDiversity)
+		mReason = ETerminationReason::DiversityCollapse;
+	else if (mCriteria.mMaxGenerationCount > 0 && inGenerationCount >= mCriteria.mMaxGenerationCount)
+		mReason = ETerminationReason::MaxGenerations;
+
+	return mReason;
+}
+
+
+
+FString FGeneticTerminationMonitor::GetDescription() const
+{
+	switch (mReason)
+	{
+	case ETerminationReason::MaxGenerations:
+		return FString::Printf(TEXT("Reached the maximum of %d generations"), mCriteria.mMaxGenerationCount);
+	case ETerminationReason::TargetFitnessFactor:
+		return FString::Printf(TEXT("Fitness factor %f reached the target of %f after %d generations"), mFitnessFactor, mCriteria.mTargetFitnessFactor, mGenerationCount);
+	case ETerminationReason::Stagnation:
+		return FString::Printf(TEXT("Best fitness %f has not improved since generation %d, stopped after %d generations"), mBestFitness, mBestFitnessGeneration, mGenerationCount);
+	case ETerminationReason::DiversityCollapse:
+		return FString::Printf(TEXT("Diversity %f dropped below %f after %d generations"), mDiversity, mCriteria.mMinDiversity, mGenerationCount);
+	case ETerminationReason::None:
+	default:
+		return TEXT("Not terminated");
+	}
+}
+
+
+
+const TCHAR* FGeneticTerminationMonitor::GetReasonName(const ETerminationReason inReason)
+{
+	switch (inReason)
+	{
+	case ETerminationReason::MaxGenerations:
+		return TEXT("MaxGenerations");
+	case ETerminationReason::TargetFitnessFactor:
+		return TEXT("TargetFitnessFactor");
+	case ETerminationReason::Stagnation:
+		return TEXT("Stagnation");
+	case ETerminationReason::DiversityCollapse:
+		return TEXT("DiversityCollapse");
+	case ETerminationReason::None:
+	default:
+		return TEXT("None");
+	}
+}
+
+
+
+/**
+* Only the progress of the run is serialized, the criteria come from the configuration
+*/
+FArchive& operator<<(FArchive& ioArchive, FGeneticTerminationMonitor& ioMonitor)
+{
+	uint8 reason = static_cast<uint8>(ioMonitor.mReason);
+	ioArchive << reason;
+	ioMonitor.mReason = static_cast<ETerminationReason>(reason);
+
+	ioArchive << ioMonitor.mGenerationCount;
+	ioArchive << ioMonitor.mBestFitness;
+	ioArchive << ioMonitor.mBestFitnessGeneration;
+	ioArchive << ioMonitor.mFitnessFactor;
+	ioArchive << ioMonitor.mDiversity;
+
+	return ioArchive;
+}
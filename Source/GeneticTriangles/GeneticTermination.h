@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// API includes
+#include "Enums.h"
+
+/**
+* Root mean square distance of a set of points to their mean, updated one point at a time
+* Uses Welford's running variance, which needs a single pass and stays accurate far away from the origin
+*/
+struct FPopulationDiversity
+{
+	int32 mAmount = 0;
+	FVector mMean = FVector::ZeroVector;
+	double mSquaredDeviation = 0.0;
+
+	void Add(const FVector& inPoint)
+	{
+		++mAmount;
+
+		const FVector deviation = inPoint - mMean;
+		mMean += deviation / mAmount;
+		mSquaredDeviation += FVector::DotProduct(deviation, inPoint - mMean);
+	}
+
+	float Get() const { return mAmount > 0 ? FMath::Sqrt(mSquaredDeviation / mAmount) : 0.0f; }
+};
+
+
+
+/**
+* When a run should stop by itself, every criterion is disabled by a value of zero
+*/
+struct FGeneticTerminationCriteria
+{
+	int32 mMaxGenerationCount = 0;
+	float mTargetFitnessFactor = 0.0f;
+	int32 mStagnationWindow = 0; ///< Amount of generations the best fitness may go without improving
+	float mMinDiversity = 0.0f;
+
+	bool IsEnabled() const { return mMaxGenerationCount > 0 || mTargetFitnessFactor > 0.0f || mStagnationWindow > 0 || mMinDiversity > 0.0f; }
+};
+
+
+
+/**
+* Checks the termination criteria after every generation of a run
+* Only keeps track of the best fitness so far, so it costs nothing to update every generation
+*/
+class GENETICTRIANGLES_API FGeneticTerminationMonitor
+{
+public:
+	FGeneticTerminationMonitor(const FGeneticTerminationCriteria& inCriteria = FGeneticTerminationCriteria());
+
+	void SetCriteria(const FGeneticTerminationCriteria& inCriteria) { mCriteria = inCriteria; }
+	void Reset();
+
+	ETerminationReason Update(const int32 inGenerationCount, const float inBestFitness, const float inFitnessFactor, const float inDiversity);
+
+	bool HasTerminated() const { return mReason != ETerminationReason::None; }
+	ETerminationReason GetReason() const { return mReason; }
+	FString GetDescription() const;
+
+	static const TCHAR* GetReasonName(const ETerminationReason inReason);
+
+	friend FArchive& operator<<(FArchive& ioArchive, FGeneticTerminationMonitor& ioMonitor);
+
+private:
+	FGeneticTerminationCriteria mCriteria;
+
+	ETerminationReason mReason = ETerminationReason::None;
+	int32 mGenerationCount = 0;
+	float mBestFitness = -TNumericLimits<float>::Max();
+	int32 mBestFitnessGeneration = 0;
+	float mFitnessFactor = 0.0f;
+	float mDiversity = 0.0f;
+};
@@ -10,6 +10,9 @@ public class GeneticTriangles : ModuleRules
 
 		PrivateDependencyModuleNames.AddRange(new string[] {  });
 
+		// History chunks are compressed at a selectable level, which FCompression does not expose
+		AddEngineThirdPartyPrivateStaticDependencies(Target, "zlib");
+
 		// Uncomment if you are using Slate UI
 		// PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
 		
@@ -3,3 +3,28 @@
 #include "GeneticTriangles.h"
 
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, GeneticTriangles, "GeneticTriangles" );
+
+DEFINE_STAT(STAT_GeneticTriangles_StepGeneration);
+DEFINE_STAT(STAT_GeneticTriangles_EvaluateParents);
+DEFINE_STAT(STAT_GeneticTriangles_EvaluateOffspring);
+DEFINE_STAT(STAT_GeneticTriangles_SnapToTerrain);
+DEFINE_STAT(STAT_GeneticTriangles_PathGeometry);
+DEFINE_STAT(STAT_GeneticTriangles_WorldTraces);
+DEFINE_STAT(STAT_GeneticTriangles_ScorePopulation);
+DEFINE_STAT(STAT_GeneticTriangles_EvaluateFitness);
+DEFINE_STAT(STAT_GeneticTriangles_Selection);
+DEFINE_STAT(STAT_GeneticTriangles_Crossover);
+DEFINE_STAT(STAT_GeneticTriangles_Mutation);
+DEFINE_STAT(STAT_GeneticTriangles_Purge);
+DEFINE_STAT(STAT_GeneticTriangles_Capture);
+DEFINE_STAT(STAT_GeneticTriangles_ColorCoding);
+DEFINE_STAT(STAT_GeneticTriangles_Recording);
+DEFINE_STAT(STAT_GeneticTriangles_Presentation);
+DEFINE_STAT(STAT_GeneticTriangles_ObstacleTraces);
+DEFINE_STAT(STAT_GeneticTriangles_TargetTraces);
+DEFINE_STAT(STAT_GeneticTriangles_TerrainTraces);
+DEFINE_STAT(STAT_GeneticTriangles_TerrainHiddenTraces);
+DEFINE_STAT(STAT_GeneticTriangles_ActorsSpawned);
+DEFINE_STAT(STAT_GeneticTriangles_ActorsDestroyed);
+DEFINE_STAT(STAT_GeneticTriangles_HistoryBytesWritten);
+DEFINE_STAT(STAT_GeneticTriangles_HistoryRetained);
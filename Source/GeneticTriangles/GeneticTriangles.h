@@ -4,4 +4,5 @@
 
 #include "Engine.h"
 
-#include "Enums.h"
\ No newline at end of file
+#include "Enums.h"
+#include "GeneticTrianglesStats.h"
\ No newline at end of file
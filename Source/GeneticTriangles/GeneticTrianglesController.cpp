@@ -204,6 +204,28 @@ void AGeneticTrianglesController::RequestDeserialization()
 
 
 
+void AGeneticTrianglesController::RequestCheckpoint()
+{
+	FindPathManager();
+
+	check(mPathManager != nullptr);
+
+	mPathManager->RequestCheckpoint();
+}
+
+
+
+bool AGeneticTrianglesController::RequestResume()
+{
+	FindPathManager();
+
+	check(mPathManager != nullptr);
+
+	return mPathManager->ResumeFromCheckpoint();
+}
+
+
+
 int32 AGeneticTrianglesController::RequestKnowledgeOfGenerationCount()
 {
 	FindPathManager();
@@ -56,6 +56,12 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "GeneticPaths")
 	void RequestDeserialization();
 
+	UFUNCTION(BlueprintCallable, Category = "GeneticPaths")
+	void RequestCheckpoint();
+
+	UFUNCTION(BlueprintCallable, Category = "GeneticPaths")
+	bool RequestResume();
+
 	UFUNCTION(BlueprintCallable, Category = "GeneticPaths")
 	int32 RequestKnowledgeOfGenerationCount();
 	
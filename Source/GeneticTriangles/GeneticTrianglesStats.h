@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+/**
+* "stat GeneticTriangles" shows where the time of a generation goes
+* The cycle counters cover the phases of the algorithm and the stages a generation goes through after it,
+* they are gathered on whichever thread runs them, the game thread, the task graph or the island workers
+* The counters are reset every frame, the memory stat is not
+*/
+DECLARE_STATS_GROUP(TEXT("GeneticTriangles"), STATGROUP_GeneticTriangles, STATCAT_Advanced);
+
+// Phases of the path algorithm
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Step generation"), STAT_GeneticTriangles_StepGeneration, STATGROUP_GeneticTriangles, GENETICTRIANGLES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Evaluate parents"), STAT_GeneticTriangles_EvaluateParents, STATGROUP_GeneticTriangles, GENETICTRIANGLES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Evaluate offspring"), STAT_GeneticTriangles_EvaluateOffspring, STATGROUP_GeneticTriangles, GENETICTRIANGLES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("  Snap to terrain"), STAT_GeneticTriangles_SnapToTerrain, STATGROUP_GeneticTriangles, GENETICTRIANGLES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("  Path geometry"), STAT_GeneticTriangles_PathGeometry, STATGROUP_GeneticTriangles, GENETICTRIANGLES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("  World traces"), STAT_GeneticTriangles_WorldTraces, STATGROUP_GeneticTriangles, GENETICTRIANGLES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("  Score population"), STAT_GeneticTriangles_ScorePopulation, STATGROUP_GeneticTriangles, GENETICTRIANGLES_API);
+
+// Shared by the path algorithm and both triangle managers
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Evaluate fitness"), STAT_GeneticTriangles_EvaluateFitness, STATGROUP_GeneticTriangles, GENETICTRIANGLES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Selection"), STAT_GeneticTriangles_Selection, STATGROUP_GeneticTriangles, GENETICTRIANGLES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Crossover"), STAT_GeneticTriangles_Crossover, STATGROUP_GeneticTriangles, GENETICTRIANGLES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Mutation"), STAT_GeneticTriangles_Mutation, STATGROUP_GeneticTriangles, GENETICTRIANGLES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Purge"), STAT_GeneticTriangles_Purge, STATGROUP_GeneticTriangles, GENETICTRIANGLES_API);
+
+// Stages after the algorithm
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Capture generation"), STAT_GeneticTriangles_Capture, STATGROUP_GeneticTriangles, GENETICTRIANGLES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Color coding"), STAT_GeneticTriangles_ColorCoding, STATGROUP_GeneticTriangles, GENETICTRIANGLES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Record history"), STAT_GeneticTriangles_Recording, STATGROUP_GeneticTriangles, GENETICTRIANGLES_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Present generation"), STAT_GeneticTriangles_Presentation, STATGROUP_GeneticTriangles, GENETICTRIANGLES_API);
+
+// Line traces by the channel they are traced on
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Line traces, Obstacle"), STAT_GeneticTriangles_ObstacleTraces, STATGROUP_GeneticTriangles, GENETICTRIANGLES_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Line traces, Target"), STAT_GeneticTriangles_TargetTraces, STATGROUP_GeneticTriangles, GENETICTRIANGLES_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Line traces, Terrain"), STAT_GeneticTriangles_TerrainTraces, STATGROUP_GeneticTriangles, GENETICTRIANGLES_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Line traces, TerrainHidden"), STAT_GeneticTriangles_TerrainHiddenTraces, STATGROUP_GeneticTriangles, GENETICTRIANGLES_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Actors spawned"), STAT_GeneticTriangles_ActorsSpawned, STATGROUP_GeneticTriangles, GENETICTRIANGLES_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Actors destroyed"), STAT_GeneticTriangles_ActorsDestroyed, STATGROUP_GeneticTriangles, GENETICTRIANGLES_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("History bytes written"), STAT_GeneticTriangles_HistoryBytesWritten, STATGROUP_GeneticTriangles, GENETICTRIANGLES_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("History retained by replays"), STAT_GeneticTriangles_HistoryRetained, STATGROUP_GeneticTriangles, GENETICTRIANGLES_API);
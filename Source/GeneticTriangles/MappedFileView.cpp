@@ -0,0 +1,178 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneticTriangles.h"
+#include "MappedFileView.h"
+
+#if PLATFORM_WINDOWS
+#include "AllowWindowsPlatformTypes.h"
+#include <windows.h>
+#include "HideWindowsPlatformTypes.h"
+#elif PLATFORM_LINUX || PLATFORM_MAC
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+FMappedFileView::FMappedFileView()
+{
+}
+
+
+
+FMappedFileView::~FMappedFileView()
+{
+	Close();
+}
+
+
+
+bool FMappedFileView::Open(const FString& inFilePath)
+{
+	Close();
+
+	if (Map(inFilePath))
+		return true;
+
+	mFileHandle = FPlatformFileManager::Get().GetPlatformFile().OpenRead(*inFilePath);
+	if (mFileHandle == nullptr)
+		return false;
+
+	mSize = mFileHandle->Size();
+	return true;
+}
+
+
+
+void FMappedFileView::Close()
+{
+	Unmap();
+
+	if (mFileHandle != nullptr)
+	{
+		delete mFileHandle;
+		mFileHandle = nullptr;
+	}
+
+	mSize = 0;
+	mReadBuffer.Empty();
+}
+
+
+
+/**
+* Returns a pointer to inSize bytes of the file at inOffset, or nullptr if the range lies outside of the file
+* Mapped files return a pointer into the mapping, which stays valid until the view is closed
+* Otherwise the range is read into the read buffer, so the pointer is only valid until the next read
+*/
+const uint8* FMappedFileView::Read(const int64 inOffset, const int64 inSize)
+{
+	if (inOffset < 0 || inSize < 0 || inOffset + inSize > mSize)
+		return nullptr;
+
+	if (mMappedData != nullptr)
+		return mMappedData + inOffset;
+
+	if (mFileHandle == nullptr)
+		return nullptr;
+
+	mReadBuffer.SetNum(inSize, false);
+
+	if (!mFileHandle->Seek(inOffset) || !mFileHandle->Read(mReadBuffer.GetData(), inSize))
+		return nullptr;
+
+	return mReadBuffer.GetData();
+}
+
+
+
+bool FMappedFileView::Map(const FString& inFilePath)
+{
+	const FString absolute_file_path = FPaths::ConvertRelativePathToFull(inFilePath);
+
+#if PLATFORM_WINDOWS
+	// Others may keep reading the file, but it may not be written to while it is mapped
+	HANDLE file = CreateFileW(*absolute_file_path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	const void* mapped_data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (mapped_data == nullptr)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	mPlatformFile = file;
+	mPlatformMapping = mapping;
+	mMappedData = (const uint8*)mapped_data;
+	mSize = file_size.QuadPart;
+
+	return true;
+#elif PLATFORM_LINUX || PLATFORM_MAC
+	const int32 file = open(TCHAR_TO_UTF8(*absolute_file_path), O_RDONLY);
+	if (file < 0)
+		return false;
+
+	struct stat file_status;
+	if (fstat(file, &file_status) != 0 || file_status.st_size == 0)
+	{
+		close(file);
+		return false;
+	}
+
+	void* mapped_data = mmap(nullptr, file_status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	if (mapped_data == MAP_FAILED)
+	{
+		close(file);
+		return false;
+	}
+
+	mPlatformFile = file;
+	mMappedData = (const uint8*)mapped_data;
+	mSize = file_status.st_size;
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+
+void FMappedFileView::Unmap()
+{
+	if (mMappedData == nullptr)
+		return;
+
+#if PLATFORM_WINDOWS
+	UnmapViewOfFile(mMappedData);
+	CloseHandle(mPlatformMapping);
+	CloseHandle(mPlatformFile);
+
+	mPlatformMapping = nullptr;
+	mPlatformFile = nullptr;
+#elif PLATFORM_LINUX || PLATFORM_MAC
+	munmap((void*)mMappedData, mSize);
+	close(mPlatformFile);
+
+	mPlatformFile = -1;
+#endif
+
+	mMappedData = nullptr;
+}
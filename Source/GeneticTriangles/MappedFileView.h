@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+/**
+* Read-only view of a whole file, memory mapped where the platform allows it
+*
+* The engine has no mapped file handles yet, so the mapping is done through the platform API on Windows, Linux and Mac
+* Everywhere else, and for files that can not be mapped, ranges are read through a platform file handle into a reusable buffer instead
+* Mapped pages are only loaded once they are touched, so opening a file is instant and resident memory follows what is actually read
+*/
+class GENETICTRIANGLES_API FMappedFileView
+{
+public:
+	FMappedFileView();
+	~FMappedFileView();
+
+	bool Open(const FString& inFilePath);
+	void Close();
+
+	const uint8* Read(const int64 inOffset, const int64 inSize);
+
+	bool IsOpen() const { return mMappedData != nullptr || mFileHandle != nullptr; }
+	bool IsMapped() const { return mMappedData != nullptr; }
+	int64 GetSize() const { return mSize; }
+
+private:
+	FMappedFileView(const FMappedFileView&) = delete;
+	FMappedFileView& operator=(const FMappedFileView&) = delete;
+
+	bool Map(const FString& inFilePath);
+	void Unmap();
+
+private:
+	const uint8* mMappedData = nullptr;
+	int64 mSize = 0;
+
+#if PLATFORM_WINDOWS
+	void* mPlatformFile = nullptr;
+	void* mPlatformMapping = nullptr;
+#elif PLATFORM_LINUX || PLATFORM_MAC
+	int32 mPlatformFile = -1;
+#endif
+
+	IFileHandle* mFileHandle = nullptr; ///< Only used when the file could not be mapped
+	TArray<uint8> mReadBuffer;
+};
@@ -0,0 +1,484 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneticTriangles.h"
+#include "PathBenchmark.h"
+
+#include "PathCommandletHelpers.h"
+#include "PathGeneticAlgorithm.h"
+#include "PathManager.h"
+#include "Triangle.h"
+#include "TriangleManager.h"
+#include "UpdatedTriangleManager.h"
+
+FPathBenchmark::FPathBenchmark(const FPathBenchmarkSettings& inSettings)
+	:
+	mSettings(inSettings)
+{
+	// Seed zero makes the path algorithm pick a random seed, which would make the runs unrepeatable
+	mSettings.mRandomSeed = FMath::Max(mSettings.mRandomSeed, 1);
+	mSettings.mGenerationAmount = FMath::Max(mSettings.mGenerationAmount, 1);
+
+	if (mSettings.mMapNames.Num() == 0)
+		GetDefaultMapNames(mSettings.mMapNames);
+
+	if (mSettings.mPopulationSizes.Num() == 0)
+		GetDefaultPopulationSizes(mSettings.mPopulationSizes);
+}
+
+
+
+/**
+* Every shipped path map, followed by the triangle maps of both triangle managers
+*/
+void FPathBenchmark::GetDefaultMapNames(TArray<FString>& outMapNames)
+{
+	outMapNames.Reset();
+	outMapNames.Add(TEXT("Path_NoObstacles"));
+	outMapNames.Add(TEXT("Path_SimpleObstacle"));
+	outMapNames.Add(TEXT("Path_LShape"));
+	outMapNames.Add(TEXT("Path_Slope"));
+	outMapNames.Add(TEXT("PathStandardFilter"));
+	outMapNames.Add(TEXT("PathGreatFilter"));
+	outMapNames.Add(TEXT("GATriangles"));
+	outMapNames.Add(TEXT("GATriangles_Updated"));
+}
+
+
+
+void FPathBenchmark::GetDefaultPopulationSizes(TArray<int32>& outPopulationSizes)
+{
+	outPopulationSizes.Reset();
+	outPopulationSizes.Add(20);
+	outPopulationSizes.Add(200);
+	outPopulationSizes.Add(2000);
+	outPopulationSizes.Add(20000);
+}
+
+
+
+/**
+* Loads every map in turn and runs it at every population size, returns false if any map could not be run
+* A map is run by the first manager that is found in it, path managers take precedence
+*/
+bool FPathBenchmark::Run()
+{
+	mResults.Reset();
+
+	bool has_succeeded = true;
+
+	for (const FString& map_name : mSettings.mMapNames)
+	{
+		UWorld* world = FPathCommandletHelpers::LoadWorld(map_name);
+		if (world == nullptr)
+		{
+			UE_LOG(LogTemp, Error, TEXT("FPathBenchmark::Run >> Unable to load map %s"), *map_name);
+			has_succeeded = false;
+			continue;
+		}
+
+		APathManager* path_manager = FPathCommandletHelpers::FindPathManager(world);
+
+		AUpdatedTriangleManager* updated_triangle_manager = nullptr;
+		for (TActorIterator<AUpdatedTriangleManager> it(world); it; ++it)
+		{
+			updated_triangle_manager = *it;
+			break;
+		}
+
+		ATriangleManager* triangle_manager = nullptr;
+		for (TActorIterator<ATriangleManager> it(world); it; ++it)
+		{
+			triangle_manager = *it;
+			break;
+		}
+
+		for (const int32 population_size : mSettings.mPopulationSizes)
+		{
+			FPathBenchmarkResult result;
+			result.mMapName = FPackageName::GetShortName(map_name);
+			result.mPopulationSize = population_size;
+
+			bool has_run = false;
+			if (path_manager != nullptr && path_manager->AreNodesValid())
+				has_run = RunPathManager(world, path_manager, population_size, result);
+			else if (updated_triangle_manager != nullptr)
+				has_run = RunUpdatedTriangleManager(world, updated_triangle_manager, population_size, result);
+			else if (triangle_manager != nullptr)
+				has_run = RunTriangleManager(world, triangle_manager, population_size, result);
+
+			if (!has_run)
+			{
+				UE_LOG(LogTemp, Error, TEXT("FPathBenchmark::Run >> Map %s has no manager that can be run"), *map_name);
+				has_succeeded = false;
+				break;
+			}
+
+			UE_LOG(LogTemp, Display, TEXT("FPathBenchmark::Run >> %s, %d individuals: %f generations/s, p50 %f ms, p99 %f ms, %f traces/generation, %f MB"),
+				*result.mMapName, population_size, result.mGenerationsPerSecond, result.mLatencyP50, result.mLatencyP99, result.mTracesPerGeneration, result.mPeakMemory);
+
+			mResults.Add(result);
+		}
+
+		FPathCommandletHelpers::ReleaseWorld(world);
+	}
+
+	return has_succeeded;
+}
+
+
+
+/**
+* Writes one row per map and population size
+*/
+bool FPathBenchmark::SaveResults(const FString& inFilePath) const
+{
+	FString table = TEXT("Map,Manager,PopulationSize,Generations,WallTimeSeconds,GenerationsPerSecond,LatencyP50Ms,LatencyP99Ms,TracesPerGeneration,PeakMemoryMB\n");
+
+	for (const FPathBenchmarkResult& result : mResults)
+	{
+		table += FString::Printf(TEXT("%s,%s,%d,%d,%f,%f,%f,%f,%f,%f\n"),
+			*result.mMapName, *result.mManagerName, result.mPopulationSize, result.mGenerationAmount, result.mWallTime,
+			result.mGenerationsPerSecond, result.mLatencyP50, result.mLatencyP99, result.mTracesPerGeneration, result.mPeakMemory);
+	}
+
+	return FFileHelper::SaveStringToFile(table, *inFilePath);
+}
+
+
+
+/**
+* Reads the results of an earlier benchmark, columns are looked up by name so a baseline may have columns in any order
+*/
+bool FPathBenchmark::LoadResults(const FString& inFilePath, TArray<FPathBenchmarkResult>& outResults)
+{
+	outResults.Reset();
+
+	TArray<FString> lines;
+	if (!FFileHelper::LoadANSITextFileToStrings(*inFilePath, nullptr, lines) || lines.Num() == 0)
+		return false;
+
+	TArray<FString> column_names;
+	lines[0].ParseIntoArray(column_names, TEXT(","));
+
+	const int32 map_column = column_names.Find(TEXT("Map"));
+	const int32 manager_column = column_names.Find(TEXT("Manager"));
+	const int32 population_size_column = column_names.Find(TEXT("PopulationSize"));
+	const int32 generations_column = column_names.Find(TEXT("Generations"));
+	const int32 wall_time_column = column_names.Find(TEXT("WallTimeSeconds"));
+	const int32 generations_per_second_column = column_names.Find(TEXT("GenerationsPerSecond"));
+	const int32 latency_p50_column = column_names.Find(TEXT("LatencyP50Ms"));
+	const int32 latency_p99_column = column_names.Find(TEXT("LatencyP99Ms"));
+	const int32 traces_column = column_names.Find(TEXT("TracesPerGeneration"));
+	const int32 memory_column = column_names.Find(TEXT("PeakMemoryMB"));
+
+	if (map_column == INDEX_NONE || population_size_column == INDEX_NONE)
+		return false;
+
+	for (int32 i = 1; i < lines.Num(); ++i)
+	{
+		TArray<FString> values;
+		if (lines[i].ParseIntoArray(values, TEXT(","), false) != column_names.Num())
+			continue;
+
+		FPathBenchmarkResult& result = outResults[outResults.AddDefaulted()];
+		result.mMapName = values[map_column];
+		result.mPopulationSize = FCString::Atoi(*values[population_size_column]);
+
+		if (manager_column != INDEX_NONE)
+			result.mManagerName = values[manager_column];
+		if (generations_column != INDEX_NONE)
+			result.mGenerationAmount = FCString::Atoi(*values[generations_column]);
+		if (wall_time_column != INDEX_NONE)
+			result.mWallTime = FCString::Atod(*values[wall_time_column]);
+		if (generations_per_second_column != INDEX_NONE)
+			result.mGenerationsPerSecond = FCString::Atod(*values[generations_per_second_column]);
+		if (latency_p50_column != INDEX_NONE)
+			result.mLatencyP50 = FCString::Atod(*values[latency_p50_column]);
+		if (latency_p99_column != INDEX_NONE)
+			result.mLatencyP99 = FCString::Atod(*values[latency_p99_column]);
+		if (traces_column != INDEX_NONE)
+			result.mTracesPerGeneration = FCString::Atod(*values[traces_column]);
+		if (memory_column != INDEX_NONE)
+			result.mPeakMemory = FCString::Atod(*values[memory_column]);
+	}
+
+	return true;
+}
+
+
+
+/**
+* Compares every result with the baseline result of the same map and population size, results without one are left out
+* Writes one row per metric and returns the amount of metrics that got worse by more than their threshold
+*/
+int32 FPathBenchmark::CompareWithBaseline(const TArray<FPathBenchmarkResult>& inBaseline, const FString& inComparisonFilePath) const
+{
+	const FPathBenchmarkThresholds& thresholds = mSettings.mThresholds;
+
+	FString table = TEXT("Map,PopulationSize,Metric,Baseline,Current,ChangePercent,ThresholdPercent,Regressed\n");
+	int32 regression_amount = 0;
+
+	for (const FPathBenchmarkResult& result : mResults)
+	{
+		const FPathBenchmarkResult* baseline = inBaseline.FindByPredicate([&result](const FPathBenchmarkResult& inBaselineResult)
+		{
+			return inBaselineResult.mMapName == result.mMapName && inBaselineResult.mPopulationSize == result.mPopulationSize;
+		});
+
+		if (baseline == nullptr)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("FPathBenchmark::CompareWithBaseline >> The baseline has no result for %s with %d individuals"), *result.mMapName, result.mPopulationSize);
+			continue;
+		}
+
+		// A loss of throughput is a negative change, so it is flipped to compare it like the others
+		struct FMetric
+		{
+			const TCHAR* mName;
+			double mBaseline;
+			double mCurrent;
+			double mWorsening;
+			float mThreshold;
+		};
+
+		const FMetric metrics[] =
+		{
+			{ TEXT("GenerationsPerSecond"), baseline->mGenerationsPerSecond, result.mGenerationsPerSecond, -GetChange(baseline->mGenerationsPerSecond, result.mGenerationsPerSecond), thresholds.mMaxThroughputLoss },
+			{ TEXT("LatencyP50Ms"), baseline->mLatencyP50, result.mLatencyP50, GetChange(baseline->mLatencyP50, result.mLatencyP50), thresholds.mMaxLatencyGain },
+			{ TEXT("LatencyP99Ms"), baseline->mLatencyP99, result.mLatencyP99, GetChange(baseline->mLatencyP99, result.mLatencyP99), thresholds.mMaxLatencyGain },
+			{ TEXT("TracesPerGeneration"), baseline->mTracesPerGeneration, result.mTracesPerGeneration, GetChange(baseline->mTracesPerGeneration, result.mTracesPerGeneration), thresholds.mMaxTraceGain },
+			{ TEXT("PeakMemoryMB"), baseline->mPeakMemory, result.mPeakMemory, GetChange(baseline->mPeakMemory, result.mPeakMemory), thresholds.mMaxMemoryGain }
+		};
+
+		for (const FMetric& metric : metrics)
+		{
+			const bool has_regressed = metric.mWorsening > metric.mThreshold;
+			if (has_regressed)
+			{
+				++regression_amount;
+				UE_LOG(LogTemp, Warning, TEXT("FPathBenchmark::CompareWithBaseline >> %s with %d individuals regressed in %s, %f -> %f"),
+					*result.mMapName, result.mPopulationSize, metric.mName, metric.mBaseline, metric.mCurrent);
+			}
+
+			table += FString::Printf(TEXT("%s,%d,%s,%f,%f,%f,%f,%d\n"),
+				*result.mMapName, result.mPopulationSize, metric.mName, metric.mBaseline, metric.mCurrent,
+				GetChange(metric.mBaseline, metric.mCurrent), metric.mThreshold, has_regressed ? 1 : 0);
+		}
+	}
+
+	if (!FFileHelper::SaveStringToFile(table, *inComparisonFilePath))
+		UE_LOG(LogTemp, Warning, TEXT("FPathBenchmark::CompareWithBaseline >> Unable to save %s"), *inComparisonFilePath);
+
+	return regression_amount;
+}
+
+
+
+void FPathBenchmark::FRunSamples::Begin(const int32 inGenerationAmount)
+{
+	mLatencies.Reset(inGenerationAmount);
+	mTraceAmount = 0;
+	mStartMemory = FPlatformMemory::GetStats().UsedPhysical;
+	mPeakMemory = mStartMemory;
+	mStartTime = FPlatformTime::Seconds();
+}
+
+
+
+void FPathBenchmark::FRunSamples::BeginGeneration()
+{
+	mGenerationStartTime = FPlatformTime::Seconds();
+}
+
+
+
+/**
+* The memory is sampled after the latency is taken, so sampling does not count towards the generation
+*/
+void FPathBenchmark::FRunSamples::EndGeneration(const int32 inTraceAmount)
+{
+	mLatencies.Add((FPlatformTime::Seconds() - mGenerationStartTime) * 1000.0);
+	mTraceAmount += inTraceAmount;
+	mPeakMemory = FMath::Max(mPeakMemory, (uint64)FPlatformMemory::GetStats().UsedPhysical);
+}
+
+
+
+void FPathBenchmark::FRunSamples::Finish(FPathBenchmarkResult& outResult)
+{
+	double total_latency = 0.0;
+	for (const double latency : mLatencies)
+		total_latency += latency;
+
+	mLatencies.Sort();
+
+	outResult.mGenerationAmount = mLatencies.Num();
+	outResult.mWallTime = FPlatformTime::Seconds() - mStartTime;
+
+	// Only the generations themselves, the bookkeeping in between is left out
+	outResult.mGenerationsPerSecond = total_latency > 0.0 ? mLatencies.Num() * 1000.0 / total_latency : 0.0;
+	outResult.mLatencyP50 = GetPercentile(mLatencies, 0.5f);
+	outResult.mLatencyP99 = GetPercentile(mLatencies, 0.99f);
+	outResult.mTracesPerGeneration = mLatencies.Num() > 0 ? (double)mTraceAmount / mLatencies.Num() : 0.0;
+	outResult.mPeakMemory = (mPeakMemory - mStartMemory) / (1024.0 * 1024.0);
+}
+
+
+
+bool FPathBenchmark::RunPathManager(UWorld* inWorld, APathManager* inPathManager, const int32 inPopulationSize, FPathBenchmarkResult& outResult) const
+{
+	FPathGeneticAlgorithmSettings settings = inPathManager->GatherSettings();
+	settings.mDrawDebug = false;
+	settings.mPopulationCount = inPopulationSize;
+	settings.mRandomSeed = mSettings.mRandomSeed;
+
+	FPathGeneticAlgorithm algorithm(inWorld, settings);
+	algorithm.InitializeRun();
+
+	FRunSamples samples;
+	samples.Begin(mSettings.mGenerationAmount);
+
+	for (int32 i = 0; i < mSettings.mGenerationAmount; ++i)
+	{
+		samples.BeginGeneration();
+		algorithm.RunGeneration();
+		samples.EndGeneration(algorithm.GetTraceAmount());
+	}
+
+	outResult.mManagerName = TEXT("PathManager");
+	samples.Finish(outResult);
+
+	return true;
+}
+
+
+
+/**
+* Runs a copy of the manager placed in the map, so every run starts from the properties of the map
+* The original manager has no generation loop of its own, a generation is the four steps it exposes, after the tick that balances its mutation rate
+*/
+bool FPathBenchmark::RunTriangleManager(UWorld* inWorld, ATriangleManager* inTriangleManager, const int32 inPopulationSize, FPathBenchmarkResult& outResult) const
+{
+	FActorSpawnParameters spawn_parameters;
+	spawn_parameters.Template = inTriangleManager;
+
+	ATriangleManager* triangle_manager = inWorld->SpawnActor<ATriangleManager>(spawn_parameters);
+	if (triangle_manager == nullptr)
+		return false;
+
+	triangle_manager->PopulationSize = inPopulationSize;
+
+	// The manager draws from the global random stream without ever seeding it
+	FMath::RandInit(mSettings.mRandomSeed);
+	triangle_manager->InitializePopulation();
+
+	FRunSamples samples;
+	samples.Begin(mSettings.mGenerationAmount);
+
+	for (int32 i = 0; i < mSettings.mGenerationAmount; ++i)
+	{
+		samples.BeginGeneration();
+
+		triangle_manager->Tick(0.0f);
+		triangle_manager->EvaluateFitness();
+		triangle_manager->SelectionStep();
+		triangle_manager->CrossoverStep();
+		triangle_manager->MutationStep();
+
+		samples.EndGeneration(0);
+	}
+
+	outResult.mManagerName = TEXT("TriangleManager");
+	samples.Finish(outResult);
+
+	DestroyTriangles(inWorld);
+	triangle_manager->Destroy();
+
+	return true;
+}
+
+
+
+/**
+* Runs a copy of the manager placed in the map with its termination criteria disabled, so it runs every generation it is asked for
+*/
+bool FPathBenchmark::RunUpdatedTriangleManager(UWorld* inWorld, AUpdatedTriangleManager* inTriangleManager, const int32 inPopulationSize, FPathBenchmarkResult& outResult) const
+{
+	FActorSpawnParameters spawn_parameters;
+	spawn_parameters.Template = inTriangleManager;
+
+	AUpdatedTriangleManager* triangle_manager = inWorld->SpawnActor<AUpdatedTriangleManager>(spawn_parameters);
+	if (triangle_manager == nullptr)
+		return false;
+
+	triangle_manager->PopulationCount = inPopulationSize;
+	triangle_manager->RandomSeed = mSettings.mRandomSeed;
+	triangle_manager->MaxGenerationCount = 0;
+	triangle_manager->TargetFitnessFactor = 0.0f;
+	triangle_manager->StagnationWindow = 0;
+	triangle_manager->MinDiversity = 0.0f;
+	triangle_manager->VisualizationInterval = MAX_int32;
+
+	// The triangles are spawned before the manager seeds the global random stream
+	FMath::RandInit(mSettings.mRandomSeed);
+	triangle_manager->Initialize();
+
+	FRunSamples samples;
+	samples.Begin(mSettings.mGenerationAmount);
+
+	for (int32 i = 0; i < mSettings.mGenerationAmount; ++i)
+	{
+		samples.BeginGeneration();
+		triangle_manager->RunGeneration();
+		samples.EndGeneration(0);
+	}
+
+	outResult.mManagerName = TEXT("UpdatedTriangleManager");
+	samples.Finish(outResult);
+
+	DestroyTriangles(inWorld);
+	triangle_manager->Destroy();
+
+	return true;
+}
+
+
+
+/**
+* The triangle managers never let go of their triangles, so they are cleared from the world before the next run
+*/
+void FPathBenchmark::DestroyTriangles(UWorld* inWorld)
+{
+	for (TActorIterator<ATriangle> it(inWorld); it; ++it)
+	{
+		INC_DWORD_STAT(STAT_GeneticTriangles_ActorsDestroyed);
+		it->Destroy();
+	}
+}
+
+
+
+/**
+* Nearest rank percentile of values sorted in ascending order
+*/
+double FPathBenchmark::GetPercentile(const TArray<double>& inSortedValues, const float inPercentile)
+{
+	if (inSortedValues.Num() == 0)
+		return 0.0;
+
+	const int32 rank = FMath::CeilToInt(inPercentile * inSortedValues.Num());
+	return inSortedValues[FMath::Clamp(rank - 1, 0, inSortedValues.Num() - 1)];
+}
+
+
+
+/**
+* Relative change in percent, a baseline of zero leaves nothing to compare against
+*/
+double FPathBenchmark::GetChange(const double inBaseline, const double inCurrent)
+{
+	if (inBaseline == 0.0)
+		return 0.0;
+
+	return (inCurrent - inBaseline) / FMath::Abs(inBaseline) * 100.0;
+}
@@ -0,0 +1,106 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Forward decl
+class APathManager;
+class ATriangleManager;
+class AUpdatedTriangleManager;
+
+/**
+* How much worse than the baseline a run may get before it counts as a regression, all in percent
+*/
+struct FPathBenchmarkThresholds
+{
+	float mMaxThroughputLoss = 5.0f;
+	float mMaxLatencyGain = 10.0f; ///< Applies to the median as well as the 99th percentile
+	float mMaxTraceGain = 0.0f; ///< Runs are seeded, so any change in the amount of traces is a change in behavior
+	float mMaxMemoryGain = 20.0f;
+};
+
+/**
+* Settings of a benchmark, every map is run once at every population size
+*/
+struct FPathBenchmarkSettings
+{
+	TArray<FString> mMapNames;
+	TArray<int32> mPopulationSizes;
+	int32 mGenerationAmount = 50;
+	int32 mRandomSeed = 1;
+
+	FPathBenchmarkThresholds mThresholds;
+};
+
+/**
+* Measurements of one map at one population size
+* Latencies are in milliseconds, memory is the growth of the used physical memory during the run in megabytes
+*/
+struct FPathBenchmarkResult
+{
+	FString mMapName;
+	FString mManagerName;
+	int32 mPopulationSize = 0;
+	int32 mGenerationAmount = 0;
+	double mWallTime = 0.0;
+	double mGenerationsPerSecond = 0.0;
+	double mLatencyP50 = 0.0;
+	double mLatencyP99 = 0.0;
+	double mTracesPerGeneration = 0.0;
+	double mPeakMemory = 0.0;
+};
+
+/**
+* Runs a fixed amount of seeded generations on every map at every population size, one run at a time so runs do not compete
+*
+* Path maps run the algorithm of their path manager headless, the same way the experiment commandlet does
+* Triangle maps run a fresh copy of the manager placed in the map, which spawns its triangles into the loaded world
+* Initializing the population is not part of the measurements, only the generations themselves are
+*/
+class GENETICTRIANGLES_API FPathBenchmark
+{
+public:
+	FPathBenchmark(const FPathBenchmarkSettings& inSettings);
+
+	static void GetDefaultMapNames(TArray<FString>& outMapNames);
+	static void GetDefaultPopulationSizes(TArray<int32>& outPopulationSizes);
+
+	bool Run();
+
+	bool SaveResults(const FString& inFilePath) const;
+	static bool LoadResults(const FString& inFilePath, TArray<FPathBenchmarkResult>& outResults);
+	int32 CompareWithBaseline(const TArray<FPathBenchmarkResult>& inBaseline, const FString& inComparisonFilePath) const;
+
+	const TArray<FPathBenchmarkResult>& GetResults() const { return mResults; }
+
+private:
+	/**
+	* The measurements of the run in progress, gathered one generation at a time
+	*/
+	struct FRunSamples
+	{
+		TArray<double> mLatencies;
+		int64 mTraceAmount = 0;
+		uint64 mStartMemory = 0;
+		uint64 mPeakMemory = 0;
+		double mStartTime = 0.0;
+		double mGenerationStartTime = 0.0;
+
+		void Begin(const int32 inGenerationAmount);
+		void BeginGeneration();
+		void EndGeneration(const int32 inTraceAmount);
+		void Finish(FPathBenchmarkResult& outResult);
+	};
+
+	bool RunPathManager(UWorld* inWorld, APathManager* inPathManager, const int32 inPopulationSize, FPathBenchmarkResult& outResult) const;
+	bool RunTriangleManager(UWorld* inWorld, ATriangleManager* inTriangleManager, const int32 inPopulationSize, FPathBenchmarkResult& outResult) const;
+	bool RunUpdatedTriangleManager(UWorld* inWorld, AUpdatedTriangleManager* inTriangleManager, const int32 inPopulationSize, FPathBenchmarkResult& outResult) const;
+	static void DestroyTriangles(UWorld* inWorld);
+
+	static double GetPercentile(const TArray<double>& inSortedValues, const float inPercentile);
+	static double GetChange(const double inBaseline, const double inCurrent);
+
+private:
+	FPathBenchmarkSettings mSettings;
+
+	TArray<FPathBenchmarkResult> mResults;
+};
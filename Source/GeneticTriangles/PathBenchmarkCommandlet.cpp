@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneticTriangles.h"
+#include "PathBenchmarkCommandlet.h"
+
+#include "PathBenchmark.h"
+
+UPathBenchmarkCommandlet::UPathBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+
+
+int32 UPathBenchmarkCommandlet::Main(const FString& Params)
+{
+	TArray<FString> tokens;
+	TArray<FString> switches;
+	TMap<FString, FString> params;
+	ParseCommandLine(*Params, tokens, switches, params);
+
+	FPathBenchmarkSettings settings;
+
+	const FString* maps_param = params.Find(TEXT("Maps"));
+	if (maps_param != nullptr)
+		maps_param->ParseIntoArray(settings.mMapNames, TEXT(","));
+
+	const FString* population_sizes_param = params.Find(TEXT("PopulationSizes"));
+	if (population_sizes_param != nullptr)
+	{
+		TArray<FString> population_sizes;
+		population_sizes_param->ParseIntoArray(population_sizes, TEXT(","));
+
+		for (const FString& population_size : population_sizes)
+		{
+			if (FCString::Atoi(*population_size) > 0)
+				settings.mPopulationSizes.Add(FCString::Atoi(*population_size));
+		}
+	}
+
+	const FString* generations_param = params.Find(TEXT("Generations"));
+	if (generations_param != nullptr)
+		settings.mGenerationAmount = FCString::Atoi(**generations_param);
+
+	const FString* seed_param = params.Find(TEXT("Seed"));
+	if (seed_param != nullptr)
+		settings.mRandomSeed = FCString::Atoi(**seed_param);
+
+	// Thresholds that are not given keep their defaults
+	FPathBenchmarkThresholds& thresholds = settings.mThresholds;
+	const TPair<const TCHAR*, float*> threshold_params[] =
+	{
+		TPair<const TCHAR*, float*>(TEXT("MaxThroughputLoss"), &thresholds.mMaxThroughputLoss),
+		TPair<const TCHAR*, float*>(TEXT("MaxLatencyGain"), &thresholds.mMaxLatencyGain),
+		TPair<const TCHAR*, float*>(TEXT("MaxTraceGain"), &thresholds.mMaxTraceGain),
+		TPair<const TCHAR*, float*>(TEXT("MaxMemoryGain"), &thresholds.mMaxMemoryGain)
+	};
+
+	for (const TPair<const TCHAR*, float*>& threshold_param : threshold_params)
+	{
+		const FString* value = params.Find(threshold_param.Key);
+		if (value != nullptr)
+			*threshold_param.Value = FCString::Atof(**value);
+	}
+
+	const FString* output_param = params.Find(TEXT("Output"));
+	const FString output_directory = output_param != nullptr ? *output_param : FPaths::GameSavedDir() / TEXT("PathBenchmarks");
+
+	// The baseline is read up front, so a typo does not surface only after the whole benchmark has run
+	TArray<FPathBenchmarkResult> baseline;
+	const FString* baseline_param = params.Find(TEXT("Baseline"));
+	if (baseline_param != nullptr && !FPathBenchmark::LoadResults(*baseline_param, baseline))
+	{
+		UE_LOG(LogTemp, Error, TEXT("UPathBenchmarkCommandlet::Main >> Unable to read the baseline %s"), **baseline_param);
+		return 1;
+	}
+
+	FPathBenchmark benchmark(settings);
+
+	const double start_time = FPlatformTime::Seconds();
+	const bool has_run_all_maps = benchmark.Run();
+	const double wall_time = FPlatformTime::Seconds() - start_time;
+
+	const bool has_saved_results = benchmark.SaveResults(output_directory / TEXT("Benchmark.csv"));
+
+	UE_LOG(LogTemp, Display, TEXT("UPathBenchmarkCommandlet::Main >> Finished %d runs in %f seconds"), benchmark.GetResults().Num(), wall_time);
+
+	int32 regression_amount = 0;
+	if (baseline_param != nullptr)
+	{
+		regression_amount = benchmark.CompareWithBaseline(baseline, output_directory / TEXT("Benchmark_Comparison.csv"));
+
+		if (regression_amount > 0)
+			UE_LOG(LogTemp, Error, TEXT("UPathBenchmarkCommandlet::Main >> %d metrics regressed compared to %s"), regression_amount, **baseline_param);
+	}
+
+	return has_run_all_maps && has_saved_results && regression_amount == 0 ? 0 : 1;
+}
@@ -0,0 +1,32 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Engine includes
+#include "Commandlets/Commandlet.h"
+
+#include "PathBenchmarkCommandlet.generated.h"
+
+/**
+* Measures the throughput of the genetic algorithms on the shipped maps without rendering, for before and after comparisons
+*
+* Every map is run with a fixed seed at every population size for a fixed amount of generations
+* The results are written as a .csv table, which doubles as the baseline of later runs
+* When a baseline is given every result is compared with it, and the commandlet fails if any metric regressed beyond its threshold
+*
+* Usage: UE4Editor-Cmd GeneticTriangles.uproject -run=PathBenchmark -nullrhi [-Maps=Path_Slope,GATriangles] [-PopulationSizes=20,200]
+*		[-Generations=50] [-Seed=1] [-Output=<directory>] [-Baseline=<file.csv>]
+*		[-MaxThroughputLoss=5] [-MaxLatencyGain=10] [-MaxTraceGain=0] [-MaxMemoryGain=20]
+*
+* Without -Maps or -PopulationSizes every shipped map is run at 20, 200, 2000 and 20000 individuals, thresholds are in percent
+*/
+UCLASS()
+class GENETICTRIANGLES_API UPathBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UPathBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneticTriangles.h"
+#include "PathCheckpointFile.h"
+
+#include "FileManager.h"
+
+#include "PathHistoryFile.h"
+
+FArchive& operator<<(FArchive& ioArchive, FPathCheckpointFile::FHeader& ioHeader)
+{
+	ioArchive << ioHeader.mMagic;
+	ioArchive << ioHeader.mVersion;
+	ioArchive << ioHeader.mUncompressedSize;
+	ioArchive << ioHeader.mCompressedSize;
+	ioArchive << ioHeader.mCrc;
+
+	return ioArchive;
+}
+
+
+
+bool FPathCheckpointFile::Save(const FPathCheckpoint& inCheckpoint, const FString& inFilePath)
+{
+	TArray<uint8> uncompressed_data;
+	FMemoryWriter writer(uncompressed_data);
+	SerializeCheckpoint(writer, const_cast<FPathCheckpoint&>(inCheckpoint));
+
+	int32 compressed_size = FCompression::CompressMemoryBound(ECompressionFlags::COMPRESS_ZLIB, uncompressed_data.Num());
+
+	TArray<uint8> file_data;
+	FMemoryWriter file_writer(file_data);
+
+	FHeader header;
+	file_writer << header;
+
+	const int32 payload_offset = file_data.Num();
+	file_data.AddUninitialized(compressed_size);
+
+	if (!FCompression::CompressMemory(ECompressionFlags::COMPRESS_ZLIB, file_data.GetData() + payload_offset, compressed_size, uncompressed_data.GetData(), uncompressed_data.Num()))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FPathCheckpointFile::Save >> Unable to compress the checkpoint!"));
+		return false;
+	}
+
+	file_data.SetNum(payload_offset + compressed_size, false);
+
+	// The header goes in last, it needs the size and checksum of the payload
+	header.mUncompressedSize = uncompressed_data.Num();
+	header.mCompressedSize = compressed_size;
+	header.mCrc = FCrc::MemCrc32(file_data.GetData() + payload_offset, compressed_size);
+
+	file_writer.Seek(0);
+	file_writer << header;
+
+	const FString temporary_file_path = inFilePath + TEXT(".tmp");
+	if (!FFileHelper::SaveArrayToFile(file_data, *temporary_file_path))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FPathCheckpointFile::Save >> Unable to write %s!"), *temporary_file_path);
+		return false;
+	}
+
+	return IFileManager::Get().Move(*inFilePath, *temporary_file_path, true);
+}
+
+
+
+bool FPathCheckpointFile::Load(const FString& inFilePath, FPathCheckpoint& outCheckpoint)
+{
+	TArray<uint8> file_data;
+	if (!FFileHelper::LoadFileToArray(file_data, *inFilePath, FILEREAD_Silent))
+		return false;
+
+	FMemoryReader file_reader(file_data);
+
+	FHeader header;
+	file_reader << header;
+
+	if (file_reader.IsError() || header.mMagic != FileMagic)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FPathCheckpointFile::Load >> %s is not a checkpoint!"), *inFilePath);
+		return false;
+	}
+
+	if (header.mVersion > LatestVersion)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FPathCheckpointFile::Load >> %s was written by a newer version (%d)!"), *inFilePath, header.mVersion);
+		return false;
+	}
+
+	const int32 payload_offset = file_reader.Tell();
+	if (header.mCompressedSize < 0 || header.mUncompressedSize < 0 || payload_offset + header.mCompressedSize > file_data.Num() ||
+		FCrc::MemCrc32(file_data.GetData() + payload_offset, header.mCompressedSize) != header.mCrc)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FPathCheckpointFile::Load >> %s is damaged!"), *inFilePath);
+		return false;
+	}
+
+	TArray<uint8> uncompressed_data;
+	uncompressed_data.SetNum(header.mUncompressedSize);
+
+	if (!FCompression::UncompressMemory(ECompressionFlags::COMPRESS_ZLIB, uncompressed_data.GetData(), header.mUncompressedSize, file_data.GetData() + payload_offset, header.mCompressedSize))
+		return false;
+
+	FMemoryReader reader(uncompressed_data);
+	SerializeCheckpoint(reader, outCheckpoint);
+
+	return !reader.IsError();
+}
+
+
+
+/**
+* Serializes the payload of a checkpoint in either direction
+*/
+void FPathCheckpointFile::SerializeCheckpoint(FArchive& ioArchive, FPathCheckpoint& ioCheckpoint)
+{
+	int32 property_amount = ioCheckpoint.mProperties.Num();
+	ioArchive << property_amount;
+
+	if (ioArchive.IsLoading())
+		ioCheckpoint.mProperties.SetNum(property_amount);
+
+	for (TPair<FString, FString>& property : ioCheckpoint.mProperties)
+	{
+		ioArchive << property.Key;
+		ioArchive << property.Value;
+	}
+
+	FPathGeneticAlgorithmState& state = ioCheckpoint.mAlgorithmState;
+	ioArchive << state.mInitialRandomSeed;
+	ioArchive << state.mCurrentRandomSeed;
+	ioArchive << state.mGenerationCount;
+	ioArchive << state.mPendingImmigrantAmount;
+	ioArchive << state.mTotalFitness;
+	FPathHistoryFile::SerializeGenerationInfo(ioArchive, state.mGenerationInfo);
+
+	// Genomes are stored at full precision, a resumed run has to match the original bit for bit
+	ioArchive << state.mGenomes;
+	ioArchive << state.mFitness;
+
+	ioArchive << ioCheckpoint.mTerminationMonitor;
+}
@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// API includes
+#include "GeneticTermination.h"
+#include "PathGeneticAlgorithm.h"
+
+/**
+* Everything needed to continue a run where it was left, taken in between two generations
+* The configuration is kept as the exported text of the properties of the path manager, so it survives changes to their layout
+*/
+struct FPathCheckpoint
+{
+	TArray<TPair<FString, FString>> mProperties;
+	FPathGeneticAlgorithmState mAlgorithmState;
+	FGeneticTerminationMonitor mTerminationMonitor;
+};
+
+
+
+/**
+* Reads and writes a run checkpoint, the .gacp file
+*
+* The file is a small header followed by a single zlib compressed payload, the header holds a checksum of the payload
+* A checkpoint is first written next to the destination and only moved over it once complete,
+* so a crash while saving leaves the previous checkpoint intact
+*/
+class GENETICTRIANGLES_API FPathCheckpointFile
+{
+public:
+	static const uint32 FileMagic = 0x50434147; // "GACP"
+	static const int32 LatestVersion = 1;
+
+	struct FHeader
+	{
+		uint32 mMagic = FileMagic;
+		int32 mVersion = LatestVersion;
+		int32 mUncompressedSize = 0;
+		int32 mCompressedSize = 0;
+		uint32 mCrc = 0; ///< Of the compressed payload
+
+		friend FArchive& operator<<(FArchive& ioArchive, FHeader& ioHeader);
+	};
+
+public:
+	static bool Save(const FPathCheckpoint& inCheckpoint, const FString& inFilePath);
+	static bool Load(const FString& inFilePath, FPathCheckpoint& outCheckpoint);
+
+	static void SerializeCheckpoint(FArchive& ioArchive, FPathCheckpoint& ioCheckpoint);
+};
@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneticTriangles.h"
+#include "PathCheckpointWriter.h"
+
+FPathCheckpointWriter::FPathCheckpointWriter(const FString& inFilePath)
+	:
+	mFilePath(inFilePath)
+{
+}
+
+
+
+FPathCheckpointWriter::~FPathCheckpointWriter()
+{
+	// The task points into the writer
+	Flush();
+}
+
+
+
+/**
+* Starts writing the checkpoint, returns false without taking it if the previous one is still being written
+*/
+bool FPathCheckpointWriter::Save(TUniquePtr<FPathCheckpoint>&& inCheckpoint)
+{
+	check(inCheckpoint.IsValid());
+
+	if (IsSaving())
+		return false;
+
+	mCheckpoint = MoveTemp(inCheckpoint);
+
+	const FPathCheckpoint* checkpoint = mCheckpoint.Get();
+	const FString file_path = mFilePath;
+	FThreadSafeCounter* saved_amount = &mSavedAmount;
+
+	mSaveEvent = FFunctionGraphTask::CreateAndDispatchWhenReady([checkpoint, file_path, saved_amount]()
+	{
+		if (FPathCheckpointFile::Save(*checkpoint, file_path))
+			saved_amount->Increment();
+		else
+			UE_LOG(LogTemp, Warning, TEXT("FPathCheckpointWriter::Save >> Unable to save the checkpoint of generation %d!"), checkpoint->mAlgorithmState.mGenerationCount);
+	}, TStatId(), nullptr, ENamedThreads::AnyThread);
+
+	return true;
+}
+
+
+
+/**
+* Waits for the checkpoint in flight, if any
+*/
+void FPathCheckpointWriter::Flush()
+{
+	if (IsSaving())
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(mSaveEvent);
+
+	mCheckpoint.Reset();
+}
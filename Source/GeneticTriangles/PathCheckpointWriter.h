@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// API includes
+#include "PathCheckpointFile.h"
+
+/**
+* When and where a run writes its checkpoints
+*/
+struct FPathCheckpointSettings
+{
+	FString mFilePath;
+	int32 mInterval = 0; ///< Generations between periodic checkpoints, zero only writes the requested ones
+	TArray<TPair<FString, FString>> mProperties; ///< The configuration of the run, identical for every checkpoint
+
+	bool ShouldSave(const int32 inGenerationCount) const { return mInterval > 0 && inGenerationCount > 0 && (inGenerationCount % mInterval) == 0; }
+};
+
+
+
+/**
+* Writes the checkpoints of a run in the background, the run only pays for copying its state
+*
+* Compressing and writing happen in a task, a single checkpoint is in flight at a time
+* While one is being written the run skips its next checkpoints instead of queueing them, as every checkpoint replaces the previous one
+*/
+class GENETICTRIANGLES_API FPathCheckpointWriter
+{
+public:
+	FPathCheckpointWriter(const FString& inFilePath);
+	~FPathCheckpointWriter();
+
+	bool IsSaving() const { return mSaveEvent.IsValid() && !mSaveEvent->IsComplete(); }
+	bool Save(TUniquePtr<FPathCheckpoint>&& inCheckpoint);
+	void Flush();
+
+	const FString& GetFilePath() const { return mFilePath; }
+	int32 GetSavedAmount() const { return mSavedAmount.GetValue(); }
+
+private:
+	FPathCheckpointWriter(const FPathCheckpointWriter&) = delete;
+	FPathCheckpointWriter& operator=(const FPathCheckpointWriter&) = delete;
+
+private:
+	FString mFilePath;
+	TUniquePtr<FPathCheckpoint> mCheckpoint; ///< The checkpoint being written, only touched by the task while it runs
+	FGraphEventRef mSaveEvent;
+	FThreadSafeCounter mSavedAmount;
+};
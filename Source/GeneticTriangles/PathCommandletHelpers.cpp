@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneticTriangles.h"
+#include "PathCommandletHelpers.h"
+
+#include "PathManager.h"
+
+/**
+* Loads the map and initializes its world far enough for scene queries, nothing is rendered or ticked
+* Scene queries only read from the physics scene, so runs on other threads may share the world
+*/
+UWorld* FPathCommandletHelpers::LoadWorld(const FString& inMapName)
+{
+	// Short names are looked up in the maps folder
+	const FString package_name = inMapName.Contains(TEXT("/")) ? inMapName : FString(TEXT("/Game/Maps/")) + inMapName;
+
+	UPackage* package = LoadPackage(nullptr, *package_name, LOAD_None);
+	if (package == nullptr)
+		return nullptr;
+
+	UWorld* world = UWorld::FindWorldInPackage(package);
+	if (world == nullptr)
+		return nullptr;
+
+	world->AddToRoot();
+	world->WorldType = EWorldType::Game;
+
+	world->InitWorld(UWorld::InitializationValues()
+		.AllowAudioPlayback(false)
+		.CreatePhysicsScene(true)
+		.ShouldSimulatePhysics(false)
+		.CreateNavigation(false)
+		.CreateAISystem(false)
+		.EnableTraceCollision(true));
+
+	// Registers the components, which creates the collision the traces run against
+	world->UpdateWorldComponents(true, false);
+
+	return world;
+}
+
+
+
+void FPathCommandletHelpers::ReleaseWorld(UWorld* inWorld)
+{
+	if (inWorld == nullptr)
+		return;
+
+	inWorld->DestroyWorld(false);
+	inWorld->RemoveFromRoot();
+}
+
+
+
+APathManager* FPathCommandletHelpers::FindPathManager(UWorld* inWorld)
+{
+	for (TActorIterator<APathManager> it(inWorld); it; ++it)
+		return *it;
+
+	return nullptr;
+}
+
+
+
+/**
+* Reads all entries of a section of an ini file in order, keys may occur more than once
+*/
+void FPathCommandletHelpers::ReadIniSection(const FString& inFilePath, const TCHAR* inSection, TArray<TPair<FString, FString>>& outEntries)
+{
+	FConfigFile config_file;
+	config_file.Read(inFilePath);
+
+	const FConfigSection* section = config_file.Find(inSection);
+	if (section == nullptr)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FPathCommandletHelpers::ReadIniSection >> %s has no [%s] section"), *inFilePath, inSection);
+		return;
+	}
+
+	for (FConfigSection::TConstIterator it(*section); it; ++it)
+		outEntries.Add(TPair<FString, FString>(it.Key().ToString(), it.Value().GetValue()));
+}
+
+
+
+/**
+* Sets a property of the path manager through reflection, returns false if there is no such property or the value does not parse
+*/
+bool FPathCommandletHelpers::ApplyOverride(APathManager* inPathManager, const FString& inPropertyName, const FString& inValue)
+{
+	UProperty* property = FindField<UProperty>(APathManager::StaticClass(), *inPropertyName);
+	if (property == nullptr)
+		return false;
+
+	return property->ImportText(*inValue, property->ContainerPtrToValuePtr<void>(inPathManager), PPF_None, inPathManager) != nullptr;
+}
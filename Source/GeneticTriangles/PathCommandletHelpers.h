@@ -0,0 +1,19 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Forward decl
+class APathManager;
+
+/**
+* Shared functionality of the path commandlets
+*/
+struct GENETICTRIANGLES_API FPathCommandletHelpers
+{
+	static UWorld* LoadWorld(const FString& inMapName);
+	static void ReleaseWorld(UWorld* inWorld);
+	static APathManager* FindPathManager(UWorld* inWorld);
+
+	static void ReadIniSection(const FString& inFilePath, const TCHAR* inSection, TArray<TPair<FString, FString>>& outEntries);
+	static bool ApplyOverride(APathManager* inPathManager, const FString& inPropertyName, const FString& inValue);
+};
@@ -0,0 +1,223 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneticTriangles.h"
+#include "PathExperimentCommandlet.h"
+
+#include "PathCommandletHelpers.h"
+#include "PathGeneticAlgorithm.h"
+#include "PathHistoryWriter.h"
+#include "PathManager.h"
+#include "PathStatisticsWriter.h"
+
+UPathExperimentCommandlet::UPathExperimentCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+
+
+int32 UPathExperimentCommandlet::Main(const FString& Params)
+{
+	TArray<FString> tokens;
+	TArray<FString> switches;
+	TMap<FString, FString> params;
+	ParseCommandLine(*Params, tokens, switches, params);
+
+	const FString* map_name = params.Find(TEXT("Map"));
+	if (map_name == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("UPathExperimentCommandlet::Main >> No map given, use -Map=<MapName>"));
+		return 1;
+	}
+
+	const FString* generations_param = params.Find(TEXT("Generations"));
+	const int32 generation_amount = generations_param != nullptr ? FCString::Atoi(**generations_param) : 1000;
+
+	const FString* output_param = params.Find(TEXT("Output"));
+	const FString output_directory = output_param != nullptr ? *output_param : FPaths::GameSavedDir() / TEXT("PathExperiments");
+
+	// Load the map and find the path manager to experiment with
+	UWorld* world = FPathCommandletHelpers::LoadWorld(*map_name);
+	if (world == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("UPathExperimentCommandlet::Main >> Unable to load map %s"), **map_name);
+		return 1;
+	}
+
+	APathManager* path_manager = FPathCommandletHelpers::FindPathManager(world);
+
+	if (path_manager == nullptr || !path_manager->AreNodesValid())
+	{
+		UE_LOG(LogTemp, Error, TEXT("UPathExperimentCommandlet::Main >> Map %s has no path manager with valid nodes"), **map_name);
+
+		FPathCommandletHelpers::ReleaseWorld(world);
+		return 1;
+	}
+
+	TMap<FString, FString> overrides;
+	GatherOverrides(params, overrides);
+	ApplyOverrides(path_manager, overrides);
+
+	// Nobody is watching, so nothing is drawn
+	FPathGeneticAlgorithmSettings settings = path_manager->GatherSettings();
+	settings.mDrawDebug = false;
+
+	FPathGeneticAlgorithm algorithm(world, settings);
+	FPathCapturedEvaluation captured_evaluation;
+	FGenerationSerializationData generation;
+
+	// The generations are streamed into the history file as they are stored
+	const FString map_short_name = FPackageName::GetShortName(*map_name);
+	const FString history_file_path = output_directory / map_short_name + TEXT(".ga");
+	const FString summary_file_path = output_directory / map_short_name + TEXT("_Summary.txt");
+
+	FPathHistoryWriter history_writer;
+	bool has_saved_history = history_writer.Open(history_file_path, settings.mPopulationCount, 1, path_manager->HistoryKeyframeInterval, path_manager->GatherHistoryQuantization(), path_manager->GatherHistoryCompression(), path_manager->RecordLineage);
+
+	// Statistics go next to the history file, with the columns the path manager asks for
+	FPathStatisticsWriter statistics_writer;
+	statistics_writer.Open(history_file_path, path_manager->GatherStatisticsSettings());
+
+	float best_fitness_factor = 0.0f;
+	int32 best_fitness_factor_generation = 0;
+
+	// The termination criteria of the path manager apply as well, -Generations only caps the run
+	FGeneticTerminationMonitor termination_monitor(path_manager->GatherTerminationCriteria());
+
+	const double start_time = FPlatformTime::Seconds();
+
+	for (int32 i = 0; i < generation_amount; ++i)
+	{
+		const double breeding_start_time = FPlatformTime::Seconds();
+		algorithm.RunGeneration();
+
+		FGenerationStageTimings timings;
+		timings.mBreeding = (FPlatformTime::Seconds() - breeding_start_time) * 1000.0;
+
+		const FGenerationInfo& generation_info = algorithm.GetGenerationInfo();
+		history_writer.AppendLineage(generation_info.mGenerationNumber, algorithm.GetLineage());
+
+		if (generation_info.mFitnessFactor > best_fitness_factor)
+		{
+			best_fitness_factor = generation_info.mFitnessFactor;
+			best_fitness_factor_generation = generation_info.mGenerationNumber;
+		}
+
+		const bool has_terminated = termination_monitor.Update(algorithm.GetGenerationCount(), generation_info.mBestFitness, generation_info.mFitnessFactor, generation_info.mDiversity) != ETerminationReason::None;
+
+		// Only every n-th generation is stored, same as in the editor
+		if (has_terminated || path_manager->VisualizationInterval <= 1 || (generation_info.mGenerationNumber % path_manager->VisualizationInterval) == 0)
+		{
+			double stage_start_time = FPlatformTime::Seconds();
+			algorithm.CaptureGeneration(generation, captured_evaluation);
+			timings.mCapture = (FPlatformTime::Seconds() - stage_start_time) * 1000.0;
+
+			stage_start_time = FPlatformTime::Seconds();
+			FPathGeneticAlgorithm::ColorCodeGeneration(generation, captured_evaluation, settings.mInvalidPathColor);
+			timings.mColorCoding = (FPlatformTime::Seconds() - stage_start_time) * 1000.0;
+
+			stage_start_time = FPlatformTime::Seconds();
+			has_saved_history &= history_writer.Append(generation, 0, false, &algorithm.GetLineage());
+			timings.mRecording = (FPlatformTime::Seconds() - stage_start_time) * 1000.0;
+		}
+
+		statistics_writer.Append(generation_info, timings);
+
+		if (has_terminated)
+			break;
+	}
+
+	const double wall_time = FPlatformTime::Seconds() - start_time;
+
+	history_writer.Close();
+	statistics_writer.Close();
+
+	const FGenerationInfo& final_info = algorithm.GetGenerationInfo();
+
+	FString summary;
+	summary += FString::Printf(TEXT("Map=%s\n"), **map_name);
+	summary += FString::Printf(TEXT("Generations=%d\n"), algorithm.GetGenerationCount());
+	summary += FString::Printf(TEXT("StoredGenerations=%d\n"), history_writer.GetChunkAmount());
+	summary += FString::Printf(TEXT("PopulationCount=%d\n"), settings.mPopulationCount);
+	summary += FString::Printf(TEXT("RandomSeed=%d\n"), algorithm.GetRandomSeed());
+	summary += FString::Printf(TEXT("WallTimeSeconds=%f\n"), wall_time);
+	summary += FString::Printf(TEXT("GenerationsPerSecond=%f\n"), wall_time > 0.0 ? algorithm.GetGenerationCount() / wall_time : 0.0);
+	summary += FString::Printf(TEXT("FinalAverageFitness=%f\n"), final_info.mAverageFitness);
+	summary += FString::Printf(TEXT("FinalFitnessFactor=%f\n"), final_info.mFitnessFactor);
+	summary += FString::Printf(TEXT("FinalAverageAmountOfNodes=%f\n"), final_info.mAverageAmountOfNodes);
+	summary += FString::Printf(TEXT("FinalDiversity=%f\n"), final_info.mDiversity);
+	summary += FString::Printf(TEXT("BestFitnessFactor=%f\n"), best_fitness_factor);
+	summary += FString::Printf(TEXT("BestFitnessFactorGeneration=%d\n"), best_fitness_factor_generation);
+	summary += FString::Printf(TEXT("TerminationReason=%s\n"), FGeneticTerminationMonitor::GetReasonName(termination_monitor.GetReason()));
+	summary += FString::Printf(TEXT("Termination=%s\n"), *termination_monitor.GetDescription());
+	summary += FString::Printf(TEXT("HistoryFile=%s\n"), has_saved_history ? *history_file_path : TEXT("None"));
+
+	if (path_manager->QuantizeHistory)
+	{
+		const FPathQuantizationStats& quantization_stats = history_writer.GetQuantizationStats();
+		summary += FString::Printf(TEXT("QuantizedChromosomes=%d\n"), quantization_stats.mQuantizedChromosomeAmount);
+		summary += FString::Printf(TEXT("MaxReconstructionError=%f\n"), quantization_stats.mMaxError);
+		summary += FString::Printf(TEXT("FullPrecisionGenomes=%d\n"), quantization_stats.mFullPrecisionGenomeAmount);
+	}
+
+	for (const TPair<FString, FString>& entry : overrides)
+		summary += FString::Printf(TEXT("Override.%s=%s\n"), *entry.Key, *entry.Value);
+
+	const bool has_saved_summary = FFileHelper::SaveStringToFile(summary, *summary_file_path);
+
+	UE_LOG(LogTemp, Display, TEXT("%s"), *summary);
+
+	FPathCommandletHelpers::ReleaseWorld(world);
+
+	return has_saved_history && has_saved_summary ? 0 : 1;
+}
+
+
+
+/**
+* Collects the property overrides, those of the [PathExperiment] section in the ini first, then those of the command line
+*/
+void UPathExperimentCommandlet::GatherOverrides(const TMap<FString, FString>& inParams, TMap<FString, FString>& outOverrides) const
+{
+	const FString* ini_path = inParams.Find(TEXT("Ini"));
+	if (ini_path != nullptr)
+	{
+		TArray<TPair<FString, FString>> entries;
+		FPathCommandletHelpers::ReadIniSection(*ini_path, TEXT("PathExperiment"), entries);
+
+		for (const TPair<FString, FString>& entry : entries)
+			outOverrides.Add(entry.Key, entry.Value);
+	}
+
+	// Parameters of the commandlet itself are never properties
+	static const TCHAR* reserved_params[] = { TEXT("Run"), TEXT("Map"), TEXT("Generations"), TEXT("Output"), TEXT("Ini") };
+
+	for (const TPair<FString, FString>& param : inParams)
+	{
+		bool is_reserved = false;
+		for (const TCHAR* reserved_param : reserved_params)
+			is_reserved |= param.Key == reserved_param;
+
+		if (!is_reserved)
+			outOverrides.Add(param.Key, param.Value);
+	}
+}
+
+
+
+/**
+* Applies the overrides through reflection, anything that does not name a property of the path manager is ignored
+*/
+void UPathExperimentCommandlet::ApplyOverrides(APathManager* inPathManager, const TMap<FString, FString>& inOverrides) const
+{
+	for (const TPair<FString, FString>& entry : inOverrides)
+	{
+		if (FindField<UProperty>(APathManager::StaticClass(), *entry.Key) == nullptr)
+			UE_LOG(LogTemp, Verbose, TEXT("UPathExperimentCommandlet::ApplyOverrides >> Ignoring %s, not a property of APathManager"), *entry.Key);
+		else if (!FPathCommandletHelpers::ApplyOverride(inPathManager, entry.Key, entry.Value))
+			UE_LOG(LogTemp, Warning, TEXT("UPathExperimentCommandlet::ApplyOverrides >> Unable to set %s to %s"), *entry.Key, *entry.Value);
+	}
+}
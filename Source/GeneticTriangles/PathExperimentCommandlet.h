@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Engine includes
+#include "Commandlets/Commandlet.h"
+
+#include "PathExperimentCommandlet.generated.h"
+
+// Forward decl
+class APathManager;
+
+/**
+* Runs a path experiment without rendering, for render-less servers
+*
+* Loads a map, applies property overrides to its path manager, runs a fixed amount of generations at full speed,
+* then writes the .ga history and a stats summary
+* The run ends early when it meets the termination criteria of the path manager
+*
+* Usage: UE4Editor-Cmd GeneticTriangles.uproject -run=PathExperiment -nullrhi -Map=Path_Slope -Generations=1000
+*		[-Output=<directory>] [-Ini=<file>] [-<PropertyName>=<Value> ...]
+*
+* Overrides are read from the [PathExperiment] section of the ini first, overrides on the command line take precedence
+*/
+UCLASS()
+class GENETICTRIANGLES_API UPathExperimentCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UPathExperimentCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	void GatherOverrides(const TMap<FString, FString>& inParams, TMap<FString, FString>& outOverrides) const;
+	void ApplyOverrides(APathManager* inPathManager, const TMap<FString, FString>& inOverrides) const;
+};
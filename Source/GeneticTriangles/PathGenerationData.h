@@ -0,0 +1,106 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+/**
+* Statistics of a single island of an island run
+*/
+struct FIslandGenerationInfo
+{
+	int32 mGenerationNumber = 0;
+	int32 mImmigrantAmount = 0;
+	float mAverageFitness = 0.0f;
+	float mFitnessFactor = 0.0f;
+	float mAverageAmountOfNodes = 0.0f;
+};
+
+
+
+/**
+* Time in milliseconds the algorithm spent in every phase of a single generation
+* A generation that is spread over multiple steps adds up the time of all of them
+*/
+struct FGenerationPhaseTimings
+{
+	float mEvaluateParents = 0.0f; ///< Including scoring the population
+	float mSelection = 0.0f;
+	float mCrossover = 0.0f;
+	float mMutation = 0.0f;
+	float mEvaluateOffspring = 0.0f; ///< Including scoring the population
+
+	float GetTotal() const { return mEvaluateParents + mSelection + mCrossover + mMutation + mEvaluateOffspring; }
+};
+
+
+
+/**
+* Statistics of a single generation, shown in the HUD and stored in the history file
+*/
+struct FGenerationInfo
+{
+	int32 mGenerationNumber = 0;
+	int32 mCrossoverAmount = 0;
+	int32 mAmountOfTranslationMutations = 0;
+	int32 mAmountOfInsertionMutations = 0;
+	int32 mAmountOfDeletionMutations = 0;
+	float mAverageFitness = 0.0f;
+	float mMaximumFitness = 0.0f;
+	float mFitnessFactor = 0.0f;
+	float mAverageAmountOfNodes = 0.0f;
+	float mBestFitness = 0.0f; ///< Fitness of the fittest path
+	float mFitnessVariance = 0.0f; ///< Only written to the statistics files, not to the history file
+	float mDiversity = 0.0f; ///< Root mean square distance of the path centroids to the centroid of the population
+	int32 mFrameCount = 1; ///< Amount of frames the generation was spread over, only ever more than one when frame slicing
+	int32 mImmigrantAmount = 0; ///< Amount of paths that migrated into the population right before this generation
+	FGenerationPhaseTimings mPhaseTimings; ///< Stored in the history file since version 8
+	TArray<FIslandGenerationInfo> mIslandInfo; ///< Only filled in for island runs, the other values then cover all islands
+};
+
+
+
+/**
+* Wall time in milliseconds spent in every stage of a single generation
+*/
+struct FGenerationStageTimings
+{
+	float mBreeding = 0.0f; ///< Evaluation, selection, crossover and mutation, the only stage on the critical path besides capturing
+	float mCapture = 0.0f;
+	float mColorCoding = 0.0f;
+	float mRecording = 0.0f;
+	float mPresentation = 0.0f; ///< Zero for generations which were skipped by the viewer
+};
+
+
+
+/**
+* Everything needed to draw a single path of a generation
+*/
+struct FPathSerializationData
+{
+	int32 mNodeAmount = 0;
+	TArray<FVector> mGeneticRepresentation;
+	FColor mColor = FColor::Black;
+	bool mFittest = false;
+};
+
+
+
+/**
+* A finished generation, used for the history file as well as for the snapshots handed to the game thread
+*/
+struct FGenerationSerializationData
+{
+	TArray<FPathSerializationData> mPathSerializationData;
+	FGenerationInfo mGenerationInfo;
+
+	SIZE_T GetAllocatedSize() const
+	{
+		SIZE_T allocated_size = mPathSerializationData.GetAllocatedSize() + mGenerationInfo.mIslandInfo.GetAllocatedSize();
+		for (const FPathSerializationData& path : mPathSerializationData)
+			allocated_size += path.mGeneticRepresentation.GetAllocatedSize();
+
+		return allocated_size;
+	}
+};
+
+using FGenerationHistory = TArray<FGenerationSerializationData>;
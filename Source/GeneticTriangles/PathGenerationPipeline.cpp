@@ -0,0 +1,167 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneticTriangles.h"
+#include "PathGenerationPipeline.h"
+
+#include "PathHistoryWriter.h"
+
+FPathGenerationPipeline::FPathGenerationPipeline(FPathHistoryWriter* inHistoryWriter)
+	:
+	mHistoryWriter(inHistoryWriter)
+{
+}
+
+
+
+FPathGenerationPipeline::~FPathGenerationPipeline()
+{
+	// The tasks point into the slots and the history writer
+	Flush();
+}
+
+
+
+/**
+* Captures the current generation of the algorithm and starts the tasks that color code and record it
+* Blocks only if every slot still has a generation in flight
+*/
+void FPathGenerationPipeline::Submit(const FPathGeneticAlgorithm& inAlgorithm, const float inBreedingTime)
+{
+	FSlot& slot = mSlots[mNextSlot];
+	mNextSlot = (mNextSlot + 1) % SlotCount;
+
+	if (slot.mRecordedEvent.IsValid() && !slot.mRecordedEvent->IsComplete())
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(slot.mRecordedEvent, ENamedThreads::GameThread);
+
+	RetireSlot(slot);
+
+	const double capture_start_time = FPlatformTime::Seconds();
+	inAlgorithm.CaptureGeneration(slot.mGeneration, slot.mEvaluation);
+	slot.mLineage = inAlgorithm.GetLineage();
+
+	slot.mTimings = FGenerationStageTimings();
+	slot.mTimings.mBreeding = inBreedingTime;
+	slot.mTimings.mCapture = (FPlatformTime::Seconds() - capture_start_time) * 1000.0;
+	slot.mSequence = mSubmittedCount++;
+	slot.mIsRetired = false;
+
+	FSlot* slot_pointer = &slot;
+	const FColor invalid_path_color = inAlgorithm.GetSettings().mInvalidPathColor;
+
+	slot.mColorCodedEvent = FFunctionGraphTask::CreateAndDispatchWhenReady([slot_pointer, invalid_path_color]()
+	{
+		const double start_time = FPlatformTime::Seconds();
+		FPathGeneticAlgorithm::ColorCodeGeneration(slot_pointer->mGeneration, slot_pointer->mEvaluation, invalid_path_color);
+		slot_pointer->mTimings.mColorCoding = (FPlatformTime::Seconds() - start_time) * 1000.0;
+	}, TStatId(), nullptr, ENamedThreads::AnyThread);
+
+	FGraphEventArray record_prerequisites;
+	record_prerequisites.Add(slot.mColorCodedEvent);
+	if (mLastRecordedEvent.IsValid())
+		record_prerequisites.Add(mLastRecordedEvent);
+
+	FPathHistoryWriter* history_writer = mHistoryWriter;
+
+	slot.mRecordedEvent = FFunctionGraphTask::CreateAndDispatchWhenReady([slot_pointer, history_writer]()
+	{
+		const double start_time = FPlatformTime::Seconds();
+		if (history_writer != nullptr)
+			history_writer->Append(slot_pointer->mGeneration, 0, false, &slot_pointer->mLineage);
+		slot_pointer->mTimings.mRecording = (FPlatformTime::Seconds() - start_time) * 1000.0;
+	}, TStatId(), &record_prerequisites, ENamedThreads::AnyThread);
+
+	mLastRecordedEvent = slot.mRecordedEvent;
+}
+
+
+
+/**
+* Presents the newest generation which has been color coded, generations that were overtaken in the mean time are never shown
+* Also retires the generations that have gone through every stage, which makes their timings available
+*/
+void FPathGenerationPipeline::Update(TFunctionRef<void(const FGenerationSerializationData&)> inPresent)
+{
+	FSlot* newest_slot = nullptr;
+
+	for (FSlot& slot : mSlots)
+	{
+		if (slot.mIsRetired || slot.mSequence <= mPresentedSequence || !slot.mColorCodedEvent->IsComplete())
+			continue;
+
+		if (newest_slot == nullptr || slot.mSequence > newest_slot->mSequence)
+			newest_slot = &slot;
+	}
+
+	if (newest_slot != nullptr)
+	{
+		// Presenting only reads the generation, so it may overlap with the recording task
+		const double start_time = FPlatformTime::Seconds();
+		inPresent(newest_slot->mGeneration);
+		newest_slot->mTimings.mPresentation = (FPlatformTime::Seconds() - start_time) * 1000.0;
+
+		mPresentedSequence = newest_slot->mSequence;
+	}
+
+	for (FSlot& slot : mSlots)
+	{
+		if (!slot.mIsRetired && slot.mRecordedEvent->IsComplete())
+			RetireSlot(slot);
+	}
+}
+
+
+
+/**
+* Waits for every generation in flight to be recorded
+*/
+void FPathGenerationPipeline::Flush()
+{
+	// Recording tasks are chained, so the last one finishes after all others
+	if (mLastRecordedEvent.IsValid() && !mLastRecordedEvent->IsComplete())
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(mLastRecordedEvent, ENamedThreads::GameThread);
+}
+
+
+
+/**
+* Waits until every generation in flight can be presented, without waiting for them to be recorded
+*/
+void FPathGenerationPipeline::WaitForColorCoding()
+{
+	for (FSlot& slot : mSlots)
+	{
+		if (!slot.mIsRetired && !slot.mColorCodedEvent->IsComplete())
+			FTaskGraphInterface::Get().WaitUntilTaskCompletes(slot.mColorCodedEvent, ENamedThreads::GameThread);
+	}
+}
+
+
+
+int32 FPathGenerationPipeline::GetPendingRecordAmount() const
+{
+	int32 pending_record_amount = 0;
+	for (const FSlot& slot : mSlots)
+	{
+		if (!slot.mIsRetired && !slot.mRecordedEvent->IsComplete())
+			++pending_record_amount;
+	}
+
+	return pending_record_amount;
+}
+
+
+
+void FPathGenerationPipeline::RetireSlot(FSlot& inSlot)
+{
+	if (inSlot.mIsRetired)
+		return;
+
+	inSlot.mIsRetired = true;
+
+	// Slots may retire out of order, only keep the timings of the most recent generation
+	if (inSlot.mSequence > mRetiredSequence)
+	{
+		mRetiredSequence = inSlot.mSequence;
+		mTimings = inSlot.mTimings;
+	}
+}
@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// API includes
+#include "PathGenerationData.h"
+#include "PathGeneticAlgorithm.h"
+
+// Forward decl
+class FPathHistoryWriter;
+
+/**
+* Takes everything that happens to a finished generation off the critical path of the game thread
+*
+* Only capturing the generation happens right away, as the algorithm changes the population as soon as the next generation starts
+* Color coding and recording into the history file then run as tasks on the task graph, while the next generation is already being bred
+* Recording depends on color coding, and on the recording of the previous generation so the chunks in the file stay in order
+* Presentation happens on the game thread through Update, which always shows the newest color coded generation
+*/
+class GENETICTRIANGLES_API FPathGenerationPipeline
+{
+public:
+	FPathGenerationPipeline(FPathHistoryWriter* inHistoryWriter);
+	~FPathGenerationPipeline();
+
+	void Submit(const FPathGeneticAlgorithm& inAlgorithm, const float inBreedingTime);
+	void Update(TFunctionRef<void(const FGenerationSerializationData&)> inPresent);
+	void Flush();
+	void WaitForColorCoding();
+
+	const FGenerationStageTimings& GetTimings() const { return mTimings; }
+	const FGraphEventRef& GetLastRecordedEvent() const { return mLastRecordedEvent; }
+	int32 GetPendingRecordAmount() const;
+
+private:
+	/**
+	* A generation in flight, slots are reused once all tasks of the generation have finished
+	*/
+	struct FSlot
+	{
+		FGenerationSerializationData mGeneration;
+		FPathCapturedEvaluation mEvaluation;
+		TArray<FPathLineageRecord> mLineage; ///< Parents of the paths of mGeneration, which the history deltas are encoded against
+		FGenerationStageTimings mTimings;
+
+		FGraphEventRef mColorCodedEvent;
+		FGraphEventRef mRecordedEvent;
+
+		int32 mSequence = INDEX_NONE;
+		bool mIsRetired = true;
+	};
+
+	void RetireSlot(FSlot& inSlot);
+
+private:
+	static const int32 SlotCount = 3;
+
+	FSlot mSlots[SlotCount];
+	int32 mNextSlot = 0;
+	int32 mSubmittedCount = 0;
+	int32 mPresentedSequence = INDEX_NONE;
+	int32 mRetiredSequence = INDEX_NONE;
+
+	FGraphEventRef mLastRecordedEvent;
+	FPathHistoryWriter* mHistoryWriter = nullptr; ///< Only written to by the recording tasks, nothing is recorded without one
+	FGenerationStageTimings mTimings; ///< Timings of the most recent generation which has gone through every stage
+};
@@ -0,0 +1,986 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneticTriangles.h"
+#include "PathGeneticAlgorithm.h"
+
+FPathGeneticAlgorithm::FPathGeneticAlgorithm(const UWorld* inWorld, const FPathGeneticAlgorithmSettings& inSettings)
+	:
+	mWorld(inWorld),
+	mSettings(inSettings)
+{
+	// A seed of zero means the run is not meant to be reproducible
+	mInitialRandomSeed = mSettings.mRandomSeed != 0 ? mSettings.mRandomSeed : FMath::Rand();
+	mRandomStream.Initialize(mInitialRandomSeed);
+}
+
+
+
+void FPathGeneticAlgorithm::InitializeRun()
+{
+	// Create population
+	mPopulation.Reset(mSettings.mPopulationCount);
+	mPopulation.SetNum(mSettings.mPopulationCount);
+
+	for (FPathIndividual& path : mPopulation)
+	{
+		const int32 amount_of_nodes = mRandomStream.RandRange(mSettings.mMinAmountOfPointsPerPathAtStartup, mSettings.mMaxAmountOfPointsPerPathAtStartup);
+
+		path.ResetEvaluation();
+		path.RandomizeValues(mRandomStream, mSettings.mStartLocation, amount_of_nodes, mSettings.mMaxInitialVariation);
+		path.DetermineGeneticRepresentation();
+		path.mLineageIndex = INDEX_NONE;
+	}
+
+	mGenerationInfo = FGenerationInfo();
+	mGenerationCount = 0;
+	mTotalFitness = 0.0f;
+
+	mPhase = EPathGenerationPhase::EvaluateParents;
+	mPhaseCursor = 0;
+	mStepsThisGeneration = 0;
+}
+
+
+
+void FPathGeneticAlgorithm::RunGeneration()
+{
+	// Without a bound every phase finishes in a single step
+	while (!StepGeneration(MAX_int32))
+	{
+	}
+}
+
+
+
+/**
+* Advances the current generation, every phase processes at most inMaxPathsPerPhase paths during this step
+* Phases that are finished hand over to the next phase within the same step, the step ends as soon as a phase runs out of budget
+* The random stream is drawn from in the same order regardless of the bound, so a sliced run matches an unsliced run with the same seed
+* Returns true once the generation has finished
+*/
+bool FPathGeneticAlgorithm::StepGeneration(const int32 inMaxPathsPerPhase)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GeneticTriangles_StepGeneration);
+
+	if (!IsInitialized())
+		InitializeRun();
+
+	const int32 max_paths_per_phase = FMath::Max(inMaxPathsPerPhase, 1);
+
+	++mStepsThisGeneration;
+
+	while (true)
+	{
+		const int32 phase_size = GetPhaseSize(mPhase);
+
+		if (mPhaseCursor == 0)
+			BeginPhase(mPhase);
+
+		// Crossover works on pairs, so it always gets to process an even amount of paths
+		int32 budget = max_paths_per_phase;
+		if (mPhase == EPathGenerationPhase::Crossover)
+			budget = FMath::Max(budget + (budget & 1), 2);
+
+		const int32 begin = mPhaseCursor;
+		const int32 end = begin + FMath::Min(budget, phase_size - begin);
+
+		const uint32 start_cycles = FPlatformTime::Cycles();
+		RunPhase(mPhase, begin, end);
+		AddPhaseTime(mPhase, FPlatformTime::Cycles() - start_cycles);
+
+		mPhaseCursor = end;
+
+		if (mPhaseCursor < phase_size)
+			return false;
+
+		FinishPhase(mPhase);
+		mPhaseCursor = 0;
+
+		if (mPhase == EPathGenerationPhase::ScoreOffspring)
+		{
+			FinishLineage();
+
+			mGenerationInfo.mGenerationNumber = mGenerationCount++;
+			mGenerationInfo.mFrameCount = mStepsThisGeneration;
+			mGenerationInfo.mImmigrantAmount = mPendingImmigrantAmount;
+			mPendingImmigrantAmount = 0;
+
+			mPhase = EPathGenerationPhase::EvaluateParents;
+			mStepsThisGeneration = 0;
+
+			return true;
+		}
+
+		mPhase = (EPathGenerationPhase)((uint8)mPhase + 1);
+	}
+}
+
+
+
+int32 FPathGeneticAlgorithm::GetPhaseSize(const EPathGenerationPhase inPhase) const
+{
+	switch (inPhase)
+	{
+	case EPathGenerationPhase::EvaluateParents:
+	case EPathGenerationPhase::EvaluateOffspring:
+	case EPathGenerationPhase::Mutation:
+		return mPopulation.Num();
+	case EPathGenerationPhase::Selection:
+		return mSettings.mPopulationCount;
+	case EPathGenerationPhase::Crossover:
+		return mMatingIndices.Num();
+	case EPathGenerationPhase::ScoreParents:
+	case EPathGenerationPhase::ScoreOffspring:
+	default:
+		return 1;
+	}
+}
+
+
+
+void FPathGeneticAlgorithm::BeginPhase(const EPathGenerationPhase inPhase)
+{
+	switch (inPhase)
+	{
+	case EPathGenerationPhase::EvaluateParents:
+		mGenerationInfo.mPhaseTimings = FGenerationPhaseTimings();
+		mEvaluationBounds = FEvaluationBounds();
+		mTraceAmount = 0;
+		break;
+	case EPathGenerationPhase::EvaluateOffspring:
+		mEvaluationBounds = FEvaluationBounds();
+		break;
+	case EPathGenerationPhase::Selection:
+		mMatingIndices.Reset(mSettings.mPopulationCount);
+		break;
+	case EPathGenerationPhase::Crossover:
+		mOffspring.SetNum(mMatingIndices.Num(), false);
+		mBreedingLineage.SetNum(mMatingIndices.Num(), false);
+		mGenerationInfo.mCrossoverAmount = 0;
+		break;
+	case EPathGenerationPhase::Mutation:
+		mGenerationInfo.mAmountOfTranslationMutations = 0;
+		mGenerationInfo.mAmountOfInsertionMutations = 0;
+		mGenerationInfo.mAmountOfDeletionMutations = 0;
+		break;
+	default:
+		break;
+	}
+}
+
+
+
+void FPathGeneticAlgorithm::RunPhase(const EPathGenerationPhase inPhase, const int32 inBegin, const int32 inEnd)
+{
+	// Scoring counts towards the evaluation it finishes
+	const bool is_evaluating_parents = inPhase == EPathGenerationPhase::EvaluateParents || inPhase == EPathGenerationPhase::ScoreParents;
+	const bool is_evaluating_offspring = inPhase == EPathGenerationPhase::EvaluateOffspring || inPhase == EPathGenerationPhase::ScoreOffspring;
+	FScopeCycleCounter evaluation_cycle_counter(is_evaluating_parents ? GET_STATID(STAT_GeneticTriangles_EvaluateParents) : is_evaluating_offspring ? GET_STATID(STAT_GeneticTriangles_EvaluateOffspring) : TStatId());
+
+	switch (inPhase)
+	{
+	case EPathGenerationPhase::EvaluateParents:
+	case EPathGenerationPhase::EvaluateOffspring:
+		EvaluatePaths(inBegin, inEnd);
+		break;
+	case EPathGenerationPhase::ScoreParents:
+	case EPathGenerationPhase::ScoreOffspring:
+		ScorePopulation();
+		break;
+	case EPathGenerationPhase::Selection:
+		SelectionStep(inEnd);
+		break;
+	case EPathGenerationPhase::Crossover:
+		CrossoverStep(inBegin, inEnd);
+		break;
+	case EPathGenerationPhase::Mutation:
+		MutationStep(inBegin, inEnd);
+		break;
+	default:
+		break;
+	}
+}
+
+
+
+void FPathGeneticAlgorithm::FinishPhase(const EPathGenerationPhase inPhase)
+{
+	// Keep track of the new paths, the old ones will be overwritten by the next crossover
+	if (inPhase == EPathGenerationPhase::Crossover)
+		Swap(mPopulation, mOffspring);
+}
+
+
+
+void FPathGeneticAlgorithm::AddPhaseTime(const EPathGenerationPhase inPhase, const uint32 inCycles)
+{
+	FGenerationPhaseTimings& timings = mGenerationInfo.mPhaseTimings;
+	const float milliseconds = (float)FPlatformTime::ToMilliseconds(inCycles);
+
+	switch (inPhase)
+	{
+	case EPathGenerationPhase::EvaluateParents:
+	case EPathGenerationPhase::ScoreParents:
+		timings.mEvaluateParents += milliseconds;
+		break;
+	case EPathGenerationPhase::Selection:
+		timings.mSelection += milliseconds;
+		break;
+	case EPathGenerationPhase::Crossover:
+		timings.mCrossover += milliseconds;
+		break;
+	case EPathGenerationPhase::Mutation:
+		timings.mMutation += milliseconds;
+		break;
+	case EPathGenerationPhase::EvaluateOffspring:
+	case EPathGenerationPhase::ScoreOffspring:
+		timings.mEvaluateOffspring += milliseconds;
+		break;
+	default:
+		break;
+	}
+}
+
+
+
+/**
+* Snaps the paths in [inBegin, inEnd) to the terrain and gathers everything the fitness calculation needs from the world
+* The population wide extremes are accumulated in mEvaluationBounds, the fitness itself is assigned by ScorePopulation
+*/
+void FPathGeneticAlgorithm::EvaluatePaths(const int32 inBegin, const int32 inEnd)
+{
+	// What defines fitness for a path?
+	// 1. SHORTEST / CLOSEST
+	// -> Amount of chunks per path (less chunks == more fitness)
+	// -> Length of a path (shorter l => higher f)
+	// -> Distance of the final node in relation to the targeted node
+	// -> Average orientation of the path
+
+	// Fitness is calculated as an agreation of multiple fitness values
+
+	// /////////////////////////
+	// 1. DATA AND STATE CACHING
+	// /////////////////////////
+	FEvaluationBounds& bounds = mEvaluationBounds;
+	const FVector targetting_location = mSettings.mTargetLocation;
+
+	// Force paths to snap to terrain if possible, then run a single geometry pass over the final chromosomes of the slice
+	// This yields the path lengths as well as the slope and max length flags
+	mGeometryBatch.Reset(inEnd - inBegin, (inEnd - inBegin) * mSettings.mMaxAmountOfPointsPerPathAtStartup);
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_GeneticTriangles_SnapToTerrain);
+
+		for (int32 i = inBegin; i < inEnd; ++i)
+		{
+			FPathIndividual& path = mPopulation[i];
+
+			path.ResetEvaluation();
+			mTraceAmount += path.SnapToTerrain(mWorld);
+			mGeometryBatch.AddGenome(path.mGeneticRepresentation);
+		}
+	}
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_GeneticTriangles_PathGeometry);
+		mGeometryBatch.Evaluate(FPathGeometryConstraints(mSettings.mUseMaxLengthFitness, mSettings.mMaxEuclidianDistance, mSettings.mUseSlopeFitnessEvaluation, mSettings.mMaxSlopeToleranceAngle));
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_GeneticTriangles_WorldTraces);
+
+	// Traces are counted locally and added to the stats once the slice is done, rather than one stat update per trace
+	int32 obstacle_trace_amount = 0;
+	int32 terrain_hidden_trace_amount = 0;
+	int32 target_trace_amount = 0;
+
+	for (int32 i = inBegin; i < inEnd; ++i)
+	{
+		FPathIndividual& path = mPopulation[i];
+
+		path.ApplyGeometry(mGeometryBatch.GetResult(i - inBegin));
+
+		// Node amount calculation
+		const int32 node_amount = path.GetAmountOfNodes();
+
+		if (node_amount < bounds.mLeastAmountOfNodes)
+			bounds.mLeastAmountOfNodes = node_amount;
+
+		if (node_amount > bounds.mMostAmountOfNodes)
+			bounds.mMostAmountOfNodes = node_amount;
+
+		// Distance calculations
+		const float distance_to_targetting_node = (targetting_location - path.GetLocationOfFinalNode()).Size();
+
+		if (distance_to_targetting_node < bounds.mClosestDistance)
+			bounds.mClosestDistance = distance_to_targetting_node;
+
+		if (distance_to_targetting_node > bounds.mFurthestDistance)
+			bounds.mFurthestDistance = distance_to_targetting_node;
+
+		// Length calculation
+		const float path_length = path.mLength;
+
+		if (path_length < bounds.mShortestPathLength)
+			bounds.mShortestPathLength = path_length;
+
+		if (path_length > bounds.mLongestPathLength)
+			bounds.mLongestPathLength = path_length;
+
+		// Diversity calculation
+		FVector centroid = FVector::ZeroVector;
+		for (const FVector& chromosome : path.mGeneticRepresentation)
+			centroid += chromosome;
+
+		if (path.mGeneticRepresentation.Num() > 0)
+			bounds.mDiversity.Add(centroid / path.mGeneticRepresentation.Num());
+
+		// Trace handling
+		const TArray<FVector>& genetic_representation = path.mGeneticRepresentation;
+		for (int32 index = 1; index < genetic_representation.Num(); ++index)
+		{
+			const bool is_world_valid = mWorld != nullptr;
+
+			if (is_world_valid)
+			{
+				// Check for obstacles between previous and current node
+				// If a hit result is detected, either one of the nodes is in an obstacle or an obstacle is blocking the way
+				++obstacle_trace_amount;
+				FHitResult obstacle_hit_result;
+				if (mWorld->LineTraceSingleByChannel(obstacle_hit_result, genetic_representation[index - 1], genetic_representation[index], ECollisionChannel::ECC_GameTraceChannel1))
+					path.mIsInObstacle = true;
+
+				// Check for terrain traveling (hidden)
+				++terrain_hidden_trace_amount;
+				FHitResult terrain_hit_result;
+				if (mWorld->LineTraceSingleByChannel(terrain_hit_result, genetic_representation[index - 1], genetic_representation[index], ECollisionChannel::ECC_GameTraceChannel4))
+					path.mTravelingThroughTerrain = true;
+			}
+
+			// Check if the head is able to see the target
+			// This is the case if no obstacles are in the way
+			if (is_world_valid && index == genetic_representation.Num() - 1)
+			{
+				++target_trace_amount;
+				FHitResult hit_result;
+				if (!mWorld->LineTraceSingleByChannel(hit_result, genetic_representation[index], targetting_location, ECollisionChannel::ECC_GameTraceChannel2))
+					path.mCanSeeTarget = true;
+			}
+
+			// Check if the path has reached the target
+			if ((targetting_location - genetic_representation.Last()).Size() < 100.0f) // @TODO: Magic value, need radius of target node
+				path.mHasReachedTarget = true;
+
+			// Obstacle avoidance
+			if (mSettings.mApplyObstacleAvoidanceLogic && is_world_valid)
+			{
+				TArray<FVector> trace_ends;
+
+				if (mSettings.mTraceBehaviour == EObstacleTraceBehaviour::WindDirectionTracing)
+				{
+					trace_ends.Reserve(8);
+
+					trace_ends.Add(FVector(1.0f, 0.0f, 0.0f) * mSettings.mTraceDistance); // East
+					trace_ends.Add(FVector(1.0f, -1.0f, 0.0f) * mSettings.mTraceDistance); // South-East
+					trace_ends.Add(FVector(0.0f, -1.0f, 0.0f) * mSettings.mTraceDistance); // South
+					trace_ends.Add(FVector(-1.0f, -1.0f, 0.0f) * mSettings.mTraceDistance); // South-West
+					trace_ends.Add(FVector(-1.0f, 0.0f, 0.0f) * mSettings.mTraceDistance); // West
+					trace_ends.Add(FVector(-1.0f, 1.0f, 0.0f) * mSettings.mTraceDistance); // North-West
+					trace_ends.Add(FVector(0.0f, 1.0f, 0.0f) * mSettings.mTraceDistance); // North
+					trace_ends.Add(FVector(1.0f, 1.0f, 0.0f) * mSettings.mTraceDistance); // North-East
+				}
+				else
+				{
+					trace_ends.Reserve(mSettings.mAmountOfCyclicPoints);
+
+					float degree = 0.0f;
+
+					for (int32 n = 0; n < mSettings.mAmountOfCyclicPoints; ++n)
+					{
+						trace_ends.Add(FVector(FMath::Sin(FMath::DegreesToRadians(degree)), FMath::Cos(FMath::DegreesToRadians(degree)), 0.0f) * mSettings.mTraceDistance);
+						degree += 360 / (float)(mSettings.mAmountOfCyclicPoints);
+					}
+				}
+
+				// Debug drawing is only allowed on the game thread
+				const bool can_draw_debug = mSettings.mDrawDebug && IsInGameThread();
+
+				obstacle_trace_amount += trace_ends.Num();
+
+				FVector start = genetic_representation[index];
+				for (const FVector& end : trace_ends)
+				{
+					FHitResult hit_result;
+					if (mWorld->LineTraceSingleByChannel(hit_result, start, start + end, ECollisionChannel::ECC_GameTraceChannel1))
+						path.mObstacleHitMultiplierChunk += 0.125f;
+
+					if (can_draw_debug)
+						DrawDebugPoint(mWorld, start + end, 10, FColor::Cyan);
+				}
+			}
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_GeneticTriangles_ObstacleTraces, obstacle_trace_amount);
+	INC_DWORD_STAT_BY(STAT_GeneticTriangles_TerrainHiddenTraces, terrain_hidden_trace_amount);
+	INC_DWORD_STAT_BY(STAT_GeneticTriangles_TargetTraces, target_trace_amount);
+	mTraceAmount += obstacle_trace_amount + terrain_hidden_trace_amount + target_trace_amount;
+}
+
+
+
+/**
+* Assigns the fitness of every path once the whole population has been evaluated, then sorts the population by fitness
+* Only plain arithmetic happens here, so it is never spread over multiple steps
+*/
+void FPathGeneticAlgorithm::ScorePopulation()
+{
+	SCOPE_CYCLE_COUNTER(STAT_GeneticTriangles_ScorePopulation);
+
+	const int32 least_amount_of_nodes = mEvaluationBounds.mLeastAmountOfNodes;
+	const int32 most_amount_of_nodes = mEvaluationBounds.mMostAmountOfNodes;
+	const float closest_distance = mEvaluationBounds.mClosestDistance;
+	const float furthest_distance = mEvaluationBounds.mFurthestDistance;
+	const float shortest_path_length = mEvaluationBounds.mShortestPathLength;
+	const float longest_path_length = mEvaluationBounds.mLongestPathLength;
+	const FVector targetting_location = mSettings.mTargetLocation;
+
+	// ///////////////////////////////
+	// 2. CALCULATE AND ASSIGN FITNESS
+	// ///////////////////////////////
+	mTotalFitness = 0.0f;
+	int32 amount_of_nodes = 0;
+	int32 offenders = 0;
+	float highest_fitness = 0.0f;
+	for (FPathIndividual& path : mPopulation)
+	{
+		// Need zero handling
+		float node_amount_blend_value = 0.0f;
+		if (least_amount_of_nodes - most_amount_of_nodes != 0)
+		{
+			node_amount_blend_value = (path.GetAmountOfNodes() - most_amount_of_nodes) / (least_amount_of_nodes - most_amount_of_nodes);
+		}
+
+		float proximity_blend_value = 0.0f;
+		if (FMath::Abs(closest_distance - furthest_distance) > 0.1f)
+		{
+			proximity_blend_value = ((targetting_location - path.GetLocationOfFinalNode()).Size() - furthest_distance) / (closest_distance - furthest_distance);
+		}
+
+		float length_blend_value = 0.0f;
+		if (FMath::Abs(shortest_path_length - longest_path_length) > 0.1f)
+		{
+			length_blend_value = (path.mLength - longest_path_length) / (shortest_path_length - longest_path_length);
+		}
+
+		// Determine if the path is able to see the target node
+		float can_see_target_fitness = 0.0f;
+		if (path.mCanSeeTarget)
+			can_see_target_fitness = mSettings.mCanSeeTargetWeight;
+
+		// Path has reached target, mark fit
+		float target_reached_fitness = 0.0f;
+		if (path.mHasReachedTarget)
+			target_reached_fitness = mSettings.mTargetReachedWeight;
+
+		// Should the path hit an obstacle, mark it unfit
+		float obstacle_multiplier = 1.0f;
+		if (path.mIsInObstacle)
+			obstacle_multiplier = mSettings.mObstacleHitMultiplier;
+
+		// Slope too intense for the path to continue on, mark unfit
+		float slope_too_intense_multiplier = 1.0f;
+		if (mSettings.mUseSlopeFitnessEvaluation && path.mSlopeTooIntense)
+			slope_too_intense_multiplier = mSettings.mSlopeTooIntenseMultiplier;
+
+		// Path traveling through terrain?
+		float traveling_through_terrain_multiplier = 1.0f;
+		if (mSettings.mUseSlopeFitnessEvaluation && path.mTravelingThroughTerrain)
+			traveling_through_terrain_multiplier = mSettings.mPiercesTerrainMultiplier;
+
+		// Obstacle avoidance?
+		// @TODO
+		float obstacle_avoidance_multiplier = 1.0f;
+		float obstacle_avoidance_weight = 0.0f;
+		if (mSettings.mApplyObstacleAvoidanceLogic)
+		{
+			if (path.mObstacleHitMultiplierChunk > 0.0f)
+			{
+				obstacle_avoidance_multiplier = 0.0f;
+				obstacle_avoidance_weight = 0.0f;
+				++offenders;
+			}
+			else
+			{
+				obstacle_avoidance_weight = 100.0f;
+			}
+		}
+
+		// Distance between points too large?
+		float max_length_multiplier = 1.0f;
+		if (mSettings.mUseMaxLengthFitness)
+		{
+			if (path.mDistanceBetweenChromosomesTooLarge)
+				max_length_multiplier = mSettings.mEuclidianOvershootMultiplier;
+		}
+
+		// Calculate final fitness based on the various weights and multipliers
+		const float weight_fitness = ((mSettings.mAmountOfNodesWeight * node_amount_blend_value) +
+										(mSettings.mProximityToTargetedNodeWeight * proximity_blend_value) +
+										(mSettings.mLengthWeight * length_blend_value) +
+										can_see_target_fitness +
+										target_reached_fitness +
+										mSettings.mSlopeWeight +
+										obstacle_avoidance_weight);
+		const float weight_multiplier = obstacle_multiplier * slope_too_intense_multiplier * traveling_through_terrain_multiplier * max_length_multiplier * obstacle_avoidance_multiplier;
+		const float final_fitness = weight_fitness * weight_multiplier;
+
+		path.mFitness = final_fitness;
+		path.mAmountOfNodesFitness = mSettings.mAmountOfNodesWeight * node_amount_blend_value;
+
+		// Caching
+		if (final_fitness > highest_fitness)
+			highest_fitness = final_fitness;
+
+		mTotalFitness += final_fitness;
+		amount_of_nodes += path.GetAmountOfNodes();
+	}
+
+	for (FPathIndividual& path : mPopulation)
+	{
+		if (path.mFitness == highest_fitness)
+			path.mFittestSolution = true;
+	}
+
+	const float average_fitness = mTotalFitness / mPopulation.Num();
+
+	float squared_deviation = 0.0f;
+	for (const FPathIndividual& path : mPopulation)
+		squared_deviation += FMath::Square(path.mFitness - average_fitness);
+
+	mGenerationInfo.mAverageFitness = average_fitness;
+	mGenerationInfo.mFitnessVariance = squared_deviation / mPopulation.Num();
+	mGenerationInfo.mAverageAmountOfNodes = amount_of_nodes / (float)mPopulation.Num();
+	mGenerationInfo.mBestFitness = highest_fitness;
+	mGenerationInfo.mDiversity = mEvaluationBounds.mDiversity.Get();
+
+	const float max_fitness = mSettings.mAmountOfNodesWeight + mSettings.mProximityToTargetedNodeWeight + mSettings.mLengthWeight + mSettings.mCanSeeTargetWeight + mSettings.mTargetReachedWeight + mSettings.mSlopeWeight;
+	mGenerationInfo.mMaximumFitness = max_fitness;
+	mGenerationInfo.mFitnessFactor = average_fitness / max_fitness;
+
+	// ////////////////////////////////////
+	// 3. SORT PATHS BY FITNESS, DESCENDING
+	// ////////////////////////////////////
+	mPopulation.Sort([](const FPathIndividual& lhs, const FPathIndividual& rhs)
+	{
+		return lhs.mFitness > rhs.mFitness;
+	});
+}
+
+
+
+/**
+* Selects mates until inEnd mates have been selected this generation
+*/
+void FPathGeneticAlgorithm::SelectionStep(const int32 inEnd)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GeneticTriangles_Selection);
+
+	// Still roulette wheel sampling, the kernel is shared with Tools/GaBench, see PathKernels.h
+	PathKernels::SelectMates(mRandomStream, mPopulation.Num(), mTotalFitness, mMatingIndices.Num(), inEnd,
+		[this](const int32 inIndex) { return mPopulation[inIndex].mFitness; },
+		[this](const int32 inIndex) { mMatingIndices.Add(inIndex); });
+}
+
+
+
+/**
+* Breeds the mates in [inBegin, inEnd) into mOffspring, inBegin is always even
+* The offspring replaces the population once the whole phase has finished, see FinishPhase
+*/
+void FPathGeneticAlgorithm::CrossoverStep(const int32 inBegin, const int32 inEnd)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GeneticTriangles_Crossover);
+
+	int32 successfull_crossover_amount = 0;
+
+	// Loop over the paths and try to apply crossover
+	for (int32 i = inBegin; i < inEnd; i += 2)
+	{
+		// An uneven population leaves the final path without a partner, it is carried over as is
+		if (!mMatingIndices.IsValidIndex(i + 1))
+		{
+			DuplicateIndividual(mPopulation[mMatingIndices[i]], mOffspring[i]);
+
+			mBreedingLineage[i] = FPathLineageRecord();
+			mBreedingLineage[i].mParentIndices[0] = mPopulation[mMatingIndices[i]].mLineageIndex;
+			mOffspring[i].mLineageIndex = i;
+			continue;
+		}
+
+		FPathLineageRecord& lineage_0 = mBreedingLineage[i];
+		FPathLineageRecord& lineage_1 = mBreedingLineage[i + 1];
+		lineage_0 = FPathLineageRecord();
+		lineage_1 = FPathLineageRecord();
+
+		mOffspring[i].mLineageIndex = i;
+		mOffspring[i + 1].mLineageIndex = i + 1;
+
+		const float R = mRandomStream.FRandRange(0.0f, 100.0f);
+
+		// Crossover for a pair happens if crossover probability is met
+		if (R >= (100.0f - mSettings.mCrossoverProbability))
+		{
+			const FPathIndividual* current_path = &mPopulation[mMatingIndices[i]];
+			const FPathIndividual* next_path = &mPopulation[mMatingIndices[i + 1]];
+			const FPathIndividual* smallest_path = nullptr;
+			const FPathIndividual* bigger_path = nullptr;
+
+			if (current_path->GetAmountOfNodes() < next_path->GetAmountOfNodes())
+			{
+				smallest_path = current_path;
+				bigger_path = next_path;
+			}
+			else
+			{
+				smallest_path = next_path;
+				bigger_path = current_path;
+			}
+
+			const int32 num_chromosomes_small = smallest_path->GetAmountOfNodes();
+			const int32 num_chromosomes_big = bigger_path->GetAmountOfNodes();
+
+			// Append the rest of the chromosomes to the children when
+			// The bigger path is more fit than the smaller one
+			// Only interesting if we remove part of the fitness calculation
+			const bool append_tail_of_bigger_path = (smallest_path->mFitness - smallest_path->mAmountOfNodesFitness) < (bigger_path->mFitness - bigger_path->mAmountOfNodesFitness);
+
+			FPathIndividual& offspring_0 = mOffspring[i];
+			FPathIndividual& offspring_1 = mOffspring[i + 1];
+
+			offspring_0.ResetEvaluation();
+			offspring_0.mGeneticRepresentation.Reset(num_chromosomes_big);
+			offspring_1.ResetEvaluation();
+			offspring_1.mGeneticRepresentation.Reset(num_chromosomes_big);
+
+			TArray<FVector>& genes_0 = offspring_0.mGeneticRepresentation;
+			TArray<FVector>& genes_1 = offspring_1.mGeneticRepresentation;
+
+			// The first offspring starts out as the smallest path, the second one as the bigger path
+			lineage_0.mParentIndices[0] = smallest_path->mLineageIndex;
+			lineage_0.mParentIndices[1] = bigger_path->mLineageIndex;
+			lineage_1.mParentIndices[0] = bigger_path->mLineageIndex;
+			lineage_1.mParentIndices[1] = smallest_path->mLineageIndex;
+			lineage_0.mCrossoverOperator = (uint8)mSettings.mCrossoverOperator;
+			lineage_1.mCrossoverOperator = (uint8)mSettings.mCrossoverOperator;
+
+			// Do crossover operation depending on selected operator, the kernel is shared with Tools/GaBench, see PathKernels.h
+			int32 crossover_points[2];
+			PathKernels::CrossoverGenes(mRandomStream, (PathKernels::ECrossoverOperator)mSettings.mCrossoverOperator,
+				smallest_path->mGeneticRepresentation.GetData(), num_chromosomes_small, bigger_path->mGeneticRepresentation.GetData(), num_chromosomes_big,
+				append_tail_of_bigger_path, crossover_points, [&genes_0, &genes_1](const FVector& inChromosome0, const FVector& inChromosome1)
+			{
+				genes_0.Add(inChromosome0);
+				genes_1.Add(inChromosome1);
+			});
+
+			lineage_0.mCrossoverPoints[0] = lineage_1.mCrossoverPoints[0] = (int16)crossover_points[0];
+			lineage_0.mCrossoverPoints[1] = lineage_1.mCrossoverPoints[1] = (int16)crossover_points[1];
+
+			offspring_0.DetermineGeneticRepresentation();
+			offspring_1.DetermineGeneticRepresentation();
+
+			++successfull_crossover_amount;
+		}
+		else // otherwise they are carried / copied over to the next generation
+		{
+			DuplicateIndividual(mPopulation[mMatingIndices[i]], mOffspring[i]);
+			DuplicateIndividual(mPopulation[mMatingIndices[i + 1]], mOffspring[i + 1]);
+
+			lineage_0.mParentIndices[0] = mPopulation[mMatingIndices[i]].mLineageIndex;
+			lineage_1.mParentIndices[0] = mPopulation[mMatingIndices[i + 1]].mLineageIndex;
+		}
+	}
+
+	mGenerationInfo.mCrossoverAmount += successfull_crossover_amount;
+}
+
+
+
+void FPathGeneticAlgorithm::MutationStep(const int32 inBegin, const int32 inEnd)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GeneticTriangles_Mutation);
+
+	// Keep track of the mutation amount this generation
+	int32 successful_translation_mutations = 0;
+	int32 successful_insertion_mutations = 0;
+	int32 successful_deletion_mutations = 0;
+
+	for (int32 i = inBegin; i < inEnd; ++i)
+	{
+		FPathIndividual& path = mPopulation[i];
+		FPathLineageRecord& lineage = mBreedingLineage[path.mLineageIndex];
+
+		// Every path may be considered for mutation
+		const float rand = mRandomStream.FRandRange(0.0f, 100.0f);
+		if (rand < mSettings.mMutationProbability)
+		{
+			// Determine which mutations occur
+			bool do_translation_mutation = false;
+			bool do_insertion_mutation = false;
+			bool do_deletion_mutation = false;
+
+			const float translate_point_probability = mRandomStream.FRandRange(0, 100.0f);
+			if (translate_point_probability < mSettings.mTranslatePointProbability)
+				do_translation_mutation = true;
+
+			const float insert_point_probability = mRandomStream.FRandRange(0, 100.0f);
+			if (insert_point_probability < mSettings.mInsertionProbability)
+				do_insertion_mutation = true;
+
+			// Only do insertion or deletion in the same mutation step
+			if (!do_insertion_mutation)
+			{
+				const float deletion_probability = mRandomStream.FRandRange(0, 100.0f);
+				if (deletion_probability < mSettings.mDeletionProbability)
+					do_deletion_mutation = true;
+			}
+
+			// Then do mutations
+			if (do_translation_mutation)
+			{
+				path.MutateThroughTranslation(mRandomStream, mSettings.mTranslationMutationType, mSettings.mMaxTranslationOffset);
+				lineage.mMutationFlags |= FPathLineageRecord::TranslationMutation;
+				++successful_translation_mutations;
+			}
+			if (do_insertion_mutation)
+			{
+				path.MutateThroughInsertion(mRandomStream);
+				lineage.mMutationFlags |= FPathLineageRecord::InsertionMutation;
+				++successful_insertion_mutations;
+			}
+			if (do_deletion_mutation)
+			{
+				path.MutateThroughDeletion(mRandomStream);
+				lineage.mMutationFlags |= FPathLineageRecord::DeletionMutation;
+				++successful_deletion_mutations;
+			}
+		}
+	}
+
+	// Keep track of the mutation amount
+	mGenerationInfo.mAmountOfTranslationMutations += successful_translation_mutations;
+	mGenerationInfo.mAmountOfInsertionMutations += successful_insertion_mutations;
+	mGenerationInfo.mAmountOfDeletionMutations += successful_deletion_mutations;
+}
+
+
+
+void FPathGeneticAlgorithm::DuplicateIndividual(const FPathIndividual& inSource, FPathIndividual& outDuplicate) const
+{
+	outDuplicate.ResetEvaluation();
+	outDuplicate.mGeneticRepresentation = inSource.mGeneticRepresentation;
+	outDuplicate.DetermineGeneticRepresentation();
+}
+
+
+
+/**
+* Puts the lineage records of the generation in the order the offspring were sorted in
+* From here on the paths point at their own position, which is what the offspring of the next generation record as their parents
+*/
+void FPathGeneticAlgorithm::FinishLineage()
+{
+	mLineage.SetNum(mPopulation.Num(), false);
+
+	for (int32 i = 0; i < mPopulation.Num(); ++i)
+	{
+		FPathIndividual& path = mPopulation[i];
+
+		mLineage[i] = mBreedingLineage.IsValidIndex(path.mLineageIndex) ? mBreedingLineage[path.mLineageIndex] : FPathLineageRecord();
+		path.mLineageIndex = i;
+	}
+}
+
+
+
+/**
+* Copies the genomes of the fittest paths, the population is sorted by fitness once a generation has finished
+*/
+void FPathGeneticAlgorithm::GetEmigrants(const int32 inAmount, TArray<TArray<FVector>>& outGenomes) const
+{
+	const int32 amount = FMath::Min(inAmount, mPopulation.Num());
+
+	outGenomes.Reset(amount);
+
+	for (int32 i = 0; i < amount; ++i)
+		outGenomes.Add(mPopulation[i].mGeneticRepresentation);
+}
+
+
+
+/**
+* Replaces the least fit paths by the immigrants, only allowed in between generations
+* Their fitness is determined by the evaluation at the start of the next generation
+*/
+void FPathGeneticAlgorithm::AcceptImmigrants(const TArray<TArray<FVector>>& inGenomes)
+{
+	check(!IsGenerationInProgress());
+
+	const int32 amount = FMath::Min(inGenomes.Num(), mPopulation.Num());
+
+	for (int32 i = 0; i < amount; ++i)
+	{
+		FPathIndividual& path = mPopulation[mPopulation.Num() - 1 - i];
+
+		path.ResetEvaluation();
+		path.mGeneticRepresentation = inGenomes[i];
+		path.DetermineGeneticRepresentation();
+		path.mLineageIndex = INDEX_NONE;
+	}
+
+	mPendingImmigrantAmount += amount;
+}
+
+
+
+/**
+* Copies the current generation into a form which can be drawn and serialized
+* Colors are left untouched, they are applied afterwards by ColorCodeGeneration which only needs the captured data
+* The arrays of the outputs are reused, so capturing into the same objects every generation does not reallocate
+*/
+void FPathGeneticAlgorithm::CaptureGeneration(FGenerationSerializationData& outGeneration, FPathCapturedEvaluation& outEvaluation) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_GeneticTriangles_Capture);
+
+	outGeneration.mGenerationInfo = mGenerationInfo;
+
+	TArray<FPathSerializationData>& paths = outGeneration.mPathSerializationData;
+	paths.SetNum(mPopulation.Num(), false);
+	outEvaluation.mFitness.SetNum(mPopulation.Num(), false);
+	outEvaluation.mIsInvalid.SetNum(mPopulation.Num(), false);
+
+	for (int32 i = 0; i < mPopulation.Num(); ++i)
+	{
+		const FPathIndividual& path = mPopulation[i];
+		FPathSerializationData& path_data = paths[i];
+
+		path_data.mNodeAmount = path.GetAmountOfNodes();
+		path_data.mGeneticRepresentation = path.mGeneticRepresentation;
+		path_data.mFittest = path.mFittestSolution && !path.IsInvalid();
+
+		outEvaluation.mFitness[i] = path.mFitness;
+		outEvaluation.mIsInvalid[i] = path.IsInvalid();
+	}
+}
+
+
+
+/**
+* Saves the state of the run, only allowed in between generations
+*/
+void FPathGeneticAlgorithm::SaveState(FPathGeneticAlgorithmState& outState) const
+{
+	check(!IsGenerationInProgress());
+
+	outState.mInitialRandomSeed = mInitialRandomSeed;
+	outState.mCurrentRandomSeed = mRandomStream.GetCurrentSeed();
+	outState.mGenerationCount = mGenerationCount;
+	outState.mPendingImmigrantAmount = mPendingImmigrantAmount;
+	outState.mTotalFitness = mTotalFitness;
+	outState.mGenerationInfo = mGenerationInfo;
+
+	outState.mGenomes.SetNum(mPopulation.Num());
+	outState.mFitness.SetNum(mPopulation.Num());
+
+	for (int32 i = 0; i < mPopulation.Num(); ++i)
+	{
+		outState.mGenomes[i] = mPopulation[i].mGeneticRepresentation;
+		outState.mFitness[i] = mPopulation[i].mFitness;
+	}
+}
+
+
+
+/**
+* Continues a run from a saved state, the next generation is identical to the one the original run would have bred
+*/
+void FPathGeneticAlgorithm::RestoreState(const FPathGeneticAlgorithmState& inState)
+{
+	check(inState.mGenomes.Num() == inState.mFitness.Num());
+
+	mInitialRandomSeed = inState.mInitialRandomSeed;
+	mRandomStream.Initialize(inState.mCurrentRandomSeed);
+
+	mPopulation.Reset(inState.mGenomes.Num());
+	mPopulation.SetNum(inState.mGenomes.Num());
+
+	for (int32 i = 0; i < mPopulation.Num(); ++i)
+	{
+		FPathIndividual& path = mPopulation[i];
+
+		path.ResetEvaluation();
+		path.mGeneticRepresentation = inState.mGenomes[i];
+		path.DetermineGeneticRepresentation();
+		path.mFitness = inState.mFitness[i];
+		path.mLineageIndex = i;
+	}
+
+	mGenerationInfo = inState.mGenerationInfo;
+	mGenerationCount = inState.mGenerationCount;
+	mPendingImmigrantAmount = inState.mPendingImmigrantAmount;
+	mTotalFitness = inState.mTotalFitness;
+
+	mPhase = EPathGenerationPhase::EvaluateParents;
+	mPhaseCursor = 0;
+	mStepsThisGeneration = 0;
+}
+
+
+
+/**
+* Colors the paths of a captured generation by fitness, does not depend on the algorithm so it may run on any thread
+*/
+void FPathGeneticAlgorithm::ColorCodeGeneration(FGenerationSerializationData& ioGeneration, const FPathCapturedEvaluation& inEvaluation, const FColor& inInvalidPathColor)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GeneticTriangles_ColorCoding);
+
+	float lowest_fitness = TNumericLimits<float>::Max();
+	float highest_fitness = 0.0f;
+
+	for (const float fitness : inEvaluation.mFitness)
+	{
+		if (fitness < lowest_fitness)
+			lowest_fitness = fitness;
+		if (fitness > highest_fitness)
+			highest_fitness = fitness;
+	}
+
+	TArray<FPathSerializationData>& paths = ioGeneration.mPathSerializationData;
+
+	for (int32 i = 0; i < paths.Num(); ++i)
+	{
+		FPathSerializationData& path_data = paths[i];
+
+		if (inEvaluation.mIsInvalid[i])
+		{
+			// Completely unfit paths are marked grey
+			path_data.mColor = inInvalidPathColor;
+		}
+		else
+		{
+			// Apply color coding based on the lowest and highest fitness values
+			const float blend_value = (inEvaluation.mFitness[i] - highest_fitness) / (lowest_fitness - highest_fitness);
+
+			FColor red = FColor::Red;
+			FColor green = FColor::Green;
+
+			FColor blended;
+			blended.A = 255;
+			blended.R = FMath::Lerp(red.R, green.R, 1.0f - blend_value * 255);
+			blended.G = FMath::Lerp(red.G, green.G, 1.0f - blend_value * 255);
+			blended.B = 0;
+
+			path_data.mColor = blended;
+		}
+	}
+}
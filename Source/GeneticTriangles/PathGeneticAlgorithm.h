@@ -0,0 +1,208 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// API includes
+#include "Enums.h"
+#include "GeneticTermination.h"
+#include "PathGenerationData.h"
+#include "PathGeometry.h"
+#include "PathIndividual.h"
+#include "PathLineage.h"
+
+/**
+* Copy of the configuration of a path manager
+* The algorithm only works on this copy, so it never has to touch the actor while a generation is running
+*/
+struct FPathGeneticAlgorithmSettings
+{
+	// Population
+	int32 mRandomSeed = 0;
+	int32 mPopulationCount = 20;
+	float mMaxInitialVariation = 40.0f;
+	int32 mMinAmountOfPointsPerPathAtStartup = 2;
+	int32 mMaxAmountOfPointsPerPathAtStartup = 10;
+
+	FVector mStartLocation = FVector::ZeroVector;
+	FVector mTargetLocation = FVector::ZeroVector;
+	FColor mInvalidPathColor = FColor::Black;
+	bool mDrawDebug = true;
+
+	// Standard fitness
+	float mAmountOfNodesWeight = 100.0f;
+	float mProximityToTargetedNodeWeight = 100.0f;
+	float mLengthWeight = 100.0f;
+	float mCanSeeTargetWeight = 100.0f;
+	float mTargetReachedWeight = 100.0f;
+	float mObstacleHitMultiplier = 0.0f;
+
+	// Slope fitness
+	bool mUseSlopeFitnessEvaluation = false;
+	float mSlopeWeight = 100.0f;
+	float mSlopeTooIntenseMultiplier = 0.0f;
+	float mPiercesTerrainMultiplier = 0.0f;
+	float mMaxSlopeToleranceAngle = 45.0f;
+
+	// Max length fitness
+	bool mUseMaxLengthFitness = false;
+	float mMaxEuclidianDistance = 40.0f;
+	float mEuclidianOvershootMultiplier = 0.0f;
+
+	// Crossover
+	float mCrossoverProbability = 70.0f;
+	ECrossoverOperator mCrossoverOperator = ECrossoverOperator::SinglePoint;
+
+	// Mutation
+	ETranslationMutationType mTranslationMutationType = ETranslationMutationType::AnyButStart;
+	float mMutationProbability = 5.0f;
+	float mTranslatePointProbability = 0.0f;
+	float mInsertionProbability = 0.0f;
+	float mDeletionProbability = 0.0f;
+	float mMaxTranslationOffset = 40.0f;
+
+	// Obstacle avoidance
+	bool mApplyObstacleAvoidanceLogic = false;
+	EObstacleTraceBehaviour mTraceBehaviour = EObstacleTraceBehaviour::WindDirectionTracing;
+	int32 mAmountOfCyclicPoints = 8;
+	float mTraceDistance = 20.0f;
+};
+
+
+
+/**
+* Per path evaluation results captured alongside a generation, everything color coding needs
+*/
+struct FPathCapturedEvaluation
+{
+	TArray<float> mFitness;
+	TArray<bool> mIsInvalid;
+};
+
+
+
+/**
+* Everything the algorithm needs to continue a run in between two generations, exactly as if it had never been interrupted
+* The population is evaluated again at the start of every generation, so only its genomes matter, the fitness is kept for reference
+*/
+struct FPathGeneticAlgorithmState
+{
+	int32 mInitialRandomSeed = 0;
+	int32 mCurrentRandomSeed = 0;
+	int32 mGenerationCount = 0;
+	int32 mPendingImmigrantAmount = 0;
+	float mTotalFitness = 0.0f;
+	FGenerationInfo mGenerationInfo;
+
+	TArray<TArray<FVector>> mGenomes;
+	TArray<float> mFitness;
+};
+
+
+
+/**
+* The phases of a single generation, in order of execution
+* Every phase but the scoring phases may be spread over multiple steps
+*/
+enum class EPathGenerationPhase : uint8
+{
+	EvaluateParents, // Snap to terrain, geometry and traces of the current population
+	ScoreParents, // Fitness assignment and sorting, always done in one go
+	Selection,
+	Crossover,
+	Mutation,
+	EvaluateOffspring,
+	ScoreOffspring
+};
+
+
+
+/**
+* The genetic algorithm behind the path manager
+* Owns the population as plain data and only reads from the world through scene queries
+* As such it may run on the game thread as well as on a worker thread
+*/
+class GENETICTRIANGLES_API FPathGeneticAlgorithm
+{
+public:
+	FPathGeneticAlgorithm(const UWorld* inWorld, const FPathGeneticAlgorithmSettings& inSettings);
+
+	void SetSettings(const FPathGeneticAlgorithmSettings& inSettings) { mSettings = inSettings; }
+	const FPathGeneticAlgorithmSettings& GetSettings() const { return mSettings; }
+
+	void InitializeRun();
+	void RunGeneration();
+	bool StepGeneration(const int32 inMaxPathsPerPhase);
+	void CaptureGeneration(FGenerationSerializationData& outGeneration, FPathCapturedEvaluation& outEvaluation) const;
+
+	void SaveState(FPathGeneticAlgorithmState& outState) const;
+	void RestoreState(const FPathGeneticAlgorithmState& inState);
+
+	void GetEmigrants(const int32 inAmount, TArray<TArray<FVector>>& outGenomes) const;
+	void AcceptImmigrants(const TArray<TArray<FVector>>& inGenomes);
+	static void ColorCodeGeneration(FGenerationSerializationData& ioGeneration, const FPathCapturedEvaluation& inEvaluation, const FColor& inInvalidPathColor);
+
+	bool IsInitialized() const { return mPopulation.Num() > 0; }
+	bool IsGenerationInProgress() const { return mPhase != EPathGenerationPhase::EvaluateParents || mPhaseCursor > 0; }
+	EPathGenerationPhase GetPhase() const { return mPhase; }
+	int32 GetGenerationCount() const { return mGenerationCount; }
+	int32 GetRandomSeed() const { return mInitialRandomSeed; }
+	const FGenerationInfo& GetGenerationInfo() const { return mGenerationInfo; }
+	int32 GetTraceAmount() const { return mTraceAmount; } ///< Line traces of the generation in progress, or of the last one once it has finished
+	const TArray<FPathLineageRecord>& GetLineage() const { return mLineage; } ///< Of the generation that finished last, in population order
+	const TArray<FPathIndividual>& GetPopulation() const { return mPopulation; }
+
+private:
+	int32 GetPhaseSize(const EPathGenerationPhase inPhase) const;
+	void BeginPhase(const EPathGenerationPhase inPhase);
+	void RunPhase(const EPathGenerationPhase inPhase, const int32 inBegin, const int32 inEnd);
+	void FinishPhase(const EPathGenerationPhase inPhase);
+	void AddPhaseTime(const EPathGenerationPhase inPhase, const uint32 inCycles);
+
+	void EvaluatePaths(const int32 inBegin, const int32 inEnd);
+	void ScorePopulation();
+	void SelectionStep(const int32 inEnd);
+	void CrossoverStep(const int32 inBegin, const int32 inEnd);
+	void MutationStep(const int32 inBegin, const int32 inEnd);
+
+	void DuplicateIndividual(const FPathIndividual& inSource, FPathIndividual& outDuplicate) const;
+	void FinishLineage();
+
+private:
+	const UWorld* mWorld = nullptr;
+	FPathGeneticAlgorithmSettings mSettings;
+	FRandomStream mRandomStream;
+	int32 mInitialRandomSeed = 0; ///< Kept apart from the stream, a restored stream starts at the seed it was saved with
+
+	TArray<FPathIndividual> mPopulation;
+	TArray<FPathIndividual> mOffspring; ///< Swapped with the population after crossover, keeps the allocations of the previous generation around
+	TArray<int32> mMatingIndices;
+	TArray<FPathLineageRecord> mBreedingLineage; ///< One record per offspring, in the order the offspring were bred in
+	TArray<FPathLineageRecord> mLineage;
+	FPathGeometryBatch mGeometryBatch;
+
+	/**
+	* Population wide extremes gathered while evaluating, needed to blend the fitness of every path
+	*/
+	struct FEvaluationBounds
+	{
+		int32 mLeastAmountOfNodes = INT32_MAX;
+		int32 mMostAmountOfNodes = 0;
+		float mClosestDistance = TNumericLimits<float>::Max();
+		float mFurthestDistance = 0.0f;
+		float mShortestPathLength = TNumericLimits<float>::Max();
+		float mLongestPathLength = 0.0f;
+		FPopulationDiversity mDiversity; ///< Spread of the path centroids, accumulated one path at a time so it survives being split over steps
+	};
+
+	FEvaluationBounds mEvaluationBounds;
+
+	FGenerationInfo mGenerationInfo; ///< Only complete once a generation has finished, the counters are filled in while the generation is in progress
+	int32 mGenerationCount = 0;
+	float mTotalFitness = 0.0f;
+
+	EPathGenerationPhase mPhase = EPathGenerationPhase::EvaluateParents;
+	int32 mPhaseCursor = 0; ///< Amount of paths the current phase has processed so far
+	int32 mStepsThisGeneration = 0;
+	int32 mPendingImmigrantAmount = 0;
+	int32 mTraceAmount = 0;
+};
@@ -0,0 +1,228 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneticTriangles.h"
+#include "PathGeneticWorker.h"
+
+#include "PathHistoryWriter.h"
+#include "PathStatisticsWriter.h"
+
+FPathGeneticWorker::FPathGeneticWorker(const UWorld* inWorld, const FPathGeneticAlgorithmSettings& inSettings, const int32 inVisualizationInterval, const float inTimeBetweenGenerations, const FGeneticTerminationCriteria& inTerminationCriteria, FPathHistoryWriter* inHistoryWriter, FPathStatisticsWriter* inStatisticsWriter, const FPathMigrationSettings& inMigrationSettings, const FPathCheckpointSettings* inCheckpointSettings, const FPathCheckpoint* inResumeCheckpoint)
+	:
+	mAlgorithm(inWorld, inSettings),
+	mHistoryWriter(inHistoryWriter),
+	mStatisticsWriter(inStatisticsWriter),
+	mTerminationMonitor(inTerminationCriteria),
+	mMigrationSettings(inMigrationSettings),
+	mMigrationRandomStream(mAlgorithm.GetRandomSeed() ^ 0x5bd1e995),
+	mVisualizationInterval(inVisualizationInterval),
+	mTimeBetweenGenerations(inTimeBetweenGenerations),
+	mIsCheckpointRequested(false),
+	mHasFinishedRun(false)
+{
+	if (inCheckpointSettings != nullptr)
+	{
+		mCheckpointSettings = *inCheckpointSettings;
+		mCheckpointWriter = MakeUnique<FPathCheckpointWriter>(mCheckpointSettings.mFilePath);
+	}
+
+	// The termination monitor continues where it was, only the criteria come from the current configuration
+	if (inResumeCheckpoint != nullptr)
+	{
+		mAlgorithm.RestoreState(inResumeCheckpoint->mAlgorithmState);
+		mTerminationMonitor = inResumeCheckpoint->mTerminationMonitor;
+		mTerminationMonitor.SetCriteria(inTerminationCriteria);
+	}
+
+	mWakeUpEvent = FPlatformProcess::GetSynchEventFromPool(false);
+
+	// Start the thread last, everything it touches has been set up by now
+	mThread = FRunnableThread::Create(this, TEXT("FPathGeneticWorker"), 0, TPri_Normal);
+}
+
+
+
+FPathGeneticWorker::~FPathGeneticWorker()
+{
+	if (mThread != nullptr)
+	{
+		Stop();
+		mThread->WaitForCompletion();
+
+		delete mThread;
+		mThread = nullptr;
+	}
+
+	FPlatformProcess::ReturnSynchEventToPool(mWakeUpEvent);
+	mWakeUpEvent = nullptr;
+}
+
+
+
+uint32 FPathGeneticWorker::Run()
+{
+	while (mStopTaskCounter.GetValue() == 0)
+	{
+		ProcessCommands();
+
+		if (mIsPlaying)
+		{
+			RunGeneration();
+
+			// Honour the delay between generations, a new command cuts the delay short
+			if (mTimeBetweenGenerations > 0.0f)
+				mWakeUpEvent->Wait(FMath::CeilToInt(mTimeBetweenGenerations * 1000.0f));
+		}
+		else
+		{
+			mWakeUpEvent->Wait();
+		}
+	}
+
+	return 0;
+}
+
+
+
+void FPathGeneticWorker::Stop()
+{
+	mStopTaskCounter.Increment();
+	mWakeUpEvent->Trigger();
+}
+
+
+
+void FPathGeneticWorker::EnqueueCommand(const EAnimationControlState inCommand)
+{
+	mCommands.Enqueue(inCommand);
+	mWakeUpEvent->Trigger();
+}
+
+
+
+void FPathGeneticWorker::ProcessCommands()
+{
+	EAnimationControlState command;
+	while (mCommands.Dequeue(command))
+	{
+		// A finished run can not be resumed, a new worker is created for the next run
+		if (mHasFinishedRun)
+			continue;
+
+		switch (command)
+		{
+		case EAnimationControlState::Play:
+			mIsPlaying = true;
+			break;
+		case EAnimationControlState::Pause:
+			mIsPlaying = false;
+			break;
+		case EAnimationControlState::Stop:
+			mIsPlaying = false;
+			mHasFinishedRun = true;
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+
+
+void FPathGeneticWorker::RunGeneration()
+{
+	// Migrants that arrived since the previous generation replace the least fit paths
+	if (mMigrationSettings.mHub != nullptr)
+	{
+		while (mMigrationSettings.mHub->Receive(mMigrationSettings.mIslandIndex, mMigrants))
+			mAlgorithm.AcceptImmigrants(mMigrants);
+	}
+
+	// Every stage runs on the worker itself, so all timings belong to this generation, only presentation happens elsewhere
+	FGenerationStageTimings timings;
+
+	double start_time = FPlatformTime::Seconds();
+	mAlgorithm.RunGeneration();
+	timings.mBreeding = (FPlatformTime::Seconds() - start_time) * 1000.0;
+
+	Migrate();
+
+	const FGenerationInfo& generation_info = mAlgorithm.GetGenerationInfo();
+
+	if (mHistoryWriter != nullptr)
+		mHistoryWriter->AppendLineage(generation_info.mGenerationNumber, mAlgorithm.GetLineage(), mMigrationSettings.mIslandIndex);
+
+	const bool has_terminated = mTerminationMonitor.Update(mAlgorithm.GetGenerationCount(), generation_info.mBestFitness, generation_info.mFitnessFactor, generation_info.mDiversity) != ETerminationReason::None;
+
+	// The final generation is always kept, even when it falls in between the visualized ones
+	if (has_terminated || mVisualizationInterval <= 1 || (generation_info.mGenerationNumber % mVisualizationInterval) == 0)
+	{
+		FGenerationSerializationData& snapshot = mSnapshots.GetWriteBuffer();
+
+		start_time = FPlatformTime::Seconds();
+		mAlgorithm.CaptureGeneration(snapshot, mCapturedEvaluation);
+		timings.mCapture = (FPlatformTime::Seconds() - start_time) * 1000.0;
+
+		start_time = FPlatformTime::Seconds();
+		FPathGeneticAlgorithm::ColorCodeGeneration(snapshot, mCapturedEvaluation, mAlgorithm.GetSettings().mInvalidPathColor);
+		timings.mColorCoding = (FPlatformTime::Seconds() - start_time) * 1000.0;
+
+		start_time = FPlatformTime::Seconds();
+		if (mHistoryWriter != nullptr)
+			mHistoryWriter->Append(snapshot, mMigrationSettings.mIslandIndex, false, &mAlgorithm.GetLineage());
+		timings.mRecording = (FPlatformTime::Seconds() - start_time) * 1000.0;
+
+		mSnapshots.Publish();
+	}
+
+	if (mStatisticsWriter != nullptr)
+		mStatisticsWriter->Append(generation_info, timings, mMigrationSettings.mIslandIndex);
+
+	if (has_terminated)
+	{
+		mIsPlaying = false;
+		mHasFinishedRun = true;
+	}
+	else
+		SaveCheckpoint();
+}
+
+
+
+/**
+* Every n-th generation the fittest paths of the island are posted to another island
+*/
+void FPathGeneticWorker::Migrate()
+{
+	FPathMigrationHub* hub = mMigrationSettings.mHub;
+	if (hub == nullptr || hub->GetIslandCount() < 2 || mMigrationSettings.mMigrationInterval < 1 || mMigrationSettings.mMigrantAmount < 1)
+		return;
+
+	if (mAlgorithm.GetGenerationCount() % mMigrationSettings.mMigrationInterval != 0)
+		return;
+
+	mAlgorithm.GetEmigrants(mMigrationSettings.mMigrantAmount, mMigrants);
+	hub->Post(hub->GetDestination(mMigrationSettings, mMigrationRandomStream), mMigrants);
+}
+
+
+
+/**
+* Takes a checkpoint if one is due, a requested checkpoint waits for the one in flight instead of being skipped
+*/
+void FPathGeneticWorker::SaveCheckpoint()
+{
+	if (!mCheckpointWriter.IsValid() || mCheckpointWriter->IsSaving())
+		return;
+
+	if (!mIsCheckpointRequested && !mCheckpointSettings.ShouldSave(mAlgorithm.GetGenerationCount()))
+		return;
+
+	mIsCheckpointRequested = false;
+
+	TUniquePtr<FPathCheckpoint> checkpoint = MakeUnique<FPathCheckpoint>();
+	checkpoint->mProperties = mCheckpointSettings.mProperties;
+	checkpoint->mTerminationMonitor = mTerminationMonitor;
+	mAlgorithm.SaveState(checkpoint->mAlgorithmState);
+
+	mCheckpointWriter->Save(MoveTemp(checkpoint));
+}
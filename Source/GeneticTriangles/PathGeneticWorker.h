@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// API includes
+#include "Enums.h"
+#include "PathCheckpointWriter.h"
+#include "PathGenerationData.h"
+#include "PathGeneticAlgorithm.h"
+#include "PathMigrationHub.h"
+#include "TripleBuffer.h"
+
+// Forward decl
+class FPathHistoryWriter;
+class FPathStatisticsWriter;
+
+/**
+* Runs the generations of a path run on a dedicated thread
+*
+* The worker owns the population, the game thread only ever sees immutable snapshots of finished generations
+* Snapshots are published through a lock-free triple buffer, animation control states are sent over a command queue
+* Every stored generation is appended to the history file by the worker itself, nothing of it is kept in memory
+* The lineage and the statistics of every generation are written as well, whether the generation is stored or not
+* In island runs every island has its own worker, which exchange migrants through the migration hub in between generations
+* A worker that meets its termination criteria finishes the run by itself, the game thread then stops the other workers
+* Checkpoints are taken by the worker in between generations, either periodically or when requested, and written in the background
+*/
+class GENETICTRIANGLES_API FPathGeneticWorker : public FRunnable
+{
+public:
+	FPathGeneticWorker(const UWorld* inWorld, const FPathGeneticAlgorithmSettings& inSettings, const int32 inVisualizationInterval, const float inTimeBetweenGenerations, const FGeneticTerminationCriteria& inTerminationCriteria, FPathHistoryWriter* inHistoryWriter, FPathStatisticsWriter* inStatisticsWriter, const FPathMigrationSettings& inMigrationSettings = FPathMigrationSettings(), const FPathCheckpointSettings* inCheckpointSettings = nullptr, const FPathCheckpoint* inResumeCheckpoint = nullptr);
+	virtual ~FPathGeneticWorker();
+
+	// FRunnable interface
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+	// Game thread interface
+	void EnqueueCommand(const EAnimationControlState inCommand);
+	void RequestCheckpoint() { mIsCheckpointRequested = true; }
+
+	bool UpdateSnapshot() { return mSnapshots.Update(); }
+	const FGenerationSerializationData& GetSnapshot() const { return mSnapshots.GetReadBuffer(); }
+
+	bool HasFinishedRun() const { return mHasFinishedRun; }
+
+	bool HasTerminated() const { return mHasFinishedRun && mTerminationMonitor.HasTerminated(); }
+	const FGeneticTerminationMonitor& GetTerminationMonitor() const { check(mHasFinishedRun); return mTerminationMonitor; }
+
+private:
+	void ProcessCommands();
+	void RunGeneration();
+	void Migrate();
+	void SaveCheckpoint();
+
+private:
+	FPathGeneticAlgorithm mAlgorithm;
+	TLockFreeTripleBuffer<FGenerationSerializationData> mSnapshots;
+	TQueue<EAnimationControlState, EQueueMode::Spsc> mCommands;
+	FPathHistoryWriter* mHistoryWriter = nullptr; ///< Shared by the islands of a run, outlives the worker
+	FPathStatisticsWriter* mStatisticsWriter = nullptr; ///< Same as the history writer, may be null as well
+	FPathCapturedEvaluation mCapturedEvaluation;
+	FGeneticTerminationMonitor mTerminationMonitor;
+
+	FPathMigrationSettings mMigrationSettings;
+	FRandomStream mMigrationRandomStream;
+	TArray<TArray<FVector>> mMigrants;
+
+	FPathCheckpointSettings mCheckpointSettings;
+	TUniquePtr<FPathCheckpointWriter> mCheckpointWriter; ///< Only valid when the run writes checkpoints
+	FThreadSafeBool mIsCheckpointRequested;
+
+	int32 mVisualizationInterval = 1;
+	float mTimeBetweenGenerations = 0.0f;
+	bool mIsPlaying = false;
+
+	FThreadSafeBool mHasFinishedRun;
+	FThreadSafeCounter mStopTaskCounter;
+	FEvent* mWakeUpEvent = nullptr;
+	FRunnableThread* mThread = nullptr;
+};
@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneticTriangles.h"
+#include "PathGeometry.h"
+
+void FPathGeometryBatch::Reset(const int32 inExpectedGenomeAmount, const int32 inExpectedChromosomeAmount)
+{
+	// Keep the allocations around, the batch is refilled every fitness evaluation
+	mChromosomes.Reset(inExpectedChromosomeAmount);
+	mSegmentLengths.Reset(inExpectedChromosomeAmount);
+	mResults.Reset(inExpectedGenomeAmount);
+
+	mOffsets.Reset(inExpectedGenomeAmount + 1);
+	mOffsets.Add(0);
+}
+
+
+
+int32 FPathGeometryBatch::AddGenome(const TArray<FVector>& inGenome)
+{
+	mChromosomes.Append(inGenome);
+	mOffsets.Add(mChromosomes.Num());
+
+	return mOffsets.Num() - 2;
+}
+
+
+
+void FPathGeometryBatch::Evaluate(const FPathGeometryConstraints& inConstraints)
+{
+	const int32 genome_amount = mOffsets.Num() - 1;
+
+	mSegmentLengths.SetNumUninitialized(mChromosomes.Num(), false);
+	mResults.SetNumUninitialized(genome_amount, false);
+
+	for (int32 i = 0; i < genome_amount; ++i)
+	{
+		const int32 offset = mOffsets[i];
+		const int32 chromosome_amount = mOffsets[i + 1] - offset;
+
+		mResults[i] = EvaluateGenome(mChromosomes.GetData() + offset, chromosome_amount, inConstraints, mSegmentLengths.GetData() + offset);
+
+		if (chromosome_amount > 0)
+			mSegmentLengths[offset + chromosome_amount - 1] = 0.0f;
+	}
+}
+
+
+
+/**
+* The kernel is shared with Tools/GaBench, see PathKernels.h
+*/
+FPathGeometryResult FPathGeometryBatch::EvaluateGenome(const FVector* inChromosomes, const int32 inChromosomeAmount, const FPathGeometryConstraints& inConstraints, float* outSegmentLengths)
+{
+	return PathKernels::EvaluateGenome(inChromosomes, inChromosomeAmount, inConstraints, outSegmentLengths);
+}
@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// API includes
+#include "PathKernels.h"
+
+using FPathGeometryConstraints = PathKernels::FGeometryConstraints; ///< Limits used by the fused geometry pass
+using FPathGeometryResult = PathKernels::FGeometryResult; ///< Output of the geometry pass for a single genome
+
+
+
+/**
+* Flat chromosome buffer for a whole population
+* Genomes are appended back to back, after which a single pass computes segment lengths, total length and the constraint flags of every genome
+*/
+class GENETICTRIANGLES_API FPathGeometryBatch
+{
+public:
+	void Reset(const int32 inExpectedGenomeAmount, const int32 inExpectedChromosomeAmount);
+	int32 AddGenome(const TArray<FVector>& inGenome);
+	void Evaluate(const FPathGeometryConstraints& inConstraints);
+
+	int32 Num() const { return mResults.Num(); }
+	const FPathGeometryResult& GetResult(const int32 inGenomeIndex) const { return mResults[inGenomeIndex]; }
+
+	// Segment i of a genome runs from chromosome i to chromosome i + 1, the final entry of every genome is unused
+	const float* GetSegmentLengths(const int32 inGenomeIndex) const { return mSegmentLengths.GetData() + mOffsets[inGenomeIndex]; }
+
+	static FPathGeometryResult EvaluateGenome(const FVector* inChromosomes, const int32 inChromosomeAmount, const FPathGeometryConstraints& inConstraints, float* outSegmentLengths = nullptr);
+
+private:
+	TArray<FVector> mChromosomes;
+	TArray<int32> mOffsets; ///< Start of every genome in mChromosomes, with one trailing entry marking the end of the buffer
+	TArray<float> mSegmentLengths;
+	TArray<FPathGeometryResult> mResults;
+};
@@ -0,0 +1,123 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneticTriangles.h"
+#include "PathHistoryDelta.h"
+
+#include "PathHistoryKernels.h"
+
+/**
+* Mutated chromosomes are quantized the same way whole genomes are
+*/
+void FPathDelta::Serialize(FArchive& ioArchive, const FPathQuantization& inQuantization, FPathQuantizationStats* ioStats)
+{
+	ioArchive << mParentIndices[0];
+	ioArchive << mParentIndices[1];
+	ioArchive << mCrossoverIndex;
+	ioArchive << mNodeAmount;
+	ioArchive << mColor;
+	ioArchive << mFittest;
+	ioArchive << mMutatedIndices;
+	inQuantization.SerializeGenome(ioArchive, mMutatedChromosomes, ioStats);
+}
+
+
+
+/**
+* Describes every path of inGeneration by its parents among the paths of inReference, the arrays of outDeltas are reused
+* inLineage holds a record per path of inGeneration, pointing into inReference, it has to be null unless inReference is the generation right before
+* The paths it knows the parents of are encoded in a single pass over their chromosomes, the others recover their parents from the chromosomes
+*/
+void FPathHistoryDelta::Encode(const FGenerationSerializationData& inReference, const FGenerationSerializationData& inGeneration, const TArray<FPathLineageRecord>* inLineage, TArray<FPathDelta>& outDeltas)
+{
+	const TArray<FPathSerializationData>& parents = inReference.mPathSerializationData;
+	const TArray<FPathSerializationData>& paths = inGeneration.mPathSerializationData;
+
+	const bool has_lineage = inLineage != nullptr && inLineage->Num() == paths.Num();
+
+	const auto get_parent_genes = [&parents](const int32 inParentIndex)
+	{
+		const TArray<FVector>& parent_genes = parents[inParentIndex].mGeneticRepresentation;
+		return PathHistoryKernels::TGenomeView<FVector>(parent_genes.GetData(), parent_genes.Num());
+	};
+
+	FParentLookup lookup;
+
+	outDeltas.SetNum(paths.Num(), false);
+
+	for (int32 i = 0; i < paths.Num(); ++i)
+	{
+		const FPathSerializationData& path = paths[i];
+		const TArray<FVector>& genes = path.mGeneticRepresentation;
+
+		FPathDelta& delta = outDeltas[i];
+		delta.mNodeAmount = path.mNodeAmount;
+		delta.mColor = path.mColor;
+		delta.mFittest = path.mFittest;
+		delta.mMutatedIndices.Reset();
+		delta.mMutatedChromosomes.Reset();
+
+		const int32 first_parent = has_lineage ? (*inLineage)[i].mParentIndices[0] : INDEX_NONE;
+		const int32 second_parent = has_lineage ? (*inLineage)[i].mParentIndices[1] : INDEX_NONE;
+
+		delta.mCrossoverIndex = PathHistoryKernels::EncodePath(PathHistoryKernels::TGenomeView<FVector>(genes.GetData(), genes.Num()), parents.Num(), get_parent_genes, lookup,
+			first_parent, second_parent, delta.mParentIndices, [&delta, &genes](const int32 inIndex)
+		{
+			delta.mMutatedIndices.Add(inIndex);
+			delta.mMutatedChromosomes.Add(genes[inIndex]);
+		});
+	}
+}
+
+
+
+/**
+* Rebuilds a generation from the generation stored before it, outGeneration may not be inReference
+* The generation info is not part of the deltas and is left untouched
+*/
+bool FPathHistoryDelta::Apply(const FGenerationSerializationData& inReference, const TArray<FPathDelta>& inDeltas, FGenerationSerializationData& outGeneration)
+{
+	check(&inReference != &outGeneration);
+
+	const TArray<FPathSerializationData>& parents = inReference.mPathSerializationData;
+	TArray<FPathSerializationData>& paths = outGeneration.mPathSerializationData;
+
+	paths.SetNum(inDeltas.Num(), false);
+
+	for (int32 i = 0; i < inDeltas.Num(); ++i)
+	{
+		const FPathDelta& delta = inDeltas[i];
+		FPathSerializationData& path = paths[i];
+
+		if (delta.mNodeAmount < 0 || delta.mCrossoverIndex < 0 || delta.mMutatedIndices.Num() != delta.mMutatedChromosomes.Num())
+			return false;
+
+		path.mNodeAmount = delta.mNodeAmount;
+		path.mColor = delta.mColor;
+		path.mFittest = delta.mFittest;
+
+		TArray<FVector>& genes = path.mGeneticRepresentation;
+		genes.SetNumUninitialized(delta.mNodeAmount, false);
+
+		int32 mutation_cursor = 0;
+		for (int32 j = 0; j < delta.mNodeAmount; ++j)
+		{
+			if (mutation_cursor < delta.mMutatedIndices.Num() && delta.mMutatedIndices[mutation_cursor] == j)
+			{
+				genes[j] = delta.mMutatedChromosomes[mutation_cursor++];
+				continue;
+			}
+
+			const int32 parent_index = delta.mParentIndices[j < delta.mCrossoverIndex ? 0 : 1];
+			if (!parents.IsValidIndex(parent_index) || !parents[parent_index].mGeneticRepresentation.IsValidIndex(j))
+				return false;
+
+			genes[j] = parents[parent_index].mGeneticRepresentation[j];
+		}
+
+		// Every mutated chromosome has to have been used, otherwise the deltas are damaged
+		if (mutation_cursor != delta.mMutatedIndices.Num())
+			return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// API includes
+#include "PathGenerationData.h"
+#include "PathLineage.h"
+#include "PathQuantization.h"
+
+/**
+* A single path, described by the paths of the previous stored generation it was bred from
+*
+* The chromosomes before the crossover index are those of the first parent, the rest are those of the second parent
+* Chromosomes which differ from the parents, through mutation, snapping or a parent being too short, are listed separately
+* A path that was carried over as is refers to the same parent twice, with the crossover index at its end and nothing mutated
+*/
+struct FPathDelta
+{
+	int32 mParentIndices[2] = { INDEX_NONE, INDEX_NONE };
+	int32 mCrossoverIndex = 0;
+	int32 mNodeAmount = 0;
+	FColor mColor = FColor::Black;
+	bool mFittest = false;
+
+	TArray<int32> mMutatedIndices;
+	TArray<FVector> mMutatedChromosomes;
+
+	void Serialize(FArchive& ioArchive, const FPathQuantization& inQuantization, FPathQuantizationStats* ioStats = nullptr);
+};
+
+
+
+/**
+* Encodes a stored generation against the stored generation before it, and rebuilds it again
+*
+* The parents are taken from the lineage the algorithm recorded, which is only valid when the reference is the generation right before
+* Without it, or for paths it does not know the parents of, the parents are recovered from the chromosomes themselves,
+* which holds up against migration and generations that were skipped by the visualization interval
+* Either way the chromosomes are compared bit for bit, a rebuilt generation is identical to the generation that was encoded
+* The encoding is shared with Tools/GaBench, see PathHistoryKernels.h
+*/
+class GENETICTRIANGLES_API FPathHistoryDelta
+{
+public:
+	static void Encode(const FGenerationSerializationData& inReference, const FGenerationSerializationData& inGeneration, const TArray<FPathLineageRecord>* inLineage, TArray<FPathDelta>& outDeltas);
+	static bool Apply(const FGenerationSerializationData& inReference, const TArray<FPathDelta>& inDeltas, FGenerationSerializationData& outGeneration);
+
+private:
+	/**
+	* Lookups into the reference for the paths without a known lineage, only built once such a path comes up, see PathHistoryKernels::EncodePath
+	*/
+	struct FParentLookup
+	{
+		TMultiMap<uint32, int32> mGenomes; ///< Hash of the whole genome
+		TMultiMap<uint32, int32> mChromosomes; ///< Hash of a chromosome and its position, a parent is listed once per chromosome
+		bool mIsBuilt = false;
+
+		void AddGenome(const uint32 inHash, const int32 inParentIndex) { mGenomes.Add(inHash, inParentIndex); }
+		void AddChromosome(const uint32 inHash, const int32 inParentIndex) { mChromosomes.Add(inHash, inParentIndex); }
+
+		template <typename TVisitor>
+		void ForEachGenome(const uint32 inHash, TVisitor inVisitor) const { ForEach(mGenomes, inHash, inVisitor); }
+
+		template <typename TVisitor>
+		void ForEachChromosome(const uint32 inHash, TVisitor inVisitor) const { ForEach(mChromosomes, inHash, inVisitor); }
+
+		template <typename TVisitor>
+		static void ForEach(const TMultiMap<uint32, int32>& inMap, const uint32 inHash, TVisitor inVisitor)
+		{
+			for (TMultiMap<uint32, int32>::TConstKeyIterator it = inMap.CreateConstKeyIterator(inHash); it; ++it)
+			{
+				if (!inVisitor(it.Value()))
+					return;
+			}
+		}
+	};
+};
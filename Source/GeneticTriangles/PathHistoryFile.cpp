@@ -0,0 +1,525 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneticTriangles.h"
+#include "PathHistoryFile.h"
+
+#include "Async/ParallelFor.h"
+#include "FileManager.h"
+
+#include "PathHistoryKernels.h"
+#include "PathHistoryWriter.h"
+
+FArchive& operator<<(FArchive& ioArchive, FPathHistoryFile::FHeader& ioHeader)
+{
+	ioArchive << ioHeader.mMagic;
+	ioArchive << ioHeader.mVersion;
+	ioArchive << ioHeader.mPopulationCount;
+	ioArchive << ioHeader.mIslandCount;
+
+	return ioArchive;
+}
+
+
+
+FArchive& operator<<(FArchive& ioArchive, FPathHistoryFile::FCompressionSettings& ioSettings)
+{
+	ioArchive << ioSettings.mLevel;
+	ioArchive << ioSettings.mBlockSize;
+	ioArchive << ioSettings.mUncompressedBytes;
+	ioArchive << ioSettings.mCompressedBytes;
+
+	return ioArchive;
+}
+
+
+
+FArchive& operator<<(FArchive& ioArchive, FPathHistoryFile::FChunkHeader& ioChunkHeader)
+{
+	ioArchive << ioChunkHeader.mMagic;
+	ioArchive << ioChunkHeader.mGenerationNumber;
+	ioArchive << ioChunkHeader.mIslandIndex;
+	ioArchive << ioChunkHeader.mUncompressedSize;
+	ioArchive << ioChunkHeader.mCompressedSize;
+	ioArchive << ioChunkHeader.mCrc;
+
+	return ioArchive;
+}
+
+
+
+FArchive& operator<<(FArchive& ioArchive, FPathHistoryFile::FIndexEntry& ioIndexEntry)
+{
+	ioArchive << ioIndexEntry.mOffset;
+	ioArchive << ioIndexEntry.mGenerationNumber;
+	ioArchive << ioIndexEntry.mIslandIndex;
+
+	return ioArchive;
+}
+
+
+
+FArchive& operator<<(FArchive& ioArchive, FPathHistoryFile::FFooter& ioFooter)
+{
+	ioArchive << ioFooter.mIndexOffset;
+	ioArchive << ioFooter.mMagic;
+
+	return ioArchive;
+}
+
+
+
+FString FPathHistoryFile::GetDefaultDirectory()
+{
+	return FPaths::GameSavedDir() / TEXT("PathHistory");
+}
+
+
+
+/**
+* Every run gets a file of its own, named after the moment it started, so a run never overwrites a file that is still being saved
+*/
+FString FPathHistoryFile::MakeRunFilePath(const FString& inDirectory)
+{
+	return inDirectory / FString::Printf(TEXT("Paths_%s.ga"), *FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S-%s")));
+}
+
+
+
+/**
+* Returns the most recently written .ga file in the directory, or an empty string if there is none
+*/
+FString FPathHistoryFile::FindLatestFile(const FString& inDirectory)
+{
+	IFileManager& file_manager = IFileManager::Get();
+
+	TArray<FString> file_names;
+	file_manager.FindFiles(file_names, *(inDirectory / TEXT("*.ga")), true, false);
+
+	FString latest_file_path;
+	FDateTime latest_time_stamp = FDateTime::MinValue();
+
+	for (const FString& file_name : file_names)
+	{
+		const FString file_path = inDirectory / file_name;
+		const FDateTime time_stamp = file_manager.GetTimeStamp(*file_path);
+
+		if (time_stamp > latest_time_stamp)
+		{
+			latest_time_stamp = time_stamp;
+			latest_file_path = file_path;
+		}
+	}
+
+	return latest_file_path;
+}
+
+
+
+/**
+* Writes a history that is already in memory, one chunk per generation, as if it had been streamed
+*/
+bool FPathHistoryFile::Save(const FGenerationHistory& inHistory, const int32 inPopulationCount, const FString& inFilePath)
+{
+	FPathHistoryWriter writer;
+	if (!writer.Open(inFilePath, inPopulationCount))
+		return false;
+
+	bool has_saved = true;
+	for (const FGenerationSerializationData& generation : inHistory)
+		has_saved &= writer.Append(generation);
+
+	writer.Close();
+
+	return has_saved;
+}
+
+
+
+/**
+* Files written before the chunked format have no header, they start with the compressed archive right away
+*/
+bool FPathHistoryFile::IsLegacyFile(const FString& inFilePath)
+{
+	TUniquePtr<FArchive> reader(IFileManager::Get().CreateFileReader(*inFilePath));
+	if (!reader.IsValid() || reader->TotalSize() < (int64)sizeof(uint32))
+		return false;
+
+	uint32 magic = 0;
+	*reader << magic;
+
+	return magic != FileMagic;
+}
+
+
+
+/**
+* Rewrites a version 1 file in the latest format, which has to decode the whole legacy file once
+* The paths may be the same, the converted file is only moved over the legacy file once it has been written completely
+*/
+bool FPathHistoryFile::ConvertLegacyFile(const FString& inLegacyFilePath, const FString& inFilePath)
+{
+	FGenerationHistory history;
+	int32 population_count = 0;
+
+	TArray<uint8> compressed_data;
+	if (!FFileHelper::LoadFileToArray(compressed_data, *inLegacyFilePath) || !LoadLegacy(compressed_data, history, population_count))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FPathHistoryFile::ConvertLegacyFile >> Unable to read %s!"), *inLegacyFilePath);
+		return false;
+	}
+
+	compressed_data.Empty();
+
+	const FString temporary_file_path = inFilePath + TEXT(".tmp");
+	if (!Save(history, population_count, temporary_file_path))
+		return false;
+
+	return IFileManager::Get().Move(*inFilePath, *temporary_file_path, true);
+}
+
+
+
+/**
+* Serializes a single generation in either direction, this is the uncompressed contents of a chunk
+* inVersion is the version of the file, generations are always written in the latest version
+*/
+void FPathHistoryFile::SerializeGeneration(FArchive& ioArchive, FGenerationSerializationData& ioGeneration, const int32 inVersion, const FPathQuantization& inQuantization, FPathQuantizationStats* ioStats)
+{
+	SerializeGenerationInfo(ioArchive, ioGeneration.mGenerationInfo);
+
+	if (inVersion >= 8)
+		SerializePhaseTimings(ioArchive, ioGeneration.mGenerationInfo.mPhaseTimings);
+
+	TArray<FPathSerializationData>& paths = ioGeneration.mPathSerializationData;
+
+	int32 path_amount = paths.Num();
+	ioArchive << path_amount;
+
+	if (ioArchive.IsLoading())
+		paths.SetNum(path_amount);
+
+	for (FPathSerializationData& path : paths)
+	{
+		ioArchive << path.mNodeAmount;
+		inQuantization.SerializeGenome(ioArchive, path.mGeneticRepresentation, ioStats);
+		ioArchive << path.mColor;
+		ioArchive << path.mFittest;
+	}
+}
+
+
+
+/**
+* Keyframe and delta chunks both start with the generation info
+*/
+void FPathHistoryFile::SerializeGenerationInfo(FArchive& ioArchive, FGenerationInfo& ioGenerationInfo)
+{
+	FGenerationInfo& info = ioGenerationInfo;
+
+	ioArchive << info.mGenerationNumber;
+	ioArchive << info.mCrossoverAmount;
+	ioArchive << info.mAmountOfTranslationMutations;
+	ioArchive << info.mAmountOfInsertionMutations;
+	ioArchive << info.mAmountOfDeletionMutations;
+	ioArchive << info.mAverageFitness;
+	ioArchive << info.mMaximumFitness;
+	ioArchive << info.mFitnessFactor;
+	ioArchive << info.mAverageAmountOfNodes;
+	ioArchive << info.mBestFitness;
+	ioArchive << info.mDiversity;
+	ioArchive << info.mFrameCount;
+	ioArchive << info.mImmigrantAmount;
+}
+
+
+
+void FPathHistoryFile::SerializePhaseTimings(FArchive& ioArchive, FGenerationPhaseTimings& ioPhaseTimings)
+{
+	ioArchive << ioPhaseTimings.mEvaluateParents;
+	ioArchive << ioPhaseTimings.mSelection;
+	ioArchive << ioPhaseTimings.mCrossover;
+	ioArchive << ioPhaseTimings.mMutation;
+	ioArchive << ioPhaseTimings.mEvaluateOffspring;
+}
+
+
+
+void FPathHistoryFile::SerializeDeltas(FArchive& ioArchive, TArray<FPathDelta>& ioDeltas, const FPathQuantization& inQuantization, FPathQuantizationStats* ioStats)
+{
+	int32 delta_amount = ioDeltas.Num();
+	ioArchive << delta_amount;
+
+	if (ioArchive.IsLoading())
+	{
+		if (delta_amount < 0)
+		{
+			ioArchive.SetError();
+			return;
+		}
+
+		ioDeltas.SetNum(delta_amount, false);
+	}
+
+	for (FPathDelta& delta : ioDeltas)
+		delta.Serialize(ioArchive, inQuantization, ioStats);
+}
+
+
+
+/**
+* Serializes the generation into the scratch buffer and compresses it into outCompressed
+* Both buffers are reused, so callers that compress many generations should hold on to them
+*/
+bool FPathHistoryFile::CompressGeneration(const FGenerationSerializationData& inGeneration, const FPathQuantization& inQuantization, const FCompressionSettings& inCompression, TArray<uint8>& ioScratch, TArray<uint8>& outCompressed, int32& outUncompressedSize, FPathQuantizationStats* ioStats)
+{
+	ioScratch.Reset();
+
+	// Saving does not change the generation
+	FMemoryWriter writer(ioScratch);
+	SerializeGeneration(writer, const_cast<FGenerationSerializationData&>(inGeneration), LatestVersion, inQuantization, ioStats);
+
+	outUncompressedSize = ioScratch.Num();
+
+	return CompressScratch(ioScratch, inCompression, outCompressed);
+}
+
+
+
+/**
+* Same as CompressGeneration, for the deltas of a generation to the generation stored before it
+*/
+bool FPathHistoryFile::CompressGenerationDelta(const FGenerationInfo& inGenerationInfo, const TArray<FPathDelta>& inDeltas, const FPathQuantization& inQuantization, const FCompressionSettings& inCompression, TArray<uint8>& ioScratch, TArray<uint8>& outCompressed, int32& outUncompressedSize, FPathQuantizationStats* ioStats)
+{
+	ioScratch.Reset();
+
+	// Saving does not change the info nor the deltas
+	FMemoryWriter writer(ioScratch);
+	SerializeGenerationInfo(writer, const_cast<FGenerationInfo&>(inGenerationInfo));
+	SerializePhaseTimings(writer, const_cast<FGenerationPhaseTimings&>(inGenerationInfo.mPhaseTimings));
+	SerializeDeltas(writer, const_cast<TArray<FPathDelta>&>(inDeltas), inQuantization, ioStats);
+
+	outUncompressedSize = ioScratch.Num();
+
+	return CompressScratch(ioScratch, inCompression, outCompressed);
+}
+
+
+
+bool FPathHistoryFile::DecompressGeneration(const uint8* inCompressed, const FChunkHeader& inChunkHeader, const int32 inVersion, const FPathQuantization& inQuantization, const FCompressionSettings& inCompression, TArray<uint8>& ioScratch, FGenerationSerializationData& outGeneration)
+{
+	if (!DecompressScratch(inCompressed, inChunkHeader, inCompression, ioScratch))
+		return false;
+
+	FMemoryReader reader(ioScratch);
+	SerializeGeneration(reader, outGeneration, inVersion, inQuantization);
+
+	return !reader.IsError();
+}
+
+
+
+/**
+* Rebuilds the generation of a delta chunk, inReference has to be the generation of the chunk before it
+*/
+bool FPathHistoryFile::DecompressGenerationDelta(const uint8* inCompressed, const FChunkHeader& inChunkHeader, const int32 inVersion, const FPathQuantization& inQuantization, const FCompressionSettings& inCompression, const FGenerationSerializationData& inReference, TArray<uint8>& ioScratch, TArray<FPathDelta>& ioDeltas, FGenerationSerializationData& outGeneration)
+{
+	if (!DecompressScratch(inCompressed, inChunkHeader, inCompression, ioScratch))
+		return false;
+
+	FMemoryReader reader(ioScratch);
+	SerializeGenerationInfo(reader, outGeneration.mGenerationInfo);
+
+	if (inVersion >= 8)
+		SerializePhaseTimings(reader, outGeneration.mGenerationInfo.mPhaseTimings);
+
+	SerializeDeltas(reader, ioDeltas, inQuantization);
+
+	return !reader.IsError() && FPathHistoryDelta::Apply(inReference, ioDeltas, outGeneration);
+}
+
+
+
+/**
+* A lineage block holds the amount of records of every generation in it, followed by all records back to back
+*/
+bool FPathHistoryFile::CompressLineage(const TArray<int32>& inRecordAmounts, const TArray<FPathLineageRecord>& inRecords, const FCompressionSettings& inCompression, TArray<uint8>& ioScratch, TArray<uint8>& outCompressed, int32& outUncompressedSize)
+{
+	ioScratch.Reset();
+
+	FMemoryWriter writer(ioScratch);
+
+	int32 generation_amount = inRecordAmounts.Num();
+	writer << generation_amount;
+
+	for (int32 record_amount : inRecordAmounts)
+		writer << record_amount;
+
+	for (const FPathLineageRecord& record : inRecords)
+		writer << const_cast<FPathLineageRecord&>(record);
+
+	outUncompressedSize = ioScratch.Num();
+
+	return CompressScratch(ioScratch, inCompression, outCompressed);
+}
+
+
+
+bool FPathHistoryFile::DecompressLineage(const uint8* inCompressed, const FChunkHeader& inChunkHeader, const FCompressionSettings& inCompression, TArray<uint8>& ioScratch, TArray<int32>& outRecordAmounts, TArray<FPathLineageRecord>& outRecords)
+{
+	if (!DecompressScratch(inCompressed, inChunkHeader, inCompression, ioScratch))
+		return false;
+
+	FMemoryReader reader(ioScratch);
+
+	int32 generation_amount = 0;
+	reader << generation_amount;
+
+	if (generation_amount < 0 || generation_amount > ioScratch.Num() / (int32)sizeof(int32))
+		return false;
+
+	outRecordAmounts.SetNum(generation_amount, false);
+
+	int32 total_record_amount = 0;
+	for (int32& record_amount : outRecordAmounts)
+	{
+		reader << record_amount;
+		total_record_amount += FMath::Max(record_amount, 0);
+	}
+
+	if (reader.IsError() || reader.TotalSize() - reader.Tell() != (int64)total_record_amount * FPathLineageRecord::SerializedSize)
+		return false;
+
+	outRecords.SetNum(total_record_amount, false);
+	for (FPathLineageRecord& record : outRecords)
+		reader << record;
+
+	return !reader.IsError();
+}
+
+
+
+namespace
+{
+	/**
+	* Spreads the blocks of a payload over the task graph, a single block stays on the calling thread
+	*/
+	const auto ParallelForBlocks = [](const int32 inBlockAmount, TFunctionRef<void(int32)> inBody)
+	{
+		ParallelFor(inBlockAmount, inBody, inBlockAmount <= 1);
+	};
+}
+
+
+
+/**
+* Compresses the blocks of the payload in parallel, the kernel is shared with Tools/GaBench, see PathHistoryKernels.h
+*/
+bool FPathHistoryFile::CompressScratch(const TArray<uint8>& inScratch, const FCompressionSettings& inCompression, TArray<uint8>& outCompressed)
+{
+	const int32 block_size = inCompression.HasBlocks() ? inCompression.mBlockSize : 0;
+
+	int32 compressed_size = PathHistoryKernels::GetCompressBound(inScratch.Num(), inCompression.mLevel, block_size);
+	outCompressed.SetNum(compressed_size, false);
+
+	if (!PathHistoryKernels::CompressBlocks(inScratch.GetData(), inScratch.Num(), inCompression.mLevel, block_size, outCompressed.GetData(), compressed_size, ParallelForBlocks))
+		return false;
+
+	outCompressed.SetNum(compressed_size, false);
+	return true;
+}
+
+
+
+/**
+* Inflates the blocks of the payload in parallel, every block straight into its place in the scratch buffer
+*/
+bool FPathHistoryFile::DecompressScratch(const uint8* inCompressed, const FChunkHeader& inChunkHeader, const FCompressionSettings& inCompression, TArray<uint8>& ioScratch)
+{
+	if (inChunkHeader.mUncompressedSize < 0 || inChunkHeader.mCompressedSize < 0)
+		return false;
+
+	ioScratch.SetNum(inChunkHeader.mUncompressedSize, false);
+
+	const int32 block_size = inCompression.HasBlocks() ? inCompression.mBlockSize : 0;
+
+	TArray<int32, TInlineAllocator<65>> block_offsets;
+	block_offsets.SetNumUninitialized(PathHistoryKernels::GetBlockAmount(inChunkHeader.mUncompressedSize, block_size) + 1);
+
+	return PathHistoryKernels::InflateBlocks(inCompressed, inChunkHeader.mCompressedSize, block_size, ioScratch.GetData(), inChunkHeader.mUncompressedSize, block_offsets.GetData(), ParallelForBlocks);
+}
+
+
+
+bool FPathHistoryFile::LoadLegacy(const TArray<uint8>& inCompressedData, FGenerationHistory& outHistory, int32& outPopulationCount)
+{
+	FArchiveLoadCompressedProxy decompressor = FArchiveLoadCompressedProxy(inCompressedData, ECompressionFlags::COMPRESS_ZLIB);
+	
+	FBufferArchive decompressed_data;
+	decompressor << decompressed_data;
+
+	FMemoryReader from_binary = FMemoryReader(decompressed_data, true);
+	from_binary.Seek(0);
+
+	// Restore settings from data
+	{
+		outHistory.Reset();
+
+		int32 total_amount_of_generations = 0;
+		from_binary << total_amount_of_generations;
+
+		int32 population_size = 0;
+		from_binary << population_size;
+
+		outHistory.Reserve(total_amount_of_generations);
+		outPopulationCount = population_size;
+
+		for (int32 generation_index = 0; generation_index < total_amount_of_generations; ++generation_index) // Iterate per generation
+		{
+			FGenerationSerializationData generation_data;
+
+			TArray<FPathSerializationData>& all_paths = generation_data.mPathSerializationData;
+
+			for (int32 path_index = 0; path_index < population_size; ++path_index) // Iterate per path
+			{
+				// Start filling up the DeserializationData array with the deserialized data
+				FPathSerializationData deserialized_path_data;
+				from_binary << deserialized_path_data.mNodeAmount;
+
+				deserialized_path_data.mGeneticRepresentation.Reserve(deserialized_path_data.mNodeAmount);
+
+				for (int32 location_index = 0; location_index < deserialized_path_data.mNodeAmount; ++location_index) // Iterate per chromosome
+				{
+					FVector node_location;
+					from_binary << node_location;
+
+					deserialized_path_data.mGeneticRepresentation.Add(node_location);
+				}
+
+				from_binary << deserialized_path_data.mColor;
+				from_binary << deserialized_path_data.mFittest;
+
+				all_paths.Add(deserialized_path_data);
+			}
+
+			from_binary << generation_data.mGenerationInfo.mAmountOfDeletionMutations;
+			from_binary << generation_data.mGenerationInfo.mAmountOfInsertionMutations;
+			from_binary << generation_data.mGenerationInfo.mAmountOfTranslationMutations;
+			from_binary << generation_data.mGenerationInfo.mAverageAmountOfNodes;
+			from_binary << generation_data.mGenerationInfo.mAverageFitness;
+			from_binary << generation_data.mGenerationInfo.mCrossoverAmount;
+			from_binary << generation_data.mGenerationInfo.mFitnessFactor;
+			from_binary << generation_data.mGenerationInfo.mGenerationNumber;
+			from_binary << generation_data.mGenerationInfo.mMaximumFitness;
+
+			outHistory.Add(generation_data);
+		}
+	}
+
+	decompressor.FlushCache();
+	from_binary.FlushCache();
+
+	decompressed_data.Empty();
+	decompressed_data.Close();
+
+	return true;
+}
@@ -0,0 +1,157 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// API includes
+#include "PathGenerationData.h"
+#include "PathHistoryDelta.h"
+#include "PathLineage.h"
+
+/**
+* Reads and writes the history of a path run, the .ga file
+*
+* Since version 2 the file starts with a small header, followed by one independently compressed chunk per stored generation
+* Chunks are appended by FPathHistoryWriter while the run is going, a file cut short by a crash is read up to its last complete chunk
+* Island runs write a chunk per island per stored generation, the islands are combined again when the file is read
+*
+* Since version 3 closing the file appends an index with the offset of every chunk, followed by a footer pointing at the index
+* FPathHistoryReader uses it to decode single generations on demand, files without an index have theirs rebuilt by scanning the chunk headers
+*
+* Since version 4 only keyframe chunks hold whole generations, the chunks in between hold the deltas to the chunk before them
+* A delta describes every path by its parents in the previous stored generation, see FPathHistoryDelta
+* Delta chunks are told apart by their magic, so the chunk header and the index are unchanged
+*
+* Since version 5 the header is followed by the quantization of the file, genomes of quantized files are stored in fixed point
+* Files compacted by FPathHistoryRetention hold generations of a single path in between the full ones, the header holds the full population count
+*
+* Since version 6 the lineage of every generation is stored alongside, including the generations that were not stored themselves
+* Lineage chunks hold a block of consecutive generations of a single island, one fixed size FPathLineageRecord per path
+* Their island index is stored as -1 - island, so readers that only look for generations skip them in the index
+*
+* Since version 7 the quantization is followed by the compression settings of the file, see FCompressionSettings
+* The payload of every chunk is split into blocks of a fixed uncompressed size, which are compressed independently of each other
+* The payload starts with the compressed size of every block, followed by the blocks, a block as large as its uncompressed data is stored as is
+* Before version 7 every payload is a single zlib stream
+*
+* Since version 8 the generation info of keyframe and delta chunks is followed by the time every phase of the algorithm took
+*
+* Version 1 files are a single zlib compressed archive holding the amount of stored generations and the population count,
+* followed by every path of every generation and the generation info, they can only be loaded as a whole or converted
+*/
+class GENETICTRIANGLES_API FPathHistoryFile
+{
+public:
+	static const uint32 FileMagic = 0x46484147; // "GAHF"
+	static const uint32 ChunkMagic = 0x4B484347; // "GCHK"
+	static const uint32 DeltaChunkMagic = 0x544C4447; // "GDLT"
+	static const uint32 LineageChunkMagic = 0x4E494C47; // "GLIN"
+	static const uint32 IndexMagic = 0x58444947; // "GIDX"
+	static const uint32 FooterMagic = 0x444E4547; // "GEND"
+	static const int32 LatestVersion = 8;
+
+	struct FHeader
+	{
+		uint32 mMagic = FileMagic;
+		int32 mVersion = LatestVersion;
+		int32 mPopulationCount = 0; ///< Paths per stored generation, over all islands
+		int32 mIslandCount = 1;
+
+		static const int32 SerializedSize = 4 * sizeof(int32);
+
+		friend FArchive& operator<<(FArchive& ioArchive, FHeader& ioHeader);
+	};
+
+	/**
+	* How the chunks of a file are compressed, the totals are only filled in once the file has been closed
+	*/
+	struct FCompressionSettings
+	{
+		int32 mLevel = DefaultCompressionLevel; ///< 0 stores every block as is, 1 to 9 are the zlib levels
+		int32 mBlockSize = DefaultBlockSize; ///< Uncompressed bytes per block, 0 or less compresses every payload as a single stream
+		int64 mUncompressedBytes = 0; ///< Of the payloads of all chunks
+		int64 mCompressedBytes = 0;
+
+		static const int32 DefaultCompressionLevel = 6;
+		static const int32 DefaultBlockSize = 32 * 1024; ///< The window of zlib, smaller blocks would start to cost compression ratio
+		static const int32 SerializedSize = 2 * sizeof(int32) + 2 * sizeof(int64);
+
+		bool IsStored() const { return mLevel <= 0; }
+		bool HasBlocks() const { return mBlockSize > 0; }
+		int32 GetBlockAmount(const int32 inUncompressedSize) const { return HasBlocks() ? FMath::DivideAndRoundUp(inUncompressedSize, mBlockSize) : 1; }
+		float GetRatio() const { return mUncompressedBytes > 0 ? (float)((double)mCompressedBytes / (double)mUncompressedBytes) : 0.0f; } ///< 0 while unknown
+
+		friend FArchive& operator<<(FArchive& ioArchive, FCompressionSettings& ioSettings);
+	};
+
+	struct FChunkHeader
+	{
+		uint32 mMagic = ChunkMagic; ///< DeltaChunkMagic for delta chunks
+		int32 mGenerationNumber = 0;
+		int32 mIslandIndex = 0;
+		int32 mUncompressedSize = 0;
+		int32 mCompressedSize = 0;
+		uint32 mCrc = 0; ///< Of the compressed data, catches a chunk that was only partly written
+
+		static const int32 SerializedSize = 6 * sizeof(int32);
+
+		bool IsValid() const { return mMagic == ChunkMagic || mMagic == DeltaChunkMagic; }
+		bool IsDelta() const { return mMagic == DeltaChunkMagic; }
+		bool IsLineage() const { return mMagic == LineageChunkMagic; }
+
+		static int32 GetLineageIslandIndex(const int32 inIslandIndex) { return -1 - inIslandIndex; } ///< Converts in both directions
+
+		friend FArchive& operator<<(FArchive& ioArchive, FChunkHeader& ioChunkHeader);
+	};
+
+	struct FIndexEntry
+	{
+		int64 mOffset = 0; ///< Of the chunk header
+		int32 mGenerationNumber = 0;
+		int32 mIslandIndex = 0;
+
+		static const int32 SerializedSize = sizeof(int64) + 2 * sizeof(int32);
+
+		friend FArchive& operator<<(FArchive& ioArchive, FIndexEntry& ioIndexEntry);
+	};
+
+	/**
+	* Last bytes of the file, only present once the file has been closed properly
+	*/
+	struct FFooter
+	{
+		int64 mIndexOffset = 0;
+		uint32 mMagic = FooterMagic;
+
+		static const int32 SerializedSize = sizeof(int64) + sizeof(uint32);
+
+		friend FArchive& operator<<(FArchive& ioArchive, FFooter& ioFooter);
+	};
+
+public:
+	static FString GetDefaultDirectory();
+	static FString MakeRunFilePath(const FString& inDirectory);
+	static FString FindLatestFile(const FString& inDirectory);
+
+	static bool Save(const FGenerationHistory& inHistory, const int32 inPopulationCount, const FString& inFilePath);
+
+	static bool IsLegacyFile(const FString& inFilePath);
+	static bool ConvertLegacyFile(const FString& inLegacyFilePath, const FString& inFilePath);
+
+	static void SerializeGeneration(FArchive& ioArchive, FGenerationSerializationData& ioGeneration, const int32 inVersion, const FPathQuantization& inQuantization, FPathQuantizationStats* ioStats = nullptr);
+	static void SerializeGenerationInfo(FArchive& ioArchive, FGenerationInfo& ioGenerationInfo);
+	static void SerializePhaseTimings(FArchive& ioArchive, FGenerationPhaseTimings& ioPhaseTimings);
+	static void SerializeDeltas(FArchive& ioArchive, TArray<FPathDelta>& ioDeltas, const FPathQuantization& inQuantization, FPathQuantizationStats* ioStats = nullptr);
+	static bool CompressGeneration(const FGenerationSerializationData& inGeneration, const FPathQuantization& inQuantization, const FCompressionSettings& inCompression, TArray<uint8>& ioScratch, TArray<uint8>& outCompressed, int32& outUncompressedSize, FPathQuantizationStats* ioStats = nullptr);
+	static bool CompressGenerationDelta(const FGenerationInfo& inGenerationInfo, const TArray<FPathDelta>& inDeltas, const FPathQuantization& inQuantization, const FCompressionSettings& inCompression, TArray<uint8>& ioScratch, TArray<uint8>& outCompressed, int32& outUncompressedSize, FPathQuantizationStats* ioStats = nullptr);
+	static bool DecompressGeneration(const uint8* inCompressed, const FChunkHeader& inChunkHeader, const int32 inVersion, const FPathQuantization& inQuantization, const FCompressionSettings& inCompression, TArray<uint8>& ioScratch, FGenerationSerializationData& outGeneration);
+	static bool DecompressGenerationDelta(const uint8* inCompressed, const FChunkHeader& inChunkHeader, const int32 inVersion, const FPathQuantization& inQuantization, const FCompressionSettings& inCompression, const FGenerationSerializationData& inReference, TArray<uint8>& ioScratch, TArray<FPathDelta>& ioDeltas, FGenerationSerializationData& outGeneration);
+	static bool CompressLineage(const TArray<int32>& inRecordAmounts, const TArray<FPathLineageRecord>& inRecords, const FCompressionSettings& inCompression, TArray<uint8>& ioScratch, TArray<uint8>& outCompressed, int32& outUncompressedSize);
+	static bool DecompressLineage(const uint8* inCompressed, const FChunkHeader& inChunkHeader, const FCompressionSettings& inCompression, TArray<uint8>& ioScratch, TArray<int32>& outRecordAmounts, TArray<FPathLineageRecord>& outRecords);
+
+	static bool CompressScratch(const TArray<uint8>& inScratch, const FCompressionSettings& inCompression, TArray<uint8>& outCompressed);
+	static bool DecompressScratch(const uint8* inCompressed, const FChunkHeader& inChunkHeader, const FCompressionSettings& inCompression, TArray<uint8>& ioScratch);
+
+private:
+
+	static bool LoadLegacy(const TArray<uint8>& inCompressedData, FGenerationHistory& outHistory, int32& outPopulationCount);
+};
@@ -0,0 +1,395 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#include "zlib.h"
+
+/**
+* The history encoding without the engine, included by FPathHistoryDelta and FPathHistoryFile as well as by Tools/GaBench
+* This way the benchmarks time the code the game runs, so only the standard library and zlib may be used here
+*
+* Chromosomes are compared and hashed bit for bit, so TVector may be any type of three floats
+*/
+namespace PathHistoryKernels
+{
+	const int32_t IndexNone = -1;
+	const int32_t MaxCandidateAmount = 16; ///< Parents compared per path when the lineage is unknown
+
+	/**
+	* The chromosomes of a single genome, without owning them
+	*/
+	template <typename TVector>
+	struct TGenomeView
+	{
+		const TVector* mData = nullptr;
+		int32_t mNum = 0;
+
+		TGenomeView() { }
+		TGenomeView(const TVector* inData, const int32_t inNum) : mData(inData), mNum(inNum) { }
+	};
+
+
+
+	template <typename TVector>
+	bool IsSameChromosome(const TVector& inLhs, const TVector& inRhs)
+	{
+		return std::memcmp(&inLhs, &inRhs, sizeof(TVector)) == 0;
+	}
+
+
+
+	template <typename TVector>
+	bool IsSameGenome(const TGenomeView<TVector>& inLhs, const TGenomeView<TVector>& inRhs)
+	{
+		return inLhs.mNum == inRhs.mNum && (inLhs.mNum == 0 || std::memcmp(inLhs.mData, inRhs.mData, inLhs.mNum * sizeof(TVector)) == 0);
+	}
+
+
+
+	template <typename TVector>
+	uint32_t HashGenome(const TGenomeView<TVector>& inGenome)
+	{
+		return (uint32_t)crc32(0, reinterpret_cast<const Bytef*>(inGenome.mData), (uInt)(inGenome.mNum * sizeof(TVector)));
+	}
+
+
+
+	template <typename TVector>
+	uint32_t HashChromosome(const TVector& inChromosome, const int32_t inPosition)
+	{
+		return (uint32_t)crc32((uLong)inPosition, reinterpret_cast<const Bytef*>(&inChromosome), (uInt)sizeof(TVector));
+	}
+
+
+
+	template <typename TVector>
+	int32_t GetPrefixLength(const TGenomeView<TVector>& inParentGenes, const TGenomeView<TVector>& inGenes)
+	{
+		const int32_t shared_amount = std::min(inParentGenes.mNum, inGenes.mNum);
+
+		int32_t prefix_length = 0;
+		while (prefix_length < shared_amount && IsSameChromosome(inParentGenes.mData[prefix_length], inGenes.mData[prefix_length]))
+			++prefix_length;
+
+		return prefix_length;
+	}
+
+
+
+	template <typename TVector>
+	int32_t GetMatchAmount(const TGenomeView<TVector>& inParentGenes, const TGenomeView<TVector>& inGenes, const int32_t inStart)
+	{
+		const int32_t shared_amount = std::min(inParentGenes.mNum, inGenes.mNum);
+
+		int32_t matches = 0;
+		for (int32_t j = inStart; j < shared_amount; ++j)
+		{
+			if (IsSameChromosome(inParentGenes.mData[j], inGenes.mData[j]))
+				++matches;
+		}
+
+		return matches;
+	}
+
+
+
+	/**
+	* Lists every parent under the hash of its genome and under the hash of every chromosome together with its position
+	* TParentLookup needs AddGenome and AddChromosome taking a hash and a parent index, inGetParentGenes returns the TGenomeView of a parent
+	*/
+	template <typename TVector, typename TGetParentGenes, typename TParentLookup>
+	void BuildParentLookup(const int32_t inParentAmount, TGetParentGenes inGetParentGenes, TParentLookup& ioLookup)
+	{
+		for (int32_t i = 0; i < inParentAmount; ++i)
+		{
+			const TGenomeView<TVector> parent_genes = inGetParentGenes(i);
+			ioLookup.AddGenome(HashGenome(parent_genes), i);
+
+			for (int32_t j = 0; j < parent_genes.mNum; ++j)
+				ioLookup.AddChromosome(HashChromosome(parent_genes.mData[j], j), i);
+		}
+	}
+
+
+
+	/**
+	* Recovers the parents of a path from its chromosomes, exact copies are looked up through the hash of their genome
+	* Otherwise the first parent is the candidate sharing the longest prefix among the parents sharing the chromosome after the start,
+	* the second the candidate sharing the most chromosomes after that prefix among the parents sharing the chromosome at the crossover index
+	* At most MaxCandidateAmount parents are compared for either, a path without any candidate gets no parents and stores every chromosome
+	*
+	* TParentLookup needs ForEachGenome and ForEachChromosome, which pass the parents listed under a hash to a visitor until it returns false
+	*/
+	template <typename TVector, typename TGetParentGenes, typename TParentLookup>
+	void FindParents(const TGenomeView<TVector>& inGenes, TGetParentGenes inGetParentGenes, const TParentLookup& inLookup, int32_t& outFirstParent, int32_t& outSecondParent)
+	{
+		outFirstParent = IndexNone;
+		outSecondParent = IndexNone;
+
+		inLookup.ForEachGenome(HashGenome(inGenes), [&](const int32_t inParentIndex)
+		{
+			if (!IsSameGenome(inGetParentGenes(inParentIndex), inGenes))
+				return true;
+
+			outFirstParent = inParentIndex;
+			outSecondParent = inParentIndex;
+			return false;
+		});
+
+		if (outFirstParent != IndexNone || inGenes.mNum == 0)
+			return;
+
+		// Every path shares the starting chromosome, so the first one to tell the parents apart is the one after it
+		const int32_t first_position = std::min(1, inGenes.mNum - 1);
+
+		int32_t crossover_index = 0;
+		int32_t candidate_amount = 0;
+		inLookup.ForEachChromosome(HashChromosome(inGenes.mData[first_position], first_position), [&](const int32_t inParentIndex)
+		{
+			const int32_t prefix_length = GetPrefixLength(inGetParentGenes(inParentIndex), inGenes);
+			if (outFirstParent == IndexNone || prefix_length > crossover_index)
+			{
+				outFirstParent = inParentIndex;
+				crossover_index = prefix_length;
+			}
+
+			return ++candidate_amount < MaxCandidateAmount;
+		});
+
+		// A mutated copy keeps the first parent for both
+		outSecondParent = outFirstParent;
+		if (crossover_index >= inGenes.mNum)
+			return;
+
+		int32_t most_matches = outFirstParent != IndexNone ? GetMatchAmount(inGetParentGenes(outFirstParent), inGenes, crossover_index) : -1;
+
+		candidate_amount = 0;
+		inLookup.ForEachChromosome(HashChromosome(inGenes.mData[crossover_index], crossover_index), [&](const int32_t inParentIndex)
+		{
+			const int32_t matches = GetMatchAmount(inGetParentGenes(inParentIndex), inGenes, crossover_index);
+			if (matches > most_matches)
+			{
+				outSecondParent = inParentIndex;
+				most_matches = matches;
+			}
+
+			return ++candidate_amount < MaxCandidateAmount;
+		});
+
+		// Without a first parent the prefix is empty, so the second parent explains everything it can
+		if (outFirstParent == IndexNone)
+			outFirstParent = outSecondParent;
+	}
+
+
+
+	/**
+	* Describes a path by its parents among inParentAmount parents, inFirstParentHint and inSecondParentHint are the parents the lineage recorded
+	* A path without a valid first parent goes through FindParents, the lookup is only built once such a path comes up
+	* The chromosomes of the first parent reach up to the longest prefix they share with the path,
+	* inAddMutation receives the position of every chromosome the second parent does not explain after it
+	* Besides what BuildParentLookup and FindParents need, TParentLookup has an mIsBuilt flag, returns the crossover index
+	*/
+	template <typename TVector, typename TGetParentGenes, typename TParentLookup, typename TAddMutation>
+	int32_t EncodePath(const TGenomeView<TVector>& inGenes, const int32_t inParentAmount, TGetParentGenes inGetParentGenes, TParentLookup& ioLookup,
+		const int32_t inFirstParentHint, const int32_t inSecondParentHint, int32_t outParentIndices[2], TAddMutation inAddMutation)
+	{
+		int32_t first_parent = inFirstParentHint;
+		int32_t second_parent = inSecondParentHint;
+
+		// Paths that were carried over as is only have a first parent, immigrants have none
+		if (first_parent < 0 || first_parent >= inParentAmount)
+		{
+			if (!ioLookup.mIsBuilt)
+			{
+				BuildParentLookup<TVector>(inParentAmount, inGetParentGenes, ioLookup);
+				ioLookup.mIsBuilt = true;
+			}
+
+			FindParents(inGenes, inGetParentGenes, ioLookup, first_parent, second_parent);
+		}
+		else if (second_parent < 0 || second_parent >= inParentAmount)
+		{
+			second_parent = first_parent;
+		}
+
+		outParentIndices[0] = first_parent;
+		outParentIndices[1] = second_parent;
+
+		const bool is_first_parent_valid = first_parent >= 0 && first_parent < inParentAmount;
+		const bool is_second_parent_valid = second_parent >= 0 && second_parent < inParentAmount;
+
+		const int32_t crossover_index = is_first_parent_valid ? GetPrefixLength(inGetParentGenes(first_parent), inGenes) : 0;
+		const TGenomeView<TVector> second_genes = is_second_parent_valid ? inGetParentGenes(second_parent) : TGenomeView<TVector>();
+
+		for (int32_t j = crossover_index; j < inGenes.mNum; ++j)
+		{
+			if (!is_second_parent_valid || j >= second_genes.mNum || !IsSameChromosome(second_genes.mData[j], inGenes.mData[j]))
+				inAddMutation(j);
+		}
+
+		return crossover_index;
+	}
+
+
+
+	/**
+	* Blocks of at most inBlockSize bytes, a block size of 0 or less compresses the payload as a single stream
+	*/
+	inline int32_t GetBlockAmount(const int32_t inSize, const int32_t inBlockSize)
+	{
+		return inBlockSize > 0 ? (inSize + inBlockSize - 1) / inBlockSize : 1;
+	}
+
+
+
+	/**
+	* The size CompressBlocks needs to compress inSize bytes into, every block is compressed into a slot of its own first
+	*/
+	inline int32_t GetCompressBound(const int32_t inSize, const int32_t inLevel, const int32_t inBlockSize)
+	{
+		if (inBlockSize <= 0)
+			return (int32_t)compressBound((uLong)inSize);
+
+		const int32_t block_bound = inLevel <= 0 ? inBlockSize : (int32_t)compressBound((uLong)inBlockSize);
+		return GetBlockAmount(inSize, inBlockSize) * ((int32_t)sizeof(int32_t) + block_bound);
+	}
+
+
+
+	/**
+	* Compresses a single zlib stream, level 0 stores the data inside the stream
+	*/
+	inline bool CompressStream(const uint8_t* inData, const int32_t inSize, const int32_t inLevel, uint8_t* outCompressed, int32_t& ioCompressedSize)
+	{
+		uLongf compressed_size = (uLongf)ioCompressedSize;
+		if (compress2(outCompressed, &compressed_size, inData, (uLong)inSize, std::min(std::max(inLevel, (int32_t)Z_NO_COMPRESSION), (int32_t)Z_BEST_COMPRESSION)) != Z_OK)
+			return false;
+
+		ioCompressedSize = (int32_t)compressed_size;
+		return true;
+	}
+
+
+
+	/**
+	* Splits the payload into blocks which are compressed through inParallelFor, then moves the blocks together behind the table of their sizes
+	* Blocks that would not shrink are stored as they are, so with blocks a payload can always be written
+	* outCompressed has to hold GetCompressBound bytes, ioCompressedSize receives the size that was used
+	*
+	* inParallelFor runs a body for every index below an amount, it may run them in any order and on any thread
+	*/
+	template <typename TParallelFor>
+	bool CompressBlocks(const uint8_t* inData, const int32_t inSize, const int32_t inLevel, const int32_t inBlockSize, uint8_t* outCompressed, int32_t& ioCompressedSize, TParallelFor inParallelFor)
+	{
+		if (inBlockSize <= 0)
+			return CompressStream(inData, inSize, inLevel, outCompressed, ioCompressedSize);
+
+		const int32_t block_amount = GetBlockAmount(inSize, inBlockSize);
+		const int32_t table_size = block_amount * (int32_t)sizeof(int32_t);
+		const int32_t block_bound = inLevel <= 0 ? inBlockSize : (int32_t)compressBound((uLong)inBlockSize);
+
+		if (ioCompressedSize < table_size + block_amount * block_bound)
+			return false;
+
+		// Every block writes its own entry of the table, so the blocks do not have to wait on the sizes of the blocks before them
+		inParallelFor(block_amount, [&](const int32_t inBlockIndex)
+		{
+			const int32_t block_offset = inBlockIndex * inBlockSize;
+			const int32_t block_size = std::min(inBlockSize, inSize - block_offset);
+			uint8_t* block_slot = outCompressed + table_size + inBlockIndex * block_bound;
+
+			int32_t compressed_size = block_bound;
+			if (inLevel <= 0 || !CompressStream(inData + block_offset, block_size, inLevel, block_slot, compressed_size) || compressed_size >= block_size)
+			{
+				std::memcpy(block_slot, inData + block_offset, block_size);
+				compressed_size = block_size;
+			}
+
+			std::memcpy(outCompressed + inBlockIndex * sizeof(int32_t), &compressed_size, sizeof(int32_t));
+		});
+
+		int32_t compressed_offset = table_size;
+		for (int32_t i = 0; i < block_amount; ++i)
+		{
+			int32_t compressed_size = 0;
+			std::memcpy(&compressed_size, outCompressed + i * sizeof(int32_t), sizeof(int32_t));
+
+			std::memmove(outCompressed + compressed_offset, outCompressed + table_size + i * block_bound, compressed_size);
+			compressed_offset += compressed_size;
+		}
+
+		ioCompressedSize = compressed_offset;
+		return true;
+	}
+
+
+
+	/**
+	* Inflates the blocks of the payload through inParallelFor, every block straight into its place in outData
+	* ioBlockOffsets has to hold GetBlockAmount + 1 entries, the offset of every block follows from the sizes of the blocks before it
+	*/
+	template <typename TParallelFor>
+	bool InflateBlocks(const uint8_t* inCompressed, const int32_t inCompressedSize, const int32_t inBlockSize, uint8_t* outData, const int32_t inSize, int32_t* ioBlockOffsets, TParallelFor inParallelFor)
+	{
+		if (inSize < 0 || inCompressedSize < 0)
+			return false;
+
+		if (inBlockSize <= 0)
+		{
+			uLongf uncompressed_size = (uLongf)inSize;
+			return uncompress(outData, &uncompressed_size, inCompressed, (uLong)inCompressedSize) == Z_OK && uncompressed_size == (uLongf)inSize;
+		}
+
+		const int32_t block_amount = GetBlockAmount(inSize, inBlockSize);
+		const int32_t table_size = block_amount * (int32_t)sizeof(int32_t);
+		if (inCompressedSize < table_size)
+			return false;
+
+		// The last offset is the end of the payload
+		ioBlockOffsets[0] = table_size;
+
+		for (int32_t i = 0; i < block_amount; ++i)
+		{
+			int32_t compressed_size = 0;
+			std::memcpy(&compressed_size, inCompressed + i * sizeof(int32_t), sizeof(int32_t));
+
+			const int32_t block_size = std::min(inBlockSize, inSize - i * inBlockSize);
+			if (compressed_size <= 0 || compressed_size > block_size || ioBlockOffsets[i] > inCompressedSize - compressed_size)
+				return false;
+
+			ioBlockOffsets[i + 1] = ioBlockOffsets[i] + compressed_size;
+		}
+
+		if (ioBlockOffsets[block_amount] != inCompressedSize)
+			return false;
+
+		std::atomic<int32_t> failed_block_amount(0);
+
+		inParallelFor(block_amount, [&](const int32_t inBlockIndex)
+		{
+			const int32_t block_offset = inBlockIndex * inBlockSize;
+			const int32_t block_size = std::min(inBlockSize, inSize - block_offset);
+			const int32_t compressed_size = ioBlockOffsets[inBlockIndex + 1] - ioBlockOffsets[inBlockIndex];
+			const uint8_t* compressed_block = inCompressed + ioBlockOffsets[inBlockIndex];
+
+			// A block as large as its uncompressed data is stored as is
+			if (compressed_size == block_size)
+			{
+				std::memcpy(outData + block_offset, compressed_block, block_size);
+				return;
+			}
+
+			uLongf uncompressed_size = (uLongf)block_size;
+			if (uncompress(outData + block_offset, &uncompressed_size, compressed_block, (uLong)compressed_size) != Z_OK || uncompressed_size != (uLongf)block_size)
+				++failed_block_amount;
+		});
+
+		return failed_block_amount.load() == 0;
+	}
+}
@@ -0,0 +1,488 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneticTriangles.h"
+#include "PathHistoryReader.h"
+
+#include "Serialization/BufferReader.h"
+
+#include "PathMigrationHub.h"
+
+FPathHistoryReader::FPathHistoryReader()
+{
+}
+
+
+
+FPathHistoryReader::~FPathHistoryReader()
+{
+	Close();
+}
+
+
+
+/**
+* Reads the header and the chunk index, version 1 files can not be opened and have to be converted first
+*/
+bool FPathHistoryReader::Open(const FString& inFilePath)
+{
+	Close();
+
+	if (!mView.Open(inFilePath))
+		return false;
+
+	if (!ReadStructure(0, FPathHistoryFile::FHeader::SerializedSize, mHeader) ||
+		mHeader.mMagic != FPathHistoryFile::FileMagic || mHeader.mVersion < 2 || mHeader.mVersion > FPathHistoryFile::LatestVersion || mHeader.mIslandCount < 1)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FPathHistoryReader::Open >> %s is not a supported history file, version 1 files have to be converted first"), *inFilePath);
+
+		Close();
+		return false;
+	}
+
+	mFirstChunkOffset = FPathHistoryFile::FHeader::SerializedSize;
+
+	if (mHeader.mVersion >= 5)
+	{
+		if (!ReadStructure(mFirstChunkOffset, FPathQuantization::SerializedSize, mQuantization))
+		{
+			Close();
+			return false;
+		}
+
+		mFirstChunkOffset += FPathQuantization::SerializedSize;
+	}
+
+	if (mHeader.mVersion >= 7)
+	{
+		if (!ReadStructure(mFirstChunkOffset, FPathHistoryFile::FCompressionSettings::SerializedSize, mCompression) || mCompression.mBlockSize < 0)
+		{
+			Close();
+			return false;
+		}
+
+		mFirstChunkOffset += FPathHistoryFile::FCompressionSettings::SerializedSize;
+	}
+	else
+	{
+		// Every payload is a single zlib stream
+		mCompression.mBlockSize = 0;
+	}
+
+	if (!mView.IsMapped())
+		UE_LOG(LogTemp, Display, TEXT("FPathHistoryReader::Open >> Unable to map %s, reading its chunks through the file instead"), *inFilePath);
+
+	TArray<FPathHistoryFile::FIndexEntry> index;
+	mHasIndex = ReadIndex(index);
+
+	if (!mHasIndex)
+	{
+		UE_LOG(LogTemp, Display, TEXT("FPathHistoryReader::Open >> %s has no index, the run did not finish cleanly. Rebuilding it from the chunks"), *inFilePath);
+		RebuildIndex(index);
+	}
+
+	mIslandChunkOffsets.SetNum(mHeader.mIslandCount);
+	for (const FPathHistoryFile::FIndexEntry& index_entry : index)
+	{
+		if (mIslandChunkOffsets.IsValidIndex(index_entry.mIslandIndex))
+		{
+			mIslandChunkOffsets[index_entry.mIslandIndex].Add(index_entry.mOffset);
+		}
+		else if (index_entry.mIslandIndex < 0)
+		{
+			// Compacted files keep the lineage of every island of the run, while their generations are combined into one
+			const int32 island_index = FPathHistoryFile::FChunkHeader::GetLineageIslandIndex(index_entry.mIslandIndex);
+			if (island_index >= mIslandLineageBlocks.Num())
+				mIslandLineageBlocks.SetNum(island_index + 1);
+
+			FLineageBlock& lineage_block = mIslandLineageBlocks[island_index][mIslandLineageBlocks[island_index].AddDefaulted()];
+			lineage_block.mOffset = index_entry.mOffset;
+			lineage_block.mFirstGenerationNumber = index_entry.mGenerationNumber;
+		}
+	}
+
+	// Islands may have stored a different amount of generations, only the generations stored by all islands are kept
+	mGenerationAmount = MAX_int32;
+	for (const TArray<int64>& chunk_offsets : mIslandChunkOffsets)
+		mGenerationAmount = FMath::Min(mGenerationAmount, chunk_offsets.Num());
+
+	mIslandGenerations.SetNum(mHeader.mIslandCount);
+	mIslandGenerationIndices.Init(INDEX_NONE, mHeader.mIslandCount);
+
+	return true;
+}
+
+
+
+void FPathHistoryReader::Close()
+{
+	mView.Close();
+
+	mHeader = FPathHistoryFile::FHeader();
+	mQuantization = FPathQuantization();
+	mCompression = FPathHistoryFile::FCompressionSettings();
+	mFirstChunkOffset = 0;
+	mHasIndex = false;
+	mIslandChunkOffsets.Reset();
+	mGenerationAmount = 0;
+	mIslandGenerationIndices.Reset();
+
+	mIslandLineageBlocks.Reset();
+	mLineageIslandIndex = INDEX_NONE;
+	mLineageBlockIndex = INDEX_NONE;
+}
+
+
+
+/**
+* Decodes a single stored generation, the islands of an island run are combined into one generation
+*/
+bool FPathHistoryReader::ReadGeneration(const int32 inGenerationIndex, FGenerationSerializationData& outGeneration)
+{
+	if (!IsOpen() || inGenerationIndex < 0 || inGenerationIndex >= mGenerationAmount)
+		return false;
+
+	if (mHeader.mIslandCount == 1)
+	{
+		if (!ReadIslandGeneration(0, inGenerationIndex))
+			return false;
+
+		outGeneration = mIslandGenerations[0];
+		return true;
+	}
+
+	TArray<const FGenerationSerializationData*> island_generations;
+	for (int32 i = 0; i < mHeader.mIslandCount; ++i)
+	{
+		if (!ReadIslandGeneration(i, inGenerationIndex))
+			return false;
+
+		island_generations.Add(&mIslandGenerations[i]);
+	}
+
+	FPathMigrationHub::CombineIslandGenerations(island_generations, outGeneration);
+
+	return true;
+}
+
+
+
+/**
+* Looks up how a single path of a generation was bred, inPathIndex being its position in the population of that generation
+*/
+bool FPathHistoryReader::ReadLineage(const int32 inIslandIndex, const int32 inGenerationNumber, const int32 inPathIndex, FPathLineageRecord& outRecord)
+{
+	if (!ReadLineageBlock(inIslandIndex, inGenerationNumber))
+		return false;
+
+	const int32 generation_offset = inGenerationNumber - mIslandLineageBlocks[mLineageIslandIndex][mLineageBlockIndex].mFirstGenerationNumber;
+	if (inPathIndex < 0 || inPathIndex >= mLineageRecordAmounts[generation_offset])
+		return false;
+
+	outRecord = mLineageRecords[mLineageRecordOffsets[generation_offset] + inPathIndex];
+
+	return true;
+}
+
+
+
+/**
+* Walks the ancestry of a path back for at most inMaxDepth generations, or until the lineage runs out
+* Every ancestor is listed once per generation, however many of its descendants it shares, starting with the path itself
+* Zero or less for inMaxDepth walks back to the first generation that has lineage
+*/
+bool FPathHistoryReader::TraceAncestry(const int32 inIslandIndex, const int32 inGenerationNumber, const int32 inPathIndex, const int32 inMaxDepth, TArray<FPathAncestor>& outAncestors)
+{
+	outAncestors.Reset();
+
+	TArray<int32> path_indices;
+	TArray<int32> parent_indices;
+	path_indices.Add(inPathIndex);
+
+	for (int32 generation_number = inGenerationNumber; path_indices.Num() > 0 && generation_number >= 0; --generation_number)
+	{
+		if (inMaxDepth > 0 && inGenerationNumber - generation_number >= inMaxDepth)
+			break;
+
+		parent_indices.Reset();
+
+		for (const int32 path_index : path_indices)
+		{
+			FPathAncestor& ancestor = outAncestors[outAncestors.AddDefaulted()];
+			ancestor.mGenerationNumber = generation_number;
+			ancestor.mPathIndex = path_index;
+
+			if (!ReadLineage(inIslandIndex, generation_number, path_index, ancestor.mRecord))
+			{
+				// Only the path itself has to have lineage, the ancestry may run out before the first generation
+				outAncestors.Pop(false);
+				return outAncestors.Num() > 0;
+			}
+
+			for (const int32 parent_index : ancestor.mRecord.mParentIndices)
+			{
+				if (parent_index != INDEX_NONE)
+					parent_indices.AddUnique(parent_index);
+			}
+		}
+
+		Swap(path_indices, parent_indices);
+		path_indices.Sort();
+	}
+
+	return outAncestors.Num() > 0;
+}
+
+
+
+/**
+* Hands out a lineage block as it is stored, without decompressing it
+*/
+bool FPathHistoryReader::ReadRawLineageBlock(const int32 inIslandIndex, const int32 inBlockIndex, FPathHistoryFile::FChunkHeader& outChunkHeader, const uint8*& outData)
+{
+	if (!mIslandLineageBlocks.IsValidIndex(inIslandIndex) || !mIslandLineageBlocks[inIslandIndex].IsValidIndex(inBlockIndex))
+		return false;
+
+	const int64 offset = mIslandLineageBlocks[inIslandIndex][inBlockIndex].mOffset;
+	if (!ReadStructure(offset, FPathHistoryFile::FChunkHeader::SerializedSize, outChunkHeader) || !outChunkHeader.IsLineage())
+		return false;
+
+	outData = mView.Read(offset + FPathHistoryFile::FChunkHeader::SerializedSize, outChunkHeader.mCompressedSize);
+
+	return outData != nullptr && FCrc::MemCrc32(outData, outChunkHeader.mCompressedSize) == outChunkHeader.mCrc;
+}
+
+
+
+/**
+* Deserializes a fixed size structure of the file, straight from the mapped pages
+*/
+template<typename T>
+bool FPathHistoryReader::ReadStructure(const int64 inOffset, const int32 inSize, T& outStructure)
+{
+	const uint8* data = mView.Read(inOffset, inSize);
+	if (data == nullptr)
+		return false;
+
+	FBufferReader reader(const_cast<uint8*>(data), inSize, false);
+	reader << outStructure;
+
+	return !reader.IsError();
+}
+
+
+
+/**
+* Reads the index through the footer at the end of the file, returns false if either is missing or damaged
+*/
+bool FPathHistoryReader::ReadIndex(TArray<FPathHistoryFile::FIndexEntry>& outIndex)
+{
+	const int64 file_size = mView.GetSize();
+
+	FPathHistoryFile::FFooter footer;
+	if (!ReadStructure(file_size - FPathHistoryFile::FFooter::SerializedSize, FPathHistoryFile::FFooter::SerializedSize, footer))
+		return false;
+
+	if (footer.mMagic != FPathHistoryFile::FooterMagic || footer.mIndexOffset < mFirstChunkOffset)
+		return false;
+
+	const int32 index_header_size = sizeof(uint32) + sizeof(int32);
+	const uint8* index_header = mView.Read(footer.mIndexOffset, index_header_size);
+	if (index_header == nullptr)
+		return false;
+
+	uint32 index_magic = 0;
+	int32 index_entry_amount = 0;
+	{
+		FBufferReader reader(const_cast<uint8*>(index_header), index_header_size, false);
+		reader << index_magic;
+		reader << index_entry_amount;
+	}
+
+	if (index_magic != FPathHistoryFile::IndexMagic || index_entry_amount < 0)
+		return false;
+
+	const int64 index_size = (int64)index_entry_amount * FPathHistoryFile::FIndexEntry::SerializedSize;
+	const uint8* index_data = mView.Read(footer.mIndexOffset + index_header_size, index_size);
+	if (index_data == nullptr)
+		return false;
+
+	FBufferReader reader(const_cast<uint8*>(index_data), index_size, false);
+
+	outIndex.SetNum(index_entry_amount);
+	for (FPathHistoryFile::FIndexEntry& index_entry : outIndex)
+		reader << index_entry;
+
+	return !reader.IsError();
+}
+
+
+
+/**
+* Hops from chunk header to chunk header without decoding anything, up to the first incomplete chunk
+*/
+void FPathHistoryReader::RebuildIndex(TArray<FPathHistoryFile::FIndexEntry>& outIndex)
+{
+	outIndex.Reset();
+
+	const int64 file_size = mView.GetSize();
+	int64 offset = mFirstChunkOffset;
+
+	FPathHistoryFile::FChunkHeader chunk_header;
+	while (ReadStructure(offset, FPathHistoryFile::FChunkHeader::SerializedSize, chunk_header))
+	{
+		const int64 chunk_end = offset + FPathHistoryFile::FChunkHeader::SerializedSize + chunk_header.mCompressedSize;
+		if ((!chunk_header.IsValid() && !chunk_header.IsLineage()) || chunk_header.mCompressedSize <= 0 || chunk_end > file_size)
+			break;
+
+		FPathHistoryFile::FIndexEntry& index_entry = outIndex[outIndex.AddDefaulted()];
+		index_entry.mOffset = offset;
+		index_entry.mGenerationNumber = chunk_header.mGenerationNumber;
+		index_entry.mIslandIndex = chunk_header.mIslandIndex;
+
+		offset = chunk_end;
+	}
+}
+
+
+
+bool FPathHistoryReader::IsKeyframe(const int64 inOffset)
+{
+	FPathHistoryFile::FChunkHeader chunk_header;
+	return ReadStructure(inOffset, FPathHistoryFile::FChunkHeader::SerializedSize, chunk_header) && !chunk_header.IsDelta();
+}
+
+
+
+/**
+* Brings the generation of the island up to the stored generation at inGenerationIndex
+* Decoding starts at the nearest keyframe before it, unless the generation decoded last is nearer
+*/
+bool FPathHistoryReader::ReadIslandGeneration(const int32 inIslandIndex, const int32 inGenerationIndex)
+{
+	int32& current_index = mIslandGenerationIndices[inIslandIndex];
+	if (current_index == inGenerationIndex)
+		return true;
+
+	const TArray<int64>& chunk_offsets = mIslandChunkOffsets[inIslandIndex];
+
+	// Scrubbing forward continues from the generation decoded last
+	const int32 continue_index = (current_index != INDEX_NONE && current_index < inGenerationIndex) ? current_index + 1 : INDEX_NONE;
+
+	int32 first_index = inGenerationIndex;
+	while (first_index != continue_index && !IsKeyframe(chunk_offsets[first_index]))
+	{
+		// Every island starts with a keyframe, not finding one means the file is damaged
+		if (first_index == 0)
+			return false;
+
+		--first_index;
+	}
+
+	// The deltas are applied to the generation of the island, which is replaced by every decoded chunk
+	const FGenerationSerializationData& reference = mIslandGenerations[inIslandIndex];
+	current_index = INDEX_NONE;
+
+	for (int32 i = first_index; i <= inGenerationIndex; ++i)
+	{
+		if (!ReadChunk(chunk_offsets[i], reference, mDecodedGeneration))
+		{
+			current_index = INDEX_NONE;
+			return false;
+		}
+
+		Swap(mIslandGenerations[inIslandIndex], mDecodedGeneration);
+		current_index = i;
+	}
+
+	return true;
+}
+
+
+
+/**
+* Decompresses a chunk from the mapped pages into the scratch buffer, nothing of the compressed data is copied
+* Delta chunks are applied to inReference, which has to be the generation of the chunk before it
+*/
+bool FPathHistoryReader::ReadChunk(const int64 inOffset, const FGenerationSerializationData& inReference, FGenerationSerializationData& outGeneration)
+{
+	FPathHistoryFile::FChunkHeader chunk_header;
+	if (!ReadStructure(inOffset, FPathHistoryFile::FChunkHeader::SerializedSize, chunk_header))
+		return false;
+
+	if (!chunk_header.IsValid() || chunk_header.mCompressedSize <= 0 || chunk_header.mUncompressedSize <= 0)
+		return false;
+
+	const uint8* compressed_data = mView.Read(inOffset + FPathHistoryFile::FChunkHeader::SerializedSize, chunk_header.mCompressedSize);
+	if (compressed_data == nullptr || FCrc::MemCrc32(compressed_data, chunk_header.mCompressedSize) != chunk_header.mCrc)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FPathHistoryReader::ReadChunk >> Chunk of generation %d is damaged"), chunk_header.mGenerationNumber);
+		return false;
+	}
+
+	if (chunk_header.IsDelta())
+		return FPathHistoryFile::DecompressGenerationDelta(compressed_data, chunk_header, mHeader.mVersion, mQuantization, mCompression, inReference, mScratch, mDeltas, outGeneration);
+
+	return FPathHistoryFile::DecompressGeneration(compressed_data, chunk_header, mHeader.mVersion, mQuantization, mCompression, mScratch, outGeneration);
+}
+
+
+
+/**
+* Makes sure the lineage block holding the generation of the island is decoded, the block decoded last is kept
+*/
+bool FPathHistoryReader::ReadLineageBlock(const int32 inIslandIndex, const int32 inGenerationNumber)
+{
+	if (!mIslandLineageBlocks.IsValidIndex(inIslandIndex))
+		return false;
+
+	const TArray<FLineageBlock>& lineage_blocks = mIslandLineageBlocks[inIslandIndex];
+
+	// Blocks are stored in order of generation, the block of the generation is the last one starting at or before it
+	int32 block_index = INDEX_NONE;
+	if (mLineageIslandIndex == inIslandIndex && mLineageBlockIndex != INDEX_NONE)
+	{
+		const int32 first_generation_number = lineage_blocks[mLineageBlockIndex].mFirstGenerationNumber;
+		if (inGenerationNumber >= first_generation_number && inGenerationNumber < first_generation_number + mLineageRecordAmounts.Num())
+			return true;
+	}
+
+	for (int32 i = lineage_blocks.Num() - 1; i >= 0; --i)
+	{
+		if (lineage_blocks[i].mFirstGenerationNumber <= inGenerationNumber)
+		{
+			block_index = i;
+			break;
+		}
+	}
+
+	if (block_index == INDEX_NONE)
+		return false;
+
+	mLineageIslandIndex = INDEX_NONE;
+	mLineageBlockIndex = INDEX_NONE;
+
+	FPathHistoryFile::FChunkHeader chunk_header;
+	const uint8* compressed_data = nullptr;
+	if (!ReadRawLineageBlock(inIslandIndex, block_index, chunk_header, compressed_data))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FPathHistoryReader::ReadLineageBlock >> Lineage from generation %d on is damaged"), lineage_blocks[block_index].mFirstGenerationNumber);
+		return false;
+	}
+
+	if (!FPathHistoryFile::DecompressLineage(compressed_data, chunk_header, mCompression, mScratch, mLineageRecordAmounts, mLineageRecords))
+		return false;
+
+	mLineageRecordOffsets.SetNum(mLineageRecordAmounts.Num(), false);
+
+	int32 record_offset = 0;
+	for (int32 i = 0; i < mLineageRecordAmounts.Num(); ++i)
+	{
+		mLineageRecordOffsets[i] = record_offset;
+		record_offset += mLineageRecordAmounts[i];
+	}
+
+	mLineageIslandIndex = inIslandIndex;
+	mLineageBlockIndex = block_index;
+
+	return inGenerationNumber < lineage_blocks[block_index].mFirstGenerationNumber + mLineageRecordAmounts.Num();
+}
@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// API includes
+#include "MappedFileView.h"
+#include "PathGenerationData.h"
+#include "PathHistoryFile.h"
+
+/**
+* Random access into a .ga file, only the generations that are asked for are read and decoded
+*
+* The file is memory mapped, so opening it only touches the pages of the header and the chunk index, however large the run
+* Chunks are decompressed straight from the mapped pages into a scratch buffer which is reused for every generation,
+* the blocks of a chunk are inflated in parallel
+* Files that were never closed have no index, theirs is rebuilt by hopping from chunk header to chunk header
+* Delta chunks are rebuilt from the nearest keyframe before them, or from the generation decoded last when scrubbing forward
+* The lineage is read a block at a time, tracing the ancestry of a path never decodes a single generation
+* The file stays open for as long as the reader lives, which is only meant to be used from a single thread
+*/
+class GENETICTRIANGLES_API FPathHistoryReader
+{
+public:
+	FPathHistoryReader();
+	~FPathHistoryReader();
+
+	bool Open(const FString& inFilePath);
+	void Close();
+
+	bool ReadGeneration(const int32 inGenerationIndex, FGenerationSerializationData& outGeneration);
+
+	bool HasLineage() const { return mIslandLineageBlocks.Num() > 0; }
+	bool ReadLineage(const int32 inIslandIndex, const int32 inGenerationNumber, const int32 inPathIndex, FPathLineageRecord& outRecord);
+	bool TraceAncestry(const int32 inIslandIndex, const int32 inGenerationNumber, const int32 inPathIndex, const int32 inMaxDepth, TArray<FPathAncestor>& outAncestors);
+
+	int32 GetLineageIslandCount() const { return mIslandLineageBlocks.Num(); }
+	int32 GetLineageBlockAmount(const int32 inIslandIndex) const { return mIslandLineageBlocks.IsValidIndex(inIslandIndex) ? mIslandLineageBlocks[inIslandIndex].Num() : 0; }
+	bool ReadRawLineageBlock(const int32 inIslandIndex, const int32 inBlockIndex, FPathHistoryFile::FChunkHeader& outChunkHeader, const uint8*& outData);
+
+	bool IsOpen() const { return mView.IsOpen(); }
+	bool IsMapped() const { return mView.IsMapped(); }
+	bool HasIndex() const { return mHasIndex; }
+	int32 GetGenerationAmount() const { return mGenerationAmount; }
+	int32 GetPopulationCount() const { return mHeader.mPopulationCount; }
+	int32 GetIslandCount() const { return mHeader.mIslandCount; }
+	const FPathQuantization& GetQuantization() const { return mQuantization; }
+	const FPathHistoryFile::FCompressionSettings& GetCompression() const { return mCompression; }
+
+private:
+	FPathHistoryReader(const FPathHistoryReader&) = delete;
+	FPathHistoryReader& operator=(const FPathHistoryReader&) = delete;
+
+	template<typename T>
+	bool ReadStructure(const int64 inOffset, const int32 inSize, T& outStructure);
+
+	bool ReadIndex(TArray<FPathHistoryFile::FIndexEntry>& outIndex);
+	void RebuildIndex(TArray<FPathHistoryFile::FIndexEntry>& outIndex);
+	bool IsKeyframe(const int64 inOffset);
+	bool ReadIslandGeneration(const int32 inIslandIndex, const int32 inGenerationIndex);
+	bool ReadChunk(const int64 inOffset, const FGenerationSerializationData& inReference, FGenerationSerializationData& outGeneration);
+	bool ReadLineageBlock(const int32 inIslandIndex, const int32 inGenerationNumber);
+
+private:
+	FMappedFileView mView;
+	FPathHistoryFile::FHeader mHeader;
+	FPathQuantization mQuantization; ///< Disabled for files older than version 5
+	FPathHistoryFile::FCompressionSettings mCompression; ///< Without blocks for files older than version 7
+	int64 mFirstChunkOffset = 0;
+	bool mHasIndex = false;
+
+	TArray<TArray<int64>> mIslandChunkOffsets; ///< Offset of every chunk of every island, in order of generation
+	int32 mGenerationAmount = 0; ///< Stored generations of which every island has a chunk
+
+	TArray<uint8> mScratch;
+	TArray<FPathDelta> mDeltas;
+	TArray<FGenerationSerializationData> mIslandGenerations; ///< The generation decoded last for every island, delta chunks are applied to it
+	TArray<int32> mIslandGenerationIndices;
+	FGenerationSerializationData mDecodedGeneration; ///< Swapped with the generation of an island once a chunk has been decoded
+
+	struct FLineageBlock
+	{
+		int64 mOffset = 0;
+		int32 mFirstGenerationNumber = 0;
+	};
+
+	TArray<TArray<FLineageBlock>> mIslandLineageBlocks; ///< In order of generation for every island that has lineage
+
+	// The lineage block decoded last, walking the ancestry back through a block decodes it once
+	int32 mLineageIslandIndex = INDEX_NONE;
+	int32 mLineageBlockIndex = INDEX_NONE;
+	TArray<int32> mLineageRecordAmounts;
+	TArray<int32> mLineageRecordOffsets; ///< Of the first record of every generation in the block
+	TArray<FPathLineageRecord> mLineageRecords;
+};
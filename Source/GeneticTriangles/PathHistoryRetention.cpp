@@ -0,0 +1,183 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneticTriangles.h"
+#include "PathHistoryRetention.h"
+
+#include "FileManager.h"
+
+#include "PathHistoryReader.h"
+#include "PathHistoryWriter.h"
+
+/**
+* Every n-th generation of the given age is kept, inExtraTiers shifts all tiers outside of the recent window further out
+*/
+int32 FPathHistoryRetentionPolicy::GetStride(const int32 inAge, const int32 inExtraTiers) const
+{
+	const int32 window = GetEffectiveWindow();
+	if (inAge < window)
+		return 1;
+
+	const int32 tier = (inAge - window) / FMath::Max(mTierLength, 1) + 1 + inExtraTiers;
+
+	return 1 << FMath::Min(tier, 30);
+}
+
+
+
+/**
+* The recent window on its own has to fit the budget
+*/
+int32 FPathHistoryRetentionPolicy::GetEffectiveWindow() const
+{
+	const int32 window = FMath::Max(mRecentWindow, 0);
+
+	return mMaxFullGenerations > 0 ? FMath::Min(window, mMaxFullGenerations) : window;
+}
+
+
+
+/**
+* The least amount of extra tiers which makes the full generations fit the budget
+*/
+int32 FPathHistoryRetentionPolicy::FindExtraTiers(const int32 inGenerationAmount) const
+{
+	if (mMaxFullGenerations <= 0)
+		return 0;
+
+	for (int32 extra_tiers = 0; extra_tiers < 30; ++extra_tiers)
+	{
+		int32 retained_amount = 0;
+		for (int32 i = 0; i < inGenerationAmount; ++i)
+		{
+			if (IsRetained(i, inGenerationAmount, extra_tiers))
+				++retained_amount;
+		}
+
+		if (retained_amount <= mMaxFullGenerations)
+			return extra_tiers;
+	}
+
+	return 30;
+}
+
+
+
+/**
+* Strides are powers of two, so a generation that is kept in a tier is also kept in every tier before it
+* The final generation is always kept
+*/
+bool FPathHistoryRetentionPolicy::IsRetained(const int32 inGenerationIndex, const int32 inGenerationAmount, const int32 inExtraTiers) const
+{
+	const int32 age = inGenerationAmount - 1 - inGenerationIndex;
+	if (age == 0)
+		return true;
+
+	return (inGenerationIndex % GetStride(age, inExtraTiers)) == 0;
+}
+
+
+
+bool FPathHistoryRetention::Compact(const FString& inFilePath, const FPathHistoryRetentionPolicy& inPolicy, const int32 inKeyframeInterval, FStats* outStats)
+{
+	FPathHistoryReader reader;
+	if (!reader.Open(inFilePath))
+		return false;
+
+	const int32 generation_amount = reader.GetGenerationAmount();
+	const int32 extra_tiers = inPolicy.FindExtraTiers(generation_amount);
+
+	// Nothing would be dropped, the file stays as it is
+	if (generation_amount <= inPolicy.GetEffectiveWindow())
+		return true;
+
+	const FString temporary_file_path = inFilePath + TEXT(".tmp");
+
+	// The lineage blocks are carried over as they are, so the compacted file keeps the compression of the run
+	FPathHistoryWriter writer;
+	if (!writer.Open(temporary_file_path, reader.GetPopulationCount(), 1, inKeyframeInterval, reader.GetQuantization(), reader.GetCompression(), false))
+		return false;
+
+	FStats stats;
+	FGenerationSerializationData generation;
+	FGenerationSerializationData reduced_generation;
+	float best_fitness = -TNumericLimits<float>::Max();
+	bool was_reduced = false;
+	bool has_compacted = true;
+
+	for (int32 i = 0; i < generation_amount && has_compacted; ++i)
+	{
+		if (!reader.ReadGeneration(i, generation))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("FPathHistoryRetention::Compact >> Unable to decode generation %d of %s!"), i, *inFilePath);
+			has_compacted = false;
+			break;
+		}
+
+		const bool is_improvement = generation.mGenerationInfo.mBestFitness > best_fitness;
+		best_fitness = FMath::Max(best_fitness, generation.mGenerationInfo.mBestFitness);
+
+		if (inPolicy.IsRetained(i, generation_amount, extra_tiers) || is_improvement)
+		{
+			// A full generation right after a reduced one would only be a poor delta, it starts a new keyframe instead
+			has_compacted = writer.Append(generation, 0, was_reduced);
+			was_reduced = false;
+
+			++stats.mFullGenerationAmount;
+			if (!inPolicy.IsRetained(i, generation_amount, extra_tiers))
+				++stats.mImprovementAmount;
+		}
+		else
+		{
+			ReduceToFittest(generation, reduced_generation);
+			has_compacted = writer.Append(reduced_generation);
+			was_reduced = true;
+
+			++stats.mReducedGenerationAmount;
+		}
+	}
+
+	// The lineage is kept in full, it is small next to the generations and tracing it back needs every generation
+	for (int32 island_index = 0; has_compacted && island_index < reader.GetLineageIslandCount(); ++island_index)
+	{
+		for (int32 block_index = 0; has_compacted && block_index < reader.GetLineageBlockAmount(island_index); ++block_index)
+		{
+			FPathHistoryFile::FChunkHeader chunk_header;
+			const uint8* chunk_data = nullptr;
+			has_compacted = reader.ReadRawLineageBlock(island_index, block_index, chunk_header, chunk_data) && writer.AppendChunk(chunk_header, chunk_data);
+		}
+	}
+
+	has_compacted &= writer.Close();
+
+	// The original has to be unmapped before it can be replaced
+	reader.Close();
+
+	if (!has_compacted || !IFileManager::Get().Move(*inFilePath, *temporary_file_path, true))
+	{
+		IFileManager::Get().Delete(*temporary_file_path);
+		return false;
+	}
+
+	if (outStats != nullptr)
+		*outStats = stats;
+
+	return true;
+}
+
+
+
+/**
+* Keeps only the path that was marked fittest, or the first path of generations in which none was
+*/
+void FPathHistoryRetention::ReduceToFittest(const FGenerationSerializationData& inGeneration, FGenerationSerializationData& outGeneration)
+{
+	outGeneration.mGenerationInfo = inGeneration.mGenerationInfo;
+	outGeneration.mPathSerializationData.Reset(1);
+
+	const TArray<FPathSerializationData>& paths = inGeneration.mPathSerializationData;
+	if (paths.Num() == 0)
+		return;
+
+	const FPathSerializationData* fittest_path = paths.FindByPredicate([](const FPathSerializationData& inPath) { return inPath.mFittest; });
+	outGeneration.mPathSerializationData.Add(fittest_path != nullptr ? *fittest_path : paths[0]);
+}
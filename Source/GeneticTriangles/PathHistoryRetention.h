@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// API includes
+#include "PathGenerationData.h"
+
+/**
+* Which stored generations of a run are kept in full once the run has finished
+*
+* The last mRecentWindow generations are always kept, further back only every k-th generation is,
+* with k doubling every mTierLength generations, so the amount of full generations stays bounded however long the run is
+* Generations which improved the best fitness are always kept, of all others only the fittest path is
+* With a budget the tiers are thinned out further until the full generations fit, the improvements are not counted
+*/
+struct GENETICTRIANGLES_API FPathHistoryRetentionPolicy
+{
+	bool mIsEnabled = false;
+	int32 mRecentWindow = 1000;
+	int32 mTierLength = 1000;
+	int32 mMaxFullGenerations = 0; ///< Zero does not limit the amount of full generations beyond the tiers
+
+	int32 GetStride(const int32 inAge, const int32 inExtraTiers) const;
+	int32 GetEffectiveWindow() const;
+	int32 FindExtraTiers(const int32 inGenerationAmount) const;
+	bool IsRetained(const int32 inGenerationIndex, const int32 inGenerationAmount, const int32 inExtraTiers) const;
+};
+
+
+
+/**
+* Thins out a finished history file according to a retention policy
+*
+* The file is decoded once from front to back and rewritten next to itself, then moved over the original
+* Generations that are not retained are written with only their fittest path, so a replay still covers every stored generation
+* Island runs are rewritten with their islands combined, the way a replay shows them anyway
+*/
+class GENETICTRIANGLES_API FPathHistoryRetention
+{
+public:
+	struct FStats
+	{
+		int32 mFullGenerationAmount = 0;
+		int32 mImprovementAmount = 0; ///< Full generations that were only kept because they improved the best fitness
+		int32 mReducedGenerationAmount = 0;
+	};
+
+	static bool Compact(const FString& inFilePath, const FPathHistoryRetentionPolicy& inPolicy, const int32 inKeyframeInterval, FStats* outStats = nullptr);
+
+	static void ReduceToFittest(const FGenerationSerializationData& inGeneration, FGenerationSerializationData& outGeneration);
+};
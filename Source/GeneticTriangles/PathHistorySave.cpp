@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneticTriangles.h"
+#include "PathHistorySave.h"
+
+FPathHistorySave::FPathHistorySave(TUniquePtr<FPathHistoryWriter>&& inHistoryWriter, TUniquePtr<FPathGenerationPipeline>&& inPipeline, const FPathHistoryRetentionPolicy& inRetentionPolicy)
+	:
+	mHistoryWriter(MoveTemp(inHistoryWriter)),
+	mPipeline(MoveTemp(inPipeline)),
+	mHasSucceeded(false)
+{
+	check(mHistoryWriter.IsValid());
+
+	mFilePath = mHistoryWriter->GetFilePath();
+	mExpectedChunkAmount = mHistoryWriter->GetChunkAmount();
+
+	FGraphEventArray prerequisites;
+	if (mPipeline.IsValid() && mPipeline->GetLastRecordedEvent().IsValid())
+	{
+		prerequisites.Add(mPipeline->GetLastRecordedEvent());
+		mExpectedChunkAmount += mPipeline->GetPendingRecordAmount();
+	}
+
+	FPathHistoryWriter* history_writer = mHistoryWriter.Get();
+	FThreadSafeBool* has_succeeded = &mHasSucceeded;
+
+	mClosedEvent = FFunctionGraphTask::CreateAndDispatchWhenReady([history_writer, has_succeeded, inRetentionPolicy]()
+	{
+		*has_succeeded = history_writer->Close();
+
+		if (!*has_succeeded || !inRetentionPolicy.mIsEnabled)
+			return;
+
+		// A file that could not be compacted is still a complete history, only a larger one
+		FPathHistoryRetention::FStats stats;
+		if (FPathHistoryRetention::Compact(history_writer->GetFilePath(), inRetentionPolicy, history_writer->GetKeyframeInterval(), &stats))
+			UE_LOG(LogTemp, Display, TEXT("FPathHistorySave >> Kept %d full generations of which %d improved the best fitness, reduced %d generations to their fittest path"),
+				stats.mFullGenerationAmount, stats.mImprovementAmount, stats.mReducedGenerationAmount);
+		else
+			UE_LOG(LogTemp, Warning, TEXT("FPathHistorySave >> Unable to compact %s, it keeps every generation"), *history_writer->GetFilePath());
+	}, TStatId(), &prerequisites, ENamedThreads::AnyThread);
+}
+
+
+
+FPathHistorySave::~FPathHistorySave()
+{
+	// The task points into the save
+	Wait();
+}
+
+
+
+void FPathHistorySave::Wait()
+{
+	if (!mClosedEvent->IsComplete())
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(mClosedEvent, ENamedThreads::GameThread);
+}
+
+
+
+/**
+* Fraction of the chunks of the run that have been written, closing the file counts as the final chunk
+*/
+float FPathHistorySave::GetProgress() const
+{
+	if (IsComplete())
+		return 1.0f;
+
+	return FMath::Min(mHistoryWriter->GetChunkAmount() / (float)(mExpectedChunkAmount + 1), 1.0f);
+}
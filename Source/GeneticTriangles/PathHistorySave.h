@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// API includes
+#include "PathGenerationPipeline.h"
+#include "PathHistoryRetention.h"
+#include "PathHistoryWriter.h"
+
+/**
+* Finishes the history file of a stopped run in the background, so stopping never waits on the disk
+*
+* Takes over the writer of the run, and the pipeline if the run had one, without copying anything they hold
+* The file is closed by a task that only starts once the last generation in flight has been recorded,
+* after which the pipeline is destroyed on the game thread together with the save
+* A new run opens a file of its own, so it may start while a save is still going
+* With a retention policy the closed file is compacted by the same task, the save is only complete once that is done
+*/
+class GENETICTRIANGLES_API FPathHistorySave
+{
+public:
+	FPathHistorySave(TUniquePtr<FPathHistoryWriter>&& inHistoryWriter, TUniquePtr<FPathGenerationPipeline>&& inPipeline, const FPathHistoryRetentionPolicy& inRetentionPolicy = FPathHistoryRetentionPolicy());
+	~FPathHistorySave();
+
+	void Wait();
+
+	bool IsComplete() const { return mClosedEvent->IsComplete(); }
+	bool HasSucceeded() const { return IsComplete() && mHasSucceeded; }
+	float GetProgress() const;
+	const FString& GetFilePath() const { return mFilePath; }
+
+private:
+	FPathHistorySave(const FPathHistorySave&) = delete;
+	FPathHistorySave& operator=(const FPathHistorySave&) = delete;
+
+private:
+	TUniquePtr<FPathHistoryWriter> mHistoryWriter;
+	TUniquePtr<FPathGenerationPipeline> mPipeline; ///< Its recording tasks point into its slots, so it lives until the file has been closed
+	FGraphEventRef mClosedEvent;
+	FThreadSafeBool mHasSucceeded;
+
+	FString mFilePath;
+	int32 mExpectedChunkAmount = 0;
+};
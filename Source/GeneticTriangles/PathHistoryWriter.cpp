@@ -0,0 +1,302 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneticTriangles.h"
+#include "PathHistoryWriter.h"
+
+#include "FileManager.h"
+
+FPathHistoryWriter::FPathHistoryWriter()
+{
+}
+
+
+
+FPathHistoryWriter::~FPathHistoryWriter()
+{
+	Close();
+}
+
+
+
+/**
+* Creates the file and writes its header, an existing file is overwritten
+*/
+bool FPathHistoryWriter::Open(const FString& inFilePath, const int32 inPopulationCount, const int32 inIslandCount, const int32 inKeyframeInterval, const FPathQuantization& inQuantization, const FPathHistoryFile::FCompressionSettings& inCompression, const bool inRecordLineage)
+{
+	Close();
+
+	// Create a directory for us to safely work in
+	IFileManager& file_manager = IFileManager::Get();
+	const FString target_directory = FPaths::GetPath(inFilePath);
+	if (!file_manager.DirectoryExists(*target_directory))
+		file_manager.MakeDirectory(*target_directory, true);
+
+	mFile = file_manager.CreateFileWriter(*inFilePath);
+	if (mFile == nullptr)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FPathHistoryWriter::Open >> Unable to create %s!"), *inFilePath);
+		return false;
+	}
+
+	mFilePath = inFilePath;
+	mChunkAmount.Reset();
+	mIndex.Reset();
+
+	mIslands.Reset();
+	mIslands.SetNum(FMath::Max(inIslandCount, 1));
+	mKeyframeInterval = inKeyframeInterval;
+	mQuantization = inQuantization;
+	mQuantizationStats = FPathQuantizationStats();
+
+	mCompression = inCompression;
+	mCompression.mUncompressedBytes = 0;
+	mCompression.mCompressedBytes = 0;
+
+	mLineage.Reset();
+	if (inRecordLineage)
+	{
+		mLineage.SetNum(FMath::Max(inIslandCount, 1));
+		for (FLineageState& lineage : mLineage)
+			lineage.mRecords.Reserve(LineageBlockRecordAmount + inPopulationCount);
+	}
+
+	// A step larger than twice the budget would store almost every genome at full precision
+	if (mQuantization.IsActive() && mQuantization.mPrecision * 0.5f > mQuantization.mErrorBudget)
+		UE_LOG(LogTemp, Warning, TEXT("FPathHistoryWriter::Open >> A quantization precision of %f does not fit an error budget of %f, most genomes will be stored at full precision"), mQuantization.mPrecision, mQuantization.mErrorBudget);
+
+	FPathHistoryFile::FHeader header;
+	header.mPopulationCount = inPopulationCount;
+	header.mIslandCount = FMath::Max(inIslandCount, 1);
+
+	*mFile << header;
+	*mFile << mQuantization;
+	*mFile << mCompression;
+	mFile->Flush();
+
+	return true;
+}
+
+
+
+/**
+* Compresses the generation, or its deltas to the previous generation of the island, and appends it to the file
+* inLineage is the lineage of the generation as recorded by the algorithm, which saves the deltas from searching for the parents
+* The file is flushed after every chunk
+*/
+bool FPathHistoryWriter::Append(const FGenerationSerializationData& inGeneration, const int32 inIslandIndex, const bool inForceKeyframe, const TArray<FPathLineageRecord>* inLineage)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GeneticTriangles_Recording);
+
+	if (!IsOpen() || !mIslands.IsValidIndex(inIslandIndex))
+		return false;
+
+	FIslandState& island = mIslands[inIslandIndex];
+	TArray<uint8>& compressed_data = island.mCompressedData;
+
+	FPathHistoryFile::FChunkHeader chunk_header;
+	chunk_header.mGenerationNumber = inGeneration.mGenerationInfo.mGenerationNumber;
+	chunk_header.mIslandIndex = inIslandIndex;
+
+	const bool is_keyframe = inForceKeyframe || mKeyframeInterval <= 1 || (island.mStoredAmount % mKeyframeInterval) == 0;
+
+	bool has_compressed = false;
+	if (is_keyframe)
+	{
+		has_compressed = FPathHistoryFile::CompressGeneration(inGeneration, mQuantization, mCompression, island.mScratch, compressed_data, chunk_header.mUncompressedSize, &island.mQuantizationStats);
+	}
+	else
+	{
+		chunk_header.mMagic = FPathHistoryFile::DeltaChunkMagic;
+
+		// The lineage points into the generation right before, which is only the reference when no generation was skipped
+		const bool is_reference_parent = island.mReference.mGenerationInfo.mGenerationNumber + 1 == inGeneration.mGenerationInfo.mGenerationNumber;
+
+		FPathHistoryDelta::Encode(island.mReference, inGeneration, is_reference_parent ? inLineage : nullptr, island.mDeltas);
+		has_compressed = FPathHistoryFile::CompressGenerationDelta(inGeneration.mGenerationInfo, island.mDeltas, mQuantization, mCompression, island.mScratch, compressed_data, chunk_header.mUncompressedSize, &island.mQuantizationStats);
+	}
+
+	if (!has_compressed)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FPathHistoryWriter::Append >> Unable to compress generation %d!"), chunk_header.mGenerationNumber);
+		return false;
+	}
+
+	chunk_header.mCompressedSize = compressed_data.Num();
+	chunk_header.mCrc = FCrc::MemCrc32(compressed_data.GetData(), compressed_data.Num());
+
+	if (!WriteChunk(chunk_header, compressed_data.GetData()))
+		return false;
+
+	mChunkAmount.Increment();
+
+	// The next delta of the island is encoded against this generation
+	island.mReference = inGeneration;
+	++island.mStoredAmount;
+
+	return true;
+}
+
+
+
+/**
+* Adds the lineage of a generation to the block of the island, which is written once it is full
+* Only copies the records, a block is started right away after a gap in the generation numbers
+*/
+bool FPathHistoryWriter::AppendLineage(const int32 inGenerationNumber, const TArray<FPathLineageRecord>& inRecords, const int32 inIslandIndex)
+{
+	if (!IsOpen() || !mLineage.IsValidIndex(inIslandIndex))
+		return false;
+
+	FLineageState& lineage = mLineage[inIslandIndex];
+
+	if (lineage.mRecordAmounts.Num() > 0 && lineage.mFirstGenerationNumber + lineage.mRecordAmounts.Num() != inGenerationNumber && !FlushLineage(inIslandIndex))
+		return false;
+
+	if (lineage.mRecordAmounts.Num() == 0)
+		lineage.mFirstGenerationNumber = inGenerationNumber;
+
+	lineage.mRecordAmounts.Add(inRecords.Num());
+	lineage.mRecords.Append(inRecords);
+
+	if (lineage.mRecords.Num() >= LineageBlockRecordAmount)
+		return FlushLineage(inIslandIndex);
+
+	return true;
+}
+
+
+
+/**
+* Appends a chunk that has been compressed already, as is, used to carry chunks over from another file
+*/
+bool FPathHistoryWriter::AppendChunk(const FPathHistoryFile::FChunkHeader& inChunkHeader, const uint8* inData)
+{
+	if (!IsOpen() || !WriteChunk(inChunkHeader, inData))
+		return false;
+
+	// Only generations count as stored chunks
+	if (inChunkHeader.IsValid())
+		mChunkAmount.Increment();
+
+	return true;
+}
+
+
+
+bool FPathHistoryWriter::FlushLineage(const int32 inIslandIndex)
+{
+	FLineageState& lineage = mLineage[inIslandIndex];
+	if (lineage.mRecordAmounts.Num() == 0)
+		return true;
+
+	FPathHistoryFile::FChunkHeader chunk_header;
+	chunk_header.mMagic = FPathHistoryFile::LineageChunkMagic;
+	chunk_header.mGenerationNumber = lineage.mFirstGenerationNumber;
+	chunk_header.mIslandIndex = FPathHistoryFile::FChunkHeader::GetLineageIslandIndex(inIslandIndex);
+
+	const bool has_compressed = FPathHistoryFile::CompressLineage(lineage.mRecordAmounts, lineage.mRecords, mCompression, lineage.mScratch, lineage.mCompressedData, chunk_header.mUncompressedSize);
+
+	lineage.mRecordAmounts.Reset();
+	lineage.mRecords.Reset();
+
+	if (!has_compressed)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FPathHistoryWriter::FlushLineage >> Unable to compress the lineage from generation %d on!"), chunk_header.mGenerationNumber);
+		return false;
+	}
+
+	chunk_header.mCompressedSize = lineage.mCompressedData.Num();
+	chunk_header.mCrc = FCrc::MemCrc32(lineage.mCompressedData.GetData(), lineage.mCompressedData.Num());
+
+	return WriteChunk(chunk_header, lineage.mCompressedData.GetData());
+}
+
+
+
+/**
+* Only the write itself is serialized, the file is flushed after every chunk
+* Chunks appended as they are count towards the totals too, they were compressed with the same settings
+*/
+bool FPathHistoryWriter::WriteChunk(const FPathHistoryFile::FChunkHeader& inChunkHeader, const uint8* inData)
+{
+	FScopeLock lock(&mFileLock);
+
+	if (mFile == nullptr)
+		return false;
+
+	FPathHistoryFile::FIndexEntry& index_entry = mIndex[mIndex.AddDefaulted()];
+	index_entry.mOffset = mFile->Tell();
+	index_entry.mGenerationNumber = inChunkHeader.mGenerationNumber;
+	index_entry.mIslandIndex = inChunkHeader.mIslandIndex;
+
+	*mFile << const_cast<FPathHistoryFile::FChunkHeader&>(inChunkHeader);
+	mFile->Serialize(const_cast<uint8*>(inData), inChunkHeader.mCompressedSize);
+
+	mCompression.mUncompressedBytes += inChunkHeader.mUncompressedSize;
+	mCompression.mCompressedBytes += inChunkHeader.mCompressedSize;
+
+	INC_DWORD_STAT_BY(STAT_GeneticTriangles_HistoryBytesWritten, FPathHistoryFile::FChunkHeader::SerializedSize + inChunkHeader.mCompressedSize);
+
+	// A crash from here on still leaves this chunk in the file
+	mFile->Flush();
+
+	return !mFile->IsError();
+}
+
+
+
+/**
+* Writes the lineage that is still pending, then appends the index of all chunks and the footer pointing at it and closes the file
+* The compression totals are written into the header last, a file that was never closed keeps zeros there
+* Returns false if the file was not open, or if anything written to it has failed
+*/
+bool FPathHistoryWriter::Close()
+{
+	for (int32 i = 0; i < mLineage.Num(); ++i)
+	{
+		if (IsOpen())
+			FlushLineage(i);
+	}
+
+	mLineage.Reset();
+
+	FScopeLock lock(&mFileLock);
+
+	if (mFile == nullptr)
+		return false;
+
+	FPathHistoryFile::FFooter footer;
+	footer.mIndexOffset = mFile->Tell();
+
+	uint32 index_magic = FPathHistoryFile::IndexMagic;
+	int32 index_entry_amount = mIndex.Num();
+	*mFile << index_magic;
+	*mFile << index_entry_amount;
+
+	for (FPathHistoryFile::FIndexEntry& index_entry : mIndex)
+		*mFile << index_entry;
+
+	*mFile << footer;
+
+	// The totals are only known now, they are written over the ones in the header
+	mFile->Seek(FPathHistoryFile::FHeader::SerializedSize + FPathQuantization::SerializedSize);
+	*mFile << mCompression;
+
+	const bool has_closed = mFile->Close();
+	delete mFile;
+	mFile = nullptr;
+
+	UE_LOG(LogTemp, Display, TEXT("FPathHistoryWriter::Close >> Compressed %lld bytes of generations and lineage into %lld bytes, a ratio of %f"),
+		mCompression.mUncompressedBytes, mCompression.mCompressedBytes, mCompression.GetRatio());
+
+	if (mQuantization.IsActive())
+	{
+		for (const FIslandState& island : mIslands)
+			mQuantizationStats.Merge(island.mQuantizationStats);
+
+		UE_LOG(LogTemp, Display, TEXT("FPathHistoryWriter::Close >> Quantized %d chromosomes with a maximum reconstruction error of %f, %d genomes were stored at full precision"),
+			mQuantizationStats.mQuantizedChromosomeAmount, mQuantizationStats.mMaxError, mQuantizationStats.mFullPrecisionGenomeAmount);
+	}
+
+	return has_closed;
+}
@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// API includes
+#include "PathGenerationData.h"
+#include "PathHistoryFile.h"
+#include "PathQuantization.h"
+
+/**
+* Streams the generations of a run into a .ga file as they are produced
+*
+* Every generation is compressed on its own and appended as a chunk, then the file is flushed
+* Every n-th chunk of an island is a keyframe holding the whole generation, the others only hold the deltas to the chunk before them
+* Nothing but the previous stored generation of every island is kept in memory, so memory does not grow with the length of a run,
+* and stopping a run only has to close the file, which appends the chunk index
+* Append may be called from any thread, compression happens on the calling thread and only the write itself is serialized
+* The generations of a single island have to be appended in order though, which the pipeline and the workers already do
+* Deltas use the lineage of the generation as its parents when it is given and the previous stored generation is the one right before it
+* Genomes may be quantized, closing the file reports the largest reconstruction error of the run
+* The blocks of a chunk are compressed in parallel, the totals of the run are written into the header when the file is closed
+* The lineage of every generation is gathered into blocks per island and appended once a block is full, or when the file is closed
+* Lineage and generations of an island may be appended from different threads, they do not share any state but the file
+*/
+class GENETICTRIANGLES_API FPathHistoryWriter
+{
+public:
+	FPathHistoryWriter();
+	~FPathHistoryWriter();
+
+	static const int32 DefaultKeyframeInterval = 32;
+	static const int32 LineageBlockRecordAmount = 32768; ///< Records gathered before a lineage block is written, about half a megabyte
+
+	bool Open(const FString& inFilePath, const int32 inPopulationCount, const int32 inIslandCount = 1, const int32 inKeyframeInterval = DefaultKeyframeInterval, const FPathQuantization& inQuantization = FPathQuantization(), const FPathHistoryFile::FCompressionSettings& inCompression = FPathHistoryFile::FCompressionSettings(), const bool inRecordLineage = true);
+	bool Append(const FGenerationSerializationData& inGeneration, const int32 inIslandIndex = 0, const bool inForceKeyframe = false, const TArray<FPathLineageRecord>* inLineage = nullptr);
+	bool AppendLineage(const int32 inGenerationNumber, const TArray<FPathLineageRecord>& inRecords, const int32 inIslandIndex = 0);
+	bool AppendChunk(const FPathHistoryFile::FChunkHeader& inChunkHeader, const uint8* inData);
+	bool Close();
+
+	bool IsOpen() const { return mFile != nullptr; }
+	int32 GetChunkAmount() const { return mChunkAmount.GetValue(); }
+	int32 GetKeyframeInterval() const { return mKeyframeInterval; }
+	const FString& GetFilePath() const { return mFilePath; }
+	const FPathQuantizationStats& GetQuantizationStats() const { return mQuantizationStats; } ///< Complete once the file has been closed
+	const FPathHistoryFile::FCompressionSettings& GetCompression() const { return mCompression; } ///< The totals are complete once the file has been closed
+
+private:
+	FPathHistoryWriter(const FPathHistoryWriter&) = delete;
+	FPathHistoryWriter& operator=(const FPathHistoryWriter&) = delete;
+
+	bool FlushLineage(const int32 inIslandIndex);
+	bool WriteChunk(const FPathHistoryFile::FChunkHeader& inChunkHeader, const uint8* inData);
+
+private:
+	/**
+	* Only ever touched by the thread appending the generations of the island
+	*/
+	struct FIslandState
+	{
+		FGenerationSerializationData mReference; ///< The previous stored generation, which the next delta is encoded against
+		int32 mStoredAmount = 0;
+
+		TArray<FPathDelta> mDeltas;
+		TArray<uint8> mScratch;
+		TArray<uint8> mCompressedData;
+		FPathQuantizationStats mQuantizationStats;
+	};
+
+	/**
+	* Only ever touched by the thread appending the lineage of the island
+	*/
+	struct FLineageState
+	{
+		int32 mFirstGenerationNumber = 0;
+		TArray<int32> mRecordAmounts; ///< Per generation in the block
+		TArray<FPathLineageRecord> mRecords; ///< Sized for a whole block up front
+
+		TArray<uint8> mScratch;
+		TArray<uint8> mCompressedData;
+	};
+
+	TArray<FIslandState> mIslands;
+	TArray<FLineageState> mLineage; ///< Empty when the lineage is not recorded
+	int32 mKeyframeInterval = DefaultKeyframeInterval; ///< One or less stores every generation as a keyframe
+	FPathQuantization mQuantization;
+	FPathQuantizationStats mQuantizationStats;
+	FPathHistoryFile::FCompressionSettings mCompression; ///< Its totals are only touched while holding the file lock
+
+	FCriticalSection mFileLock;
+	FArchive* mFile = nullptr;
+	FString mFilePath;
+	FThreadSafeCounter mChunkAmount;
+	TArray<FPathHistoryFile::FIndexEntry> mIndex; ///< A few bytes per chunk, written when the file is closed
+};
@@ -0,0 +1,155 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneticTriangles.h"
+#include "PathIndividual.h"
+
+/**
+* Clears everything the fitness evaluation determined, the genetic representation is left untouched
+*/
+void FPathIndividual::ResetEvaluation()
+{
+	mFitness = 0.0f;
+	mAmountOfNodesFitness = 0.0f;
+	mObstacleHitMultiplierChunk = 0.0f;
+
+	mIsInObstacle = false;
+	mCanSeeTarget = false;
+	mHasReachedTarget = false;
+	mSlopeTooIntense = false;
+	mTravelingThroughTerrain = false;
+	mDistanceBetweenChromosomesTooLarge = false;
+	mFittestSolution = false;
+}
+
+
+
+void FPathIndividual::DetermineGeneticRepresentation()
+{
+	// Calculate any values that might be useful for the fitness evaluation
+	mLength = FPathGeometryBatch::EvaluateGenome(mGeneticRepresentation.GetData(), mGeneticRepresentation.Num(), FPathGeometryConstraints()).mLength;
+
+	check(mLength > 0.0f);
+}
+
+
+
+void FPathIndividual::RandomizeValues(FRandomStream& inRandomStream, const FVector& inStartingLocation, const int32 inAmountOfNodes, const float inMaxVariation)
+{
+	mGeneticRepresentation.Reset(inAmountOfNodes);
+
+	PathKernels::RandomizeGenes(inRandomStream, inStartingLocation, inAmountOfNodes, inMaxVariation, [this](const FVector& inChromosome)
+	{
+		mGeneticRepresentation.Add(inChromosome);
+	});
+}
+
+
+
+FVector FPathIndividual::GetLocationOfFinalNode() const
+{
+	// If the following occurs then the path is most likely uninitialized
+	if (mGeneticRepresentation.Num() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FPathIndividual::GetLocationOfFinalNode >> Attempting access of empty path! Returning zero vector."));
+		return FVector::ZeroVector;
+	}
+
+	return mGeneticRepresentation.Last();
+}
+
+
+
+FVector FPathIndividual::GetChromosome(const int32 inIndex) const
+{
+	return mGeneticRepresentation.IsValidIndex(inIndex) ? mGeneticRepresentation[inIndex] : FVector::ZeroVector;
+}
+
+
+/**
+* Mutates the path through translating points, the kernel is shared with Tools/GaBench, see PathKernels.h
+*/
+void FPathIndividual::MutateThroughTranslation(FRandomStream& inRandomStream, const ETranslationMutationType inTranslationMutationType, const float inMaxTranslationOffset)
+{
+	PathKernels::MutateThroughTranslation(inRandomStream, (PathKernels::ETranslationMutationType)inTranslationMutationType, inMaxTranslationOffset, mGeneticRepresentation.GetData(), mGeneticRepresentation.Num());
+}
+
+
+
+/**
+* Inserts a point / chromosome in the genetic representation
+* Insertion happens anywhere after the first chromosome
+* The chromosome that gets added will be in the middle of the the element before inserting and the previous
+*/
+void FPathIndividual::MutateThroughInsertion(FRandomStream& inRandomStream)
+{
+	if (mGeneticRepresentation.Num() >= 2)
+	{
+		const int32 insertion_index = inRandomStream.RandRange(1, mGeneticRepresentation.Num() - 1);
+		if (mGeneticRepresentation.IsValidIndex(insertion_index) && mGeneticRepresentation.IsValidIndex(insertion_index - 1))
+		{
+			FVector mid_point = (mGeneticRepresentation[insertion_index] + mGeneticRepresentation[insertion_index - 1]) / 2.0f;
+			mGeneticRepresentation.Insert(mid_point, insertion_index);
+		}
+	}
+}
+
+
+
+/**
+* Removes a point / chromosome from the genetic representation
+* Removal happens anywhere after the first chromosome, which means the head may be killed off
+*/
+void FPathIndividual::MutateThroughDeletion(FRandomStream& inRandomStream)
+{
+	if (mGeneticRepresentation.Num() > 2)
+	{
+		const int32 deletion_index = inRandomStream.RandRange(1, mGeneticRepresentation.Num() - 1);
+		mGeneticRepresentation.RemoveAt(deletion_index);
+	}
+}
+
+
+
+/**
+* If possible, forces the path to snap its chromosomes to a terrain
+* Only performs scene queries, which makes it safe to call from a worker thread
+* Returns the amount of line traces it took
+*/
+int32 FPathIndividual::SnapToTerrain(const UWorld* inWorld)
+{
+	if (inWorld == nullptr)
+		return 0;
+
+	const int32 trace_amount = 2 * FMath::Max(mGeneticRepresentation.Num() - 1, 0);
+	INC_DWORD_STAT_BY(STAT_GeneticTriangles_TerrainTraces, trace_amount);
+
+	for (int32 i = 1; i < mGeneticRepresentation.Num(); ++i)
+	{
+		FHitResult positive_vertical_hit_result;
+		if (inWorld->LineTraceSingleByChannel(positive_vertical_hit_result, mGeneticRepresentation[i], mGeneticRepresentation[i] + FVector(0.0f, 0.0f, 100.0f), ECollisionChannel::ECC_GameTraceChannel3))
+			mGeneticRepresentation[i] = positive_vertical_hit_result.Location;
+
+		FHitResult negative_vertical_hit_result;
+		if (inWorld->LineTraceSingleByChannel(negative_vertical_hit_result, mGeneticRepresentation[i], mGeneticRepresentation[i] + FVector(0.0f, 0.0f, -100.0f), ECollisionChannel::ECC_GameTraceChannel3))
+			mGeneticRepresentation[i] = negative_vertical_hit_result.Location;
+	}
+
+	return trace_amount;
+}
+
+
+
+/**
+* Takes over the results of the population wide geometry pass
+* The length is replaced as the chromosomes may have been snapped to the terrain since DetermineGeneticRepresentation
+*/
+void FPathIndividual::ApplyGeometry(const FPathGeometryResult& inGeometry)
+{
+	mLength = inGeometry.mLength;
+
+	if (inGeometry.mSegmentTooLong)
+		mDistanceBetweenChromosomesTooLarge = true;
+
+	if (inGeometry.mSlopeTooIntense)
+		mSlopeTooIntense = true;
+}
@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// API includes
+#include "Enums.h"
+#include "PathGeometry.h"
+
+// The operators are cast to those of the engine-free kernels, see PathKernels.h
+static_assert((uint8)ECrossoverOperator::SinglePoint == (uint8)PathKernels::ECrossoverOperator::SinglePoint && (uint8)ECrossoverOperator::DoublePoint == (uint8)PathKernels::ECrossoverOperator::DoublePoint && (uint8)ECrossoverOperator::Uniform == (uint8)PathKernels::ECrossoverOperator::Uniform, "The crossover operators of the kernels have to match ECrossoverOperator");
+static_assert((uint8)ETranslationMutationType::AnyButStart == (uint8)PathKernels::ETranslationMutationType::AnyButStart && (uint8)ETranslationMutationType::HeadOnly == (uint8)PathKernels::ETranslationMutationType::HeadOnly && (uint8)ETranslationMutationType::HeadFalloff == (uint8)PathKernels::ETranslationMutationType::HeadFalloff && (uint8)ETranslationMutationType::AllAtOnce == (uint8)PathKernels::ETranslationMutationType::AllAtOnce, "The translation mutation types of the kernels have to match ETranslationMutationType");
+
+/**
+* A single member of the path population
+* Holds the genetic representation and the state of the fitness evaluation, without any ties to an actor
+* This allows the population to be evolved away from the game thread
+*/
+struct GENETICTRIANGLES_API FPathIndividual
+{
+	void ResetEvaluation();
+	void DetermineGeneticRepresentation();
+
+	void RandomizeValues(FRandomStream& inRandomStream, const FVector& inStartingLocation, const int32 inAmountOfNodes, const float inMaxVariation);
+
+	int32 GetAmountOfNodes() const { return mGeneticRepresentation.Num(); }
+	FVector GetLocationOfFinalNode() const;
+	FVector GetChromosome(const int32 inIndex) const;
+
+	void MutateThroughTranslation(FRandomStream& inRandomStream, const ETranslationMutationType inTranslationMutationType, const float inMaxTranslationOffset);
+	void MutateThroughInsertion(FRandomStream& inRandomStream);
+	void MutateThroughDeletion(FRandomStream& inRandomStream);
+
+	int32 SnapToTerrain(const UWorld* inWorld);
+	void ApplyGeometry(const FPathGeometryResult& inGeometry);
+
+	bool IsInvalid() const { return mIsInObstacle || mSlopeTooIntense || mTravelingThroughTerrain || mDistanceBetweenChromosomesTooLarge; }
+
+	TArray<FVector> mGeneticRepresentation;
+
+	float mFitness = 0.0f;
+	float mAmountOfNodesFitness = 0.0f;
+	float mLength = 0.0f;
+	float mObstacleHitMultiplierChunk = 0.0f;
+
+	bool mIsInObstacle = false;
+	bool mCanSeeTarget = false;
+	bool mHasReachedTarget = false;
+	bool mSlopeTooIntense = false;
+	bool mTravelingThroughTerrain = false;
+	bool mDistanceBetweenChromosomesTooLarge = false;
+	bool mFittestSolution = false;
+
+	int32 mLineageIndex = INDEX_NONE; ///< Position in the previous generation, or of the lineage record while breeding, follows the path through sorting
+};
@@ -0,0 +1,443 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define PATH_KERNELS_SSE 1
+#include <emmintrin.h>
+#else
+#define PATH_KERNELS_SSE 0
+#endif
+
+/**
+* The hot kernels of the path algorithm without the engine, included by the module as well as by Tools/GaBench
+* This way the benchmarks time the code the game runs, so only the standard library may be used here
+*
+* The vector and random stream types are template parameters:
+* TVector needs X, Y and Z, a constructor taking them, the arithmetic operators, Normalize and a static DotProduct, same as FVector
+* TRandomStream needs FRand, FRandRange and RandRange, same as FRandomStream
+*/
+namespace PathKernels
+{
+	const int32_t IndexNone = -1;
+
+	/**
+	* Same values as ECrossoverOperator, which the engine casts to
+	*/
+	enum class ECrossoverOperator : uint8_t
+	{
+		SinglePoint,
+		DoublePoint,
+		Uniform
+	};
+
+	/**
+	* Same values as ETranslationMutationType, which the engine casts to
+	*/
+	enum class ETranslationMutationType : uint8_t
+	{
+		AnyButStart,
+		HeadOnly,
+		HeadFalloff,
+		AllAtOnce
+	};
+
+	/**
+	* Limits used by the fused geometry pass
+	* Everything is stored squared so the kernel never has to take a square root or an arc cosine for its tests
+	*/
+	struct FGeometryConstraints
+	{
+		FGeometryConstraints() { }
+		FGeometryConstraints(const bool inUseMaxSegmentLength, const float inMaxSegmentLength, const bool inUseMaxSlope, const float inMaxSlopeAngle);
+
+		float mMaxSegmentLengthSquared = 3.402823466e+38f; ///< Segments longer than this are flagged
+		float mCosMaxSlopeSquared = 0.0f; ///< cos^2 of the maximum slope angle, zero disables the slope test
+	};
+
+	/**
+	* Output of the geometry pass for a single genome
+	*/
+	struct FGeometryResult
+	{
+		float mLength = 0.0f;
+		bool mSegmentTooLong = false;
+		bool mSlopeTooIntense = false;
+	};
+
+
+
+	inline FGeometryConstraints::FGeometryConstraints(const bool inUseMaxSegmentLength, const float inMaxSegmentLength, const bool inUseMaxSlope, const float inMaxSlopeAngle)
+	{
+		if (inUseMaxSegmentLength)
+			mMaxSegmentLengthSquared = inMaxSegmentLength * inMaxSegmentLength;
+
+		// The angle is clamped to [0, 90], which keeps the cosine positive and allows comparing squared values
+		// No slope exceeds 90 degrees, so that angle leaves the test disabled instead of relying on a float cosine of exactly zero
+		const float max_slope_angle = std::min(std::max(inMaxSlopeAngle, 0.0f), 90.0f);
+		if (inUseMaxSlope && max_slope_angle < 90.0f)
+		{
+			const float cos_max_slope = std::cos(max_slope_angle * (3.1415926535897932f / 180.0f));
+			mCosMaxSlopeSquared = cos_max_slope * cos_max_slope;
+		}
+	}
+
+
+
+	/**
+	* Fused length, max segment length and slope pass over a single genome
+	* Four segments are transposed into SoA lanes at a time, unused lanes are zeroed which keeps them neutral for every test
+	*
+	* The slope of a segment exceeds the tolerance angle when cos(slope) < cos(max), with cos(slope) = |horizontal| / |direction|
+	* Squaring both sides gives horizontal^2 < cos(max)^2 * direction^2, so neither a normalize nor an acos is needed
+	* A segment too short to normalize used to end up at a dot product of zero, which is 90 degrees, so it is flagged whenever the test is enabled
+	*
+	* With SSE the lengths use the hardware reciprocal square root refined by two Newton-Raphson steps, same as VectorReciprocalSqrtAccurate,
+	* other targets divide by the square root instead
+	*/
+	template <typename TVector>
+	FGeometryResult EvaluateGenome(const TVector* inChromosomes, const int32_t inChromosomeAmount, const FGeometryConstraints& inConstraints, float* outSegmentLengths = nullptr)
+	{
+		FGeometryResult result;
+
+		const int32_t segment_amount = inChromosomeAmount - 1;
+		if (inChromosomes == nullptr || segment_amount <= 0)
+			return result;
+
+		const float smallest_length_squared = 1.e-8f;
+
+		alignas(16) float delta_x[4];
+		alignas(16) float delta_y[4];
+		alignas(16) float delta_z[4];
+		alignas(16) float lengths[4];
+
+#if PATH_KERNELS_SSE
+		const __m128 max_segment_length_squared_lanes = _mm_set1_ps(inConstraints.mMaxSegmentLengthSquared);
+		const __m128 cos_max_slope_squared_lanes = _mm_set1_ps(inConstraints.mCosMaxSlopeSquared);
+		const __m128 smallest_length_squared_lanes = _mm_set1_ps(smallest_length_squared);
+		const __m128 one_half = _mm_set1_ps(0.5f);
+
+		__m128 accumulated_length = _mm_setzero_ps();
+#else
+		alignas(16) float accumulated_length[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+#endif
+		int32_t segment_too_long_mask = 0;
+		int32_t slope_too_intense_mask = 0;
+
+		const bool is_slope_test_enabled = inConstraints.mCosMaxSlopeSquared > 0.0f;
+
+		for (int32_t first_segment = 0; first_segment < segment_amount; first_segment += 4)
+		{
+			const int32_t active_lanes = std::min(4, segment_amount - first_segment);
+
+			for (int32_t lane = 0; lane < 4; ++lane)
+			{
+				if (lane < active_lanes)
+				{
+					const TVector& from = inChromosomes[first_segment + lane];
+					const TVector& to = inChromosomes[first_segment + lane + 1];
+
+					delta_x[lane] = to.X - from.X;
+					delta_y[lane] = to.Y - from.Y;
+					delta_z[lane] = to.Z - from.Z;
+				}
+				else
+				{
+					delta_x[lane] = 0.0f;
+					delta_y[lane] = 0.0f;
+					delta_z[lane] = 0.0f;
+				}
+			}
+
+#if PATH_KERNELS_SSE
+			const __m128 x = _mm_load_ps(delta_x);
+			const __m128 y = _mm_load_ps(delta_y);
+			const __m128 z = _mm_load_ps(delta_z);
+
+			const __m128 horizontal_length_squared = _mm_add_ps(_mm_mul_ps(y, y), _mm_mul_ps(x, x));
+			const __m128 length_squared = _mm_add_ps(_mm_mul_ps(z, z), horizontal_length_squared);
+
+			// sqrt(x) = x * (1 / sqrt(x)), clamped so zero length lanes produce zero instead of NaN
+			const __m128 clamped_length_squared = _mm_max_ps(length_squared, smallest_length_squared_lanes);
+			const __m128 half_length_squared = _mm_mul_ps(clamped_length_squared, one_half);
+			const __m128 estimate = _mm_rsqrt_ps(clamped_length_squared);
+			__m128 refined = _mm_sub_ps(one_half, _mm_mul_ps(half_length_squared, _mm_mul_ps(estimate, estimate)));
+			refined = _mm_add_ps(_mm_mul_ps(estimate, refined), estimate);
+			__m128 reciprocal_length = _mm_sub_ps(one_half, _mm_mul_ps(half_length_squared, _mm_mul_ps(refined, refined)));
+			reciprocal_length = _mm_add_ps(_mm_mul_ps(refined, reciprocal_length), refined);
+
+			const __m128 length = _mm_mul_ps(length_squared, reciprocal_length);
+			accumulated_length = _mm_add_ps(accumulated_length, length);
+
+			segment_too_long_mask |= _mm_movemask_ps(_mm_cmpgt_ps(length_squared, max_segment_length_squared_lanes));
+			slope_too_intense_mask |= _mm_movemask_ps(_mm_cmpgt_ps(_mm_mul_ps(cos_max_slope_squared_lanes, length_squared), horizontal_length_squared));
+
+			// Only the active lanes, the zeroed ones would count as degenerate segments
+			if (is_slope_test_enabled)
+				slope_too_intense_mask |= _mm_movemask_ps(_mm_cmpge_ps(smallest_length_squared_lanes, length_squared)) & ((1 << active_lanes) - 1);
+
+			_mm_store_ps(lengths, length);
+#else
+			for (int32_t lane = 0; lane < 4; ++lane)
+			{
+				const float horizontal_length_squared = delta_y[lane] * delta_y[lane] + delta_x[lane] * delta_x[lane];
+				const float length_squared = delta_z[lane] * delta_z[lane] + horizontal_length_squared;
+
+				lengths[lane] = length_squared / std::sqrt(std::max(length_squared, smallest_length_squared));
+				accumulated_length[lane] += lengths[lane];
+
+				if (length_squared > inConstraints.mMaxSegmentLengthSquared)
+					segment_too_long_mask |= 1 << lane;
+
+				if (inConstraints.mCosMaxSlopeSquared * length_squared > horizontal_length_squared)
+					slope_too_intense_mask |= 1 << lane;
+
+				if (is_slope_test_enabled && lane < active_lanes && length_squared <= smallest_length_squared)
+					slope_too_intense_mask |= 1 << lane;
+			}
+#endif
+
+			if (outSegmentLengths != nullptr)
+				std::memcpy(outSegmentLengths + first_segment, lengths, active_lanes * sizeof(float));
+		}
+
+#if PATH_KERNELS_SSE
+		_mm_store_ps(lengths, accumulated_length);
+#else
+		std::memcpy(lengths, accumulated_length, sizeof(lengths));
+#endif
+
+		result.mLength = lengths[0] + lengths[1] + lengths[2] + lengths[3];
+		result.mSegmentTooLong = segment_too_long_mask != 0;
+		result.mSlopeTooIntense = slope_too_intense_mask != 0;
+
+		return result;
+	}
+
+
+
+	/**
+	* Every node wanders off from the one before it in the horizontal plane, inAddChromosome receives the chromosomes in order
+	* Both offsets are drawn before the chromosome is built, so the order of the draws does not depend on the compiler
+	*/
+	template <typename TRandomStream, typename TVector, typename TAddChromosome>
+	void RandomizeGenes(TRandomStream& ioRandomStream, const TVector& inStartingLocation, const int32_t inAmountOfNodes, const float inMaxVariation, TAddChromosome inAddChromosome)
+	{
+		// The first point of a path will always be the first node
+		TVector previous = inStartingLocation;
+		inAddChromosome(previous);
+
+		for (int32_t i = 1; i < inAmountOfNodes; ++i)
+		{
+			const float x = ioRandomStream.FRandRange(-inMaxVariation, inMaxVariation);
+			const float y = ioRandomStream.FRandRange(-inMaxVariation, inMaxVariation);
+
+			previous = TVector(x, y, 0.0f) + previous;
+			inAddChromosome(previous);
+		}
+	}
+
+
+
+	/**
+	* Roulette wheel sampling until inEnd mates have been selected, inMateAmount is the amount of mates selected so far
+	* Without any fitness to go by, every path is equally likely to be selected
+	*/
+	template <typename TRandomStream, typename TGetFitness, typename TAddMate>
+	void SelectMates(TRandomStream& ioRandomStream, const int32_t inPopulationAmount, const float inTotalFitness, int32_t inMateAmount, const int32_t inEnd, TGetFitness inGetFitness, TAddMate inAddMate)
+	{
+		if (inTotalFitness <= 0.0f)
+		{
+			for (; inMateAmount < inEnd; ++inMateAmount)
+				inAddMate(ioRandomStream.RandRange(0, inPopulationAmount - 1));
+
+			return;
+		}
+
+		// A spin that rounding leaves short of the drawn fraction selects nobody and is simply spun again
+		while (inMateAmount < inEnd)
+		{
+			const float R = ioRandomStream.FRand();
+			float accumulated_fitness = 0.0f;
+
+			for (int32_t i = 0; i < inPopulationAmount; ++i)
+			{
+				accumulated_fitness += inGetFitness(i) / inTotalFitness;
+
+				if (accumulated_fitness >= R)
+				{
+					inAddMate(i);
+					++inMateAmount;
+					break;
+				}
+			}
+		}
+	}
+
+
+
+	/**
+	* The chromosomes of both offspring of a crossover, the first offspring starts out as the smallest parent, the second one as the bigger parent
+	* inAddChromosomes receives the chromosome of the first and of the second offspring for every position in order
+	* The tail of the bigger parent is only appended when inAppendTailOfBiggerPath is set, outCrossoverPoints receives the points that were drawn
+	*/
+	template <typename TRandomStream, typename TVector, typename TAddChromosomes>
+	void CrossoverGenes(TRandomStream& ioRandomStream, const ECrossoverOperator inOperator, const TVector* inSmallGenes, const int32_t inSmallAmount, const TVector* inBigGenes, const int32_t inBigAmount,
+		const bool inAppendTailOfBiggerPath, int32_t outCrossoverPoints[2], TAddChromosomes inAddChromosomes)
+	{
+		outCrossoverPoints[0] = IndexNone;
+		outCrossoverPoints[1] = IndexNone;
+
+		if (inOperator == ECrossoverOperator::SinglePoint)
+		{
+			const int32_t crossover_index = ioRandomStream.RandRange(1, inSmallAmount - 1);
+			outCrossoverPoints[0] = crossover_index;
+
+			for (int32_t j = 0; j < inBigAmount; ++j)
+			{
+				if (j < inSmallAmount)
+				{
+					// Do regular crossover when indices are valid
+					if (j < crossover_index)
+						inAddChromosomes(inSmallGenes[j], inBigGenes[j]);
+					else
+						inAddChromosomes(inBigGenes[j], inSmallGenes[j]);
+				}
+				else if (inAppendTailOfBiggerPath)
+				{
+					inAddChromosomes(inBigGenes[j], inBigGenes[j]);
+				}
+			}
+		}
+		else if (inOperator == ECrossoverOperator::DoublePoint)
+		{
+			// Drawn as floats and truncated
+			const int32_t first_crossover_index = (int32_t)ioRandomStream.FRandRange(1.0f, (float)(inSmallAmount - 1));
+			const int32_t second_crossover_index = (int32_t)ioRandomStream.FRandRange((float)(first_crossover_index + 1), (float)(inSmallAmount - 1));
+			outCrossoverPoints[0] = first_crossover_index;
+			outCrossoverPoints[1] = second_crossover_index;
+
+			for (int32_t j = 0; j < inBigAmount; ++j)
+			{
+				if (j < inSmallAmount)
+				{
+					// Do double point crossover when indices are valid
+					if (j < first_crossover_index)
+						inAddChromosomes(inSmallGenes[j], inBigGenes[j]);
+					else if (j < second_crossover_index)
+						inAddChromosomes(inBigGenes[j], inSmallGenes[j]);
+					else
+						inAddChromosomes(inSmallGenes[j], inBigGenes[j]);
+				}
+				else if (inAppendTailOfBiggerPath)
+				{
+					inAddChromosomes(inBigGenes[j], inBigGenes[j]);
+				}
+			}
+		}
+		else if (inOperator == ECrossoverOperator::Uniform)
+		{
+			for (int32_t j = 0; j < inBigAmount; ++j)
+			{
+				if (j < inSmallAmount)
+				{
+					const float bias = ioRandomStream.FRandRange(0.0f, 100.0f);
+					if (bias < 50.0f)
+						inAddChromosomes(inSmallGenes[j], inBigGenes[j]);
+					else
+						inAddChromosomes(inBigGenes[j], inSmallGenes[j]);
+				}
+				else if (inAppendTailOfBiggerPath)
+				{
+					inAddChromosomes(inBigGenes[j], inBigGenes[j]);
+				}
+			}
+		}
+	}
+
+
+
+	/**
+	* Mutates the genes through translating points in the horizontal plane, the starting chromosome is never moved
+	* Both offsets are drawn before the offset is built, so the order of the draws does not depend on the compiler
+	*/
+	template <typename TRandomStream, typename TVector>
+	void MutateThroughTranslation(TRandomStream& ioRandomStream, const ETranslationMutationType inTranslationMutationType, const float inMaxTranslationOffset, TVector* ioGenes, const int32_t inGeneAmount)
+	{
+		if (inGeneAmount <= 0)
+			return;
+
+		if (inTranslationMutationType == ETranslationMutationType::AllAtOnce) // All chromosomes (except the first one) are mutated
+		{
+			for (int32_t i = 1; i < inGeneAmount; ++i)
+			{
+				const float x = ioRandomStream.FRandRange(-inMaxTranslationOffset, inMaxTranslationOffset);
+				const float y = ioRandomStream.FRandRange(-inMaxTranslationOffset, inMaxTranslationOffset);
+				ioGenes[i] += TVector(x, y, 0.0f);
+			}
+		}
+		else if (inTranslationMutationType == ETranslationMutationType::AnyButStart) // A random chromosome (except the first one) is mutated
+		{
+			const int32_t chromosome_to_mutate_index = ioRandomStream.RandRange(1, inGeneAmount - 1);
+			const float x = ioRandomStream.FRandRange(-inMaxTranslationOffset, inMaxTranslationOffset);
+			const float y = ioRandomStream.FRandRange(-inMaxTranslationOffset, inMaxTranslationOffset);
+			ioGenes[chromosome_to_mutate_index] += TVector(x, y, 0.0f);
+		}
+		else if (inTranslationMutationType == ETranslationMutationType::HeadFalloff) // The final chromosome, all other chromosomes are mutated in the same way but with linear falloff applied
+		{
+			const float x = ioRandomStream.FRandRange(-inMaxTranslationOffset, inMaxTranslationOffset);
+			const float y = ioRandomStream.FRandRange(-inMaxTranslationOffset, inMaxTranslationOffset);
+			const TVector offset(x, y, 0.0f);
+
+			for (int32_t i = inGeneAmount - 1; i > 1; --i)
+			{
+				const float multiplier = i / (float)(inGeneAmount - 1);
+				ioGenes[i] += offset * multiplier;
+			}
+		}
+		else if (inTranslationMutationType == ETranslationMutationType::HeadOnly) // The final chromsome is mutated
+		{
+			const float x = ioRandomStream.FRandRange(-inMaxTranslationOffset, inMaxTranslationOffset);
+			const float y = ioRandomStream.FRandRange(-inMaxTranslationOffset, inMaxTranslationOffset);
+			ioGenes[inGeneAmount - 1] += TVector(x, y, 0.0f);
+		}
+	}
+
+
+
+	/**
+	* The triangle is more fit the closer one of its angles is to 90 degrees, 0 is the least and 1 the most fit
+	* Only looks past the first dot product when it is not the smallest, which is what the triangle managers have always done
+	*/
+	template <typename TVector>
+	float GetTriangleFitness(const TVector& inPoint0, const TVector& inPoint1, const TVector& inPoint2)
+	{
+		TVector vec01 = inPoint1 - inPoint0; // Vector 0->1
+		TVector vec02 = inPoint2 - inPoint0; // Vector 0->2
+		TVector vec12 = inPoint2 - inPoint1; // Vector 1->2
+
+		vec01.Normalize();
+		vec02.Normalize();
+		vec12.Normalize();
+
+		const float dot0 = std::fabs(TVector::DotProduct(vec01, vec02));
+		const float dot1 = std::fabs(TVector::DotProduct(vec12, -vec01));
+		const float dot2 = std::fabs(TVector::DotProduct(-vec12, -vec02));
+
+		float smallest = 1.1f; // Dot product will never return anything above 1.0f (even considering abs)
+
+		if (dot0 < smallest)
+			smallest = dot0;
+		else if (dot1 < smallest)
+			smallest = dot1;
+		else if (dot2 < smallest)
+			smallest = dot2;
+
+		return 1.0f - smallest;
+	}
+}
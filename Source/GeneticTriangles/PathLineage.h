@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+/**
+* How a single path of a generation was bred, a fixed size record
+*
+* Parents are positions in the population of the previous generation, in the order that generation is stored in
+* The first parent passed on the chromosomes before the first crossover point, the second parent the ones after it
+* Paths that were carried over as is only have a first parent, paths of the initial population and immigrants have none
+*/
+struct FPathLineageRecord
+{
+	static const uint8 NoCrossover = 0xFF;
+
+	static const uint8 TranslationMutation = 1 << 0;
+	static const uint8 InsertionMutation = 1 << 1;
+	static const uint8 DeletionMutation = 1 << 2;
+
+	int32 mParentIndices[2] = { INDEX_NONE, INDEX_NONE };
+	int16 mCrossoverPoints[2] = { INDEX_NONE, INDEX_NONE }; ///< Unused points of the crossover operator stay INDEX_NONE
+	uint8 mCrossoverOperator = NoCrossover; ///< An ECrossoverOperator, or NoCrossover
+	uint8 mMutationFlags = 0;
+
+	static const int32 SerializedSize = 2 * sizeof(int32) + 2 * sizeof(int16) + 2 * sizeof(uint8);
+
+	bool IsCrossover() const { return mCrossoverOperator != NoCrossover; }
+
+	friend FArchive& operator<<(FArchive& ioArchive, FPathLineageRecord& ioRecord)
+	{
+		ioArchive << ioRecord.mParentIndices[0];
+		ioArchive << ioRecord.mParentIndices[1];
+		ioArchive << ioRecord.mCrossoverPoints[0];
+		ioArchive << ioRecord.mCrossoverPoints[1];
+		ioArchive << ioRecord.mCrossoverOperator;
+		ioArchive << ioRecord.mMutationFlags;
+
+		return ioArchive;
+	}
+};
+
+
+
+/**
+* A single path in the ancestry of another path
+*/
+struct FPathAncestor
+{
+	int32 mGenerationNumber = 0;
+	int32 mPathIndex = 0;
+	FPathLineageRecord mRecord;
+};
@@ -4,7 +4,7 @@
 #include "PathManager.h"
 
 #include "Path.h"
-#include "FileManager.h"
+#include "PathHistoryFile.h"
 
 // Sets default values
 APathManager::APathManager()
@@ -30,8 +30,25 @@ void APathManager::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// Allocate space for 20000 generations
-	mSerializationData.Reserve(20000);
+	mSlicePathBudget = FMath::Max(MaxPathsPerFrame, 1);
+	mHasAutoStarted = false;
+}
+
+
+// Called when the game ends or when destroyed
+void APathManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// The workers trace against the world, so they have to be joined before the world goes away
+	ResetWorkers();
+	mPipeline.Reset();
+	mAlgorithm.Reset();
+	mCheckpointWriter.Reset();
+	mHistoryWriter.Reset();
+	mStatisticsWriter.Reset();
+	mReplayCache.Reset();
+	FinishPendingSaves();
+
+	Super::EndPlay(EndPlayReason);
 }
 
 
@@ -40,21 +57,47 @@ void APathManager::Tick( float DeltaTime )
 {
 	Super::Tick( DeltaTime );
 
-	if (AutoRun)
-		mPreviousAnimationControlState = EAnimationControlState::Play;
+	UpdatePendingSaves();
+
+	if (AutoRun && !mHasAutoStarted && mPreviousAnimationControlState == EAnimationControlState::Limbo)
+	{
+		mHasAutoStarted = true;
+		ChangeAnimationControlState(EAnimationControlState::Play);
+	}
 
 	switch (mPreviousAnimationControlState)
 	{
 	case EAnimationControlState::Play:
-		RunGenerationTimer(DeltaTime);
+		if (mWorkers.Num() > 0)
+		{
+			ConsumeWorkerSnapshot();
+			CheckWorkerTermination();
+		}
+		else
+		{
+			// Present the generations of the previous tick first, their tasks have had a whole frame to finish
+			UpdatePipeline();
+			RunGenerationTimer(DeltaTime);
+		}
 		break;
 	case EAnimationControlState::Pause:
+		if (mWorkers.Num() > 0)
+		{
+			ConsumeWorkerSnapshot();
+			CheckWorkerTermination();
+		}
+		else
+			UpdatePipeline();
 		LogGenerationInfo(); // Keep track of information on screen when paused (for now)
 		break;
 	case EAnimationControlState::Stop:
-		StopRun();
+		// The workers finish their current generation first, their history is complete once they acknowledge the stop
+		if (HaveWorkersFinishedRun())
+			StopRun();
 		break;
 	case EAnimationControlState::Limbo:
+		// A replay shows the scrubbed generation as soon as it has been decoded
+		UpdateScrub();
 		break;
 	default:
 		break;
@@ -64,715 +107,524 @@ void APathManager::Tick( float DeltaTime )
 
 void APathManager::RunGenerationTimer(const float inDeltaTime)
 {
-	// TimeBetweenGenerations may be altered anywhere
-	mTimer -= inDeltaTime;
-	if (mTimer < 0.0f)
+	switch (GenerationRunMode)
+	{
+	case EGenerationRunMode::Delayed:
+	{
+		// TimeBetweenGenerations may be altered anywhere
+		mTimer -= inDeltaTime;
+		if (mTimer < 0.0f)
+		{
+			mTimer = TimeBetweenGenerations;
+
+			RunGeneration();
+		}
+		break;
+	}
+	case EGenerationRunMode::FixedPerTick:
 	{
-		mTimer = TimeBetweenGenerations;
-		
-		RunGeneration();
+		for (int32 i = 0; i < FMath::Max(GenerationsPerTick, 1) && !mTerminationMonitor.HasTerminated(); ++i)
+			RunGeneration();
+		break;
+	}
+	case EGenerationRunMode::TimeBudget:
+	{
+		// Always run at least one generation, even if a single generation exceeds the budget
+		const double end_time = FPlatformTime::Seconds() + GenerationTimeBudget / 1000.0;
+		do
+		{
+			RunGeneration();
+		} while (FPlatformTime::Seconds() < end_time && !mTerminationMonitor.HasTerminated());
+		break;
+	}
+	case EGenerationRunMode::FrameSliced:
+	{
+		RunGenerationSlice(inDeltaTime);
+		break;
+	}
+	default:
+		break;
 	}
 }
 
 void APathManager::RunGeneration()
 {
-	if (GenerationCount == 0)
-		InitializeRun();
-
-	if (Nodes.IsValidIndex(0) && Nodes.IsValidIndex(1) && Nodes[0]->IsValidLowLevelFast() && Nodes[1]->IsValidLowLevelFast())
+	if (PrepareAlgorithm())
 	{
-		EvaluateFitness();
-		SelectionStep();
-		CrossoverStep();
-		MutationStep();
-		EvaluateFitness();
-		ColorCodePathsByFitness();
+		const double start_time = FPlatformTime::Seconds();
+		mAlgorithm->RunGeneration();
 
-		mGenerationInfo.mGenerationNumber = GenerationCount++;
-
-		LogGenerationInfo();
-		AddGenerationInfoToSerializableData();
+		FinishGeneration((FPlatformTime::Seconds() - start_time) * 1000.0);
 	}
-	else
-		UE_LOG(LogTemp, Warning, TEXT("APathManager::RunGeneration() >> One of the nodes is invalid!"));
 }
 
 
 
-void APathManager::InitializeRun()
+/**
+* Runs part of a generation, every phase processes at most mSlicePathBudget paths this tick
+* The budget is halved whenever the previous frame went over TargetFrameTime and grows slowly otherwise
+*/
+void APathManager::RunGenerationSlice(const float inDeltaTime)
 {
-	// Create population
-	mPaths.Empty();
-	mPaths.Reserve(PopulationCount);
+	const int32 max_paths_per_frame = FMath::Max(MaxPathsPerFrame, 1);
 
-	for (int32 i = 0; i < PopulationCount; ++i)
-	{
-		APath* path = GetWorld()->SpawnActor<APath>(GetTransform().GetLocation(), GetTransform().GetRotation().Rotator());
+	if (inDeltaTime * 1000.0f > TargetFrameTime)
+		mSlicePathBudget = mSlicePathBudget / 2;
+	else
+		mSlicePathBudget = mSlicePathBudget + FMath::Max(mSlicePathBudget / 8, 1);
+
+	mSlicePathBudget = FMath::Clamp(mSlicePathBudget, 1, max_paths_per_frame);
 
-		ensure(path != nullptr);
+	if (!PrepareAlgorithm())
+		return;
 
-		path->PostInit(MinAmountOfPointsPerPathAtStartup, MaxAmountOfPointsPerPathAtStartup);
-		path->RandomizeValues(Nodes[0], MaxInitialVariation);
-		path->DetermineGeneticRepresentation();
+	const double start_time = FPlatformTime::Seconds();
+	const bool has_finished_generation = mAlgorithm->StepGeneration(mSlicePathBudget);
+	mSliceBreedingTime += FPlatformTime::Seconds() - start_time;
 
-		mPaths.Add(path);
+	if (has_finished_generation)
+	{
+		FinishGeneration(mSliceBreedingTime * 1000.0);
+		mSliceBreedingTime = 0.0;
 	}
 }
 
 
 
-void APathManager::EvaluateFitness()
+/**
+* Makes sure there is an algorithm to run, returns false if the run can not continue
+*/
+bool APathManager::PrepareAlgorithm()
 {
-	// What defines fitness for a path?
-	// 1. SHORTEST / CLOSEST
-	// -> Amount of chunks per path (less chunks == more fitness)
-	// -> Length of a path (shorter l => higher f)
-	// -> Distance of the final node in relation to the targeted node
-	// -> Average orientation of the path
-
-	// Fitness is calculated as an agreation of multiple fitness values
-
-	// /////////////////////////
-	// 1. DATA AND STATE CACHING
-	// /////////////////////////
-	// Determine the least and most amount of nodes as this will influence the way fitness is calculated as well
-	int32 least_amount_of_nodes = INT32_MAX;
-	int32 most_amount_of_nodes = 0;
-
-	// Same goes for the distances between the final point of a path and the targetted node
-	float closest_distance = TNumericLimits<float>::Max();
-	float furthest_distance = 0.0f;
-	FVector targetting_location = Nodes[1]->GetActorLocation(); // Assumes this has been filled in through the editor
-
-	// And again, same goes for the length of the path
-	float shortest_path_length = TNumericLimits<float>::Max();
-	float longest_path_length = 0.0f;
-
-	for (int32 i = 0; i < mPaths.Num(); ++i)
+	if (!AreNodesValid())
 	{
-		APath* path = nullptr;
+		UE_LOG(LogTemp, Warning, TEXT("APathManager::RunGeneration() >> One of the nodes is invalid!"));
+		return false;
+	}
+
+	// The settings are gathered every generation, as the properties may be altered while running
+	// A generation which is spread over multiple ticks keeps its settings until it has finished
+	if (!mAlgorithm.IsValid())
+	{
+		OpenHistoryWriter(PopulationCount, 1);
+
+		mAlgorithm = MakeUnique<FPathGeneticAlgorithm>(GetWorld(), GatherSettings());
+		mPipeline = MakeUnique<FPathGenerationPipeline>(mHistoryWriter.Get());
+		mCheckpointWriter = MakeUnique<FPathCheckpointWriter>(GetCheckpointFilePath());
+		mTerminationMonitor.Reset();
 
-		if (mPaths.IsValidIndex(i) && mPaths[i]->IsValidLowLevelFast())
+		// A resumed run continues from the checkpoint, instead of initializing a population of its own
+		if (mResumeCheckpoint.IsValid())
 		{
-			path = mPaths[i];
+			mAlgorithm->RestoreState(mResumeCheckpoint->mAlgorithmState);
+			mTerminationMonitor = mResumeCheckpoint->mTerminationMonitor;
+			GenerationCount = mAlgorithm->GetGenerationCount();
 
-			check(path != nullptr);
+			mResumeCheckpoint.Reset();
+		}
+	}
+	else if (!mAlgorithm->IsGenerationInProgress())
+		mAlgorithm->SetSettings(GatherSettings());
 
-			// Force path to snap to terrain if possible
-			path->SnapToTerrain();
+	mTerminationMonitor.SetCriteria(GatherTerminationCriteria());
 
-			// Node amount calculation
-			const int32 node_amount = path->GetAmountOfNodes();
+	return true;
+}
 
-			if (node_amount < least_amount_of_nodes)
-				least_amount_of_nodes = node_amount;
 
-			if (node_amount > most_amount_of_nodes)
-				most_amount_of_nodes = node_amount;
 
-			// Distance calculations
-			const float distance_to_targetting_node = (targetting_location - path->GetLocationOfFinalNode()).Size();
+void APathManager::FinishGeneration(const float inBreedingTime)
+{
+	GenerationCount = mAlgorithm->GetGenerationCount();
 
-			if (distance_to_targetting_node < closest_distance)
-				closest_distance = distance_to_targetting_node;
+	const FGenerationInfo& generation_info = mAlgorithm->GetGenerationInfo();
+	const bool has_terminated = mTerminationMonitor.Update(GenerationCount, generation_info.mBestFitness, generation_info.mFitnessFactor, generation_info.mDiversity) != ETerminationReason::None;
 
-			if (distance_to_targetting_node > furthest_distance)
-				furthest_distance = distance_to_targetting_node;
+	// Everything that only matters to the viewer or the history file is skipped for the generations in between
+	// The rest is handed to the pipeline, so the next generation may start right away
+	// The final generation is always kept, even when it falls in between the visualized ones
+	if (has_terminated || ShouldVisualizeGeneration(generation_info.mGenerationNumber))
+		mPipeline->Submit(*mAlgorithm, inBreedingTime);
 
-			// Length calculation
-			const float path_length = path->GetLength();
-			
-			if (path_length < shortest_path_length)
-				shortest_path_length = path_length;
+	// The statistics of every generation are written, the stages in the background are those of the last generation through all of them
+	if (mStatisticsWriter.IsValid())
+	{
+		FGenerationStageTimings timings = mStageTimings;
+		timings.mBreeding = inBreedingTime;
+		mStatisticsWriter->Append(generation_info, timings);
+	}
 
-			if (path_length > longest_path_length)
-				longest_path_length = path_length;
+	// The lineage is small enough to be kept for every generation, the block it goes into is only compressed once full
+	if (mHistoryWriter.IsValid())
+		mHistoryWriter->AppendLineage(generation_info.mGenerationNumber, mAlgorithm->GetLineage());
 
-			// Trace & slope handling
-			const TArray<FVector>& genetic_representation = path->GetGeneticRepresentation();
-			for (int32 index = 1; index < genetic_representation.Num(); ++index)
-			{
-				const bool is_world_valid = GetWorld() != nullptr;
-				const bool is_current_index_valid = genetic_representation.IsValidIndex(index);
-				const bool is_previous_index_valid = genetic_representation.IsValidIndex(index - 1);
+	if (has_terminated)
+		TerminateRun(mTerminationMonitor);
+	else
+		SaveCheckpoint();
+}
 
-				if (is_world_valid && is_current_index_valid && is_previous_index_valid)
-				{
-					// Check for obstacles between previous and current node
-					// If a hit result is detected, either one of the nodes is in an obstacle or an obstacle is blocking the way
-					FHitResult obstacle_hit_result;
-					if (GetWorld()->LineTraceSingleByChannel(obstacle_hit_result, genetic_representation[index - 1], genetic_representation[index], ECollisionChannel::ECC_GameTraceChannel1))
-						path->MarkIsInObstacle();
-
-					// Check for terrain traveling (hidden)
-					FHitResult terrain_hit_result;
-					if (GetWorld()->LineTraceSingleByChannel(terrain_hit_result, genetic_representation[index - 1], genetic_representation[index], ECollisionChannel::ECC_GameTraceChannel4))
-						path->MarkTravelingThroughTerrain();
-				}
 
-				// Check if the head is able to see the target
-				// This is the case if no obstacles are in the way
-				if (is_world_valid && is_current_index_valid && index == genetic_representation.Num() - 1)
-				{
-					FHitResult hit_result;
-					if (!GetWorld()->LineTraceSingleByChannel(hit_result, genetic_representation[index], Nodes.IsValidIndex(1) ? Nodes[1]->GetActorLocation() : FVector::ZeroVector, ECollisionChannel::ECC_GameTraceChannel2))
-						path->MarkCanSeeTarget();
-				}
 
-				// Check if the path has reached the target
-				if ((Nodes[1]->GetActorLocation() - genetic_representation.Last()).Size() < 100.0f) // @TODO: Magic value, need radius of target node
-					path->MarkHasReachedTarget();
+void APathManager::UpdatePipeline()
+{
+	if (!mPipeline.IsValid())
+		return;
 
-				// Check if the slope between this node and the previous is inbetween the expected bounds
-				// Use dot product calculation between the vector between the two points and a vector with a constant Z
-				if (UseSlopeFitnessEvaluation)
-				{
-					if (is_current_index_valid && is_previous_index_valid)
-					{
-						FVector direction = genetic_representation[index] - genetic_representation[index - 1];
-						FVector collapsed_vector = direction;
-						collapsed_vector.Z = 0.0f;
-
-						direction.Normalize();
-						collapsed_vector.Normalize();
-
-						const float dot_product = FVector::DotProduct(direction, collapsed_vector);
-						const float radians = FMath::Acos(dot_product);
-						const float degrees = FMath::RadiansToDegrees(radians);
-
-						// Check if radians are radians and degrees are degrees, as Acos doesn't specify what the return value is
-						// Check Kismet
-						// UE_LOG(LogTemp, Warning, TEXT("Radians: %f Degrees: %f"), radians, degrees);
-
-						if (degrees > MaxSlopeToleranceAngle)
-							path->MarkSlopeTooIntense();
-					}
-				}
+	mPipeline->Update([this](const FGenerationSerializationData& inGeneration)
+	{
+		PresentGeneration(inGeneration);
+		LogGenerationInfo();
+	});
 
-				// Obstacle avoidance
-				if (ApplyObstacleAvoidanceLogic)
-				{
-					if (GetWorld() != nullptr && is_current_index_valid)
-					{
-						TArray<FVector> trace_ends;
-						
-						if (TraceBehaviour == EObstacleTraceBehaviour::WindDirectionTracing)
-						{
-							trace_ends.Reserve(8);
-
-							trace_ends.Add(FVector(1.0f, 0.0f, 0.0f) * TraceDistance); // East
-							trace_ends.Add(FVector(1.0f, -1.0f, 0.0f) * TraceDistance); // South-East
-							trace_ends.Add(FVector(0.0f, -1.0f, 0.0f) * TraceDistance); // South
-							trace_ends.Add(FVector(-1.0f, -1.0f, 0.0f) * TraceDistance); // South-West
-							trace_ends.Add(FVector(-1.0f, 0.0f, 0.0f) * TraceDistance); // West
-							trace_ends.Add(FVector(-1.0f, 1.0f, 0.0f) * TraceDistance); // North-West
-							trace_ends.Add(FVector(0.0f, 1.0f, 0.0f) * TraceDistance); // North
-							trace_ends.Add(FVector(1.0f, 1.0f, 0.0f) * TraceDistance); // North-East
-
-						}
-						else
-						{
-							trace_ends.Reserve(AmountOfCyclicPoints);
-
-							float degree = 0.0f;
-
-							for (int32 n = 0; n < AmountOfCyclicPoints; ++n)
-							{
-								trace_ends.Add(FVector(FMath::Sin(FMath::DegreesToRadians(degree)), FMath::Cos(FMath::DegreesToRadians(degree)), 0.0f) * TraceDistance);
-								degree += 360 / (float)(AmountOfCyclicPoints);
-							}
-						}
-
-						FVector start = genetic_representation[index];
-						for (const FVector& end : trace_ends)
-						{
-							FHitResult hit_result;
-							if (GetWorld()->LineTraceSingleByChannel(hit_result, start, start + end, ECollisionChannel::ECC_GameTraceChannel1))
-								path->AddObstacleHitMultiplierChunk(0.125f);
-
-							DrawDebugPoint(GetWorld(), start + end, 10, FColor::Cyan);
-						}
-					}
-				}
+	mStageTimings = mPipeline->GetTimings();
+}
 
-				// Max length fitness
-				if (UseMaxLengthFitness && is_current_index_valid && is_previous_index_valid)
-				{
-					const float length = (genetic_representation[index] - genetic_representation[index - 1]).Size();
-					if (length > MaxEuclidianDistance)
-						path->MarkDistanceBetweenChromosomesTooLarge();
-				}
-			}
-		}
-		else
-			UE_LOG(LogTemp, Warning, TEXT("APathManager::EvaluateFitness >> mPaths contains an invalid APath* at index %d"), i);
-	}
 
-	// ///////////////////////////////
-	// 2. CALCULATE AND ASSIGN FITNESS
-	// ///////////////////////////////
-	mTotalFitness = 0.0f;
-	int32 amount_of_nodes = 0;
-	int32 offenders = 0;
-	float highest_fitness = 0.0f;
-	for (int32 i = 0; i < mPaths.Num(); ++i)
-	{
-		APath* path = nullptr;
 
-		if (mPaths.IsValidIndex(i) && mPaths[i]->IsValidLowLevelFast())
-		{
-			path = mPaths[i];
+bool APathManager::ShouldVisualizeGeneration(const int32 inGenerationNumber) const
+{
+	return VisualizationInterval <= 1 || (inGenerationNumber % VisualizationInterval) == 0;
+}
 
-			check(path != nullptr);
 
-			// Need zero handling
-			float node_amount_blend_value = 0.0f;
-			if (least_amount_of_nodes - most_amount_of_nodes != 0)
-			{
-				node_amount_blend_value = (path->GetAmountOfNodes() - most_amount_of_nodes) / (least_amount_of_nodes - most_amount_of_nodes);
-			}
 
-			float proximity_blend_value = 0.0f;
-			if (FMath::Abs(closest_distance - furthest_distance) > 0.1f)
-			{
-				proximity_blend_value = ((targetting_location - path->GetLocationOfFinalNode()).Size() - furthest_distance) / (closest_distance - furthest_distance);
-			}
+bool APathManager::AreNodesValid() const
+{
+	return Nodes.IsValidIndex(0) && Nodes.IsValidIndex(1) && Nodes[0]->IsValidLowLevelFast() && Nodes[1]->IsValidLowLevelFast();
+}
 
-			float length_blend_value = 0.0f;
-			if (FMath::Abs(shortest_path_length - longest_path_length) > 0.1f)
-			{
-				length_blend_value = (path->GetLength() - longest_path_length) / (shortest_path_length - longest_path_length);
-			}
 
-			// Determine if the path is able to see the target node
-			float can_see_target_fitness = 0.0f;
-			if (path->GetCanSeeTarget())
-				can_see_target_fitness = CanSeeTargetWeight;
-			
-			// Path has reached target, mark fit
-			float target_reached_fitness = 0.0f;
-			if (path->GetHasReachedTarget())
-				target_reached_fitness = TargetReachedWeight;
-
-			// Should the path hit an obstacle, mark it unfit
-			float obstacle_multiplier = 1.0f;
-			if (path->GetIsInObstacle())
-				obstacle_multiplier = ObstacleHitMultiplier;
-
-			// Slope too intense for the path to continue on, mark unfit
-			float slope_too_intense_multiplier = 1.0f;
-			if (UseSlopeFitnessEvaluation && path->GetSlopeTooIntense())
-				slope_too_intense_multiplier = SlopeTooIntenseMultiplier;
-
-			// Path traveling through terrain?
-			float traveling_through_terrain_multiplier = 1.0f;
-			if (UseSlopeFitnessEvaluation && path->GetTravelingThroughTerrain())
-				traveling_through_terrain_multiplier = PiercesTerrainMultiplier;
-
-			// Obstacle avoidance?
-			// @TODO
-			float obstacle_avoidance_multiplier = 1.0f;
-			float obstacle_avoidance_weight = 0.0f;
-			if (ApplyObstacleAvoidanceLogic)
-			{
-				if (path->GetObstacleHitMultiplierChunk() > 0.0f)
-				{
-					obstacle_avoidance_multiplier = 0.0f;
-					obstacle_avoidance_weight = 0.0f;
-					++offenders;
-				}
-				else
-				{
-					obstacle_avoidance_weight = 100.0f;
-				}
-			}
 
-			// Distance between points too large?
-			float max_length_multiplier = 1.0f;
-			if (UseMaxLengthFitness)
-			{
-				if (path->GetDistanceBetweenChromosomesTooLarge())
-					max_length_multiplier = EuclidianOvershootMultiplier;
-			}
+/**
+* Copies the properties of the manager into the settings of the genetic algorithm
+* Assumes the nodes are valid
+*/
+FPathGeneticAlgorithmSettings APathManager::GatherSettings() const
+{
+	FPathGeneticAlgorithmSettings settings;
+
+	settings.mRandomSeed = RandomSeed;
+	settings.mPopulationCount = PopulationCount;
+	settings.mMaxInitialVariation = MaxInitialVariation;
+	settings.mMinAmountOfPointsPerPathAtStartup = MinAmountOfPointsPerPathAtStartup;
+	settings.mMaxAmountOfPointsPerPathAtStartup = MaxAmountOfPointsPerPathAtStartup;
+
+	settings.mStartLocation = Nodes[0]->GetActorLocation();
+	settings.mTargetLocation = Nodes[1]->GetActorLocation();
+	settings.mInvalidPathColor = InvalidPathColor;
+
+	settings.mAmountOfNodesWeight = AmountOfNodesWeight;
+	settings.mProximityToTargetedNodeWeight = ProximityToTargetedNodeWeight;
+	settings.mLengthWeight = LengthWeight;
+	settings.mCanSeeTargetWeight = CanSeeTargetWeight;
+	settings.mTargetReachedWeight = TargetReachedWeight;
+	settings.mObstacleHitMultiplier = ObstacleHitMultiplier;
+
+	settings.mUseSlopeFitnessEvaluation = UseSlopeFitnessEvaluation;
+	settings.mSlopeWeight = SlopeWeight;
+	settings.mSlopeTooIntenseMultiplier = SlopeTooIntenseMultiplier;
+	settings.mPiercesTerrainMultiplier = PiercesTerrainMultiplier;
+	settings.mMaxSlopeToleranceAngle = MaxSlopeToleranceAngle;
+
+	settings.mUseMaxLengthFitness = UseMaxLengthFitness;
+	settings.mMaxEuclidianDistance = MaxEuclidianDistance;
+	settings.mEuclidianOvershootMultiplier = EuclidianOvershootMultiplier;
+
+	settings.mCrossoverProbability = CrossoverProbability;
+	settings.mCrossoverOperator = CrossoverOperator;
+
+	settings.mTranslationMutationType = TranslationMutationType;
+	settings.mMutationProbability = MutationProbability;
+	settings.mTranslatePointProbability = TranslatePointProbability;
+	settings.mInsertionProbability = InsertionProbability;
+	settings.mDeletionProbability = DeletionProbability;
+	settings.mMaxTranslationOffset = MaxTranslationOffset;
+
+	settings.mApplyObstacleAvoidanceLogic = ApplyObstacleAvoidanceLogic;
+	settings.mTraceBehaviour = TraceBehaviour;
+	settings.mAmountOfCyclicPoints = AmountOfCyclicPoints;
+	settings.mTraceDistance = TraceDistance;
+
+	return settings;
+}
 
-			// Calculate final fitness based on the various weights and multipliers
-			const float weight_fitness = ((AmountOfNodesWeight * node_amount_blend_value) +
-											(ProximityToTargetedNodeWeight * proximity_blend_value) +
-											(LengthWeight * length_blend_value) +
-											can_see_target_fitness +
-											target_reached_fitness +
-											SlopeWeight +
-											obstacle_avoidance_weight);
-			const float weight_multiplier = obstacle_multiplier * slope_too_intense_multiplier * traveling_through_terrain_multiplier * max_length_multiplier * obstacle_avoidance_multiplier;
-			const float final_fitness = weight_fitness * weight_multiplier;
-
-			path->SetFitnessValues(final_fitness, AmountOfNodesWeight * node_amount_blend_value);
-			
-			// Caching
-			if (final_fitness > highest_fitness)
-				highest_fitness = final_fitness;
-			
-			mTotalFitness += final_fitness;
-			amount_of_nodes += path->GetGeneticRepresentation().Num();
-		}
-		else
-			UE_LOG(LogTemp, Warning, TEXT("APathManager::EvaluateFitness >> mPaths contains an invalid APath* at index %d"), i);
-	}
 
-	for (APath* path : mPaths)
-	{
-		check(path != nullptr);
 
-		if (path->GetFitness() == highest_fitness)
-			path->MarkFittestSolution();
-	}
+FGeneticTerminationCriteria APathManager::GatherTerminationCriteria() const
+{
+	FGeneticTerminationCriteria criteria;
 
+	criteria.mMaxGenerationCount = MaxGenerationCount;
+	criteria.mTargetFitnessFactor = TargetFitnessFactor;
+	criteria.mStagnationWindow = StagnationWindow;
+	criteria.mMinDiversity = MinDiversity;
 
-	AverageFitness = mTotalFitness / mPaths.Num();
-	
-	mGenerationInfo.mAverageFitness = AverageFitness;
-	mGenerationInfo.mAverageAmountOfNodes = amount_of_nodes / (float)mPaths.Num();
-	
-	const float max_fitness = AmountOfNodesWeight + ProximityToTargetedNodeWeight + LengthWeight + CanSeeTargetWeight + TargetReachedWeight + SlopeWeight;
-	mGenerationInfo.mMaximumFitness = max_fitness;
-	mGenerationInfo.mFitnessFactor = AverageFitness / max_fitness;
-		
-	// ////////////////////////////////////
-	// 3. SORT PATHS BY FITNESS, DESCENDING
-	// ////////////////////////////////////
-	mPaths.Sort([&](const APath& lhs, const APath& rhs) 
-	{
-		return lhs.GetFitness() > rhs.GetFitness();
-	});
+	return criteria;
 }
 
 
 
-void APathManager::SelectionStep()
+FPathQuantization APathManager::GatherHistoryQuantization() const
 {
-	mMatingPaths.Empty();
-	mMatingPaths.Reserve(PopulationCount);
+	FPathQuantization quantization;
 
-	// Still roulette wheel sampling
-	while (mMatingPaths.Num() < PopulationCount)
-	{
-		const float R = FMath::FRand();
-		float accumulated_fitness = 0.0f;
+	quantization.mIsEnabled = QuantizeHistory;
+	quantization.mOrigin = Nodes[0]->GetActorLocation();
+	quantization.mExtent = HistoryQuantizationExtent;
+	quantization.mPrecision = HistoryQuantizationPrecision;
+	quantization.mErrorBudget = HistoryQuantizationErrorBudget;
 
-		for (int32 i = 0; i < mPaths.Num(); ++i)
-		{
-			APath* path = nullptr;
+	return quantization;
+}
 
-			if (mPaths.IsValidIndex(i) && mPaths[i]->IsValidLowLevelFast())
-			{
-				path = mPaths[i];
 
-				accumulated_fitness += path->GetFitness() / mTotalFitness;
 
-				if (accumulated_fitness >= R)
-				{
-					mMatingPaths.Add(path);
-					break;
-				}
-			}
-			else
-				UE_LOG(LogTemp, Warning, TEXT("APathManager::SelectionStep >> mPaths contains an invalid APath* at index %d"), i);
-		}
-	}
+FPathHistoryFile::FCompressionSettings APathManager::GatherHistoryCompression() const
+{
+	FPathHistoryFile::FCompressionSettings compression;
+
+	compression.mLevel = FMath::Clamp(HistoryCompressionLevel, 0, 9);
+	compression.mBlockSize = HistoryCompressionBlockSize > 0 ? FMath::Max(HistoryCompressionBlockSize, 4) * 1024 : 0;
 
+	return compression;
 }
 
 
 
-void APathManager::CrossoverStep()
+FPathHistoryRetentionPolicy APathManager::GatherHistoryRetention() const
 {
-	TArray<APath*> temp;
-	temp.Reserve(PopulationCount);
+	FPathHistoryRetentionPolicy policy;
 
-	int32 successfull_crossover_amount = 0;
+	policy.mIsEnabled = LimitHistory;
+	policy.mRecentWindow = HistoryRecentWindow;
+	policy.mTierLength = HistoryTierLength;
+	policy.mMaxFullGenerations = HistoryMaxFullGenerations;
 
-	// Loop over the paths and try to apply crossover
-	for (int32 i = 0; i < mMatingPaths.Num(); i += 2)
-	{
-		const float R = FMath::FRandRange(0.0f, 100.0f);
+	return policy;
+}
 
-		// Crossover for a pair happens if crossover probability is met
-		if (R >= (100.0f - CrossoverProbability))
-		{
-			const APath* current_path = mMatingPaths[i];
-			const APath* next_path = mMatingPaths[i + 1];
-			const APath* smallest_path = nullptr;
-			const APath* bigger_path = nullptr;
-			
-			if (current_path->GetAmountOfNodes() < next_path->GetAmountOfNodes())
-			{
-				smallest_path = current_path;
-				bigger_path = next_path;
-			}
-			else
-			{
-				smallest_path = next_path;
-				bigger_path = current_path;
-			}
 
-			const int32 num_chromosomes_small = smallest_path->GetAmountOfNodes();
-			const int32 num_chromosomes_big = bigger_path->GetAmountOfNodes();
 
-			const bool variadic_length = current_path->GetAmountOfNodes() != next_path->GetAmountOfNodes();
+FPathStatisticsSettings APathManager::GatherStatisticsSettings() const
+{
+	FPathStatisticsSettings settings;
 
-			APath* offspring_0 = GetWorld()->SpawnActor<APath>(GetTransform().GetLocation(), GetTransform().GetRotation().Rotator());;
-			APath* offspring_1 = GetWorld()->SpawnActor<APath>(GetTransform().GetLocation(), GetTransform().GetRotation().Rotator());;
+	settings.mWriteCsv = WriteStatisticsCsv;
+	settings.mWriteBinary = WriteStatisticsBinary;
+	settings.mIncludeFitnessSpread = StatisticsIncludeFitnessSpread;
+	settings.mIncludeDiversity = StatisticsIncludeDiversity;
+	settings.mIncludeTimings = StatisticsIncludeTimings;
 
-			// Do crossover operation depending on selected operator
-			if (CrossoverOperator == ECrossoverOperator::SinglePoint)
-			{
-				const int32 crossover_index = FMath::RandRange(1, smallest_path->GetAmountOfNodes() - 1);
-				for (int32 j = 0; j < num_chromosomes_big; ++j)
-				{
-					if (j < num_chromosomes_small)
-					{
-						// Do regular crossover when indices are valid
-						if (j < crossover_index)
-						{
-							offspring_0->AddChromosome(smallest_path->GetChromosome(j));
-							offspring_1->AddChromosome(bigger_path->GetChromosome(j));
-						}
-						else
-						{
-							offspring_0->AddChromosome(bigger_path->GetChromosome(j));
-							offspring_1->AddChromosome(smallest_path->GetChromosome(j));
-						}
-					}
-					else
-					{
-						// Append the rest of the chromosomes to the children when
-						// The bigger path is more fit than the smaller one
-						// Only interesting if we remove part of the fitness calculation
-						if ((smallest_path->GetFitness() - smallest_path->GetAmountOfNodesFitness()) < (bigger_path->GetFitness() - bigger_path->GetAmountOfNodesFitness()))
-						{
-							offspring_0->AddChromosome(bigger_path->GetChromosome(j));
-							offspring_1->AddChromosome(bigger_path->GetChromosome(j));
-						}
-					}
-				}
-			}
-			else if (CrossoverOperator == ECrossoverOperator::DoublePoint)
-			{
-				const int32 first_crossover_index = FMath::FRandRange(1, smallest_path->GetAmountOfNodes() - 1);
-				const int32 second_crossover_index = FMath::FRandRange(first_crossover_index + 1, smallest_path->GetAmountOfNodes() - 1);
+	return settings;
+}
 
-				for (int32 j = 0; j < num_chromosomes_big; ++j)
-				{
-					if (j < num_chromosomes_small)
-					{
-						// Do double point crossover when indices are valid
-						if (j < first_crossover_index)
-						{
-							offspring_0->AddChromosome(smallest_path->GetChromosome(j));
-							offspring_1->AddChromosome(bigger_path->GetChromosome(j));
-						}
-						else if (j >= first_crossover_index && j < second_crossover_index)
-						{
-							offspring_0->AddChromosome(bigger_path->GetChromosome(j));
-							offspring_1->AddChromosome(smallest_path->GetChromosome(j));
-						}
-						else if (j >= second_crossover_index)
-						{
-							offspring_0->AddChromosome(smallest_path->GetChromosome(j));
-							offspring_1->AddChromosome(bigger_path->GetChromosome(j));
-						}
-					}
-					else
-					{
-						if ((smallest_path->GetFitness() - smallest_path->GetAmountOfNodesFitness()) < (bigger_path->GetFitness() - bigger_path->GetAmountOfNodesFitness()))
-						{
-							offspring_0->AddChromosome(bigger_path->GetChromosome(j));
-							offspring_1->AddChromosome(bigger_path->GetChromosome(j));
-						}
-					}
-				}
-			}
-			else if (CrossoverOperator == ECrossoverOperator::Uniform)
-			{
-				for (int32 j = 0; j < num_chromosomes_big; ++j)
-				{
-					if (j < num_chromosomes_small)
-					{
-						const float bias = FMath::FRandRange(0.0f, 100.0f);
-						if (bias < 50.0f)
-						{
-							offspring_0->AddChromosome(smallest_path->GetChromosome(j));
-							offspring_1->AddChromosome(bigger_path->GetChromosome(j));
-						}
-						else
-						{
-							offspring_0->AddChromosome(bigger_path->GetChromosome(j));
-							offspring_1->AddChromosome(smallest_path->GetChromosome(j));
-						}
-					}
-					else 
-					{
-						if ((smallest_path->GetFitness() - smallest_path->GetAmountOfNodesFitness()) < (bigger_path->GetFitness() - bigger_path->GetAmountOfNodesFitness()))
-						{
-							offspring_0->AddChromosome(bigger_path->GetChromosome(j));
-							offspring_1->AddChromosome(bigger_path->GetChromosome(j));
-						}
-					}
-				}
-			}
 
-			offspring_0->DetermineGeneticRepresentation();
-			offspring_1->DetermineGeneticRepresentation();
 
-			temp.Add(offspring_0);
-			temp.Add(offspring_1);
+/**
+* Starts the workers of a run, a single one or one per island
+* The island count is fixed for the duration of the run, the population is divided over the islands
+*/
+void APathManager::StartWorkers()
+{
+	const int32 island_count = FMath::Max(IslandCount, 1);
+	const float time_between_generations = GenerationRunMode == EGenerationRunMode::Delayed ? TimeBetweenGenerations : 0.0f;
 
-			++successfull_crossover_amount;
-		}
-		else // otherwise they are carried / copied over to the next generation
+	// Island runs round the population down to a multiple of the island count
+	const int32 island_population_count = island_count > 1 ? FMath::Max(PopulationCount / island_count, 2) : PopulationCount;
+
+	if (island_count > 1)
+		mMigrationHub = MakeUnique<FPathMigrationHub>(island_count);
+
+	OpenHistoryWriter(island_population_count * island_count, island_count);
+
+	// Migrants arrive whenever the other islands post them, so an island run can not be resumed the way it went
+	const FPathCheckpointSettings checkpoint_settings = GatherCheckpointSettings();
+	if (island_count > 1 && (CheckpointInterval > 0 || mResumeCheckpoint.IsValid()))
+		UE_LOG(LogTemp, Warning, TEXT("APathManager::StartWorkers >> Island runs do not support checkpoints!"));
+
+	const FPathCheckpoint* resume_checkpoint = island_count == 1 ? mResumeCheckpoint.Get() : nullptr;
+	if (resume_checkpoint != nullptr)
+		GenerationCount = resume_checkpoint->mAlgorithmState.mGenerationCount;
+
+	mWorkers.Reserve(island_count);
+
+	for (int32 i = 0; i < island_count; ++i)
+	{
+		FPathGeneticAlgorithmSettings settings = GatherSettings();
+
+		if (island_count > 1)
 		{
-			APath* duplicate_0 = GetWorld()->SpawnActor<APath>(GetTransform().GetLocation(), GetTransform().GetRotation().Rotator());
-			duplicate_0->SetGeneticRepresentation(mMatingPaths[i]->GetGeneticRepresentation());
-			duplicate_0->DetermineGeneticRepresentation();
-			temp.Add(duplicate_0);
-
-			APath* duplicate_1 = GetWorld()->SpawnActor<APath>(GetTransform().GetLocation(), GetTransform().GetRotation().Rotator());
-			duplicate_1->SetGeneticRepresentation(mMatingPaths[i+1]->GetGeneticRepresentation());
-			duplicate_1->DetermineGeneticRepresentation();
-			temp.Add(duplicate_1);
+			// Every island draws from its own random stream
+			settings.mPopulationCount = island_population_count;
+			if (RandomSeed != 0)
+				settings.mRandomSeed = RandomSeed + i * 7919;
 		}
-	}
 
-	Purge(); // Get rid of the old paths
+		FPathMigrationSettings migration_settings;
+		migration_settings.mHub = mMigrationHub.Get();
+		migration_settings.mIslandIndex = i;
+		migration_settings.mMigrationInterval = MigrationInterval;
+		migration_settings.mMigrantAmount = MigrantCount;
+		migration_settings.mTopology = MigrationTopology;
 
-	mPaths = temp; // Keep track of the new paths
+		mWorkers.Add(MakeUnique<FPathGeneticWorker>(GetWorld(), settings, VisualizationInterval, time_between_generations, GatherTerminationCriteria(), mHistoryWriter.Get(), mStatisticsWriter.Get(), migration_settings,
+			island_count == 1 ? &checkpoint_settings : nullptr, resume_checkpoint));
+	}
 
-	mGenerationInfo.mCrossoverAmount = successfull_crossover_amount;
+	mResumeCheckpoint.Reset();
 }
 
 
-void APathManager::MutationStep()
+
+void APathManager::ResetWorkers()
 {
-	// Keep track of the mutation amount this generation
-	int32 successful_translation_mutations = 0;
-	int32 successful_insertion_mutations = 0;
-	int32 successful_deletion_mutations = 0;
+	// The hub has to outlive the workers posting into it
+	mWorkers.Reset();
+	mMigrationHub.Reset();
+}
 
-	for (APath* path : mPaths)
+
+
+bool APathManager::HaveWorkersFinishedRun() const
+{
+	for (const TUniquePtr<FPathGeneticWorker>& worker : mWorkers)
 	{
-		// Every path may be considered for mutation
-		const float rand = FMath::FRandRange(0.0f, 100.0f);
-		if (rand < MutationProbability)
-		{
-			// Determine which mutations occur
-			bool do_translation_mutation = false;
-			bool do_insertion_mutation = false;
-			bool do_deletion_mutation = false;
+		if (!worker->HasFinishedRun())
+			return false;
+	}
 
-			const float translate_point_probability = FMath::FRandRange(0, 100.0f);
-			if (translate_point_probability < TranslatePointProbability)
-				do_translation_mutation = true;
+	return true;
+}
 
-			const float insert_point_probability = FMath::FRandRange(0, 100.0f);
-			if (insert_point_probability < InsertionProbability)
-				do_insertion_mutation = true;
 
-			// Only do insertion or deletion in the same mutation step
-			if (!do_insertion_mutation)
-			{
-				const float deletion_probability = FMath::FRandRange(0, 100.0f);
-				if (deletion_probability < DeletionProbability)
-					do_deletion_mutation = true;
-			}
 
-			// Then do mutations
-			if (do_translation_mutation)
-			{
-				path->MutateThroughTranslation(TranslationMutationType, MaxTranslationOffset);
-				++successful_translation_mutations;
-			}	
-			if (do_insertion_mutation)
-			{
-				path->MutateThroughInsertion();
-				++successful_insertion_mutations;
-			}
-			if (do_deletion_mutation)
-			{
-				path->MutateThroughDeletion();
-				++successful_deletion_mutations;
-			}
+/**
+* A single worker meeting its termination criteria ends the run, for island runs that means all islands stop
+*/
+void APathManager::CheckWorkerTermination()
+{
+	for (const TUniquePtr<FPathGeneticWorker>& worker : mWorkers)
+	{
+		if (worker->HasTerminated())
+		{
+			TerminateRun(worker->GetTerminationMonitor());
+			return;
 		}
 	}
-
-	// Keep track of the mutation amount
-	mGenerationInfo.mAmountOfTranslationMutations = successful_translation_mutations;
-	mGenerationInfo.mAmountOfInsertionMutations = successful_insertion_mutations;
-	mGenerationInfo.mAmountOfDeletionMutations = successful_deletion_mutations;
 }
 
 
 
-void APathManager::Purge()
+/**
+* Shows the latest generation the workers have published, if any
+* Older generations which were published in the mean time are never shown, they do end up in the history of the workers
+* The islands of an island run are shown side by side, each at the latest generation it has published
+*/
+void APathManager::ConsumeWorkerSnapshot()
 {
-	for (int32 i = mMatingPaths.Num() - 1; i > -1; --i)
+	check(mWorkers.Num() > 0);
+
+	bool has_updated = false;
+	for (TUniquePtr<FPathGeneticWorker>& worker : mWorkers)
+		has_updated |= worker->UpdateSnapshot();
+
+	if (!has_updated)
+		return;
+
+	const FGenerationSerializationData* snapshot = &mWorkers[0]->GetSnapshot();
+
+	if (mWorkers.Num() > 1)
 	{
-		if (mMatingPaths.IsValidIndex(i) && mMatingPaths[i]->IsValidLowLevelFast())
-			mMatingPaths[i]->Destroy();
+		TArray<const FGenerationSerializationData*> island_snapshots;
+		for (const TUniquePtr<FPathGeneticWorker>& worker : mWorkers)
+			island_snapshots.Add(&worker->GetSnapshot());
 
-		if (mPaths.IsValidIndex(i) && mPaths[i]->IsValidLowLevelFast())
-			mPaths[i]->Destroy();
+		FPathMigrationHub::CombineIslandGenerations(island_snapshots, mCombinedSnapshot);
+		snapshot = &mCombinedSnapshot;
 	}
+
+	GenerationCount = snapshot->mGenerationInfo.mGenerationNumber + 1;
+
+	PresentGeneration(*snapshot);
+	LogGenerationInfo();
 }
 
 
 
-void APathManager::ColorCodePathsByFitness()
+/**
+* Spawns a display path at the location of the manager
+*/
+APath* APathManager::SpawnPath()
 {
-	float lowest_fitness = TNumericLimits<float>::Max();
-	float highest_fitness = 0.0f;
+	INC_DWORD_STAT(STAT_GeneticTriangles_ActorsSpawned);
 
-	// Cache lowest & highest fitness first
-	// @TODO: Do this in the loop of EvaluateFitness()
-	for (const APath* path : mPaths)
-	{
-		const float fitness = path->GetFitness();
+	return GetWorld()->SpawnActor<APath>(GetTransform().GetLocation(), GetTransform().GetRotation().Rotator());
+}
 
-		if (fitness < lowest_fitness)
-			lowest_fitness = fitness;
-		if (fitness > highest_fitness)
-			highest_fitness = fitness;
-	}
 
-	for (APath* path : mPaths)
+
+/**
+* Shows a captured or deserialized generation through the display paths
+* Display paths are reused, only the difference in population size is spawned or destroyed
+*/
+void APathManager::PresentGeneration(const FGenerationSerializationData& inGeneration)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GeneticTriangles_Presentation);
+
+	const TArray<FPathSerializationData>& paths = inGeneration.mPathSerializationData;
+
+	while (mPaths.Num() < paths.Num())
 	{
+		APath* path = SpawnPath();
+
 		check(path != nullptr);
 
-		if (path->GetIsInObstacle() || path->GetSlopeTooIntense() || path->GetTravelingThroughTerrain() || path->GetDistanceBetweenChromosomesTooLarge())
+		mPaths.Add(path);
+	}
+
+	while (mPaths.Num() > paths.Num())
+	{
+		APath* path = mPaths.Pop(false);
+		if (path != nullptr && path->IsValidLowLevel())
 		{
-			// Completely unfit paths are marked grey
-			path->SetColorCode(InvalidPathColor);
+			path->Dispose();
+			INC_DWORD_STAT(STAT_GeneticTriangles_ActorsDestroyed);
 		}
-		else
-		{
-			// Apply color coding based on the lowest and highest fitness values
-			const float fitness = path->GetFitness();
-			const float blend_value = (fitness - highest_fitness) / (lowest_fitness - highest_fitness);
+	}
+
+	for (int32 i = 0; i < paths.Num(); ++i)
+	{
+		check(mPaths[i] != nullptr);
+
+		mPaths[i]->ApplySerializationData(paths[i]);
+	}
+
+	mGenerationInfo = inGeneration.mGenerationInfo;
+	AverageFitness = mGenerationInfo.mAverageFitness;
+}
 
-			FColor red = FColor::Red;
-			FColor green = FColor::Green;
 
-			FColor blended;
-			blended.A = 255;
-			blended.R = FMath::Lerp(red.R, green.R, 1.0f - blend_value * 255);
-			blended.G = FMath::Lerp(red.G, green.G, 1.0f - blend_value * 255);
-			blended.B = 0;
 
-			path->SetColorCode(blended);
+void APathManager::Purge()
+{
+	SCOPE_CYCLE_COUNTER(STAT_GeneticTriangles_Purge);
+
+	for (APath* path : mPaths)
+	{
+		if (path != nullptr && path->IsValidLowLevel())
+		{
+			path->Dispose();
+			INC_DWORD_STAT(STAT_GeneticTriangles_ActorsDestroyed);
 		}
 	}
+
+	// Keep memory allocated
+	mPaths.Empty(mPaths.Num());
 }
 
 
+
 void APathManager::LogGenerationInfo()
 {
 	// AutoRun > map has no UI support
@@ -780,6 +632,7 @@ void APathManager::LogGenerationInfo()
 	{
 		GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Black, TEXT("\n\n"));
 
+		GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Silver, TEXT("Frames for generation: ") + FString::FromInt(mGenerationInfo.mFrameCount));
 		GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Green, TEXT("Average amount of nodes: ") + FString::SanitizeFloat(mGenerationInfo.mAverageAmountOfNodes));
 		GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::White, TEXT("Fitness factor: ") + FString::SanitizeFloat(mGenerationInfo.mFitnessFactor));
 		GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Cyan, TEXT("Maximum fitness: ") + FString::SanitizeFloat(mGenerationInfo.mMaximumFitness));
@@ -806,7 +659,23 @@ void APathManager::ChangeAnimationControlState(const EAnimationControlState inAn
 			(mPreviousAnimationControlState == EAnimationControlState::Pause && mNextAnimationControlState == EAnimationControlState::Play) ||
 			(mPreviousAnimationControlState == EAnimationControlState::Pause && mNextAnimationControlState == EAnimationControlState::Stop))
 		{
+			// A new run on worker threads starts with fresh workers, the settings are fixed for the duration of the run
+			// Island runs always use worker threads
+			if (mPreviousAnimationControlState == EAnimationControlState::Limbo && (RunOnWorkerThread || IslandCount > 1))
+			{
+				if (!AreNodesValid())
+				{
+					UE_LOG(LogTemp, Warning, TEXT("APathManager::ChangeAnimationControlState >> One of the nodes is invalid!"));
+					return;
+				}
+
+				StartWorkers();
+			}
+
 			mPreviousAnimationControlState = mNextAnimationControlState;
+
+			for (TUniquePtr<FPathGeneticWorker>& worker : mWorkers)
+				worker->EnqueueCommand(mNextAnimationControlState);
 		}
 	}
 
@@ -819,29 +688,52 @@ void APathManager::ChangeAnimationControlState(const EAnimationControlState inAn
 
 
 
+/**
+* Ends a run that met its termination criteria, the same way as pressing stop would
+* The run is serialized and disposed of by StopRun once every worker has finished its current generation
+*/
+void APathManager::TerminateRun(const FGeneticTerminationMonitor& inTerminationMonitor)
+{
+	const FString description = inTerminationMonitor.GetDescription();
+
+	UE_LOG(LogTemp, Display, TEXT("APathManager::TerminateRun >> %s: %s"), FGeneticTerminationMonitor::GetReasonName(inTerminationMonitor.GetReason()), *description);
+
+	if (GEngine != nullptr)
+		GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Emerald, TEXT("Run terminated: ") + description);
+
+	ChangeAnimationControlState(EAnimationControlState::Stop);
+}
+
+
+
 void APathManager::StopRun()
 {
-	// @TODO: Serialize data
-	SerializeData();
-	
-	// Reset data
-	GenerationCount = 0;
-	
-	// Get rid of paths
-	// Keep memory allocated
-	for (APath* path : mPaths)
+	// Show the final generation of the workers, they have written their last chunk by now
+	if (mWorkers.Num() > 0)
 	{
-		if (path != nullptr && path->IsValidLowLevel())
-			path->Dispose();
+		ConsumeWorkerSnapshot();
+		ResetWorkers();
 	}
-	mPaths.Empty(mPaths.Num());
 
-	for (APath* path : mMatingPaths)
+	// Same goes for the pipeline, recording the generations in flight is left to the save
+	if (mPipeline.IsValid())
 	{
-		if (path != nullptr && path->IsValidLowLevel())
-			path->Dispose();
+		mPipeline->WaitForColorCoding();
+		UpdatePipeline();
 	}
-	mMatingPaths.Empty(mMatingPaths.Num());
+
+	mAlgorithm.Reset();
+	mTerminationMonitor.Reset();
+	mCheckpointWriter.Reset();
+	mStatisticsWriter.Reset();
+	mIsCheckpointRequested = false;
+
+	SerializeData();
+
+	GenerationCount = 0;
+	
+	// Get rid of paths
+	Purge();
 	
 	// Stop generation cycle
 	mPreviousAnimationControlState = EAnimationControlState::Limbo;
@@ -850,212 +742,292 @@ void APathManager::StopRun()
 
 
 
-void APathManager::SerializeData()
+/**
+* Starts a new history file for the run, the stored generations are appended to it while the run is going
+* The statistics files of the run are started next to it
+*/
+void APathManager::OpenHistoryWriter(const int32 inPopulationCount, const int32 inIslandCount)
 {
-	// Create a directory for us to safely work in
-	// @TODO: This assumes that the PC has a D drive
-	//		  WINAPI function, research what happens if drive does not exist
-	IFileManager& file_manager = IFileManager::Get();
-	const FString target_directory("D:/GeneticTrianglesOutput");
-	if (file_manager.DirectoryExists(*target_directory))
-		file_manager.MakeDirectory(*target_directory);
-
-	FBufferArchive archive;
-	archive.Reserve(1000000);
-	{
-		// Write ALL info to the buffer
+	// The run takes over the display paths of the replay
+	mReplayCache.Reset();
 
-		// Write generation count & population count
-		archive << GenerationCount;
-		archive << PopulationCount;
+	const FString file_path = FPathHistoryFile::MakeRunFilePath(GetHistoryDirectory());
 
-		// Write paths to the archive
-		for (int i = 0; i < mSerializationData.Num(); ++i) // Iterates per generation
-		{
-			for (int j = 0; j < mSerializationData[i].mPathSerializationData.Num(); ++j) // Iterates per path
-			{
-				archive << mSerializationData[i].mPathSerializationData[j].mNodeAmount;
+	mHistoryWriter = MakeUnique<FPathHistoryWriter>();
 
-				for (int k = 0; k < mSerializationData[i].mPathSerializationData[j].mGeneticRepresentation.Num(); ++k)
-				{
-					archive << mSerializationData[i].mPathSerializationData[j].mGeneticRepresentation[k];
-				}
+	if (!mHistoryWriter->Open(file_path, inPopulationCount, inIslandCount, HistoryKeyframeInterval, GatherHistoryQuantization(), GatherHistoryCompression(), RecordLineage))
+		UE_LOG(LogTemp, Warning, TEXT("APathManager::OpenHistoryWriter >> The run will not be recorded!"));
 
-				archive << mSerializationData[i].mPathSerializationData[j].mColor;
-				archive << mSerializationData[i].mPathSerializationData[j].mFittest;
-			}
+	mStatisticsWriter.Reset();
 
-			archive << mSerializationData[i].mGenerationInfo.mAmountOfDeletionMutations;
-			archive << mSerializationData[i].mGenerationInfo.mAmountOfInsertionMutations;
-			archive << mSerializationData[i].mGenerationInfo.mAmountOfTranslationMutations;
-			archive << mSerializationData[i].mGenerationInfo.mAverageAmountOfNodes;
-			archive << mSerializationData[i].mGenerationInfo.mAverageFitness;
-			archive << mSerializationData[i].mGenerationInfo.mCrossoverAmount;
-			archive << mSerializationData[i].mGenerationInfo.mFitnessFactor;
-			archive << mSerializationData[i].mGenerationInfo.mGenerationNumber;
-			archive << mSerializationData[i].mGenerationInfo.mMaximumFitness;
-		}
+	const FPathStatisticsSettings statistics_settings = GatherStatisticsSettings();
+	if (statistics_settings.IsEnabled())
+	{
+		mStatisticsWriter = MakeUnique<FPathStatisticsWriter>();
+		if (!mStatisticsWriter->Open(file_path, statistics_settings))
+			mStatisticsWriter.Reset();
 	}
-	
-	TArray<uint8> compressed_data;
-	FArchiveSaveCompressedProxy compressor = FArchiveSaveCompressedProxy(compressed_data, ECompressionFlags::COMPRESS_ZLIB);
+}
 
-	compressor << archive;
-	compressor.Flush();
 
-	const FString file_path("D:/GeneticTrianglesOutput/Paths.ga");
-	if (FFileHelper::SaveArrayToFile(compressed_data, *file_path))
-	{
-		compressor.FlushCache();
-		compressed_data.Empty();
 
-		archive.FlushCache();
-		archive.Empty();
-		archive.Close();
+/**
+* Every stored generation is already in the history file, or on its way there
+* Recording the rest and closing the file is handed to a background save, together with the pipeline of the run
+*/
+void APathManager::SerializeData()
+{
+	if (!mHistoryWriter.IsValid())
+	{
+		mPipeline.Reset();
+		return;
 	}
-	else
+
+	mPendingSaves.Add(MakeUnique<FPathHistorySave>(MoveTemp(mHistoryWriter), MoveTemp(mPipeline), GatherHistoryRetention()));
+}
+
+
+
+/**
+* Reports the saves that have finished, on the game thread
+*/
+void APathManager::UpdatePendingSaves()
+{
+	for (int32 i = 0; i < mPendingSaves.Num(); ++i)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("APathManager::SerializeData >> Unable to serialize data!"));
+		const FPathHistorySave& save = *mPendingSaves[i];
+		if (!save.IsComplete())
+			continue;
+
+		if (save.HasSucceeded())
+			mLatestHistoryFilePath = save.GetFilePath();
+		else
+			UE_LOG(LogTemp, Warning, TEXT("APathManager::UpdatePendingSaves >> Unable to save %s!"), *save.GetFilePath());
+
+		const FString file_path = save.GetFilePath();
+		const bool has_succeeded = save.HasSucceeded();
+
+		mPendingSaves.RemoveAt(i--);
+
+		OnHistorySaved.Broadcast(file_path, has_succeeded);
 	}
 }
 
 
 
-void APathManager::DeserializeData()
+void APathManager::FinishPendingSaves()
 {
-	const FString file_path("D:/GeneticTrianglesOutput/Paths.ga");
+	for (TUniquePtr<FPathHistorySave>& save : mPendingSaves)
+		save->Wait();
 
-	IFileManager& file_manager = IFileManager::Get();
-	if (!file_manager.FileExists(*file_path))
-		return;
+	UpdatePendingSaves();
+}
 
-	TArray<uint8> compressed_data;
-	FFileHelper::LoadFileToArray(compressed_data, *file_path);
 
-	FArchiveLoadCompressedProxy decompressor = FArchiveLoadCompressedProxy(compressed_data, ECompressionFlags::COMPRESS_ZLIB);
-	
-	FBufferArchive decompressed_data;
-	decompressor << decompressed_data;
 
-	FMemoryReader from_binary = FMemoryReader(decompressed_data, true);
-	from_binary.Seek(0);
+FString APathManager::GetHistoryDirectory() const
+{
+	if (HistoryOutputDirectory.Path.IsEmpty())
+		return FPathHistoryFile::GetDefaultDirectory();
 
-	// Restore settings from data
-	{
-		mDeserializationData.Reserve(20000);
+	if (FPaths::IsRelative(HistoryOutputDirectory.Path))
+		return FPaths::GameDir() / HistoryOutputDirectory.Path;
 
-		int32 total_amount_of_generations = 0;
-		from_binary << total_amount_of_generations;
+	return HistoryOutputDirectory.Path;
+}
 
-		int32 population_size = 0;
-		from_binary << population_size;
 
-		// Prepare data for post deserialization
-		mDeserializedDataGenerationAmount = total_amount_of_generations;
-		mDeserializedDataPopulationAmount = population_size;
 
-		for (int32 generation_index = 0; generation_index < total_amount_of_generations; ++generation_index) // Iterate per generation
-		{
-			FGenerationSerializationData generation_data;
+FString APathManager::GetCheckpointFilePath() const
+{
+	return GetHistoryDirectory() / TEXT("Checkpoint.gacp");
+}
 
-			TArray<FPathSerializationData>& all_paths = generation_data.mPathSerializationData;
 
-			for (int32 path_index = 0; path_index < population_size; ++path_index) // Iterate per path
-			{
-				// Start filling up the DeserializationData array with the deserialized data
-				FPathSerializationData deserialized_path_data;
-				from_binary << deserialized_path_data.mNodeAmount;
 
-				deserialized_path_data.mGeneticRepresentation.Reserve(deserialized_path_data.mNodeAmount);
+FPathCheckpointSettings APathManager::GatherCheckpointSettings() const
+{
+	FPathCheckpointSettings settings;
 
-				for (int32 location_index = 0; location_index < deserialized_path_data.mNodeAmount; ++location_index) // Iterate per chromosome
-				{
-					FVector node_location;
-					from_binary << node_location;
+	settings.mFilePath = GetCheckpointFilePath();
+	settings.mInterval = CheckpointInterval;
+	ExportConfiguration(settings.mProperties);
 
-					deserialized_path_data.mGeneticRepresentation.Add(node_location);
-				}
+	return settings;
+}
 
-				from_binary << deserialized_path_data.mColor;
-				from_binary << deserialized_path_data.mFittest;
 
-				all_paths.Add(deserialized_path_data);
-			}
 
-			from_binary << generation_data.mGenerationInfo.mAmountOfDeletionMutations;
-			from_binary << generation_data.mGenerationInfo.mAmountOfInsertionMutations;
-			from_binary << generation_data.mGenerationInfo.mAmountOfTranslationMutations;
-			from_binary << generation_data.mGenerationInfo.mAverageAmountOfNodes;
-			from_binary << generation_data.mGenerationInfo.mAverageFitness;
-			from_binary << generation_data.mGenerationInfo.mCrossoverAmount;
-			from_binary << generation_data.mGenerationInfo.mFitnessFactor;
-			from_binary << generation_data.mGenerationInfo.mGenerationNumber;
-			from_binary << generation_data.mGenerationInfo.mMaximumFitness;
-
-			mDeserializationData.Add(generation_data);
-		}
+/**
+* Exports every editable property of the path manager as text, the nodes and other references to the world are left out
+*/
+void APathManager::ExportConfiguration(TArray<TPair<FString, FString>>& outProperties) const
+{
+	outProperties.Reset();
+
+	for (TFieldIterator<UProperty> it(APathManager::StaticClass(), EFieldIteratorFlags::ExcludeSuper); it; ++it)
+	{
+		const UProperty* property = *it;
+		if (!property->HasAnyPropertyFlags(CPF_Edit) || property->ContainsObjectReference())
+			continue;
+
+		FString value;
+		property->ExportTextItem(value, property->ContainerPtrToValuePtr<void>(this), nullptr, nullptr, PPF_None);
+
+		outProperties.Add(TPair<FString, FString>(property->GetName(), value));
 	}
+}
+
 
-	compressed_data.Empty();
-	decompressor.FlushCache();
-	from_binary.FlushCache();
 
-	decompressed_data.Empty();
-	decompressed_data.Close();
+/**
+* Properties that no longer exist are skipped, properties that were added since keep their current value
+*/
+void APathManager::ImportConfiguration(const TArray<TPair<FString, FString>>& inProperties)
+{
+	for (const TPair<FString, FString>& entry : inProperties)
+	{
+		UProperty* property = FindField<UProperty>(APathManager::StaticClass(), *entry.Key);
+		if (property == nullptr || property->ImportText(*entry.Value, property->ContainerPtrToValuePtr<void>(this), PPF_None, this) == nullptr)
+			UE_LOG(LogTemp, Warning, TEXT("APathManager::ImportConfiguration >> Unable to restore %s!"), *entry.Key);
+	}
+}
 
-	// If the following line breaks the application, then something went wrong during the (de)serialization process
-	FPathSerializationData test = mDeserializationData[0].mPathSerializationData[0];
 
-	PostDeserialize();
+
+/**
+* Writes a checkpoint of the run on the game thread as soon as the current generation has finished
+* Runs on worker threads take the checkpoint on their own thread
+*/
+void APathManager::RequestCheckpoint()
+{
+	if (mWorkers.Num() > 1)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("APathManager::RequestCheckpoint >> Island runs do not support checkpoints!"));
+		return;
+	}
+
+	if (mWorkers.Num() == 1)
+		mWorkers[0]->RequestCheckpoint();
+	else if (mAlgorithm.IsValid())
+		mIsCheckpointRequested = true;
+	else
+		UE_LOG(LogTemp, Warning, TEXT("APathManager::RequestCheckpoint >> There is no run to checkpoint!"));
 }
 
 
 
 /**
-* Adds the information of the current generation to the data which will be serialized at the end
+* Starts a new run from the latest checkpoint, with the configuration it was written with
+* The resumed run continues bit for bit the way the original run would have, and is recorded into a new history file
 */
-void APathManager::AddGenerationInfoToSerializableData()
+bool APathManager::ResumeFromCheckpoint()
 {
-	FGenerationSerializationData data_to_add;
-	data_to_add.mGenerationInfo = mGenerationInfo;
+	if (mPreviousAnimationControlState != EAnimationControlState::Limbo)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("APathManager::ResumeFromCheckpoint >> The current run has to be stopped first!"));
+		return false;
+	}
+
+	TUniquePtr<FPathCheckpoint> checkpoint = MakeUnique<FPathCheckpoint>();
+	if (!FPathCheckpointFile::Load(GetCheckpointFilePath(), *checkpoint))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("APathManager::ResumeFromCheckpoint >> Unable to load %s!"), *GetCheckpointFilePath());
+		return false;
+	}
 
-	// Create an array of path serialization data
-	// Every entry corresponds to a path
-	TArray<FPathSerializationData>& serializable_data_of_paths = data_to_add.mPathSerializationData;
-	serializable_data_of_paths.Reserve(PopulationCount);
+	ImportConfiguration(checkpoint->mProperties);
 
-	// Add each path
-	for (const APath* path : mPaths)
+	if (checkpoint->mAlgorithmState.mGenomes.Num() != PopulationCount)
 	{
-		check(path != nullptr);
-		check(path->IsValidLowLevel());
+		UE_LOG(LogTemp, Warning, TEXT("APathManager::ResumeFromCheckpoint >> The checkpoint does not match the population count!"));
+		return false;
+	}
+
+	mResumeCheckpoint = MoveTemp(checkpoint);
+	ChangeAnimationControlState(EAnimationControlState::Play);
+
+	// The run could not start, the checkpoint is not kept around for the next one
+	if (mPreviousAnimationControlState == EAnimationControlState::Limbo)
+	{
+		mResumeCheckpoint.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+
+
+/**
+* Takes a checkpoint of the run on the game thread if one is due, only the copy of the state happens here
+*/
+void APathManager::SaveCheckpoint()
+{
+	if (!mCheckpointWriter.IsValid() || mCheckpointWriter->IsSaving())
+		return;
+
+	const bool is_checkpoint_due = CheckpointInterval > 0 && GenerationCount > 0 && (GenerationCount % CheckpointInterval) == 0;
+	if (!mIsCheckpointRequested && !is_checkpoint_due)
+		return;
+
+	mIsCheckpointRequested = false;
+
+	TUniquePtr<FPathCheckpoint> checkpoint = MakeUnique<FPathCheckpoint>();
+	ExportConfiguration(checkpoint->mProperties);
+	checkpoint->mTerminationMonitor = mTerminationMonitor;
+	mAlgorithm->SaveState(checkpoint->mAlgorithmState);
+
+	mCheckpointWriter->Save(MoveTemp(checkpoint));
+}
+
+
+
+void APathManager::DeserializeData()
+{
+	// A run that is still going is finished first, and every history file has to be complete before it can be replayed
+	if (mHistoryWriter.IsValid())
+		StopRun();
 
-		// Make sure everything corresponds to the path
-		FPathSerializationData path_serialization_data;
-		
-		path_serialization_data.mNodeAmount = path->GetAmountOfNodes();
-		
-		path_serialization_data.mGeneticRepresentation.Reserve(path->GetAmountOfNodes());
-		path_serialization_data.mGeneticRepresentation = path->GetGeneticRepresentation();
+	FinishPendingSaves();
 
-		path_serialization_data.mColor = path->GetColorCode();
+	const FString file_path = !mLatestHistoryFilePath.IsEmpty() ? mLatestHistoryFilePath : FPathHistoryFile::FindLatestFile(GetHistoryDirectory());
+	if (file_path.IsEmpty())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("APathManager::DeserializeData >> There is no history file in %s!"), *GetHistoryDirectory());
+		return;
+	}
 
-		path_serialization_data.mFittest = path->GetFittestSolution();
+	// Files of older versions are converted once, after which they open like any other
+	if (FPathHistoryFile::IsLegacyFile(file_path) && !FPathHistoryFile::ConvertLegacyFile(file_path, file_path))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("APathManager::DeserializeData >> Unable to convert %s to the latest format!"), *file_path);
+		return;
+	}
 
-		// Then add it to the serialization array
-		serializable_data_of_paths.Add(path_serialization_data);
+	// The file is mapped and only the header and the chunk index are read here, the generations are decoded in the background while scrubbing
+	TUniquePtr<FPathHistoryReader> history_reader = MakeUnique<FPathHistoryReader>();
+	if (!history_reader->Open(file_path) || history_reader->GetGenerationAmount() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("APathManager::DeserializeData >> Unable to deserialize data!"));
+		return;
 	}
 
-	// At the end, add the data to the data which will be serialized
-	mSerializationData.Add(data_to_add);
+	mReplayCache = MakeUnique<FPathReplayCache>(MoveTemp(history_reader), ReplayCacheCapacity, ReplayPrefetchAmount);
+
+	// Prepare data for post deserialization
+	mDeserializedDataGenerationAmount = mReplayCache->GetGenerationAmount();
+	mDeserializedDataPopulationAmount = mReplayCache->GetPopulationCount();
+
+	PostDeserialize();
 }
 
 
 
 void APathManager::HandleScrubUpdate(const float inScrubValue)
 {
-	mDeserializedDataScrubIndex = FMath::FloorToInt(mDeserializedDataGenerationAmount * inScrubValue);
-	
+	mDeserializedDataScrubIndex = FMath::Clamp(FMath::FloorToInt(mDeserializedDataGenerationAmount * inScrubValue), 0, FMath::Max(mDeserializedDataGenerationAmount - 1, 0));
+
 	UpdateScrub();
 }
 
@@ -1064,81 +1036,67 @@ void APathManager::HandleScrubUpdate(const float inScrubValue)
 void APathManager::PostDeserialize()
 {
 	// Stop running cycles
+	ResetWorkers();
+	mPipeline.Reset();
+	mAlgorithm.Reset();
+	mCheckpointWriter.Reset();
+	mStatisticsWriter.Reset();
 	mPreviousAnimationControlState = EAnimationControlState::Limbo;
 	mNextAnimationControlState = EAnimationControlState::Limbo;
 
 	// Purge old paths if there are any alive
 	Purge();
 
-	// Initialize new paths based on deserializeddata
-	DeserializeInitialization();
-
 	// Then reset the access index for scrubbing through the data
 	mDeserializedDataScrubIndex = 0;
+	mScrubGenerationIndex = INDEX_NONE;
+
+	// Initialize new paths based on deserializeddata
+	DeserializeInitialization();
 }
 
 
 
 void APathManager::DeserializeInitialization()
 {
-	//@TODO: Consider merging this with the standard initialization function
-	
-	// Create population
-	mPaths.Empty();
-	mPaths.Reserve(PopulationCount);
-
-	for (int32 i = 0; i < mDeserializedDataPopulationAmount; ++i)
-	{
-		APath* path = GetWorld()->SpawnActor<APath>(GetTransform().GetLocation(), GetTransform().GetRotation().Rotator());
-
-		check(path != nullptr);
-		
-		path->SetGeneticRepresentation(mDeserializationData[mDeserializedDataScrubIndex].mPathSerializationData[i].mGeneticRepresentation);
-		path->SetColorCode(mDeserializationData[mDeserializedDataScrubIndex].mPathSerializationData[i].mColor);
-		
-		const bool is_fittest = mDeserializationData[mDeserializedDataScrubIndex].mPathSerializationData[i].mFittest;
-		if (is_fittest)
-			path->MarkFittestSolution();
-
-		mPaths.Add(path);
-	}
+	UpdateScrub();
 }
 
 
 
 /**
 * Updates the genetic representation of the paths based on the deserialized data
+* The scrubbed generation is requested from the replay cache, the paths keep showing the previous generation until it has been decoded
 */
 void APathManager::UpdateScrub()
 {
-	if (mDeserializationData.IsValidIndex(mDeserializedDataScrubIndex))
-	{
-		for (int32 i = 0; i < mPaths.Num(); ++i)
-		{
-			APath* path = mPaths[i];
-
-			check(path != nullptr);
+	if (!mReplayCache.IsValid() || mDeserializedDataScrubIndex == mScrubGenerationIndex)
+		return;
 
-			if (mDeserializationData[mDeserializedDataScrubIndex].mPathSerializationData.IsValidIndex(i))
-			{
-				path->SetGeneticRepresentation(mDeserializationData[mDeserializedDataScrubIndex].mPathSerializationData[i].mGeneticRepresentation);
-				path->SetColorCode(mDeserializationData[mDeserializedDataScrubIndex].mPathSerializationData[i].mColor);
+	mReplayCache->RequestGeneration(mDeserializedDataScrubIndex);
 
-				const bool is_fittest = mDeserializationData[mDeserializedDataScrubIndex].mPathSerializationData[i].mFittest;
-				if (is_fittest)
-					path->MarkFittestSolution();
-			}
+	const FPathReplayCache::FGenerationRef generation = mReplayCache->FindGeneration(mDeserializedDataScrubIndex);
+	if (!generation.IsValid())
+	{
+		// Giving up on the generation keeps the error from being logged every tick
+		if (mReplayCache->HasFailed(mDeserializedDataScrubIndex))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("APathManager::UpdateScrub >> Unable to decode generation %d!"), mDeserializedDataScrubIndex);
+			mScrubGenerationIndex = mDeserializedDataScrubIndex;
 		}
 
-		mGenerationInfo = mDeserializationData[mDeserializedDataScrubIndex].mGenerationInfo;
+		return;
 	}
+
+	mScrubGenerationIndex = mDeserializedDataScrubIndex;
+	PresentGeneration(*generation);
 }
 
 
 
 int32 APathManager::GetGenerationCount() const
 {
-	if (mDeserializationData.Num() > 0)
+	if (mReplayCache.IsValid())
 		return mDeserializedDataScrubIndex;
 	else
 		return GenerationCount;
@@ -1177,5 +1135,39 @@ FString APathManager::GetGenerationInfoAsString()
 	mStringifiedGenerationInfo.Append(TEXT("Average amount of nodes: ")).Append(FString::SanitizeFloat(mGenerationInfo.mAverageAmountOfNodes));
 	mStringifiedGenerationInfo.AppendChar('\n');
 
+	mStringifiedGenerationInfo.Append(TEXT("Diversity: ")).Append(FString::SanitizeFloat(mGenerationInfo.mDiversity));
+	mStringifiedGenerationInfo.AppendChar('\n');
+
+	mStringifiedGenerationInfo.Append(TEXT("Frames for generation: ")).AppendInt(mGenerationInfo.mFrameCount);
+	mStringifiedGenerationInfo.AppendChar('\n');
+
+	mStringifiedGenerationInfo.Append(TEXT("Phase time (ms): ")).Append(FString::SanitizeFloat(mGenerationInfo.mPhaseTimings.GetTotal()));
+	mStringifiedGenerationInfo.AppendChar('\n');
+
+	for (int32 i = 0; i < mGenerationInfo.mIslandInfo.Num(); ++i)
+	{
+		const FIslandGenerationInfo& island_info = mGenerationInfo.mIslandInfo[i];
+
+		mStringifiedGenerationInfo.Append(TEXT("Island ")).AppendInt(i);
+		mStringifiedGenerationInfo.Append(TEXT(": generation #")).AppendInt(island_info.mGenerationNumber);
+		mStringifiedGenerationInfo.Append(TEXT(", fitness factor ")).Append(FString::SanitizeFloat(island_info.mFitnessFactor));
+		mStringifiedGenerationInfo.Append(TEXT(", immigrants ")).AppendInt(island_info.mImmigrantAmount);
+		mStringifiedGenerationInfo.AppendChar('\n');
+	}
+
+	for (const TUniquePtr<FPathHistorySave>& save : mPendingSaves)
+	{
+		mStringifiedGenerationInfo.Append(TEXT("Saving ")).Append(FPaths::GetCleanFilename(save->GetFilePath()));
+		mStringifiedGenerationInfo.Append(TEXT(": ")).AppendInt(FMath::FloorToInt(save->GetProgress() * 100.0f)).AppendChar('%');
+		mStringifiedGenerationInfo.AppendChar('\n');
+	}
+
+	mStringifiedGenerationInfo.Append(TEXT("Stage timings (ms): breed ")).Append(FString::SanitizeFloat(mStageTimings.mBreeding));
+	mStringifiedGenerationInfo.Append(TEXT(", capture ")).Append(FString::SanitizeFloat(mStageTimings.mCapture));
+	mStringifiedGenerationInfo.Append(TEXT(", color ")).Append(FString::SanitizeFloat(mStageTimings.mColorCoding));
+	mStringifiedGenerationInfo.Append(TEXT(", record ")).Append(FString::SanitizeFloat(mStageTimings.mRecording));
+	mStringifiedGenerationInfo.Append(TEXT(", present ")).Append(FString::SanitizeFloat(mStageTimings.mPresentation));
+	mStringifiedGenerationInfo.AppendChar('\n');
+
 	return mStringifiedGenerationInfo;
 }
\ No newline at end of file
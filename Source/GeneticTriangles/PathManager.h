@@ -8,12 +8,25 @@
 // API includes
 #include "Disposable.h"
 #include "Enums.h"
+#include "PathCheckpointWriter.h"
+#include "PathGenerationData.h"
+#include "PathGenerationPipeline.h"
+#include "PathGeneticAlgorithm.h"
+#include "PathGeneticWorker.h"
+#include "PathHistoryReader.h"
+#include "PathHistorySave.h"
+#include "PathHistoryWriter.h"
+#include "PathMigrationHub.h"
+#include "PathReplayCache.h"
+#include "PathStatisticsWriter.h"
 
 #include "PathManager.generated.h"
 
 // Forward decl
 class APath;
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FPathHistorySavedSignature, const FString&, FilePath, bool, bSucceeded);
+
 UCLASS()
 class GENETICTRIANGLES_API APathManager : public AActor, public IDisposable
 {
@@ -25,6 +38,9 @@ public:
 
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+
+	// Called when the game ends or when destroyed
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	
 	// Called every frame
 	virtual void Tick( float DeltaSeconds ) override;
@@ -37,6 +53,19 @@ public:
 	int32 GetGenerationCount() const;
 	FString GetGenerationInfoAsString();
 
+	bool AreNodesValid() const;
+	FPathGeneticAlgorithmSettings GatherSettings() const;
+	FGeneticTerminationCriteria GatherTerminationCriteria() const;
+	FPathQuantization GatherHistoryQuantization() const;
+	FPathHistoryFile::FCompressionSettings GatherHistoryCompression() const;
+	FPathHistoryRetentionPolicy GatherHistoryRetention() const;
+	FPathStatisticsSettings GatherStatisticsSettings() const;
+	FString GetHistoryDirectory() const;
+
+	void RequestCheckpoint();
+	bool ResumeFromCheckpoint();
+	FString GetCheckpointFilePath() const;
+
 public:
 	UPROPERTY(BlueprintReadWrite, meta = (Tooltip = "The transform component of the path manager, to be exposed to the editor."))
 	USceneComponent* SceneComponent = nullptr;
@@ -57,6 +86,120 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Customization", meta = (ToolTip = "The amount of seconds before a new generation is run"))
 	float TimeBetweenGenerations = 1.0f;
 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Customization", meta = (ToolTip = "Determines how many generations are run each tick"))
+	EGenerationRunMode GenerationRunMode = EGenerationRunMode::Delayed;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Customization", meta = (ToolTip = "The amount of generations to run each tick when using the FixedPerTick run mode", UIMin = 1))
+	int32 GenerationsPerTick = 10;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Customization", meta = (ToolTip = "The amount of milliseconds to spend on generations each tick when using the TimeBudget run mode", UIMin = 0.0f))
+	float GenerationTimeBudget = 10.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Customization", meta = (ToolTip = "The maximum amount of paths each phase of a generation may process in a single tick when using the FrameSliced run mode", UIMin = 1))
+	int32 MaxPathsPerFrame = 500;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Customization", meta = (ToolTip = "The frame time in milliseconds the FrameSliced run mode tries to keep, the amount of paths per tick shrinks when frames take longer", UIMin = 1.0f))
+	float TargetFrameTime = 16.6f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Customization", meta = (ToolTip = "Only every n-th generation is visualized, logged and serialized", UIMin = 1))
+	int32 VisualizationInterval = 1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Customization", meta = (ToolTip = "Every n-th serialized generation is stored as a whole, the ones in between only as the changes to the generation before them. One stores every generation as a whole", UIMin = 1))
+	int32 HistoryKeyframeInterval = 32;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "History", meta = (ToolTip = "The directory the history files of the runs are written to, relative paths are relative to the project. Empty uses Saved/PathHistory"))
+	FDirectoryPath HistoryOutputDirectory;
+
+	UPROPERTY(BlueprintAssignable, Category = "History")
+	FPathHistorySavedSignature OnHistorySaved;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "History", meta = (ToolTip = "Record the parents, crossover and mutations of every path of every generation in the history file, including the generations that are not visualized"))
+	bool RecordLineage = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "History", meta = (ToolTip = "Store the chromosomes in the history file in fixed point relative to the start node, which shrinks the file at the cost of precision"))
+	bool QuantizeHistory = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "History", meta = (ToolTip = "The size of a single fixed point step when quantizing the history", UIMin = 0.01f))
+	float HistoryQuantizationPrecision = 1.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "History", meta = (ToolTip = "Half size of the bounds around the start node that quantized chromosomes have to lie in, paths leaving them are stored at full precision"))
+	FVector HistoryQuantizationExtent = FVector(50000.0f, 50000.0f, 20000.0f);
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "History", meta = (ToolTip = "The largest error allowed along any axis of a quantized chromosome, paths exceeding it are stored at full precision", UIMin = 0.0f))
+	float HistoryQuantizationErrorBudget = 0.5f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "History", meta = (ToolTip = "The zlib level the history file is compressed with, zero stores it uncompressed, which is the fastest for local runs", ClampMin = 0, ClampMax = 9))
+	int32 HistoryCompressionLevel = 6;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "History", meta = (ToolTip = "The size in kilobytes of the blocks every stored generation is split into, the blocks are compressed and decompressed in parallel. Zero compresses every generation as a single stream, other sizes are at least 4", ClampMin = 0))
+	int32 HistoryCompressionBlockSize = FPathHistoryFile::FCompressionSettings::DefaultBlockSize / 1024;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "History", meta = (ToolTip = "Thin out the history file once the run has finished, older generations are kept ever more sparsely. Of the generations that are dropped only the fittest path is kept"))
+	bool LimitHistory = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "History", meta = (ToolTip = "The amount of most recent stored generations that are always kept in full", UIMin = 0))
+	int32 HistoryRecentWindow = 1000;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "History", meta = (ToolTip = "The amount of stored generations per tier before the recent window, every tier keeps half as many generations as the tier after it", UIMin = 1))
+	int32 HistoryTierLength = 1000;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "History", meta = (ToolTip = "The most full generations a limited history file may hold, not counting the generations that improved the best fitness. Zero only applies the tiers", UIMin = 0))
+	int32 HistoryMaxFullGenerations = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "History", meta = (ToolTip = "The amount of decoded generations a replay keeps around while scrubbing", UIMin = 1))
+	int32 ReplayCacheCapacity = 64;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "History", meta = (ToolTip = "The amount of generations a replay decodes ahead of the scrubbed generation in the direction of scrubbing, half as many are decoded behind it", UIMin = 0))
+	int32 ReplayPrefetchAmount = 8;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Statistics", meta = (ToolTip = "Write the statistics of every generation to a .csv file next to the history file"))
+	bool WriteStatisticsCsv = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Statistics", meta = (ToolTip = "Write the statistics of every generation to a columnar .gastats file next to the history file, which loads a lot faster than the .csv file"))
+	bool WriteStatisticsBinary = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Statistics", meta = (ToolTip = "Add the best fitness and the variance of the fitness to the statistics"))
+	bool StatisticsIncludeFitnessSpread = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Statistics", meta = (ToolTip = "Add the diversity and the amount of immigrants to the statistics"))
+	bool StatisticsIncludeDiversity = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Statistics", meta = (ToolTip = "Add the stage timings and the frame count to the statistics"))
+	bool StatisticsIncludeTimings = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Checkpoint", meta = (ToolTip = "A checkpoint of the run is written every n generations, from which the run may be resumed later on. Zero only writes the requested checkpoints", UIMin = 0))
+	int32 CheckpointInterval = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Customization", meta = (ToolTip = "Run the generations on a dedicated worker thread, the game thread only displays the latest finished generation"))
+	bool RunOnWorkerThread = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Islands", meta = (ToolTip = "The amount of islands the population is divided over, every island evolves on its own worker thread. One disables the island model", UIMin = 1))
+	int32 IslandCount = 1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Islands", meta = (ToolTip = "The amount of generations between migrations", UIMin = 1))
+	int32 MigrationInterval = 10;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Islands", meta = (ToolTip = "The amount of fittest paths that migrate to another island", UIMin = 0))
+	int32 MigrantCount = 2;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Islands", meta = (ToolTip = "Determines which island migrants move to"))
+	EMigrationTopology MigrationTopology = EMigrationTopology::Ring;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Termination", meta = (ToolTip = "The run stops by itself after this amount of generations, zero runs until stopped", UIMin = 0))
+	int32 MaxGenerationCount = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Termination", meta = (ToolTip = "The run stops by itself once the fitness factor of a generation reaches this value, zero disables it", UIMin = 0.0f, UIMax = 1.0f))
+	float TargetFitnessFactor = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Termination", meta = (ToolTip = "The run stops by itself once the best fitness has not improved for this amount of generations, zero disables it", UIMin = 0))
+	int32 StagnationWindow = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Termination", meta = (ToolTip = "The run stops by itself once the paths have converged, their centroids being closer to each other than this distance on average. Zero disables it", UIMin = 0.0f))
+	float MinDiversity = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Customization", meta = (ToolTip = "Seed of the random stream used by the run, zero picks a random seed"))
+	int32 RandomSeed = 0;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Customization", meta = (ToolTip = "The color of invalid / unfit paths"))
 	FColor InvalidPathColor = FColor::Black;
 
@@ -170,65 +313,66 @@ public:
 private:
 	void RunGenerationTimer(const float inDeltaTime);
 	void RunGeneration();
-
-	void InitializeRun();
-	void EvaluateFitness();
-	void SelectionStep();
-	void CrossoverStep();
-	void MutationStep();
+	void RunGenerationSlice(const float inDeltaTime);
+	bool PrepareAlgorithm();
+	void FinishGeneration(const float inBreedingTime);
+	void UpdatePipeline();
+	bool ShouldVisualizeGeneration(const int32 inGenerationNumber) const;
+
+	void StartWorkers();
+	void ResetWorkers();
+	bool HaveWorkersFinishedRun() const;
+	void CheckWorkerTermination();
+	void ConsumeWorkerSnapshot();
+
+	APath* SpawnPath();
+	void PresentGeneration(const FGenerationSerializationData& inGeneration);
 	void Purge();
-	void ColorCodePathsByFitness();
 	void LogGenerationInfo();
-	void AddGenerationInfoToSerializableData();
 
+	void TerminateRun(const FGeneticTerminationMonitor& inTerminationMonitor);
 	void StopRun();
+	void OpenHistoryWriter(const int32 inPopulationCount, const int32 inIslandCount);
+	FPathCheckpointSettings GatherCheckpointSettings() const;
+	void ExportConfiguration(TArray<TPair<FString, FString>>& outProperties) const;
+	void ImportConfiguration(const TArray<TPair<FString, FString>>& inProperties);
+	void SaveCheckpoint();
 	void SerializeData();
+	void UpdatePendingSaves();
+	void FinishPendingSaves();
 	void PostDeserialize();
 	void DeserializeInitialization();
 	void UpdateScrub();
 
 private:
-	struct FGenerationInfo
-	{
-		int32 mGenerationNumber;
-		int32 mCrossoverAmount;
-		int32 mAmountOfTranslationMutations;
-		int32 mAmountOfInsertionMutations;
-		int32 mAmountOfDeletionMutations;
-		float mAverageFitness;
-		float mMaximumFitness;
-		float mFitnessFactor;
-		float mAverageAmountOfNodes;
-	};
-
 	FGenerationInfo mGenerationInfo;
 	FString mStringifiedGenerationInfo;
 
-	TArray<APath*> mPaths;
-	TArray<APath*> mMatingPaths;
+	TArray<APath*> mPaths; ///< Display paths, showing either the last visualized generation of a run or the scrubbed generation of a replay
+	TUniquePtr<FPathGeneticAlgorithm> mAlgorithm; ///< Runs the generations on the game thread
+	TUniquePtr<FPathGenerationPipeline> mPipeline; ///< Color codes, records and presents the generations of mAlgorithm
+	TArray<TUniquePtr<FPathGeneticWorker>> mWorkers; ///< Run the generations on worker threads, one per island, only filled when RunOnWorkerThread was set or IslandCount was above one at the start of the run
+	TUniquePtr<FPathMigrationHub> mMigrationHub; ///< Only valid for island runs
+	TUniquePtr<FPathHistoryWriter> mHistoryWriter; ///< Streams the stored generations of the run into the history file, has to outlive the pipeline and the workers
+	TUniquePtr<FPathStatisticsWriter> mStatisticsWriter; ///< Streams the statistics of every generation of the run, has to outlive the workers
+	TArray<TUniquePtr<FPathHistorySave>> mPendingSaves; ///< History files of stopped runs which are still being finished in the background
+	FString mLatestHistoryFilePath; ///< The history file which was saved last, replays open it
+	FGenerationSerializationData mCombinedSnapshot;
+	FGenerationStageTimings mStageTimings;
+	FGeneticTerminationMonitor mTerminationMonitor; ///< Checks the generations of mAlgorithm, the workers have their own
+	TUniquePtr<FPathCheckpointWriter> mCheckpointWriter; ///< Writes the checkpoints of mAlgorithm, the workers have their own
+	TUniquePtr<FPathCheckpoint> mResumeCheckpoint; ///< Picked up by the next run, which then continues from it
+	bool mIsCheckpointRequested = false;
+	bool mHasAutoStarted = false; ///< AutoRun only starts the first run of a play session, a terminated run stays stopped
 	float mTimer;
-	float mTotalFitness;
+	int32 mSlicePathBudget = 1; ///< Paths per phase per tick when frame slicing, adapted to TargetFrameTime
+	double mSliceBreedingTime = 0.0; ///< Seconds spent on the slices of the current generation so far
 
 	EAnimationControlState mNextAnimationControlState = EAnimationControlState::Limbo;
 	EAnimationControlState mPreviousAnimationControlState = EAnimationControlState::Limbo;
 
-	struct FPathSerializationData
-	{
-		int32 mNodeAmount;
-		TArray<FVector> mGeneticRepresentation;
-		FColor mColor;
-		bool mFittest;
-	};
-
-	struct FGenerationSerializationData
-	{
-		TArray<FPathSerializationData> mPathSerializationData;
-		FGenerationInfo mGenerationInfo;
-	};
-
-	using FDataBlob = TArray<FGenerationSerializationData>;
-	FDataBlob mSerializationData;
-	FDataBlob mDeserializationData;
+	TUniquePtr<FPathReplayCache> mReplayCache; ///< Decodes the generations of a replay in the background, only valid after deserializing
+	int32 mScrubGenerationIndex = INDEX_NONE; ///< The generation of the replay that is currently shown
 
 	int32 mDeserializedDataGenerationAmount = 0;
 	int32 mDeserializedDataPopulationAmount = 0;
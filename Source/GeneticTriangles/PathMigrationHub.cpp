@@ -0,0 +1,125 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneticTriangles.h"
+#include "PathMigrationHub.h"
+
+FPathMigrationHub::FPathMigrationHub(const int32 inIslandCount)
+{
+	mMailboxes.Reserve(inIslandCount);
+
+	for (int32 i = 0; i < inIslandCount; ++i)
+		mMailboxes.Add(MakeUnique<FMailbox>());
+}
+
+
+
+int32 FPathMigrationHub::GetDestination(const FPathMigrationSettings& inSettings, FRandomStream& inRandomStream) const
+{
+	const int32 island_count = GetIslandCount();
+
+	if (inSettings.mTopology == EMigrationTopology::Random && island_count > 2)
+	{
+		// Any island but the source itself
+		const int32 destination = inRandomStream.RandRange(0, island_count - 2);
+		return destination >= inSettings.mIslandIndex ? destination + 1 : destination;
+	}
+
+	return (inSettings.mIslandIndex + 1) % island_count;
+}
+
+
+
+void FPathMigrationHub::Post(const int32 inDestinationIsland, const TArray<TArray<FVector>>& inGenomes)
+{
+	if (mMailboxes.IsValidIndex(inDestinationIsland))
+		mMailboxes[inDestinationIsland]->Enqueue(inGenomes);
+}
+
+
+
+/**
+* Takes the oldest batch of migrants out of the mailbox of the island, returns false if there is none
+* Must only be called by the island owning the mailbox
+*/
+bool FPathMigrationHub::Receive(const int32 inIsland, TArray<TArray<FVector>>& outGenomes)
+{
+	return mMailboxes.IsValidIndex(inIsland) && mMailboxes[inIsland]->Dequeue(outGenomes);
+}
+
+
+
+/**
+* Combines the latest generations of all islands into a single generation for presenting and serializing
+* Paths keep the colors of their own island, as the color coding is relative to the fitness within an island
+*/
+void FPathMigrationHub::CombineIslandGenerations(const TArray<const FGenerationSerializationData*>& inIslands, FGenerationSerializationData& outCombined)
+{
+	FGenerationInfo& combined_info = outCombined.mGenerationInfo;
+	combined_info = FGenerationInfo();
+	combined_info.mGenerationNumber = MAX_int32;
+	combined_info.mIslandInfo.Reset(inIslands.Num());
+
+	outCombined.mPathSerializationData.Reset();
+
+	int32 total_amount_of_paths = 0;
+	float total_fitness = 0.0f;
+	float total_amount_of_nodes = 0.0f;
+	float total_squared_diversity = 0.0f;
+
+	for (const FGenerationSerializationData* island : inIslands)
+	{
+		check(island != nullptr);
+
+		const FGenerationInfo& info = island->mGenerationInfo;
+		const int32 amount_of_paths = island->mPathSerializationData.Num();
+
+		outCombined.mPathSerializationData.Append(island->mPathSerializationData);
+
+		// The combined generation is as far as the slowest island
+		combined_info.mGenerationNumber = FMath::Min(combined_info.mGenerationNumber, info.mGenerationNumber);
+		combined_info.mCrossoverAmount += info.mCrossoverAmount;
+		combined_info.mAmountOfTranslationMutations += info.mAmountOfTranslationMutations;
+		combined_info.mAmountOfInsertionMutations += info.mAmountOfInsertionMutations;
+		combined_info.mAmountOfDeletionMutations += info.mAmountOfDeletionMutations;
+		combined_info.mImmigrantAmount += info.mImmigrantAmount;
+		combined_info.mMaximumFitness = info.mMaximumFitness;
+		combined_info.mBestFitness = FMath::Max(combined_info.mBestFitness, info.mBestFitness);
+
+		// The islands run side by side, so a phase takes as long as it does on the slowest island
+		FGenerationPhaseTimings& combined_timings = combined_info.mPhaseTimings;
+		combined_timings.mEvaluateParents = FMath::Max(combined_timings.mEvaluateParents, info.mPhaseTimings.mEvaluateParents);
+		combined_timings.mSelection = FMath::Max(combined_timings.mSelection, info.mPhaseTimings.mSelection);
+		combined_timings.mCrossover = FMath::Max(combined_timings.mCrossover, info.mPhaseTimings.mCrossover);
+		combined_timings.mMutation = FMath::Max(combined_timings.mMutation, info.mPhaseTimings.mMutation);
+		combined_timings.mEvaluateOffspring = FMath::Max(combined_timings.mEvaluateOffspring, info.mPhaseTimings.mEvaluateOffspring);
+
+		total_amount_of_paths += amount_of_paths;
+		total_fitness += info.mAverageFitness * amount_of_paths;
+		total_amount_of_nodes += info.mAverageAmountOfNodes * amount_of_paths;
+		total_squared_diversity += info.mDiversity * info.mDiversity * amount_of_paths;
+
+		FIslandGenerationInfo island_info;
+		island_info.mGenerationNumber = info.mGenerationNumber;
+		island_info.mImmigrantAmount = info.mImmigrantAmount;
+		island_info.mAverageFitness = info.mAverageFitness;
+		island_info.mFitnessFactor = info.mFitnessFactor;
+		island_info.mAverageAmountOfNodes = info.mAverageAmountOfNodes;
+
+		combined_info.mIslandInfo.Add(island_info);
+	}
+
+	if (total_amount_of_paths > 0)
+	{
+		combined_info.mAverageFitness = total_fitness / total_amount_of_paths;
+		combined_info.mAverageAmountOfNodes = total_amount_of_nodes / total_amount_of_paths;
+
+		// Only the spread within the islands, the distance between the islands themselves is not known here
+		combined_info.mDiversity = FMath::Sqrt(total_squared_diversity / total_amount_of_paths);
+	}
+
+	if (combined_info.mMaximumFitness > 0.0f)
+		combined_info.mFitnessFactor = combined_info.mAverageFitness / combined_info.mMaximumFitness;
+
+	if (inIslands.Num() == 0)
+		combined_info.mGenerationNumber = 0;
+}
@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// API includes
+#include "Enums.h"
+#include "PathGenerationData.h"
+
+// Forward decl
+class FPathMigrationHub;
+
+/**
+* How a single island takes part in migration
+*/
+struct FPathMigrationSettings
+{
+	FPathMigrationHub* mHub = nullptr; ///< No migration happens without a hub
+	int32 mIslandIndex = 0;
+	int32 mMigrationInterval = 10;
+	int32 mMigrantAmount = 2;
+	EMigrationTopology mTopology = EMigrationTopology::Ring;
+};
+
+
+
+/**
+* Lock-free mailboxes through which the islands of an island run exchange their fittest paths
+*
+* Every island owns one mailbox, any island may post into it and only the owner receives from it
+* Islands never wait on each other, migrants simply arrive in between the generations of the destination island
+*/
+class GENETICTRIANGLES_API FPathMigrationHub
+{
+public:
+	FPathMigrationHub(const int32 inIslandCount);
+
+	int32 GetIslandCount() const { return mMailboxes.Num(); }
+	int32 GetDestination(const FPathMigrationSettings& inSettings, FRandomStream& inRandomStream) const;
+
+	void Post(const int32 inDestinationIsland, const TArray<TArray<FVector>>& inGenomes);
+	bool Receive(const int32 inIsland, TArray<TArray<FVector>>& outGenomes);
+
+	static void CombineIslandGenerations(const TArray<const FGenerationSerializationData*>& inIslands, FGenerationSerializationData& outCombined);
+
+private:
+	using FMailbox = TQueue<TArray<TArray<FVector>>, EQueueMode::Mpsc>;
+
+	TArray<TUniquePtr<FMailbox>> mMailboxes;
+};
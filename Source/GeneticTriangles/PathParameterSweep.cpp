@@ -0,0 +1,322 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneticTriangles.h"
+#include "PathParameterSweep.h"
+
+#include "Async/ParallelFor.h"
+
+#include "PathCommandletHelpers.h"
+#include "PathManager.h"
+
+FPathParameterSweep::FPathParameterSweep(const FPathSweepSettings& inSettings)
+	:
+	mSettings(inSettings)
+{
+	// Seed zero makes the algorithm pick a random seed, which would make the runs unrepeatable
+	mSettings.mFirstSeed = FMath::Max(mSettings.mFirstSeed, 1);
+	mSettings.mSeedAmount = FMath::Max(mSettings.mSeedAmount, 1);
+	mSettings.mGridSteps = FMath::Max(mSettings.mGridSteps, 2);
+}
+
+
+
+/**
+* Reads the sweep settings from the entries of an ini section
+*
+* Mode=Grid|Random, Samples=<n>, SampleSeed=<n>, GridSteps=<n>, Seeds=<n>, FirstSeed=<n>,
+* Generations=<n>, TargetFitnessFactor=<f>, StopAtTarget=<bool>
+* +Param=<PropertyName>=<Value>,<Value>,... or +Param=<PropertyName>=<Min>..<Max>
+*/
+bool FPathParameterSweep::ParseSettings(const TArray<TPair<FString, FString>>& inEntries, FPathSweepSettings& outSettings)
+{
+	for (const TPair<FString, FString>& entry : inEntries)
+	{
+		if (entry.Key == TEXT("Mode"))
+			outSettings.mIsRandomSample = entry.Value == TEXT("Random");
+		else if (entry.Key == TEXT("Samples"))
+			outSettings.mSampleAmount = FCString::Atoi(*entry.Value);
+		else if (entry.Key == TEXT("SampleSeed"))
+			outSettings.mSampleSeed = FCString::Atoi(*entry.Value);
+		else if (entry.Key == TEXT("GridSteps"))
+			outSettings.mGridSteps = FCString::Atoi(*entry.Value);
+		else if (entry.Key == TEXT("Seeds"))
+			outSettings.mSeedAmount = FCString::Atoi(*entry.Value);
+		else if (entry.Key == TEXT("FirstSeed"))
+			outSettings.mFirstSeed = FCString::Atoi(*entry.Value);
+		else if (entry.Key == TEXT("Generations"))
+			outSettings.mMaxGenerationAmount = FCString::Atoi(*entry.Value);
+		else if (entry.Key == TEXT("TargetFitnessFactor"))
+			outSettings.mTargetFitnessFactor = FCString::Atof(*entry.Value);
+		else if (entry.Key == TEXT("StopAtTarget"))
+			outSettings.mStopAtTarget = FCString::ToBool(*entry.Value);
+		else if (entry.Key == TEXT("Param"))
+		{
+			FPathSweepParameter parameter;
+			FString values;
+			if (!entry.Value.Split(TEXT("="), &parameter.mPropertyName, &values) || FindField<UProperty>(APathManager::StaticClass(), *parameter.mPropertyName) == nullptr)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("FPathParameterSweep::ParseSettings >> Ignoring %s, not a property of APathManager"), *entry.Value);
+				continue;
+			}
+
+			FString range_min;
+			FString range_max;
+			if (values.Split(TEXT(".."), &range_min, &range_max))
+			{
+				parameter.mIsRange = true;
+				parameter.mRangeMin = FCString::Atof(*range_min);
+				parameter.mRangeMax = FCString::Atof(*range_max);
+			}
+			else
+				values.ParseIntoArray(parameter.mValues, TEXT(","), true);
+
+			if (parameter.mIsRange || parameter.mValues.Num() > 0)
+				outSettings.mParameters.Add(parameter);
+		}
+	}
+
+	return outSettings.mParameters.Num() > 0 && outSettings.mMaxGenerationAmount > 0;
+}
+
+
+
+void FPathParameterSweep::BuildConfigurations()
+{
+	mConfigurations.Reset();
+
+	if (mSettings.mIsRandomSample)
+		BuildRandomSample();
+	else
+		BuildGrid();
+}
+
+
+
+/**
+* Runs every configuration with every seed and waits for all of them to finish
+* The algorithm settings of all runs are gathered up front, as the path manager is changed to gather them
+*/
+void FPathParameterSweep::Run(const UWorld* inWorld, APathManager* inPathManager)
+{
+	TArray<FPathGeneticAlgorithmSettings> run_settings;
+	TArray<int32> run_configuration_indices;
+	run_settings.Reserve(mConfigurations.Num() * mSettings.mSeedAmount);
+	run_configuration_indices.Reserve(mConfigurations.Num() * mSettings.mSeedAmount);
+
+	for (int32 i = 0; i < mConfigurations.Num(); ++i)
+	{
+		for (int32 j = 0; j < mSettings.mParameters.Num(); ++j)
+		{
+			if (!FPathCommandletHelpers::ApplyOverride(inPathManager, mSettings.mParameters[j].mPropertyName, mConfigurations[i].mValues[j]))
+				UE_LOG(LogTemp, Warning, TEXT("FPathParameterSweep::Run >> Unable to set %s to %s"), *mSettings.mParameters[j].mPropertyName, *mConfigurations[i].mValues[j]);
+		}
+
+		FPathGeneticAlgorithmSettings settings = inPathManager->GatherSettings();
+		settings.mDrawDebug = false;
+
+		for (int32 j = 0; j < mSettings.mSeedAmount; ++j)
+		{
+			settings.mRandomSeed = mSettings.mFirstSeed + j;
+
+			run_settings.Add(settings);
+			run_configuration_indices.Add(i);
+		}
+	}
+
+	mResults.SetNum(run_settings.Num());
+
+	// Runs only write to their own result, and the world is only read through scene queries
+	const FPathSweepSettings& sweep_settings = mSettings;
+	ParallelFor(run_settings.Num(), [&](const int32 inRunIndex)
+	{
+		FPathSweepRunResult result = RunSingle(inWorld, run_settings[inRunIndex], sweep_settings);
+		result.mConfigurationIndex = run_configuration_indices[inRunIndex];
+
+		mResults[inRunIndex] = result;
+	});
+}
+
+
+
+/**
+* Writes one row per run, with the parameter values of its configuration
+*/
+bool FPathParameterSweep::SaveResults(const FString& inFilePath) const
+{
+	FString table = TEXT("Configuration");
+	for (const FPathSweepParameter& parameter : mSettings.mParameters)
+		table += TEXT(",") + parameter.mPropertyName;
+	table += TEXT(",RandomSeed,Generations,GenerationsToTarget,FinalFitnessFactor,BestFitnessFactor,WallTimeSeconds\n");
+
+	for (const FPathSweepRunResult& result : mResults)
+	{
+		table += FString::Printf(TEXT("%d%s,%d,%d,%d,%f,%f,%f\n"),
+			result.mConfigurationIndex, *GetConfigurationColumns(result.mConfigurationIndex), result.mRandomSeed, result.mGenerationAmount,
+			result.mGenerationsToTarget, result.mFinalFitnessFactor, result.mBestFitnessFactor, result.mWallTime);
+	}
+
+	return FFileHelper::SaveStringToFile(table, *inFilePath);
+}
+
+
+
+/**
+* Writes one row per configuration, averaged over its seeds
+* The average generations to target only counts the seeds that reached the target
+*/
+bool FPathParameterSweep::SaveConfigurationSummary(const FString& inFilePath) const
+{
+	FString table = TEXT("Configuration");
+	for (const FPathSweepParameter& parameter : mSettings.mParameters)
+		table += TEXT(",") + parameter.mPropertyName;
+	table += TEXT(",Seeds,ReachedTarget,AverageGenerationsToTarget,AverageFinalFitnessFactor,AverageBestFitnessFactor,AverageWallTimeSeconds,TotalWallTimeSeconds\n");
+
+	for (int32 i = 0; i < mConfigurations.Num(); ++i)
+	{
+		int32 seed_amount = 0;
+		int32 reached_target_amount = 0;
+		int32 total_generations_to_target = 0;
+		float total_final_fitness_factor = 0.0f;
+		float total_best_fitness_factor = 0.0f;
+		double total_wall_time = 0.0;
+
+		for (const FPathSweepRunResult& result : mResults)
+		{
+			if (result.mConfigurationIndex != i)
+				continue;
+
+			++seed_amount;
+			total_final_fitness_factor += result.mFinalFitnessFactor;
+			total_best_fitness_factor += result.mBestFitnessFactor;
+			total_wall_time += result.mWallTime;
+
+			if (result.mGenerationsToTarget != INDEX_NONE)
+			{
+				++reached_target_amount;
+				total_generations_to_target += result.mGenerationsToTarget;
+			}
+		}
+
+		if (seed_amount == 0)
+			continue;
+
+		table += FString::Printf(TEXT("%d%s,%d,%d,%f,%f,%f,%f,%f\n"),
+			i, *GetConfigurationColumns(i), seed_amount, reached_target_amount,
+			reached_target_amount > 0 ? (float)total_generations_to_target / reached_target_amount : -1.0f,
+			total_final_fitness_factor / seed_amount, total_best_fitness_factor / seed_amount,
+			total_wall_time / seed_amount, total_wall_time);
+	}
+
+	return FFileHelper::SaveStringToFile(table, *inFilePath);
+}
+
+
+
+/**
+* Every combination of the values of all parameters
+*/
+void FPathParameterSweep::BuildGrid()
+{
+	TArray<TArray<FString>> parameter_values;
+	for (const FPathSweepParameter& parameter : mSettings.mParameters)
+	{
+		TArray<FString>& values = parameter_values[parameter_values.AddDefaulted()];
+
+		if (parameter.mIsRange)
+		{
+			for (int32 i = 0; i < mSettings.mGridSteps; ++i)
+				values.Add(FString::SanitizeFloat(FMath::Lerp(parameter.mRangeMin, parameter.mRangeMax, (float)i / (mSettings.mGridSteps - 1))));
+		}
+		else
+			values = parameter.mValues;
+	}
+
+	// Count through the combinations like an odometer, the last parameter changes fastest
+	TArray<int32> value_indices;
+	value_indices.SetNumZeroed(parameter_values.Num());
+
+	while (true)
+	{
+		FPathSweepConfiguration& configuration = mConfigurations[mConfigurations.AddDefaulted()];
+		for (int32 i = 0; i < parameter_values.Num(); ++i)
+			configuration.mValues.Add(parameter_values[i][value_indices[i]]);
+
+		int32 digit = parameter_values.Num() - 1;
+		while (digit >= 0 && ++value_indices[digit] == parameter_values[digit].Num())
+		{
+			value_indices[digit] = 0;
+			--digit;
+		}
+
+		if (digit < 0)
+			break;
+	}
+}
+
+
+
+/**
+* Draws every parameter independently, uniformly from its range or its list of values
+*/
+void FPathParameterSweep::BuildRandomSample()
+{
+	FRandomStream random_stream(mSettings.mSampleSeed);
+
+	for (int32 i = 0; i < mSettings.mSampleAmount; ++i)
+	{
+		FPathSweepConfiguration& configuration = mConfigurations[mConfigurations.AddDefaulted()];
+
+		for (const FPathSweepParameter& parameter : mSettings.mParameters)
+		{
+			if (parameter.mIsRange)
+				configuration.mValues.Add(FString::SanitizeFloat(random_stream.FRandRange(parameter.mRangeMin, parameter.mRangeMax)));
+			else
+				configuration.mValues.Add(parameter.mValues[random_stream.RandRange(0, parameter.mValues.Num() - 1)]);
+		}
+	}
+}
+
+
+
+FString FPathParameterSweep::GetConfigurationColumns(const int32 inConfigurationIndex) const
+{
+	FString columns;
+	for (const FString& value : mConfigurations[inConfigurationIndex].mValues)
+		columns += TEXT(",") + value;
+
+	return columns;
+}
+
+
+
+FPathSweepRunResult FPathParameterSweep::RunSingle(const UWorld* inWorld, const FPathGeneticAlgorithmSettings& inAlgorithmSettings, const FPathSweepSettings& inSweepSettings)
+{
+	FPathSweepRunResult result;
+
+	const double start_time = FPlatformTime::Seconds();
+
+	FPathGeneticAlgorithm algorithm(inWorld, inAlgorithmSettings);
+	result.mRandomSeed = algorithm.GetRandomSeed();
+
+	for (int32 i = 0; i < inSweepSettings.mMaxGenerationAmount; ++i)
+	{
+		algorithm.RunGeneration();
+
+		const FGenerationInfo& generation_info = algorithm.GetGenerationInfo();
+		result.mBestFitnessFactor = FMath::Max(result.mBestFitnessFactor, generation_info.mFitnessFactor);
+
+		if (result.mGenerationsToTarget == INDEX_NONE && generation_info.mFitnessFactor >= inSweepSettings.mTargetFitnessFactor)
+		{
+			result.mGenerationsToTarget = algorithm.GetGenerationCount();
+
+			if (inSweepSettings.mStopAtTarget)
+				break;
+		}
+	}
+
+	result.mGenerationAmount = algorithm.GetGenerationCount();
+	result.mFinalFitnessFactor = algorithm.GetGenerationInfo().mFitnessFactor;
+	result.mWallTime = FPlatformTime::Seconds() - start_time;
+
+	return result;
+}
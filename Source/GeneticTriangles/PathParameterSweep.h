@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// API includes
+#include "PathGeneticAlgorithm.h"
+
+// Forward decl
+class APathManager;
+
+/**
+* A parameter of the path manager with the values it is swept over
+* A range is either expanded into evenly spaced values for a grid, or sampled uniformly for a random sweep
+*/
+struct FPathSweepParameter
+{
+	FString mPropertyName;
+	TArray<FString> mValues;
+
+	bool mIsRange = false;
+	float mRangeMin = 0.0f;
+	float mRangeMax = 0.0f;
+};
+
+/**
+* A single combination of parameter values, in the order of the parameters of the sweep
+*/
+struct FPathSweepConfiguration
+{
+	TArray<FString> mValues;
+};
+
+/**
+* Outcome of one configuration with one seed
+*/
+struct FPathSweepRunResult
+{
+	int32 mConfigurationIndex = 0;
+	int32 mRandomSeed = 0;
+	int32 mGenerationAmount = 0;
+	int32 mGenerationsToTarget = INDEX_NONE; ///< First generation that reached the target fitness factor, none if it never did
+	float mFinalFitnessFactor = 0.0f;
+	float mBestFitnessFactor = 0.0f;
+	double mWallTime = 0.0;
+};
+
+/**
+* Settings of a sweep, as read from the [PathSweep] section of an ini
+*/
+struct FPathSweepSettings
+{
+	TArray<FPathSweepParameter> mParameters;
+
+	bool mIsRandomSample = false;
+	int32 mSampleAmount = 16; ///< Amount of configurations of a random sweep
+	int32 mSampleSeed = 0;
+	int32 mGridSteps = 3; ///< Amount of values a range is expanded into for a grid sweep
+
+	int32 mSeedAmount = 3;
+	int32 mFirstSeed = 1;
+	int32 mMaxGenerationAmount = 1000;
+	float mTargetFitnessFactor = 0.9f;
+	bool mStopAtTarget = false;
+};
+
+/**
+* Runs every configuration of a parameter sweep with several seeds, concurrently on the task graph workers
+*
+* Every run has its own algorithm and population, the only thing runs share is the world, which they merely trace against
+* The path manager is only used to turn configurations into algorithm settings, which happens up front on the calling thread
+*/
+class GENETICTRIANGLES_API FPathParameterSweep
+{
+public:
+	FPathParameterSweep(const FPathSweepSettings& inSettings);
+
+	static bool ParseSettings(const TArray<TPair<FString, FString>>& inEntries, FPathSweepSettings& outSettings);
+
+	void BuildConfigurations();
+	void Run(const UWorld* inWorld, APathManager* inPathManager);
+
+	bool SaveResults(const FString& inFilePath) const;
+	bool SaveConfigurationSummary(const FString& inFilePath) const;
+
+	const TArray<FPathSweepConfiguration>& GetConfigurations() const { return mConfigurations; }
+	const TArray<FPathSweepRunResult>& GetResults() const { return mResults; }
+
+private:
+	void BuildGrid();
+	void BuildRandomSample();
+
+	FString GetConfigurationColumns(const int32 inConfigurationIndex) const;
+
+	static FPathSweepRunResult RunSingle(const UWorld* inWorld, const FPathGeneticAlgorithmSettings& inAlgorithmSettings, const FPathSweepSettings& inSweepSettings);
+
+private:
+	FPathSweepSettings mSettings;
+
+	TArray<FPathSweepConfiguration> mConfigurations;
+	TArray<FPathSweepRunResult> mResults;
+};
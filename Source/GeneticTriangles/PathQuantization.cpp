@@ -0,0 +1,142 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneticTriangles.h"
+#include "PathQuantization.h"
+
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+
+FArchive& operator<<(FArchive& ioArchive, FPathQuantization& ioQuantization)
+{
+	ioArchive << ioQuantization.mIsEnabled;
+	ioArchive << ioQuantization.mOrigin;
+	ioArchive << ioQuantization.mExtent;
+	ioArchive << ioQuantization.mPrecision;
+	ioArchive << ioQuantization.mErrorBudget;
+
+	return ioArchive;
+}
+
+
+
+/**
+* Serializes a genome in either direction, quantized genomes are a flag, the chromosome amount and the packed steps
+* Only saving gathers stats
+*/
+void FPathQuantization::SerializeGenome(FArchive& ioArchive, TArray<FVector>& ioGenome, FPathQuantizationStats* ioStats) const
+{
+	if (!IsActive())
+	{
+		ioArchive << ioGenome;
+		return;
+	}
+
+	TArray<uint32> steps;
+	float max_error = 0.0f;
+
+	uint8 is_quantized = (ioArchive.IsSaving() && Quantize(ioGenome, steps, max_error)) ? 1 : 0;
+	ioArchive << is_quantized;
+
+	if (is_quantized == 0)
+	{
+		ioArchive << ioGenome;
+
+		if (ioStats != nullptr && ioArchive.IsSaving())
+			++ioStats->mFullPrecisionGenomeAmount;
+
+		return;
+	}
+
+	int32 chromosome_amount = ioGenome.Num();
+	ioArchive << chromosome_amount;
+
+	// The bit writer drops the leading bits a step does not need, so the packed size is only known once written
+	if (ioArchive.IsSaving())
+	{
+		FBitWriter bit_writer(steps.Num() * 32, true);
+		for (int32 i = 0; i < steps.Num(); ++i)
+			bit_writer.SerializeInt(steps[i], GetStepAmount(i % 3));
+
+		int32 packed_size = bit_writer.GetNumBytes();
+		ioArchive << packed_size;
+		ioArchive.Serialize(bit_writer.GetData(), packed_size);
+
+		if (ioStats != nullptr)
+		{
+			ioStats->mMaxError = FMath::Max(ioStats->mMaxError, max_error);
+			ioStats->mQuantizedChromosomeAmount += chromosome_amount;
+		}
+	}
+	else
+	{
+		int32 packed_size = 0;
+		ioArchive << packed_size;
+
+		if (chromosome_amount < 0 || packed_size < 0 || packed_size > ioArchive.TotalSize() - ioArchive.Tell())
+		{
+			ioArchive.SetError();
+			return;
+		}
+
+		TArray<uint8> packed_steps;
+		packed_steps.SetNumUninitialized(packed_size);
+		ioArchive.Serialize(packed_steps.GetData(), packed_size);
+
+		FBitReader bit_reader(packed_steps.GetData(), (int64)packed_size * 8);
+
+		ioGenome.SetNumUninitialized(chromosome_amount);
+		for (FVector& chromosome : ioGenome)
+		{
+			for (int32 axis = 0; axis < 3; ++axis)
+			{
+				uint32 step = 0;
+				bit_reader.SerializeInt(step, GetStepAmount(axis));
+				chromosome[axis] = Dequantize(step, axis);
+			}
+		}
+
+		if (bit_reader.IsError())
+			ioArchive.SetError();
+	}
+}
+
+
+
+/**
+* Returns false when any chromosome of the genome can not be quantized within the bounds and the error budget
+*/
+bool FPathQuantization::Quantize(const TArray<FVector>& inGenome, TArray<uint32>& outSteps, float& outMaxError) const
+{
+	outSteps.Reset(inGenome.Num() * 3);
+	outMaxError = 0.0f;
+
+	for (const FVector& chromosome : inGenome)
+	{
+		for (int32 axis = 0; axis < 3; ++axis)
+		{
+			const float offset = chromosome[axis] - mOrigin[axis];
+			if (FMath::Abs(offset) > mExtent[axis])
+				return false;
+
+			const uint32 step_amount = GetStepAmount(axis);
+			const uint32 step = (uint32)FMath::Clamp(FMath::RoundToInt(offset / mPrecision) + (int32)(step_amount / 2), 0, (int32)step_amount - 1);
+
+			// Checked against the exact value the reader will reconstruct
+			const float error = FMath::Abs(Dequantize(step, axis) - chromosome[axis]);
+			if (error > mErrorBudget)
+				return false;
+
+			outMaxError = FMath::Max(outMaxError, error);
+			outSteps.Add(step);
+		}
+	}
+
+	return true;
+}
+
+
+
+float FPathQuantization::Dequantize(const uint32 inStep, const int32 inAxis) const
+{
+	return mOrigin[inAxis] + ((int32)inStep - (int32)(GetStepAmount(inAxis) / 2)) * mPrecision;
+}
@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+/**
+* What quantizing the genomes of a run has cost, gathered while they are encoded
+*/
+struct FPathQuantizationStats
+{
+	float mMaxError = 0.0f; ///< Largest distance along any axis between a chromosome and its reconstruction
+	int32 mQuantizedChromosomeAmount = 0;
+	int32 mFullPrecisionGenomeAmount = 0; ///< Genomes that left the bounds or the error budget, stored as they are
+
+	void Merge(const FPathQuantizationStats& inOther)
+	{
+		mMaxError = FMath::Max(mMaxError, inOther.mMaxError);
+		mQuantizedChromosomeAmount += inOther.mQuantizedChromosomeAmount;
+		mFullPrecisionGenomeAmount += inOther.mFullPrecisionGenomeAmount;
+	}
+};
+
+
+
+/**
+* Fixed point encoding of chromosomes, relative to the start node of the run
+*
+* Every axis is stored as a whole amount of mPrecision steps away from mOrigin, using only the bits the bounds need
+* A genome with a chromosome outside of mExtent, or one that would be off by more than mErrorBudget, is stored at full precision instead
+* Disabled by default, in which case genomes are serialized as plain vectors
+*/
+struct GENETICTRIANGLES_API FPathQuantization
+{
+	bool mIsEnabled = false;
+	FVector mOrigin = FVector::ZeroVector;
+	FVector mExtent = FVector(50000.0f, 50000.0f, 20000.0f); ///< Half size of the bounds around the origin
+	float mPrecision = 1.0f; ///< Size of a single step
+	float mErrorBudget = 0.5f;
+
+	static const int32 SerializedSize = sizeof(uint32) + 2 * sizeof(FVector) + 2 * sizeof(float);
+
+	bool IsActive() const { return mIsEnabled && mPrecision > 0.0f && mExtent.GetMin() > 0.0f && mExtent.GetMax() / mPrecision < (float)(MAX_int32 / 2); }
+
+	void SerializeGenome(FArchive& ioArchive, TArray<FVector>& ioGenome, FPathQuantizationStats* ioStats = nullptr) const;
+
+	friend FArchive& operator<<(FArchive& ioArchive, FPathQuantization& ioQuantization);
+
+private:
+	bool Quantize(const TArray<FVector>& inGenome, TArray<uint32>& outSteps, float& outMaxError) const;
+	uint32 GetStepAmount(const int32 inAxis) const { return 2 * (uint32)FMath::CeilToInt(mExtent[inAxis] / mPrecision) + 1; }
+	float Dequantize(const uint32 inStep, const int32 inAxis) const;
+};
@@ -0,0 +1,247 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneticTriangles.h"
+#include "PathReplayCache.h"
+
+FPathReplayCache::FPathReplayCache(TUniquePtr<FPathHistoryReader>&& inReader, const int32 inCapacity, const int32 inPrefetchAmount)
+	:
+	mReader(MoveTemp(inReader)),
+	mPrefetchAmount(FMath::Max(inPrefetchAmount, 0))
+{
+	check(mReader.IsValid() && mReader->IsOpen());
+
+	mGenerationAmount = mReader->GetGenerationAmount();
+	mPopulationCount = mReader->GetPopulationCount();
+
+	// Every generation that is prefetched has to fit, or the thread would evict what it has just decoded
+	mCapacity = FMath::Max(inCapacity, mPrefetchAmount + mPrefetchAmount / 2 + 1);
+
+	mWakeUpEvent = FPlatformProcess::GetSynchEventFromPool(false);
+
+	// Start the thread last, everything it touches has been set up by now
+	mThread = FRunnableThread::Create(this, TEXT("FPathReplayCache"), 0, TPri_BelowNormal);
+}
+
+
+
+FPathReplayCache::~FPathReplayCache()
+{
+	if (mThread != nullptr)
+	{
+		Stop();
+		mThread->WaitForCompletion();
+
+		delete mThread;
+		mThread = nullptr;
+	}
+
+	FPlatformProcess::ReturnSynchEventToPool(mWakeUpEvent);
+	mWakeUpEvent = nullptr;
+
+	for (const TPair<int32, FCacheEntry>& entry : mCache)
+		DEC_MEMORY_STAT_BY(STAT_GeneticTriangles_HistoryRetained, entry.Value.mAllocatedSize);
+}
+
+
+
+uint32 FPathReplayCache::Run()
+{
+	TArray<int32> wanted_generations;
+
+	while (mStopTaskCounter.GetValue() == 0)
+	{
+		const int32 request_count = mRequestCounter.GetValue();
+
+		int32 target = INDEX_NONE;
+		int32 direction = 1;
+		{
+			FScopeLock lock(&mCacheLock);
+			target = mRequestedGeneration;
+			direction = mScrubDirection;
+		}
+
+		if (target != INDEX_NONE)
+		{
+			GatherWantedGenerations(target, direction, wanted_generations);
+
+			for (const int32 generation_index : wanted_generations)
+			{
+				// A new request or a stop makes the rest of the list obsolete
+				if (mRequestCounter.GetValue() != request_count || mStopTaskCounter.GetValue() != 0)
+					break;
+
+				if (!IsCached(generation_index))
+					DecodeGeneration(generation_index);
+			}
+		}
+
+		if (mRequestCounter.GetValue() == request_count)
+			mWakeUpEvent->Wait();
+	}
+
+	return 0;
+}
+
+
+
+void FPathReplayCache::Stop()
+{
+	mStopTaskCounter.Increment();
+	mWakeUpEvent->Trigger();
+}
+
+
+
+/**
+* Asks for the generation to show next, the direction of the prefetching follows the direction of the requests
+*/
+void FPathReplayCache::RequestGeneration(const int32 inGenerationIndex)
+{
+	{
+		FScopeLock lock(&mCacheLock);
+
+		if (inGenerationIndex == mRequestedGeneration)
+			return;
+
+		if (mRequestedGeneration != INDEX_NONE)
+			mScrubDirection = inGenerationIndex > mRequestedGeneration ? 1 : -1;
+
+		mRequestedGeneration = inGenerationIndex;
+	}
+
+	mRequestCounter.Increment();
+	mWakeUpEvent->Trigger();
+}
+
+
+
+/**
+* Returns the generation if it has been decoded, which also marks it as recently used
+*/
+FPathReplayCache::FGenerationRef FPathReplayCache::FindGeneration(const int32 inGenerationIndex)
+{
+	FScopeLock lock(&mCacheLock);
+
+	FCacheEntry* entry = mCache.Find(inGenerationIndex);
+	if (entry == nullptr)
+		return nullptr;
+
+	entry->mLastUsed = ++mUseCount;
+
+	return entry->mGeneration;
+}
+
+
+
+bool FPathReplayCache::HasFailed(const int32 inGenerationIndex) const
+{
+	FScopeLock lock(&mCacheLock);
+
+	return mFailedGenerations.Contains(inGenerationIndex);
+}
+
+
+
+int32 FPathReplayCache::GetCachedAmount() const
+{
+	FScopeLock lock(&mCacheLock);
+
+	return mCache.Num();
+}
+
+
+
+/**
+* The requested generation first, then the ones ahead of it in the scrub direction, then the ones behind it
+*/
+void FPathReplayCache::GatherWantedGenerations(const int32 inTarget, const int32 inDirection, TArray<int32>& outGenerationIndices) const
+{
+	outGenerationIndices.Reset();
+
+	if (inTarget < 0 || inTarget >= mGenerationAmount)
+		return;
+
+	outGenerationIndices.Add(inTarget);
+
+	for (int32 i = 1; i <= mPrefetchAmount; ++i)
+	{
+		const int32 generation_index = inTarget + i * inDirection;
+		if (generation_index >= 0 && generation_index < mGenerationAmount)
+			outGenerationIndices.Add(generation_index);
+	}
+
+	for (int32 i = 1; i <= mPrefetchAmount / 2; ++i)
+	{
+		const int32 generation_index = inTarget - i * inDirection;
+		if (generation_index >= 0 && generation_index < mGenerationAmount)
+			outGenerationIndices.Add(generation_index);
+	}
+}
+
+
+
+bool FPathReplayCache::IsCached(const int32 inGenerationIndex) const
+{
+	FScopeLock lock(&mCacheLock);
+
+	return mCache.Contains(inGenerationIndex) || mFailedGenerations.Contains(inGenerationIndex);
+}
+
+
+
+/**
+* Decodes outside of the lock, only inserting the generation and evicting the least recently used one are guarded
+*/
+void FPathReplayCache::DecodeGeneration(const int32 inGenerationIndex)
+{
+	TSharedPtr<FGenerationSerializationData, ESPMode::ThreadSafe> generation;
+	{
+		FScopeLock lock(&mCacheLock);
+		if (mFreeGenerations.Num() > 0)
+			generation = mFreeGenerations.Pop(false);
+	}
+
+	if (!generation.IsValid())
+		generation = MakeShareable(new FGenerationSerializationData());
+
+	const bool has_decoded = mReader->ReadGeneration(inGenerationIndex, *generation);
+
+	FScopeLock lock(&mCacheLock);
+
+	if (!has_decoded)
+	{
+		mFailedGenerations.Add(inGenerationIndex);
+		mFreeGenerations.Add(generation);
+		return;
+	}
+
+	while (mCache.Num() >= mCapacity)
+	{
+		int32 evicted_index = INDEX_NONE;
+		uint64 oldest_use = MAX_uint64;
+
+		for (const TPair<int32, FCacheEntry>& entry : mCache)
+		{
+			if (entry.Value.mLastUsed < oldest_use)
+			{
+				oldest_use = entry.Value.mLastUsed;
+				evicted_index = entry.Key;
+			}
+		}
+
+		// A buffer the game thread still holds on to is left to it
+		FCacheEntry evicted_entry;
+		mCache.RemoveAndCopyValue(evicted_index, evicted_entry);
+		DEC_MEMORY_STAT_BY(STAT_GeneticTriangles_HistoryRetained, evicted_entry.mAllocatedSize);
+
+		if (evicted_entry.mGeneration.IsUnique())
+			mFreeGenerations.Add(evicted_entry.mGeneration);
+	}
+
+	FCacheEntry& entry = mCache.Add(inGenerationIndex);
+	entry.mGeneration = generation;
+	entry.mLastUsed = ++mUseCount;
+	entry.mAllocatedSize = generation->GetAllocatedSize();
+
+	INC_MEMORY_STAT_BY(STAT_GeneticTriangles_HistoryRetained, entry.mAllocatedSize);
+}
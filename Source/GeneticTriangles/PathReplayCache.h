@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// API includes
+#include "PathGenerationData.h"
+#include "PathHistoryReader.h"
+
+/**
+* Decodes the generations of a replay on a dedicated thread, so scrubbing never waits on the history file
+*
+* The game thread asks for the generation to show, the thread decodes it and then prefetches the generations around it,
+* most of them in the direction the replay was last scrubbed in, where the reader can continue from the previous generation
+* Decoded generations are kept in a least recently used cache, the buffers of evicted generations are reused for the next ones
+* A generation handed to the game thread stays valid for as long as it is referenced, even after it has been evicted
+* The reader is owned by the thread, a new request cuts the prefetching short
+*/
+class GENETICTRIANGLES_API FPathReplayCache : public FRunnable
+{
+public:
+	using FGenerationRef = TSharedPtr<const FGenerationSerializationData, ESPMode::ThreadSafe>;
+
+	static const int32 DefaultCapacity = 64;
+	static const int32 DefaultPrefetchAmount = 8;
+
+	FPathReplayCache(TUniquePtr<FPathHistoryReader>&& inReader, const int32 inCapacity = DefaultCapacity, const int32 inPrefetchAmount = DefaultPrefetchAmount);
+	virtual ~FPathReplayCache();
+
+	// FRunnable interface
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+	// Game thread interface
+	void RequestGeneration(const int32 inGenerationIndex);
+	FGenerationRef FindGeneration(const int32 inGenerationIndex);
+	bool HasFailed(const int32 inGenerationIndex) const;
+
+	int32 GetGenerationAmount() const { return mGenerationAmount; }
+	int32 GetPopulationCount() const { return mPopulationCount; }
+	int32 GetCachedAmount() const;
+
+private:
+	FPathReplayCache(const FPathReplayCache&) = delete;
+	FPathReplayCache& operator=(const FPathReplayCache&) = delete;
+
+	void GatherWantedGenerations(const int32 inTarget, const int32 inDirection, TArray<int32>& outGenerationIndices) const;
+	bool IsCached(const int32 inGenerationIndex) const;
+	void DecodeGeneration(const int32 inGenerationIndex);
+
+private:
+	struct FCacheEntry
+	{
+		TSharedPtr<FGenerationSerializationData, ESPMode::ThreadSafe> mGeneration;
+		uint64 mLastUsed = 0;
+		SIZE_T mAllocatedSize = 0; ///< Counted towards the retained history stat for as long as the entry is cached
+	};
+
+	TUniquePtr<FPathHistoryReader> mReader; ///< Only touched by the thread once it runs
+	int32 mGenerationAmount = 0;
+	int32 mPopulationCount = 0;
+	int32 mCapacity = DefaultCapacity;
+	int32 mPrefetchAmount = DefaultPrefetchAmount; ///< Ahead of the requested generation, half of it is prefetched behind
+
+	mutable FCriticalSection mCacheLock;
+	TMap<int32, FCacheEntry> mCache;
+	TArray<TSharedPtr<FGenerationSerializationData, ESPMode::ThreadSafe>> mFreeGenerations; ///< Evicted buffers that nobody references anymore
+	TSet<int32> mFailedGenerations;
+	uint64 mUseCount = 0;
+
+	int32 mRequestedGeneration = INDEX_NONE; ///< Guarded by the cache lock
+	int32 mScrubDirection = 1;
+	FThreadSafeCounter mRequestCounter; ///< Bumped by every new request, tells the thread to start over
+
+	FThreadSafeCounter mStopTaskCounter;
+	FEvent* mWakeUpEvent = nullptr;
+	FRunnableThread* mThread = nullptr;
+};
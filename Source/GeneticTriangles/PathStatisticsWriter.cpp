@@ -0,0 +1,311 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneticTriangles.h"
+#include "PathStatisticsWriter.h"
+
+#include "FileManager.h"
+
+FPathStatisticsWriter::FPathStatisticsWriter()
+{
+}
+
+
+
+FPathStatisticsWriter::~FPathStatisticsWriter()
+{
+	Close();
+}
+
+
+
+/**
+* Creates the files the settings ask for and writes the column layout, existing files are overwritten
+* Succeeds as long as one of the files could be created
+*/
+bool FPathStatisticsWriter::Open(const FString& inHistoryFilePath, const FPathStatisticsSettings& inSettings)
+{
+	Close();
+
+	FScopeLock lock(&mLock);
+
+	mSettings = inSettings;
+	mColumns.Reset();
+	mColumnCursor = 0;
+	mBlockRowAmount = 0;
+	mRowAmount = 0;
+	mCsvBlock.Reset();
+
+	if (!mSettings.IsEnabled())
+		return false;
+
+	AddColumn(TEXT("Island"), EColumnType::Integer);
+	AddColumn(TEXT("Generation"), EColumnType::Integer);
+	AddColumn(TEXT("Crossovers"), EColumnType::Integer);
+	AddColumn(TEXT("TranslationMutations"), EColumnType::Integer);
+	AddColumn(TEXT("InsertionMutations"), EColumnType::Integer);
+	AddColumn(TEXT("DeletionMutations"), EColumnType::Integer);
+	AddColumn(TEXT("AverageFitness"), EColumnType::Float);
+	AddColumn(TEXT("MaximumFitness"), EColumnType::Float);
+	AddColumn(TEXT("FitnessFactor"), EColumnType::Float);
+	AddColumn(TEXT("AverageNodeAmount"), EColumnType::Float);
+
+	if (mSettings.mIncludeFitnessSpread)
+	{
+		AddColumn(TEXT("BestFitness"), EColumnType::Float);
+		AddColumn(TEXT("FitnessVariance"), EColumnType::Float);
+	}
+
+	if (mSettings.mIncludeDiversity)
+	{
+		AddColumn(TEXT("Diversity"), EColumnType::Float);
+		AddColumn(TEXT("ImmigrantAmount"), EColumnType::Integer);
+	}
+
+	if (mSettings.mIncludeTimings)
+	{
+		AddColumn(TEXT("BreedingTime"), EColumnType::Float);
+		AddColumn(TEXT("CaptureTime"), EColumnType::Float);
+		AddColumn(TEXT("ColorCodingTime"), EColumnType::Float);
+		AddColumn(TEXT("RecordingTime"), EColumnType::Float);
+		AddColumn(TEXT("PresentationTime"), EColumnType::Float);
+		AddColumn(TEXT("FrameCount"), EColumnType::Integer);
+		AddColumn(TEXT("EvaluateParentsTime"), EColumnType::Float);
+		AddColumn(TEXT("SelectionTime"), EColumnType::Float);
+		AddColumn(TEXT("CrossoverTime"), EColumnType::Float);
+		AddColumn(TEXT("MutationTime"), EColumnType::Float);
+		AddColumn(TEXT("EvaluateOffspringTime"), EColumnType::Float);
+	}
+
+	IFileManager& file_manager = IFileManager::Get();
+	const FString target_directory = FPaths::GetPath(inHistoryFilePath);
+	if (!file_manager.DirectoryExists(*target_directory))
+		file_manager.MakeDirectory(*target_directory, true);
+
+	if (mSettings.mWriteCsv)
+	{
+		mCsvFile = file_manager.CreateFileWriter(*GetCsvFilePath(inHistoryFilePath));
+		if (mCsvFile == nullptr)
+			UE_LOG(LogTemp, Warning, TEXT("FPathStatisticsWriter::Open >> Unable to create %s!"), *GetCsvFilePath(inHistoryFilePath));
+	}
+
+	if (mSettings.mWriteBinary)
+	{
+		mBinaryFile = file_manager.CreateFileWriter(*GetBinaryFilePath(inHistoryFilePath));
+		if (mBinaryFile == nullptr)
+			UE_LOG(LogTemp, Warning, TEXT("FPathStatisticsWriter::Open >> Unable to create %s!"), *GetBinaryFilePath(inHistoryFilePath));
+	}
+
+	if (mCsvFile != nullptr)
+	{
+		FString csv_header;
+		for (int32 i = 0; i < mColumns.Num(); ++i)
+		{
+			if (i > 0)
+				csv_header.AppendChar(',');
+			csv_header.Append(mColumns[i].mName);
+		}
+		csv_header.AppendChar('\n');
+
+		FTCHARToUTF8 converted_header(*csv_header);
+		mCsvFile->Serialize(const_cast<ANSICHAR*>(converted_header.Get()), converted_header.Length());
+		mCsvFile->Flush();
+	}
+
+	if (mBinaryFile != nullptr)
+	{
+		uint32 magic = FileMagic;
+		uint32 version = LatestVersion;
+		int32 column_amount = mColumns.Num();
+		*mBinaryFile << magic << version << column_amount;
+
+		for (FColumn& column : mColumns)
+		{
+			uint8 type = (uint8)column.mType;
+			uint8 name_length = (uint8)column.mName.Len();
+			*mBinaryFile << type << name_length;
+			mBinaryFile->Serialize(const_cast<ANSICHAR*>(TCHAR_TO_ANSI(*column.mName)), name_length);
+		}
+
+		mBinaryFile->Flush();
+	}
+
+	return IsOpen();
+}
+
+
+
+/**
+* Adds the row of a single generation of an island, the block it ends up in is written once it is full
+*/
+bool FPathStatisticsWriter::Append(const FGenerationInfo& inGenerationInfo, const FGenerationStageTimings& inTimings, const int32 inIslandIndex)
+{
+	FScopeLock lock(&mLock);
+
+	if (!IsOpen())
+		return false;
+
+	mColumnCursor = 0;
+
+	AddInteger(inIslandIndex);
+	AddInteger(inGenerationInfo.mGenerationNumber);
+	AddInteger(inGenerationInfo.mCrossoverAmount);
+	AddInteger(inGenerationInfo.mAmountOfTranslationMutations);
+	AddInteger(inGenerationInfo.mAmountOfInsertionMutations);
+	AddInteger(inGenerationInfo.mAmountOfDeletionMutations);
+	AddFloat(inGenerationInfo.mAverageFitness);
+	AddFloat(inGenerationInfo.mMaximumFitness);
+	AddFloat(inGenerationInfo.mFitnessFactor);
+	AddFloat(inGenerationInfo.mAverageAmountOfNodes);
+
+	if (mSettings.mIncludeFitnessSpread)
+	{
+		AddFloat(inGenerationInfo.mBestFitness);
+		AddFloat(inGenerationInfo.mFitnessVariance);
+	}
+
+	if (mSettings.mIncludeDiversity)
+	{
+		AddFloat(inGenerationInfo.mDiversity);
+		AddInteger(inGenerationInfo.mImmigrantAmount);
+	}
+
+	if (mSettings.mIncludeTimings)
+	{
+		AddFloat(inTimings.mBreeding);
+		AddFloat(inTimings.mCapture);
+		AddFloat(inTimings.mColorCoding);
+		AddFloat(inTimings.mRecording);
+		AddFloat(inTimings.mPresentation);
+		AddInteger(inGenerationInfo.mFrameCount);
+
+		const FGenerationPhaseTimings& phase_timings = inGenerationInfo.mPhaseTimings;
+		AddFloat(phase_timings.mEvaluateParents);
+		AddFloat(phase_timings.mSelection);
+		AddFloat(phase_timings.mCrossover);
+		AddFloat(phase_timings.mMutation);
+		AddFloat(phase_timings.mEvaluateOffspring);
+	}
+
+	check(mColumnCursor == mColumns.Num());
+
+	// The separator after the last value is turned into the end of the line
+	mCsvBlock[mCsvBlock.Len() - 1] = '\n';
+
+	++mBlockRowAmount;
+	++mRowAmount;
+
+	if (mBlockRowAmount >= BlockRowAmount)
+		return FlushBlock();
+
+	return true;
+}
+
+
+
+/**
+* Writes the rows that are left and closes both files, returns false if any of the writes failed
+*/
+bool FPathStatisticsWriter::Close()
+{
+	FScopeLock lock(&mLock);
+
+	if (!IsOpen())
+		return true;
+
+	bool has_succeeded = FlushBlock();
+
+	if (mCsvFile != nullptr)
+	{
+		has_succeeded &= mCsvFile->Close();
+		delete mCsvFile;
+		mCsvFile = nullptr;
+	}
+
+	if (mBinaryFile != nullptr)
+	{
+		has_succeeded &= mBinaryFile->Close();
+		delete mBinaryFile;
+		mBinaryFile = nullptr;
+	}
+
+	return has_succeeded;
+}
+
+
+
+void FPathStatisticsWriter::AddColumn(const TCHAR* inName, const EColumnType inType)
+{
+	FColumn& column = mColumns[mColumns.AddDefaulted()];
+	column.mName = inName;
+	column.mType = inType;
+	column.mValues.Reserve(BlockRowAmount);
+}
+
+
+
+void FPathStatisticsWriter::AddInteger(const int32 inValue)
+{
+	FColumn& column = mColumns[mColumnCursor++];
+	check(column.mType == EColumnType::Integer);
+
+	column.mValues.Add((uint32)inValue);
+
+	mCsvBlock.AppendInt(inValue);
+	mCsvBlock.AppendChar(',');
+}
+
+
+
+void FPathStatisticsWriter::AddFloat(const float inValue)
+{
+	FColumn& column = mColumns[mColumnCursor++];
+	check(column.mType == EColumnType::Float);
+
+	uint32 raw_value;
+	FMemory::Memcpy(&raw_value, &inValue, sizeof(float));
+	column.mValues.Add(raw_value);
+
+	// Enough digits for the value to read back exactly
+	mCsvBlock.Append(FString::Printf(TEXT("%.9g,"), inValue));
+}
+
+
+
+/**
+* Appends the gathered rows to both files and flushes them, so a run that is cut short keeps every block before it
+*/
+bool FPathStatisticsWriter::FlushBlock()
+{
+	if (mBlockRowAmount == 0)
+		return true;
+
+	bool has_succeeded = true;
+
+	if (mCsvFile != nullptr)
+	{
+		FTCHARToUTF8 converted_block(*mCsvBlock);
+		mCsvFile->Serialize(const_cast<ANSICHAR*>(converted_block.Get()), converted_block.Length());
+		mCsvFile->Flush();
+		has_succeeded &= !mCsvFile->IsError();
+	}
+
+	if (mBinaryFile != nullptr)
+	{
+		int32 row_amount = mBlockRowAmount;
+		*mBinaryFile << row_amount;
+
+		for (FColumn& column : mColumns)
+			mBinaryFile->Serialize(column.mValues.GetData(), column.mValues.Num() * sizeof(uint32));
+
+		mBinaryFile->Flush();
+		has_succeeded &= !mBinaryFile->IsError();
+	}
+
+	for (FColumn& column : mColumns)
+		column.mValues.Reset();
+
+	mCsvBlock.Reset();
+	mBlockRowAmount = 0;
+
+	return has_succeeded;
+}
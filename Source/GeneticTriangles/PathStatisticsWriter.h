@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// API includes
+#include "PathGenerationData.h"
+
+/**
+* Which statistics of a run are written, and in which formats
+* The base columns are always written, the optional metrics each add a group of columns
+*/
+struct FPathStatisticsSettings
+{
+	bool mWriteCsv = true;
+	bool mWriteBinary = true;
+	bool mIncludeFitnessSpread = false; ///< BestFitness and FitnessVariance
+	bool mIncludeDiversity = false; ///< Diversity and ImmigrantAmount
+	bool mIncludeTimings = false; ///< Stage and phase timings in milliseconds and FrameCount
+
+	bool IsEnabled() const { return mWriteCsv || mWriteBinary; }
+};
+
+
+
+/**
+* Streams the statistics of every generation of a run into files of their own, next to the history file
+*
+* Nothing but statistics are stored, so a run can be analyzed without decompressing any of its genomes
+* Every column holds a single metric of a single type, one row is written per generation and island
+* Rows are gathered into blocks, every full block is appended to both files, the last block when the files are closed
+* Append may be called from any thread, island runs interleave the rows of their islands, which the Island column tells apart
+*
+* The .csv file starts with a line of column names, followed by one line per row
+*
+* The binary .gastats file is columnar, all values are 4 bytes and little endian
+*   Header: uint32 magic "GAST", uint32 version, int32 column count
+*   Per column: uint8 type (0 int32, 1 float), uint8 name length, name in ASCII
+*   Blocks until the end of the file: int32 row count, then per column the values of those rows
+* A block that is cut short, because the run was never closed, has to be skipped by readers
+*
+* Stages of the single population pipeline run in the background and finish after the row of their generation has been written,
+* their timings are those of the most recent generation that has gone through every stage, as shown on screen
+*/
+class GENETICTRIANGLES_API FPathStatisticsWriter
+{
+public:
+	FPathStatisticsWriter();
+	~FPathStatisticsWriter();
+
+	static const uint32 FileMagic = 0x54534147; ///< "GAST"
+	static const uint32 LatestVersion = 1;
+	static const int32 BlockRowAmount = 1024;
+
+	static FString GetCsvFilePath(const FString& inHistoryFilePath) { return FPaths::ChangeExtension(inHistoryFilePath, TEXT(".csv")); }
+	static FString GetBinaryFilePath(const FString& inHistoryFilePath) { return FPaths::ChangeExtension(inHistoryFilePath, TEXT(".gastats")); }
+
+	bool Open(const FString& inHistoryFilePath, const FPathStatisticsSettings& inSettings);
+	bool Append(const FGenerationInfo& inGenerationInfo, const FGenerationStageTimings& inTimings, const int32 inIslandIndex = 0);
+	bool Close();
+
+	bool IsOpen() const { return mCsvFile != nullptr || mBinaryFile != nullptr; }
+	int32 GetRowAmount() const { return mRowAmount; }
+
+private:
+	FPathStatisticsWriter(const FPathStatisticsWriter&) = delete;
+	FPathStatisticsWriter& operator=(const FPathStatisticsWriter&) = delete;
+
+	enum class EColumnType : uint8
+	{
+		Integer = 0,
+		Float = 1
+	};
+
+	/**
+	* Values are kept as their raw 4 bytes, floats and integers alike
+	*/
+	struct FColumn
+	{
+		FString mName;
+		EColumnType mType = EColumnType::Integer;
+		TArray<uint32> mValues;
+	};
+
+	void AddColumn(const TCHAR* inName, const EColumnType inType);
+	void AddInteger(const int32 inValue);
+	void AddFloat(const float inValue);
+	bool FlushBlock();
+
+private:
+	FPathStatisticsSettings mSettings;
+	TArray<FColumn> mColumns;
+	int32 mColumnCursor = 0; ///< Column the next value of the row goes into
+	int32 mBlockRowAmount = 0;
+	int32 mRowAmount = 0;
+	FString mCsvBlock; ///< Lines of the block that has not been written yet
+
+	FCriticalSection mLock;
+	FArchive* mCsvFile = nullptr;
+	FArchive* mBinaryFile = nullptr;
+};
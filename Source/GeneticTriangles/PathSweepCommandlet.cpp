@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GeneticTriangles.h"
+#include "PathSweepCommandlet.h"
+
+#include "PathCommandletHelpers.h"
+#include "PathManager.h"
+#include "PathParameterSweep.h"
+
+UPathSweepCommandlet::UPathSweepCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+
+
+int32 UPathSweepCommandlet::Main(const FString& Params)
+{
+	TArray<FString> tokens;
+	TArray<FString> switches;
+	TMap<FString, FString> params;
+	ParseCommandLine(*Params, tokens, switches, params);
+
+	const FString* map_name = params.Find(TEXT("Map"));
+	const FString* ini_path = params.Find(TEXT("Ini"));
+	if (map_name == nullptr || ini_path == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("UPathSweepCommandlet::Main >> Use -Map=<MapName> -Ini=<file>"));
+		return 1;
+	}
+
+	const FString* output_param = params.Find(TEXT("Output"));
+	const FString output_directory = output_param != nullptr ? *output_param : FPaths::GameSavedDir() / TEXT("PathSweeps");
+
+	TArray<TPair<FString, FString>> entries;
+	FPathCommandletHelpers::ReadIniSection(*ini_path, TEXT("PathSweep"), entries);
+
+	FPathSweepSettings sweep_settings;
+	if (!FPathParameterSweep::ParseSettings(entries, sweep_settings))
+	{
+		UE_LOG(LogTemp, Error, TEXT("UPathSweepCommandlet::Main >> %s describes no sweep, it needs at least one +Param and a positive amount of generations"), **ini_path);
+		return 1;
+	}
+
+	UWorld* world = FPathCommandletHelpers::LoadWorld(*map_name);
+	if (world == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("UPathSweepCommandlet::Main >> Unable to load map %s"), **map_name);
+		return 1;
+	}
+
+	APathManager* path_manager = FPathCommandletHelpers::FindPathManager(world);
+	if (path_manager == nullptr || !path_manager->AreNodesValid())
+	{
+		UE_LOG(LogTemp, Error, TEXT("UPathSweepCommandlet::Main >> Map %s has no path manager with valid nodes"), **map_name);
+
+		FPathCommandletHelpers::ReleaseWorld(world);
+		return 1;
+	}
+
+	FPathParameterSweep sweep(sweep_settings);
+	sweep.BuildConfigurations();
+
+	UE_LOG(LogTemp, Display, TEXT("UPathSweepCommandlet::Main >> Running %d configurations with %d seeds each"), sweep.GetConfigurations().Num(), sweep_settings.mSeedAmount);
+
+	const double start_time = FPlatformTime::Seconds();
+	sweep.Run(world, path_manager);
+	const double wall_time = FPlatformTime::Seconds() - start_time;
+
+	const FString map_short_name = FPackageName::GetShortName(*map_name);
+	const bool has_saved_results = sweep.SaveResults(output_directory / map_short_name + TEXT("_SweepRuns.csv"));
+	const bool has_saved_summary = sweep.SaveConfigurationSummary(output_directory / map_short_name + TEXT("_SweepConfigurations.csv"));
+
+	UE_LOG(LogTemp, Display, TEXT("UPathSweepCommandlet::Main >> Finished %d runs in %f seconds"), sweep.GetResults().Num(), wall_time);
+
+	FPathCommandletHelpers::ReleaseWorld(world);
+
+	return has_saved_results && has_saved_summary ? 0 : 1;
+}
@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+// Engine includes
+#include "Commandlets/Commandlet.h"
+
+#include "PathSweepCommandlet.generated.h"
+
+/**
+* Runs a parameter sweep over the path manager of a map without rendering
+*
+* Every configuration of a grid or a random sample is run with several seeds, all runs are spread over the task graph workers
+* The results of every run and a summary per configuration are written as .csv tables
+*
+* Usage: UE4Editor-Cmd GeneticTriangles.uproject -run=PathSweep -nullrhi -Map=Path_Slope -Ini=<file> [-Output=<directory>]
+*
+* The sweep is described by the [PathSweep] section of the ini, for example
+*	Mode=Grid
+*	Seeds=3
+*	Generations=500
+*	TargetFitnessFactor=0.9
+*	+Param=CrossoverProbability=50,70,90
+*	+Param=CrossoverOperator=SinglePoint,TwoPoint
+*	+Param=LengthWeight=50..150
+*/
+UCLASS()
+class GENETICTRIANGLES_API UPathSweepCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UPathSweepCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
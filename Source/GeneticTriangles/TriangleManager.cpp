@@ -3,6 +3,7 @@
 #include "GeneticTriangles.h"
 #include "TriangleManager.h"
 
+#include "PathKernels.h"
 #include "Triangle.h"
 
 // Sets default values
@@ -63,6 +64,7 @@ void ATriangleManager::InitializePopulation()
 
 		x.X += 50.0f;
 
+		INC_DWORD_STAT(STAT_GeneticTriangles_ActorsSpawned);
 		ATriangle* triangle_ptr = GetWorld()->SpawnActor<ATriangle>(x + y, GetTransform().GetRotation().Rotator());
 
 		ensure(triangle_ptr != nullptr);
@@ -88,6 +90,8 @@ void ATriangleManager::InitializePopulation()
 
 void ATriangleManager::EvaluateFitness()
 {
+	SCOPE_CYCLE_COUNTER(STAT_GeneticTriangles_EvaluateFitness);
+
 	// Fitness will be evaluated
 	// The triangle will be more fit if one of the angles between one of it's segments is close to 90 degrees.
 
@@ -110,30 +114,8 @@ void ATriangleManager::EvaluateFitness()
 			
 			ensure(points.IsValidIndex(0) && points.IsValidIndex(1) && points.IsValidIndex(2));
 
-			// @TODO: Important to actually use vectors...
-
-			FVector vec01 = points[1] - points[0]; // Vector 0->1
-			FVector vec02 = points[2] - points[0]; // Vector 0->2
-			FVector vec12 = points[2] - points[1]; // Vector 1->2
-
-			vec01.Normalize();
-			vec02.Normalize();
-			vec12.Normalize();
-
-			const float dot0 = FMath::Abs(FVector::DotProduct(vec01, vec02));
-			const float dot1 = FMath::Abs(FVector::DotProduct(vec12, -vec01));
-			const float dot2 = FMath::Abs(FVector::DotProduct(-vec12, -vec02));
-
-			float smallest = 1.1f; // Dot product will never return anything above 1.0f (even considering abs)
-			
-			if (dot0 < smallest)
-				smallest = dot0;
-			else if (dot1 < smallest)
-				smallest = dot1;
-			else if (dot2 < smallest)
-				smallest = dot2;
-
-			const float fitness_score = 1.0f - smallest;
+			// The kernel is shared with Tools/GaBench, see PathKernels.h
+			const float fitness_score = PathKernels::GetTriangleFitness(points[0], points[1], points[2]);
 
 			ensure(fitness_score >= 0.0f);
 
@@ -165,6 +147,8 @@ void ATriangleManager::EvaluateFitness()
 // Performance is currently extremely fast
 void ATriangleManager::SelectionStep()
 {
+	SCOPE_CYCLE_COUNTER(STAT_GeneticTriangles_Selection);
+
 	// Generate a random number R between 0 and 1
 	// Step over the triangles
 	// Sum of all triangles (accumulation)
@@ -218,6 +202,8 @@ void ATriangleManager::SelectionStep()
 
 void ATriangleManager::CrossoverStep()
 {
+	SCOPE_CYCLE_COUNTER(STAT_GeneticTriangles_Crossover);
+
 	GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Cyan, TEXT("Starting crossover algorithm"));
 	
 	// Selection of which chrosome as well
@@ -264,10 +250,12 @@ void ATriangleManager::CrossoverStep()
 			new_genetic_representation_for_second_child.Add(FMath::Lerp(gen_rep_0[j + 2], gen_rep_1[j + 2], 1.0f - crossover_point));
 		}
 
+		INC_DWORD_STAT(STAT_GeneticTriangles_ActorsSpawned);
 		ATriangle* first_child_triangle = GetWorld()->SpawnActor<ATriangle>(GetTransform().GetLocation(), GetTransform().GetRotation().Rotator());
 		first_child_triangle->SetGeneticRepresentation(new_genetic_representation_for_first_child);
 		first_child_triangle->ReconstructFromGeneticRepresentation();
 
+		INC_DWORD_STAT(STAT_GeneticTriangles_ActorsSpawned);
 		ATriangle* second_child_triangle = GetWorld()->SpawnActor<ATriangle>(GetTransform().GetLocation(), GetTransform().GetRotation().Rotator());
 		second_child_triangle->SetGeneticRepresentation(new_genetic_representation_for_second_child);
 		second_child_triangle->ReconstructFromGeneticRepresentation();
@@ -288,6 +276,8 @@ void ATriangleManager::CrossoverStep()
 
 void ATriangleManager::MutationStep()
 {
+	SCOPE_CYCLE_COUNTER(STAT_GeneticTriangles_Mutation);
+
 	GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Cyan, TEXT("Starting mutation algorithm"));
 
 	// Consider mutation for all individuals
@@ -329,6 +319,10 @@ void ATriangleManager::MutationStep()
 
 void ATriangleManager::PurgeOld()
 {
+	SCOPE_CYCLE_COUNTER(STAT_GeneticTriangles_Purge);
+
+	INC_DWORD_STAT_BY(STAT_GeneticTriangles_ActorsDestroyed, mTrianglesSortedByMatingOrder.Num());
+
 	for (int i = mTrianglesSortedByMatingOrder.Num() - 1; i > -1; --i)
 	{
 		mTrianglesSortedByMatingOrder[i]->Destroy();
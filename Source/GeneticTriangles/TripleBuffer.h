@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+/**
+* Lock-free triple buffer for a single producer and a single consumer
+*
+* The producer fills the write buffer and publishes it, which swaps it with the middle buffer
+* The consumer swaps the middle buffer with its read buffer whenever a new one has been published
+* Neither side ever waits on the other, the consumer simply keeps reading its last buffer until a newer one is available
+* Buffers are reused, so the producer should overwrite the contents of the write buffer rather than rebuild it
+*/
+template<typename T>
+class TLockFreeTripleBuffer
+{
+public:
+	TLockFreeTripleBuffer() { }
+
+	// Producer side
+	T& GetWriteBuffer() { return mBuffers[mWriteIndex]; }
+
+	void Publish()
+	{
+		const int32 previous_middle = FPlatformAtomics::InterlockedExchange(&mMiddle, mWriteIndex | DirtyFlag);
+		mWriteIndex = previous_middle & IndexMask;
+	}
+
+	// Consumer side
+	bool Update()
+	{
+		if ((mMiddle & DirtyFlag) == 0)
+			return false;
+
+		const int32 previous_middle = FPlatformAtomics::InterlockedExchange(&mMiddle, mReadIndex);
+		mReadIndex = previous_middle & IndexMask;
+
+		return true;
+	}
+
+	const T& GetReadBuffer() const { return mBuffers[mReadIndex]; }
+
+private:
+	TLockFreeTripleBuffer(const TLockFreeTripleBuffer&) = delete;
+	TLockFreeTripleBuffer& operator=(const TLockFreeTripleBuffer&) = delete;
+
+	static const int32 IndexMask = 0x3;
+	static const int32 DirtyFlag = 0x4;
+
+	T mBuffers[3];
+
+	int32 mWriteIndex = 0; ///< Only touched by the producer
+	int32 mReadIndex = 2; ///< Only touched by the consumer
+	volatile int32 mMiddle = 1; ///< Index of the middle buffer, with the dirty flag set when it holds an unread buffer
+};
@@ -3,6 +3,7 @@
 #include "GeneticTriangles.h"
 #include "UpdatedTriangleManager.h"
 
+#include "PathKernels.h"
 #include "Triangle.h"
 
 // Sets default values
@@ -27,14 +28,45 @@ void AUpdatedTriangleManager::Tick( float DeltaTime )
 {
 	Super::Tick( DeltaTime );
 
-	if (mTriangles.Num() > 0)
+	if (mTriangles.Num() > 0 && !mTerminationMonitor.HasTerminated())
 	{
-		mConstTimer -= DeltaTime;
+		switch (GenerationRunMode)
+		{
+		case EGenerationRunMode::Delayed:
+		{
+			mConstTimer -= DeltaTime;
 
-		if (mConstTimer < 0.0f)
+			if (mConstTimer < 0.0f)
+			{
+				mConstTimer = GenerationDelay;
+				RunGeneration();
+			}
+			break;
+		}
+		case EGenerationRunMode::FixedPerTick:
 		{
-			mConstTimer = GenerationDelay;
+			for (int32 i = 0; i < FMath::Max(GenerationsPerTick, 1) && !mTerminationMonitor.HasTerminated(); ++i)
+				RunGeneration();
+			break;
+		}
+		case EGenerationRunMode::TimeBudget:
+		{
+			// Always run at least one generation, even if a single generation exceeds the budget
+			const double end_time = FPlatformTime::Seconds() + GenerationTimeBudget / 1000.0;
+			do
+			{
+				RunGeneration();
+			} while (FPlatformTime::Seconds() < end_time && !mTerminationMonitor.HasTerminated());
+			break;
+		}
+		case EGenerationRunMode::FrameSliced:
+		{
+			// A triangle generation is too small to be worth slicing, run a single one per tick instead
 			RunGeneration();
+			break;
+		}
+		default:
+			break;
 		}
 	}
 }
@@ -51,6 +83,7 @@ void AUpdatedTriangleManager::Initialize()
 	{
 		FTransform transform;
 
+		INC_DWORD_STAT(STAT_GeneticTriangles_ActorsSpawned);
 		ATriangle* triangle_ptr = GetWorld()->SpawnActor<ATriangle>(transform.GetLocation(), transform.GetRotation().Rotator());
 		ensure(triangle_ptr != nullptr);
 		triangle_ptr->PostInit();
@@ -64,6 +97,15 @@ void AUpdatedTriangleManager::Initialize()
 
 	FMath::RandInit(RandomSeed);
 
+	FGeneticTerminationCriteria termination_criteria;
+	termination_criteria.mMaxGenerationCount = MaxGenerationCount;
+	termination_criteria.mTargetFitnessFactor = TargetFitnessFactor;
+	termination_criteria.mStagnationWindow = StagnationWindow;
+	termination_criteria.mMinDiversity = MinDiversity;
+
+	mTerminationMonitor.SetCriteria(termination_criteria);
+	mTerminationMonitor.Reset();
+
 	if (GEngine != nullptr)
 	{
 		GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Emerald, TEXT("Initialized triangles successfully"));
@@ -75,6 +117,12 @@ void AUpdatedTriangleManager::Initialize()
 
 void AUpdatedTriangleManager::RunGeneration()
 {
+	if (mTerminationMonitor.HasTerminated())
+		return;
+
+	// On screen logging is only done every n-th generation, as it quickly dominates the cost of a generation
+	mVisualizeGeneration = VisualizationInterval <= 1 || ((GenerationCount + 1) % VisualizationInterval) == 0;
+
 	EvaluateFitness();
 	SelectionStep();
 	CrossoverStep();
@@ -82,14 +130,23 @@ void AUpdatedTriangleManager::RunGeneration()
 
 	++GenerationCount;
 
-	GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::White, TEXT("Finished generation ") + FString::FromInt(GenerationCount));
-	GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Black, TEXT(""));
+	if (mVisualizeGeneration)
+	{
+		GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::White, TEXT("Finished generation ") + FString::FromInt(GenerationCount));
+		GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Black, TEXT(""));
+	}
+
+	// The fitness of a triangle lies in [0, 1], so the average fitness doubles as the fitness factor
+	if (mTerminationMonitor.Update(GenerationCount, mBestFitness, AverageFitness, mDiversity) != ETerminationReason::None)
+		StopRun();
 }
 
 
 
 void AUpdatedTriangleManager::EvaluateFitness()
 {
+	SCOPE_CYCLE_COUNTER(STAT_GeneticTriangles_EvaluateFitness);
+
 	// Fitness will be evaluated
 	// The triangle will be more fit if one of the angles between one of it's segments is close to 90 degrees.
 
@@ -100,6 +157,8 @@ void AUpdatedTriangleManager::EvaluateFitness()
 	// Sort this map by value
 
 	float total_fitness = 0.0f;
+	FPopulationDiversity diversity;
+	mBestFitness = 0.0f;
 
 	mMappedTrianglesContiguous.Empty();
 	mMappedTrianglesContiguous.Reserve(PopulationCount);
@@ -112,34 +171,14 @@ void AUpdatedTriangleManager::EvaluateFitness()
 
 			ensure(points.IsValidIndex(0) && points.IsValidIndex(1) && points.IsValidIndex(2));
 
-			// @TODO: Important to actually use vectors...
-
-			FVector vec01 = points[1] - points[0]; // Vector 0->1
-			FVector vec02 = points[2] - points[0]; // Vector 0->2
-			FVector vec12 = points[2] - points[1]; // Vector 1->2
-
-			vec01.Normalize();
-			vec02.Normalize();
-			vec12.Normalize();
-
-			const float dot0 = FMath::Abs(FVector::DotProduct(vec01, vec02));
-			const float dot1 = FMath::Abs(FVector::DotProduct(vec12, -vec01));
-			const float dot2 = FMath::Abs(FVector::DotProduct(-vec12, -vec02));
-
-			float smallest = 1.1f; // Dot product will never return anything above 1.0f (even considering abs)
-
-			if (dot0 < smallest)
-				smallest = dot0;
-			else if (dot1 < smallest)
-				smallest = dot1;
-			else if (dot2 < smallest)
-				smallest = dot2;
-
-			const float fitness_score = 1.0f - smallest;
+			// The kernel is shared with Tools/GaBench, see PathKernels.h
+			const float fitness_score = PathKernels::GetTriangleFitness(points[0], points[1], points[2]);
 
 			ensure(fitness_score >= 0.0f);
 
 			total_fitness += fitness_score;
+			mBestFitness = FMath::Max(mBestFitness, fitness_score);
+			diversity.Add((points[0] + points[1] + points[2]) / 3.0f);
 
 			mMappedTrianglesContiguous.Add(MappedTriangle(const_cast<ATriangle*>(triangle), fitness_score));
 		}
@@ -159,15 +198,19 @@ void AUpdatedTriangleManager::EvaluateFitness()
 
 	// Calculate average fitness, will be useful to balance the mutation rate
 	AverageFitness = total_fitness / mMappedTrianglesContiguous.Num();
+	mDiversity = diversity.Get();
 
 	//GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Cyan, TEXT("Sorted triangles | fitness | descending | normalized"));
-	GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Cyan, TEXT("Average fitness: ") + FString::SanitizeFloat(AverageFitness));
+	if (mVisualizeGeneration)
+		GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Cyan, TEXT("Average fitness: ") + FString::SanitizeFloat(AverageFitness));
 }
 
 
 
 void AUpdatedTriangleManager::SelectionStep()
 {
+	SCOPE_CYCLE_COUNTER(STAT_GeneticTriangles_Selection);
+
 	// Roulette wheel sampling
 	// While the number of elements in the mating array is less than the population count
 	// Sample the population
@@ -218,14 +261,19 @@ void AUpdatedTriangleManager::SelectionStep()
 			continue;
 	}
 
-	GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Yellow, TEXT("Selected for reproducing: ") + FString::FromInt(mMatingTriangles.Num()));
-	GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Yellow, TEXT("Expected: ") + FString::FromInt(PopulationCount));
+	if (mVisualizeGeneration)
+	{
+		GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Yellow, TEXT("Selected for reproducing: ") + FString::FromInt(mMatingTriangles.Num()));
+		GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Yellow, TEXT("Expected: ") + FString::FromInt(PopulationCount));
+	}
 }
 
 
 
 void AUpdatedTriangleManager::CrossoverStep()
 {
+	SCOPE_CYCLE_COUNTER(STAT_GeneticTriangles_Crossover);
+
 	// Loops over the mating array
 	// Generate random number R
 	// If R > Pc
@@ -265,10 +313,12 @@ void AUpdatedTriangleManager::CrossoverStep()
 				gen_1.Add(FMath::Lerp(old_genetic_representation_0[j + 2], old_genetic_representation_1[j + 2], 1.0f - crossover_point));
 			}
 
+			INC_DWORD_STAT(STAT_GeneticTriangles_ActorsSpawned);
 			ATriangle* triangle_0 = GetWorld()->SpawnActor<ATriangle>(GetTransform().GetLocation(), GetTransform().GetRotation().Rotator());
 			triangle_0->SetGeneticRepresentation(gen_0);
 			triangle_0->ReconstructFromGeneticRepresentation();
 
+			INC_DWORD_STAT(STAT_GeneticTriangles_ActorsSpawned);
 			ATriangle* triangle_1 = GetWorld()->SpawnActor<ATriangle>(GetTransform().GetLocation(), GetTransform().GetRotation().Rotator());
 			triangle_1->SetGeneticRepresentation(gen_1);
 			triangle_1->ReconstructFromGeneticRepresentation();
@@ -281,10 +331,12 @@ void AUpdatedTriangleManager::CrossoverStep()
 			// Crossover is not possible
 			// Duplicate the parents
 
+			INC_DWORD_STAT(STAT_GeneticTriangles_ActorsSpawned);
 			ATriangle* duplicate_0 = GetWorld()->SpawnActor<ATriangle>(GetTransform().GetLocation(), GetTransform().GetRotation().Rotator());
 			duplicate_0->SetGeneticRepresentation(old_genetic_representation_0);
 			duplicate_0->ReconstructFromGeneticRepresentation();
 
+			INC_DWORD_STAT(STAT_GeneticTriangles_ActorsSpawned);
 			ATriangle* duplicate_1 = GetWorld()->SpawnActor<ATriangle>(GetTransform().GetLocation(), GetTransform().GetRotation().Rotator());
 			duplicate_1->SetGeneticRepresentation(old_genetic_representation_1);
 			duplicate_1->ReconstructFromGeneticRepresentation();
@@ -298,7 +350,7 @@ void AUpdatedTriangleManager::CrossoverStep()
 
 	mTriangles = temp;
 
-	if (mTriangles.Num() == temp.Num())
+	if (mVisualizeGeneration && mTriangles.Num() == temp.Num())
 		GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Green, TEXT("Successfully did single point crossover!"));
 }
 
@@ -306,6 +358,8 @@ void AUpdatedTriangleManager::CrossoverStep()
 
 void AUpdatedTriangleManager::MutationStep()
 {
+	SCOPE_CYCLE_COUNTER(STAT_GeneticTriangles_Mutation);
+
 	int mutation_count = 0;
 
 	for (ATriangle* triangle : mTriangles)
@@ -325,19 +379,44 @@ void AUpdatedTriangleManager::MutationStep()
 		}
 	}
 	
-	GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Cyan, TEXT("Mutation amount: ") + FString::FromInt(mutation_count));
+	if (mVisualizeGeneration)
+		GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Cyan, TEXT("Mutation amount: ") + FString::FromInt(mutation_count));
 }
 
 
 
 void AUpdatedTriangleManager::Purge()
 {
+	SCOPE_CYCLE_COUNTER(STAT_GeneticTriangles_Purge);
+
 	for (int32 i = mMatingTriangles.Num() - 1; i > -1; --i)
 	{
 		if (mMatingTriangles.IsValidIndex(i))
+		{
 			mMatingTriangles[i]->Destroy();
+			INC_DWORD_STAT(STAT_GeneticTriangles_ActorsDestroyed);
+		}
 
 		if (mTriangles.IsValidIndex(i))
+		{
 			mTriangles[i]->Destroy();
+			INC_DWORD_STAT(STAT_GeneticTriangles_ActorsDestroyed);
+		}
 	}
-}
\ No newline at end of file
+}
+
+
+
+/**
+* Ends a run that met its termination criteria, the last generation stays on screen
+* Triangle runs are not recorded, so there is nothing to serialize
+*/
+void AUpdatedTriangleManager::StopRun()
+{
+	const FString description = mTerminationMonitor.GetDescription();
+
+	UE_LOG(LogTemp, Display, TEXT("AUpdatedTriangleManager::StopRun >> %s: %s"), FGeneticTerminationMonitor::GetReasonName(mTerminationMonitor.GetReason()), *description);
+
+	if (GEngine != nullptr)
+		GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Emerald, TEXT("Run terminated: ") + description);
+}
@@ -3,6 +3,10 @@
 #pragma once
 
 #include "GameFramework/Actor.h"
+
+#include "Enums.h"
+#include "GeneticTermination.h"
+
 #include "UpdatedTriangleManager.generated.h"
 
 class ATriangle;
@@ -40,6 +44,15 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ToolTip = "The GA will terminate by default if no suitable solution has been found by this generation"))
 	int32 MaxGenerationCount;
 
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ToolTip = "The GA terminates once the average fitness reaches this value, zero disables it", UIMin = 0.0f, UIMax = 1.0f))
+	float TargetFitnessFactor = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ToolTip = "The GA terminates once the best fitness has not improved for this amount of generations, zero disables it", UIMin = 0))
+	int32 StagnationWindow = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ToolTip = "The GA terminates once the triangles have converged, their centroids being closer to each other than this distance on average. Zero disables it", UIMin = 0.0f))
+	float MinDiversity = 0.0f;
+
 	UPROPERTY(BlueprintReadOnly, meta = (ToolTip = "Amount of generations already occurred"))
 	int32 GenerationCount;
 
@@ -61,12 +74,25 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ToolTip = "The delay between generation steps"))
 	float GenerationDelay = 1.0f;
 
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ToolTip = "Determines how many generations are run each tick"))
+	EGenerationRunMode GenerationRunMode = EGenerationRunMode::Delayed;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ToolTip = "The amount of generations to run each tick when using the FixedPerTick run mode", UIMin = 1))
+	int32 GenerationsPerTick = 10;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ToolTip = "The amount of milliseconds to spend on generations each tick when using the TimeBudget run mode", UIMin = 0.0f))
+	float GenerationTimeBudget = 10.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (ToolTip = "Only every n-th generation logs its info on screen", UIMin = 1))
+	int32 VisualizationInterval = 1;
+
 private:
 	void EvaluateFitness();
 	void SelectionStep();
 	void CrossoverStep();
 	void MutationStep();
 	void Purge();
+	void StopRun();
 
 private:
 	struct MappedTriangle
@@ -91,7 +117,12 @@ private:
 	TArray<MappedTriangle> mMappedTrianglesContiguous;
 	TArray<ATriangle*> mMatingTriangles;
 
+	FGeneticTerminationMonitor mTerminationMonitor;
+	float mBestFitness = 0.0f;
+	float mDiversity = 0.0f;
+
 	float mConstTimer = 1.0f;
+	bool mVisualizeGeneration = true;
 
 	FTimerHandle mTimerHandle;
 };
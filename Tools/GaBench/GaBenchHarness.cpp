@@ -0,0 +1,246 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GaBenchHarness.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace GaBench
+{
+	namespace
+	{
+		typedef std::chrono::steady_clock FClock;
+
+		double GetNanosecondsSince(const FClock::time_point& inStart)
+		{
+			return std::chrono::duration<double, std::nano>(FClock::now() - inStart).count();
+		}
+
+
+
+		/**
+		* Nearest rank, same as FPathBenchmark::GetPercentile
+		*/
+		double GetPercentile(const std::vector<double>& inSortedValues, const double inPercentile)
+		{
+			if (inSortedValues.empty())
+				return 0.0;
+
+			const int64_t rank = (int64_t)std::ceil(inPercentile * inSortedValues.size());
+			return inSortedValues[(size_t)std::min(std::max(rank - 1, (int64_t)0), (int64_t)inSortedValues.size() - 1)];
+		}
+
+
+
+		/**
+		* Names only ever hold letters, digits, underscores and slashes, anything else is escaped anyway
+		*/
+		void WriteJsonString(std::FILE* inFile, const std::string& inValue)
+		{
+			std::fputc('"', inFile);
+
+			for (const char character : inValue)
+			{
+				if (character == '"' || character == '\\')
+					std::fprintf(inFile, "\\%c", character);
+				else if ((unsigned char)character < 0x20)
+					std::fprintf(inFile, "\\u%04x", (unsigned char)character);
+				else
+					std::fputc(character, inFile);
+			}
+
+			std::fputc('"', inFile);
+		}
+	}
+
+
+
+	void FHarness::Add(std::unique_ptr<FBenchmark> inBenchmark)
+	{
+		if (mOptions.mFilter.empty() || std::string(inBenchmark->GetName()).find(mOptions.mFilter) != std::string::npos)
+			mBenchmarks.push_back(std::move(inBenchmark));
+	}
+
+
+
+	bool FHarness::Run()
+	{
+		bool has_set_up_all = true;
+
+		for (const std::unique_ptr<FBenchmark>& benchmark : mBenchmarks)
+		{
+			for (const int32_t size : mOptions.mSizes)
+			{
+				if (!benchmark->Setup(size, mOptions))
+				{
+					std::fprintf(stderr, "Unable to set up %s at size %d\n", benchmark->GetName(), size);
+					has_set_up_all = false;
+					continue;
+				}
+
+				mResults.emplace_back();
+				FBenchmarkResult& result = mResults.back();
+				result.mName = benchmark->GetName();
+				result.mSize = size;
+				result.mItemAmount = benchmark->GetItemAmount();
+				result.mIterationsPerSample = CalibrateIterations(*benchmark);
+
+				for (int32_t i = 0; i < mOptions.mWarmupSampleAmount; ++i)
+					TimeSample(*benchmark, result.mIterationsPerSample);
+
+				result.mSampleNanoseconds.reserve(mOptions.mSampleAmount);
+				for (int32_t i = 0; i < mOptions.mSampleAmount; ++i)
+					result.mSampleNanoseconds.push_back(TimeSample(*benchmark, result.mIterationsPerSample) / result.mIterationsPerSample);
+
+				ComputeStatistics(result);
+
+				if (mOptions.mJsonFilePath != "-")
+					std::fprintf(stderr, "%s/%d done\n", result.mName.c_str(), size);
+			}
+		}
+
+		return has_set_up_all;
+	}
+
+
+
+	/**
+	* Returns the time of inIterationAmount calls of the kernel, a destructive kernel is reset before every call and only the calls are summed
+	*/
+	double FHarness::TimeSample(FBenchmark& ioBenchmark, const int64_t inIterationAmount) const
+	{
+		if (!ioBenchmark.IsDestructive())
+		{
+			const FClock::time_point start = FClock::now();
+			for (int64_t i = 0; i < inIterationAmount; ++i)
+				ioBenchmark.Run();
+
+			return GetNanosecondsSince(start);
+		}
+
+		double total_nanoseconds = 0.0;
+		for (int64_t i = 0; i < inIterationAmount; ++i)
+		{
+			ioBenchmark.Reset();
+
+			const FClock::time_point start = FClock::now();
+			ioBenchmark.Run();
+			total_nanoseconds += GetNanosecondsSince(start);
+		}
+
+		return total_nanoseconds;
+	}
+
+
+
+	/**
+	* Doubles the amount of calls until a sample takes the minimum sample time, so fast kernels are not drowned out by the clock
+	*/
+	int64_t FHarness::CalibrateIterations(FBenchmark& ioBenchmark) const
+	{
+		const double min_sample_nanoseconds = mOptions.mMinSampleMilliseconds * 1.0e6;
+
+		int64_t iteration_amount = 1;
+		while (iteration_amount < (int64_t(1) << 30))
+		{
+			const double sample_nanoseconds = TimeSample(ioBenchmark, iteration_amount);
+			if (sample_nanoseconds >= min_sample_nanoseconds)
+				break;
+
+			// Jump close to the target once the sample is long enough to be trusted
+			if (sample_nanoseconds > min_sample_nanoseconds / 16.0)
+				return std::max(iteration_amount + 1, (int64_t)std::ceil(iteration_amount * min_sample_nanoseconds / sample_nanoseconds));
+
+			iteration_amount *= 2;
+		}
+
+		return iteration_amount;
+	}
+
+
+
+	void FHarness::ComputeStatistics(FBenchmarkResult& ioResult) const
+	{
+		std::vector<double> sorted_samples = ioResult.mSampleNanoseconds;
+		std::sort(sorted_samples.begin(), sorted_samples.end());
+
+		if (sorted_samples.empty())
+			return;
+
+		double sum = 0.0;
+		for (const double sample : sorted_samples)
+			sum += sample;
+
+		ioResult.mMin = sorted_samples.front();
+		ioResult.mMax = sorted_samples.back();
+		ioResult.mMedian = GetPercentile(sorted_samples, 0.5);
+		ioResult.mP90 = GetPercentile(sorted_samples, 0.9);
+		ioResult.mMean = sum / sorted_samples.size();
+
+		double squared_deviation_sum = 0.0;
+		for (const double sample : sorted_samples)
+			squared_deviation_sum += (sample - ioResult.mMean) * (sample - ioResult.mMean);
+
+		ioResult.mStandardDeviation = sorted_samples.size() > 1 ? std::sqrt(squared_deviation_sum / (sorted_samples.size() - 1)) : 0.0;
+
+		// The median is less sensitive to the odd preempted sample than the mean
+		ioResult.mItemsPerSecond = ioResult.mMedian > 0.0 ? ioResult.mItemAmount * 1.0e9 / ioResult.mMedian : 0.0;
+	}
+
+
+
+	void FHarness::PrintTable(std::FILE* inFile) const
+	{
+		std::fprintf(inFile, "%-28s %8s %12s %12s %12s %12s %10s %14s\n", "benchmark", "size", "min (ns)", "median (ns)", "p90 (ns)", "max (ns)", "stddev %", "items/s");
+
+		for (const FBenchmarkResult& result : mResults)
+		{
+			const double relative_deviation = result.mMean > 0.0 ? result.mStandardDeviation / result.mMean * 100.0 : 0.0;
+
+			std::fprintf(inFile, "%-28s %8d %12.1f %12.1f %12.1f %12.1f %10.2f %14.4g\n",
+				result.mName.c_str(), result.mSize, result.mMin, result.mMedian, result.mP90, result.mMax, relative_deviation, result.mItemsPerSecond);
+		}
+	}
+
+
+
+	/**
+	* One object per benchmark and size, with the raw samples so the results can be compared with other tools
+	*/
+	bool FHarness::WriteJson(const std::string& inFilePath) const
+	{
+		std::FILE* file = inFilePath == "-" ? stdout : std::fopen(inFilePath.c_str(), "w");
+		if (file == nullptr)
+			return false;
+
+		std::fprintf(file, "{\n  \"seed\": %d,\n  \"nodes\": %d,\n  \"warmup\": %d,\n  \"min_sample_ms\": %g,\n  \"results\": [",
+			mOptions.mRandomSeed, mOptions.mAmountOfNodes, mOptions.mWarmupSampleAmount, mOptions.mMinSampleMilliseconds);
+
+		for (size_t i = 0; i < mResults.size(); ++i)
+		{
+			const FBenchmarkResult& result = mResults[i];
+
+			std::fprintf(file, "%s\n    {\"name\": ", i == 0 ? "" : ",");
+			WriteJsonString(file, result.mName);
+			std::fprintf(file, ", \"size\": %d, \"items\": %lld, \"iterations_per_sample\": %lld,\n",
+				result.mSize, (long long)result.mItemAmount, (long long)result.mIterationsPerSample);
+			std::fprintf(file, "     \"min_ns\": %.3f, \"median_ns\": %.3f, \"mean_ns\": %.3f, \"p90_ns\": %.3f, \"max_ns\": %.3f, \"stddev_ns\": %.3f, \"items_per_second\": %.6g,\n",
+				result.mMin, result.mMedian, result.mMean, result.mP90, result.mMax, result.mStandardDeviation, result.mItemsPerSecond);
+			std::fprintf(file, "     \"samples_ns\": [");
+
+			for (size_t j = 0; j < result.mSampleNanoseconds.size(); ++j)
+				std::fprintf(file, "%s%.3f", j == 0 ? "" : ", ", result.mSampleNanoseconds[j]);
+
+			std::fprintf(file, "]}");
+		}
+
+		std::fprintf(file, "\n  ]\n}\n");
+
+		const bool has_written = std::ferror(file) == 0;
+		if (file != stdout)
+			return std::fclose(file) == 0 && has_written;
+
+		return has_written;
+	}
+}
@@ -0,0 +1,105 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+* Times the kernels in isolation, so a change to one of them shows up without the noise of a whole run
+*
+* Every benchmark is run at every size, first for a few warmup samples that are thrown away, then for the measured samples
+* A sample repeats the kernel until it took at least the minimum sample time, the statistics are per call of the kernel
+*/
+namespace GaBench
+{
+	struct FOptions
+	{
+		std::vector<int32_t> mSizes = { 20, 200, 2000, 20000 };
+		int32_t mWarmupSampleAmount = 3;
+		int32_t mSampleAmount = 20;
+		double mMinSampleMilliseconds = 5.0;
+		int32_t mAmountOfNodes = 8; ///< Nodes of every generated path
+		int32_t mRandomSeed = 1;
+		int32_t mCompressionLevel = 6; ///< Same defaults as FPathHistoryFile::FCompressionSettings
+		int32_t mBlockSize = 32 * 1024;
+		std::string mFilter; ///< Only the benchmarks whose name contains it are run
+		std::string mJsonFilePath; ///< "-" writes the results to stdout instead of the table
+	};
+
+	/**
+	* A kernel at one size, Setup and Reset are not timed
+	*/
+	class FBenchmark
+	{
+	public:
+		virtual ~FBenchmark() {}
+
+		virtual const char* GetName() const = 0;
+
+		/**
+		* Builds the input of the kernel for inSize items, the same seed gives the same input
+		*/
+		virtual bool Setup(const int32_t inSize, const FOptions& inOptions) = 0;
+
+		/**
+		* Restores the input before every call of a kernel that changes its own input, see IsDestructive
+		*/
+		virtual void Reset() {}
+		virtual bool IsDestructive() const { return false; }
+
+		virtual void Run() = 0;
+
+		/**
+		* Items handled by a single call of Run, for the throughput
+		*/
+		virtual int64_t GetItemAmount() const = 0;
+	};
+
+	struct FBenchmarkResult
+	{
+		std::string mName;
+		int32_t mSize = 0;
+		int64_t mItemAmount = 0;
+		int64_t mIterationsPerSample = 0;
+		std::vector<double> mSampleNanoseconds; ///< Per call of the kernel
+
+		double mMin = 0.0;
+		double mMedian = 0.0;
+		double mMean = 0.0;
+		double mP90 = 0.0;
+		double mMax = 0.0;
+		double mStandardDeviation = 0.0;
+		double mItemsPerSecond = 0.0;
+	};
+
+	class FHarness
+	{
+	public:
+		explicit FHarness(const FOptions& inOptions) : mOptions(inOptions) {}
+
+		void Add(std::unique_ptr<FBenchmark> inBenchmark);
+
+		/**
+		* Returns false when the setup of a benchmark failed, the other benchmarks are still run
+		*/
+		bool Run();
+
+		void PrintTable(std::FILE* inFile) const;
+		bool WriteJson(const std::string& inFilePath) const;
+
+		const std::vector<FBenchmarkResult>& GetResults() const { return mResults; }
+
+	private:
+		double TimeSample(FBenchmark& ioBenchmark, const int64_t inIterationAmount) const;
+		int64_t CalibrateIterations(FBenchmark& ioBenchmark) const;
+		void ComputeStatistics(FBenchmarkResult& ioResult) const;
+
+		FOptions mOptions;
+		std::vector<std::unique_ptr<FBenchmark>> mBenchmarks;
+		std::vector<FBenchmarkResult> mResults;
+	};
+}
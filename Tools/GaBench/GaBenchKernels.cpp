@@ -0,0 +1,603 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GaBenchKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace GaBench
+{
+	/**
+	* Same as FVector::Normalize, a vector that is too short is left as it is
+	* The scale is FMath::InvSqrt, which refines the hardware estimate by two Newton-Raphson steps where the engine uses SSE
+	*/
+	bool FVector::Normalize()
+	{
+		const float square_sum = X * X + Y * Y + Z * Z;
+		if (square_sum <= 1.e-8f)
+			return false;
+
+#if PATH_KERNELS_SSE
+		const __m128 one_half = _mm_set_ss(0.5f);
+		const __m128 value = _mm_set_ss(square_sum);
+		const __m128 half_value = _mm_mul_ss(value, one_half);
+		const __m128 estimate = _mm_rsqrt_ss(value);
+
+		__m128 refined = _mm_sub_ss(one_half, _mm_mul_ss(half_value, _mm_mul_ss(estimate, estimate)));
+		refined = _mm_add_ss(estimate, _mm_mul_ss(estimate, refined));
+		__m128 reciprocal = _mm_sub_ss(one_half, _mm_mul_ss(half_value, _mm_mul_ss(refined, refined)));
+		reciprocal = _mm_add_ss(refined, _mm_mul_ss(refined, reciprocal));
+
+		const float scale = _mm_cvtss_f32(reciprocal);
+#else
+		const float scale = 1.0f / std::sqrt(square_sum);
+#endif
+		X *= scale;
+		Y *= scale;
+		Z *= scale;
+
+		return true;
+	}
+
+
+
+	/**
+	* The mantissa of the seed is put into a float in [1, 2), same as FRandomStream::GetFraction
+	*/
+	float FRandomStream::GetFraction()
+	{
+		mSeed = mSeed * 196314165u + 907633515u;
+
+		const uint32_t bits = 0x3F800000u | (mSeed & 0x007FFFFFu);
+		float result;
+		std::memcpy(&result, &bits, sizeof(result));
+
+		return result - 1.0f;
+	}
+
+
+
+	/**
+	* Same as FPathIndividual::RandomizeValues
+	*/
+	void RandomizePath(FRandomStream& ioRandomStream, const FVector& inStartingLocation, const int32_t inAmountOfNodes, const float inMaxVariation, FPath& outPath)
+	{
+		outPath = FPath();
+		outPath.mGenes.reserve(inAmountOfNodes);
+
+		PathKernels::RandomizeGenes(ioRandomStream, inStartingLocation, inAmountOfNodes, inMaxVariation, [&outPath](const FVector& inChromosome)
+		{
+			outPath.mGenes.push_back(inChromosome);
+		});
+
+		outPath.mLength = EvaluateGenome(outPath.mGenes.data(), (int32_t)outPath.mGenes.size(), FGeometryConstraints()).mLength;
+	}
+
+
+
+	/**
+	* Same as ATriangle::PostInit, with the triangle stream instead of the global one
+	*/
+	void RandomizeTriangle(FRandomStream& ioRandomStream, const float inMaxDistanceFromMidPoint, FTriangle& outTriangle)
+	{
+		for (FVector& point : outTriangle.mPoints)
+		{
+			point.X = ioRandomStream.FRandRange(-inMaxDistanceFromMidPoint, inMaxDistanceFromMidPoint);
+			point.Y = ioRandomStream.FRandRange(-inMaxDistanceFromMidPoint, inMaxDistanceFromMidPoint);
+			point.Z = ioRandomStream.FRandRange(-inMaxDistanceFromMidPoint, inMaxDistanceFromMidPoint);
+		}
+	}
+
+
+
+	/**
+	* Same as FPathGeometryBatch::EvaluateGenome
+	*/
+	FGeometryResult EvaluateGenome(const FVector* inChromosomes, const int32_t inChromosomeAmount, const FGeometryConstraints& inConstraints, float* outSegmentLengths)
+	{
+		return PathKernels::EvaluateGenome(inChromosomes, inChromosomeAmount, inConstraints, outSegmentLengths);
+	}
+
+
+
+	/**
+	* Same as AUpdatedTriangleManager::EvaluateFitness, the triangles end up sorted by fitness, descending and normalized
+	* Returns the total fitness
+	*/
+	float EvaluateTriangleFitness(const std::vector<FTriangle>& inTriangles, std::vector<FMappedTriangle>& outMappedTriangles)
+	{
+		float total_fitness = 0.0f;
+
+		outMappedTriangles.clear();
+		outMappedTriangles.reserve(inTriangles.size());
+
+		for (size_t i = 0; i < inTriangles.size(); ++i)
+		{
+			const FVector* points = inTriangles[i].mPoints;
+
+			const float fitness_score = PathKernels::GetTriangleFitness(points[0], points[1], points[2]);
+			total_fitness += fitness_score;
+
+			FMappedTriangle mapped_triangle;
+			mapped_triangle.mIndex = (int32_t)i;
+			mapped_triangle.mFitness = fitness_score;
+			outMappedTriangles.push_back(mapped_triangle);
+		}
+
+		std::sort(outMappedTriangles.begin(), outMappedTriangles.end(), [](const FMappedTriangle& inLhs, const FMappedTriangle& inRhs)
+		{
+			return inLhs.mFitness > inRhs.mFitness;
+		});
+
+		for (FMappedTriangle& mapped_triangle : outMappedTriangles)
+			mapped_triangle.mFitness /= total_fitness;
+
+		return total_fitness;
+	}
+
+
+
+	/**
+	* Same as FPathGeneticAlgorithm::SelectionStep
+	*/
+	void SelectRoulette(FRandomStream& ioRandomStream, const std::vector<FPath>& inPopulation, const float inTotalFitness, const int32_t inEnd, std::vector<int32_t>& ioMatingIndices)
+	{
+		PathKernels::SelectMates(ioRandomStream, (int32_t)inPopulation.size(), inTotalFitness, (int32_t)ioMatingIndices.size(), inEnd,
+			[&inPopulation](const int32_t inIndex) { return inPopulation[inIndex].mFitness; },
+			[&ioMatingIndices](const int32_t inIndex) { ioMatingIndices.push_back(inIndex); });
+	}
+
+
+
+	namespace
+	{
+		void ResetEvaluation(FPath& ioPath)
+		{
+			ioPath.mFitness = 0.0f;
+			ioPath.mAmountOfNodesFitness = 0.0f;
+			ioPath.mLength = 0.0f;
+		}
+
+
+
+		/**
+		* FPathIndividual::DetermineGeneticRepresentation
+		*/
+		void DetermineLength(FPath& ioPath)
+		{
+			ioPath.mLength = EvaluateGenome(ioPath.mGenes.data(), (int32_t)ioPath.mGenes.size(), FGeometryConstraints()).mLength;
+		}
+
+
+
+		void DuplicatePath(const FPath& inSource, FPath& outDuplicate)
+		{
+			ResetEvaluation(outDuplicate);
+			outDuplicate.mGenes = inSource.mGenes;
+			DetermineLength(outDuplicate);
+		}
+	}
+
+
+
+	/**
+	* Same as FPathGeneticAlgorithm::CrossoverStep over the whole population, without the lineage records
+	* ioOffspring has to hold as many paths as there are mates, returns the amount of crossovers
+	*/
+	int32_t Crossover(FRandomStream& ioRandomStream, const ECrossoverOperator inOperator, const float inCrossoverProbability,
+		const std::vector<FPath>& inPopulation, const std::vector<int32_t>& inMatingIndices, std::vector<FPath>& ioOffspring, std::vector<FLineage>* ioLineage)
+	{
+		int32_t successfull_crossover_amount = 0;
+		const int32_t mate_amount = (int32_t)inMatingIndices.size();
+
+		// Same as mBreedingLineage, the population is the previous generation in the order it is stored in
+		if (ioLineage != nullptr)
+			ioLineage->assign(mate_amount, FLineage());
+
+		for (int32_t i = 0; i < mate_amount; i += 2)
+		{
+			if (i + 1 >= mate_amount)
+			{
+				DuplicatePath(inPopulation[inMatingIndices[i]], ioOffspring[i]);
+				if (ioLineage != nullptr)
+					(*ioLineage)[i].mParentIndices[0] = inMatingIndices[i];
+				continue;
+			}
+
+			const float R = ioRandomStream.FRandRange(0.0f, 100.0f);
+
+			if (R >= (100.0f - inCrossoverProbability))
+			{
+				const FPath* current_path = &inPopulation[inMatingIndices[i]];
+				const FPath* next_path = &inPopulation[inMatingIndices[i + 1]];
+				const FPath* smallest_path = nullptr;
+				const FPath* bigger_path = nullptr;
+
+				if (current_path->mGenes.size() < next_path->mGenes.size())
+				{
+					smallest_path = current_path;
+					bigger_path = next_path;
+				}
+				else
+				{
+					smallest_path = next_path;
+					bigger_path = current_path;
+				}
+
+				if (ioLineage != nullptr)
+				{
+					const int32_t smallest_index = smallest_path == current_path ? inMatingIndices[i] : inMatingIndices[i + 1];
+					const int32_t bigger_index = smallest_path == current_path ? inMatingIndices[i + 1] : inMatingIndices[i];
+
+					(*ioLineage)[i].mParentIndices[0] = smallest_index;
+					(*ioLineage)[i].mParentIndices[1] = bigger_index;
+					(*ioLineage)[i + 1].mParentIndices[0] = bigger_index;
+					(*ioLineage)[i + 1].mParentIndices[1] = smallest_index;
+				}
+
+				const int32_t num_chromosomes_small = (int32_t)smallest_path->mGenes.size();
+				const int32_t num_chromosomes_big = (int32_t)bigger_path->mGenes.size();
+
+				const bool append_tail_of_bigger_path = (smallest_path->mFitness - smallest_path->mAmountOfNodesFitness) < (bigger_path->mFitness - bigger_path->mAmountOfNodesFitness);
+
+				FPath& offspring_0 = ioOffspring[i];
+				FPath& offspring_1 = ioOffspring[i + 1];
+
+				ResetEvaluation(offspring_0);
+				offspring_0.mGenes.clear();
+				offspring_0.mGenes.reserve(num_chromosomes_big);
+				ResetEvaluation(offspring_1);
+				offspring_1.mGenes.clear();
+				offspring_1.mGenes.reserve(num_chromosomes_big);
+
+				std::vector<FVector>& genes_0 = offspring_0.mGenes;
+				std::vector<FVector>& genes_1 = offspring_1.mGenes;
+
+				int32_t crossover_points[2];
+				PathKernels::CrossoverGenes(ioRandomStream, inOperator, smallest_path->mGenes.data(), num_chromosomes_small, bigger_path->mGenes.data(), num_chromosomes_big,
+					append_tail_of_bigger_path, crossover_points, [&genes_0, &genes_1](const FVector& inChromosome0, const FVector& inChromosome1)
+				{
+					genes_0.push_back(inChromosome0);
+					genes_1.push_back(inChromosome1);
+				});
+
+				DetermineLength(offspring_0);
+				DetermineLength(offspring_1);
+
+				++successfull_crossover_amount;
+			}
+			else
+			{
+				DuplicatePath(inPopulation[inMatingIndices[i]], ioOffspring[i]);
+				DuplicatePath(inPopulation[inMatingIndices[i + 1]], ioOffspring[i + 1]);
+
+				if (ioLineage != nullptr)
+				{
+					(*ioLineage)[i].mParentIndices[0] = inMatingIndices[i];
+					(*ioLineage)[i + 1].mParentIndices[0] = inMatingIndices[i + 1];
+				}
+			}
+		}
+
+		return successfull_crossover_amount;
+	}
+
+
+
+	/**
+	* Same as FPathIndividual::MutateThroughTranslation
+	*/
+	void MutateThroughTranslation(FRandomStream& ioRandomStream, const ETranslationMutationType inTranslationMutationType, const float inMaxTranslationOffset, FPath& ioPath)
+	{
+		PathKernels::MutateThroughTranslation(ioRandomStream, inTranslationMutationType, inMaxTranslationOffset, ioPath.mGenes.data(), (int32_t)ioPath.mGenes.size());
+	}
+
+
+
+	/**
+	* The sort at the end of FPathGeneticAlgorithm::ScorePopulation, which moves whole paths around
+	*/
+	void SortByFitness(std::vector<FPath>& ioPopulation)
+	{
+		std::sort(ioPopulation.begin(), ioPopulation.end(), [](const FPath& inLhs, const FPath& inRhs)
+		{
+			return inLhs.mFitness > inRhs.mFitness;
+		});
+	}
+
+
+
+	namespace
+	{
+		template <typename T>
+		void Append(std::vector<uint8_t>& ioPayload, const T& inValue)
+		{
+			const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&inValue);
+			ioPayload.insert(ioPayload.end(), bytes, bytes + sizeof(T));
+		}
+
+
+
+		/**
+		* Same as FPathQuantization::Quantize, fails for a chromosome outside the bounds or beyond the error budget
+		*/
+		bool Quantize(const std::vector<FVector>& inGenome, const GaHistory::FQuantization& inQuantization, std::vector<uint32_t>& outSteps)
+		{
+			outSteps.clear();
+
+			for (const FVector& chromosome : inGenome)
+			{
+				const float values[3] = { chromosome.X, chromosome.Y, chromosome.Z };
+
+				for (int32_t axis = 0; axis < 3; ++axis)
+				{
+					const float offset = values[axis] - inQuantization.mOrigin.mValues[axis];
+					if (std::fabs(offset) > inQuantization.mExtent.mValues[axis])
+						return false;
+
+					const uint32_t step_amount = inQuantization.GetStepAmount(axis);
+					const int32_t rounded_step = (int32_t)std::floor(offset / inQuantization.mPrecision + 0.5f) + (int32_t)(step_amount / 2);
+					const uint32_t step = (uint32_t)std::min(std::max(rounded_step, 0), (int32_t)step_amount - 1);
+
+					if (std::fabs(inQuantization.Dequantize(step, axis) - values[axis]) > inQuantization.mErrorBudget)
+						return false;
+
+					outSteps.push_back(step);
+				}
+			}
+
+			return true;
+		}
+
+
+
+		/**
+		* Same as FBitWriter::SerializeInt, least significant bit first and only the bits that tell the step apart from the ones above it
+		*/
+		void PackSteps(const std::vector<uint32_t>& inSteps, const GaHistory::FQuantization& inQuantization, std::vector<uint8_t>& outPacked)
+		{
+			outPacked.assign(inSteps.size() * 4, 0);
+
+			int64_t bit_position = 0;
+			for (size_t i = 0; i < inSteps.size(); ++i)
+			{
+				const uint32_t step_amount = inQuantization.GetStepAmount((int32_t)(i % 3));
+
+				uint32_t value = 0;
+				for (uint32_t mask = 1; value + mask < step_amount && mask != 0; mask *= 2, ++bit_position)
+				{
+					if (inSteps[i] & mask)
+					{
+						outPacked[bit_position >> 3] |= (uint8_t)(1 << (bit_position & 7));
+						value += mask;
+					}
+				}
+			}
+
+			outPacked.resize((size_t)((bit_position + 7) >> 3));
+		}
+	}
+
+
+
+	namespace
+	{
+		/**
+		* Same as FPathQuantization::SerializeGenome, genomes that do not fit the quantization fall back to full floats behind a flag of zero
+		*/
+		void AppendGenome(const std::vector<FVector>& inGenome, const GaHistory::FQuantization& inQuantization, std::vector<uint32_t>& ioSteps, std::vector<uint8_t>& ioPackedSteps, std::vector<uint8_t>& ioPayload)
+		{
+			const int32_t chromosome_amount = (int32_t)inGenome.size();
+
+			const bool is_quantized = inQuantization.IsActive() && Quantize(inGenome, inQuantization, ioSteps);
+			if (inQuantization.IsActive())
+				Append(ioPayload, (uint8_t)(is_quantized ? 1 : 0));
+
+			if (is_quantized)
+			{
+				PackSteps(ioSteps, inQuantization, ioPackedSteps);
+
+				Append(ioPayload, chromosome_amount);
+				Append(ioPayload, (int32_t)ioPackedSteps.size());
+				ioPayload.insert(ioPayload.end(), ioPackedSteps.begin(), ioPackedSteps.end());
+			}
+			else
+			{
+				Append(ioPayload, chromosome_amount);
+				for (const FVector& chromosome : inGenome)
+				{
+					Append(ioPayload, chromosome.X);
+					Append(ioPayload, chromosome.Y);
+					Append(ioPayload, chromosome.Z);
+				}
+			}
+		}
+	}
+
+
+
+	/**
+	* The uncompressed payload of a keyframe chunk in the latest version, same as FPathHistoryFile::SerializeGeneration
+	* The generation info and the phase timings are left zero, only the paths are worth measuring
+	*/
+	void EncodeGeneration(const std::vector<FPath>& inPopulation, const GaHistory::FQuantization& inQuantization, std::vector<uint8_t>& outPayload)
+	{
+		outPayload.clear();
+		outPayload.resize(GaHistory::GetGenerationInfoSize(GaHistory::LatestVersion), 0);
+
+		Append(outPayload, (int32_t)inPopulation.size());
+
+		std::vector<uint32_t> steps;
+		std::vector<uint8_t> packed_steps;
+
+		for (const FPath& path : inPopulation)
+		{
+			Append(outPayload, (int32_t)path.mGenes.size());
+			AppendGenome(path.mGenes, inQuantization, steps, packed_steps, outPayload);
+
+			const uint32_t color = 0xFF000000u;
+			const uint32_t is_fittest = 0;
+			Append(outPayload, color);
+			Append(outPayload, is_fittest);
+		}
+	}
+
+
+
+	namespace
+	{
+		/**
+		* Same as FPathHistoryDelta::FParentLookup, see PathHistoryKernels::EncodePath
+		*/
+		struct FParentLookup
+		{
+			std::unordered_multimap<uint32_t, int32_t> mGenomes;
+			std::unordered_multimap<uint32_t, int32_t> mChromosomes;
+			bool mIsBuilt = false;
+
+			void AddGenome(const uint32_t inHash, const int32_t inParentIndex) { mGenomes.emplace(inHash, inParentIndex); }
+			void AddChromosome(const uint32_t inHash, const int32_t inParentIndex) { mChromosomes.emplace(inHash, inParentIndex); }
+
+			template <typename TVisitor>
+			void ForEachGenome(const uint32_t inHash, TVisitor inVisitor) const { ForEach(mGenomes, inHash, inVisitor); }
+
+			template <typename TVisitor>
+			void ForEachChromosome(const uint32_t inHash, TVisitor inVisitor) const { ForEach(mChromosomes, inHash, inVisitor); }
+
+			template <typename TVisitor>
+			static void ForEach(const std::unordered_multimap<uint32_t, int32_t>& inMap, const uint32_t inHash, TVisitor inVisitor)
+			{
+				const auto range = inMap.equal_range(inHash);
+				for (auto it = range.first; it != range.second; ++it)
+				{
+					if (!inVisitor(it->second))
+						return;
+				}
+			}
+		};
+	}
+
+
+
+	/**
+	* Same as FPathHistoryDelta::Encode, inLineage has to be null unless inReference is the generation right before
+	*/
+	void EncodeGenerationDelta(const std::vector<FPath>& inReference, const std::vector<FPath>& inGeneration, const std::vector<FLineage>* inLineage, std::vector<FPathDelta>& outDeltas)
+	{
+		using FGenomeView = PathHistoryKernels::TGenomeView<FVector>;
+
+		const bool has_lineage = inLineage != nullptr && inLineage->size() == inGeneration.size();
+		const int32_t parent_amount = (int32_t)inReference.size();
+
+		const auto get_parent_genes = [&inReference](const int32_t inParentIndex)
+		{
+			const std::vector<FVector>& parent_genes = inReference[inParentIndex].mGenes;
+			return FGenomeView(parent_genes.data(), (int32_t)parent_genes.size());
+		};
+
+		FParentLookup lookup;
+
+		outDeltas.resize(inGeneration.size());
+
+		for (size_t i = 0; i < inGeneration.size(); ++i)
+		{
+			const std::vector<FVector>& genes = inGeneration[i].mGenes;
+
+			FPathDelta& delta = outDeltas[i];
+			delta.mNodeAmount = (int32_t)genes.size();
+			delta.mMutatedIndices.clear();
+			delta.mMutatedChromosomes.clear();
+
+			const int32_t first_parent_hint = has_lineage ? (*inLineage)[i].mParentIndices[0] : GaHistory::IndexNone;
+			const int32_t second_parent_hint = has_lineage ? (*inLineage)[i].mParentIndices[1] : GaHistory::IndexNone;
+
+			delta.mCrossoverIndex = PathHistoryKernels::EncodePath(FGenomeView(genes.data(), delta.mNodeAmount), parent_amount, get_parent_genes, lookup,
+				first_parent_hint, second_parent_hint, delta.mParentIndices, [&delta, &genes](const int32_t inIndex)
+			{
+				delta.mMutatedIndices.push_back(inIndex);
+				delta.mMutatedChromosomes.push_back(genes[inIndex]);
+			});
+		}
+	}
+
+
+
+	/**
+	* The uncompressed payload of a delta chunk in the latest version, same as FPathHistoryFile::CompressGenerationDelta
+	*/
+	void SerializeGenerationDelta(const std::vector<FPathDelta>& inDeltas, const GaHistory::FQuantization& inQuantization, std::vector<uint8_t>& outPayload)
+	{
+		outPayload.clear();
+		outPayload.resize(GaHistory::GetGenerationInfoSize(GaHistory::LatestVersion), 0);
+
+		Append(outPayload, (int32_t)inDeltas.size());
+
+		std::vector<uint32_t> steps;
+		std::vector<uint8_t> packed_steps;
+
+		for (const FPathDelta& delta : inDeltas)
+		{
+			const uint32_t color = 0xFF000000u;
+			const uint32_t is_fittest = 0;
+
+			Append(outPayload, delta.mParentIndices[0]);
+			Append(outPayload, delta.mParentIndices[1]);
+			Append(outPayload, delta.mCrossoverIndex);
+			Append(outPayload, delta.mNodeAmount);
+			Append(outPayload, color);
+			Append(outPayload, is_fittest);
+
+			Append(outPayload, (int32_t)delta.mMutatedIndices.size());
+			for (const int32_t mutated_index : delta.mMutatedIndices)
+				Append(outPayload, mutated_index);
+
+			AppendGenome(delta.mMutatedChromosomes, inQuantization, steps, packed_steps, outPayload);
+		}
+	}
+
+
+
+	namespace
+	{
+		/**
+		* Runs the blocks one after the other, the engine spreads them over the task graph
+		*/
+		const auto SerialForBlocks = [](const int32_t inBlockAmount, const auto& inBody)
+		{
+			for (int32_t i = 0; i < inBlockAmount; ++i)
+				inBody(i);
+		};
+	}
+
+
+
+	/**
+	* Same as FPathHistoryFile::CompressScratch on a single thread, a block size of zero compresses the payload as one stream
+	*/
+	bool CompressPayload(const std::vector<uint8_t>& inPayload, const int32_t inLevel, const int32_t inBlockSize, std::vector<uint8_t>& outCompressed)
+	{
+		int32_t compressed_size = PathHistoryKernels::GetCompressBound((int32_t)inPayload.size(), inLevel, inBlockSize);
+		outCompressed.resize(compressed_size);
+
+		if (!PathHistoryKernels::CompressBlocks(inPayload.data(), (int32_t)inPayload.size(), inLevel, inBlockSize, outCompressed.data(), compressed_size, SerialForBlocks))
+			return false;
+
+		outCompressed.resize(compressed_size);
+		return true;
+	}
+
+
+
+	/**
+	* Same as FPathHistoryFile::DecompressScratch on a single thread
+	*/
+	bool InflatePayload(const std::vector<uint8_t>& inCompressed, const size_t inUncompressedSize, const int32_t inBlockSize, std::vector<uint8_t>& outPayload)
+	{
+		outPayload.resize(inUncompressedSize);
+
+		std::vector<int32_t> block_offsets(PathHistoryKernels::GetBlockAmount((int32_t)inUncompressedSize, inBlockSize) + 1);
+		return PathHistoryKernels::InflateBlocks(inCompressed.data(), (int32_t)inCompressed.size(), inBlockSize, outPayload.data(), (int32_t)inUncompressedSize, block_offsets.data(), SerialForBlocks);
+	}
+}
@@ -0,0 +1,130 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "GaHistoryFile.h"
+#include "PathHistoryKernels.h"
+#include "PathKernels.h"
+
+#include <cstdint>
+#include <vector>
+
+/**
+* The hot kernels of the genetic algorithms without the engine, the glue around the code they are named after
+*
+* The kernels themselves are those of PathKernels.h and PathHistoryKernels.h, which the module includes as well,
+* only FVector, FRandomStream and the serialization of the history payload are stand-ins for their engine counterparts
+* The payload is checked by decoding it with GaHistory, the same decoder gahistory reads the recorded files with
+* Engine containers are replaced by std::vector, which grows the same way TArray does for the sizes involved
+*/
+namespace GaBench
+{
+	struct FVector
+	{
+		float X = 0.0f;
+		float Y = 0.0f;
+		float Z = 0.0f;
+
+		FVector() = default;
+		FVector(const float inX, const float inY, const float inZ) : X(inX), Y(inY), Z(inZ) {}
+
+		FVector operator+(const FVector& inOther) const { return FVector(X + inOther.X, Y + inOther.Y, Z + inOther.Z); }
+		FVector operator-(const FVector& inOther) const { return FVector(X - inOther.X, Y - inOther.Y, Z - inOther.Z); }
+		FVector operator-() const { return FVector(-X, -Y, -Z); }
+		FVector operator*(const float inScale) const { return FVector(X * inScale, Y * inScale, Z * inScale); }
+		FVector operator/(const float inScale) const { return FVector(X / inScale, Y / inScale, Z / inScale); }
+		FVector& operator+=(const FVector& inOther) { X += inOther.X; Y += inOther.Y; Z += inOther.Z; return *this; }
+
+		bool Normalize();
+
+		static float DotProduct(const FVector& inA, const FVector& inB) { return inA.X * inB.X + inA.Y * inB.Y + inA.Z * inB.Z; }
+	};
+
+	/**
+	* Same generator as FRandomStream, so the kernels make the same decisions as in the engine
+	*/
+	class FRandomStream
+	{
+	public:
+		explicit FRandomStream(const int32_t inSeed) : mSeed((uint32_t)inSeed) {}
+
+		float GetFraction();
+		float FRand() { return GetFraction(); }
+		float FRandRange(const float inMin, const float inMax) { return inMin + (inMax - inMin) * FRand(); }
+		int32_t RandHelper(const int32_t inA) { return inA > 0 ? (int32_t)(GetFraction() * (float)inA) : 0; }
+		int32_t RandRange(const int32_t inMin, const int32_t inMax) { return inMin + RandHelper(inMax - inMin + 1); }
+
+	private:
+		uint32_t mSeed = 0;
+	};
+
+	using PathKernels::ECrossoverOperator;
+	using PathKernels::ETranslationMutationType;
+	using PathKernels::FGeometryConstraints;
+	using PathKernels::FGeometryResult;
+
+	/**
+	* The part of FPathIndividual the kernels touch
+	*/
+	struct FPath
+	{
+		std::vector<FVector> mGenes;
+		float mFitness = 0.0f;
+		float mAmountOfNodesFitness = 0.0f;
+		float mLength = 0.0f;
+	};
+
+	/**
+	* The parents of a bred path, same as those of FPathLineageRecord
+	*/
+	struct FLineage
+	{
+		int32_t mParentIndices[2] = { GaHistory::IndexNone, GaHistory::IndexNone };
+	};
+
+	/**
+	* Same as FPathDelta, without the color and the fittest flag
+	*/
+	struct FPathDelta
+	{
+		int32_t mParentIndices[2] = { GaHistory::IndexNone, GaHistory::IndexNone };
+		int32_t mCrossoverIndex = 0;
+		int32_t mNodeAmount = 0;
+		std::vector<int32_t> mMutatedIndices;
+		std::vector<FVector> mMutatedChromosomes;
+	};
+
+	struct FTriangle
+	{
+		FVector mPoints[3];
+	};
+
+	/**
+	* Same as MappedTriangle of the triangle managers, pointing into the population instead of at an actor
+	*/
+	struct FMappedTriangle
+	{
+		int32_t mIndex = 0;
+		float mFitness = 0.0f;
+	};
+
+
+
+	void RandomizePath(FRandomStream& ioRandomStream, const FVector& inStartingLocation, const int32_t inAmountOfNodes, const float inMaxVariation, FPath& outPath);
+	void RandomizeTriangle(FRandomStream& ioRandomStream, const float inMaxDistanceFromMidPoint, FTriangle& outTriangle);
+
+	FGeometryResult EvaluateGenome(const FVector* inChromosomes, const int32_t inChromosomeAmount, const FGeometryConstraints& inConstraints, float* outSegmentLengths = nullptr);
+	float EvaluateTriangleFitness(const std::vector<FTriangle>& inTriangles, std::vector<FMappedTriangle>& outMappedTriangles);
+
+	void SelectRoulette(FRandomStream& ioRandomStream, const std::vector<FPath>& inPopulation, const float inTotalFitness, const int32_t inEnd, std::vector<int32_t>& ioMatingIndices);
+	int32_t Crossover(FRandomStream& ioRandomStream, const ECrossoverOperator inOperator, const float inCrossoverProbability,
+		const std::vector<FPath>& inPopulation, const std::vector<int32_t>& inMatingIndices, std::vector<FPath>& ioOffspring, std::vector<FLineage>* ioLineage = nullptr);
+	void MutateThroughTranslation(FRandomStream& ioRandomStream, const ETranslationMutationType inTranslationMutationType, const float inMaxTranslationOffset, FPath& ioPath);
+	void SortByFitness(std::vector<FPath>& ioPopulation);
+
+	void EncodeGeneration(const std::vector<FPath>& inPopulation, const GaHistory::FQuantization& inQuantization, std::vector<uint8_t>& outPayload);
+	void EncodeGenerationDelta(const std::vector<FPath>& inReference, const std::vector<FPath>& inGeneration, const std::vector<FLineage>* inLineage, std::vector<FPathDelta>& outDeltas);
+	void SerializeGenerationDelta(const std::vector<FPathDelta>& inDeltas, const GaHistory::FQuantization& inQuantization, std::vector<uint8_t>& outPayload);
+	bool CompressPayload(const std::vector<uint8_t>& inPayload, const int32_t inLevel, const int32_t inBlockSize, std::vector<uint8_t>& outCompressed);
+	bool InflatePayload(const std::vector<uint8_t>& inCompressed, const size_t inUncompressedSize, const int32_t inBlockSize, std::vector<uint8_t>& outPayload);
+}
@@ -0,0 +1,614 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GaBenchHarness.h"
+#include "GaBenchKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+/**
+* Microbenchmarks of the genetic algorithm kernels, see PrintUsage
+* The sizes are population sizes, or triangle amounts for the triangle fitness
+*/
+namespace
+{
+	using namespace GaBench;
+
+	const int32_t ExitSuccess = 0;
+	const int32_t ExitFailure = 2;
+
+	const float MaxInitialVariation = 40.0f; ///< Defaults of FPathGeneticAlgorithmSettings
+	const float CrossoverProbability = 70.0f;
+	const float MutationProbability = 5.0f;
+	const float MaxTranslationOffset = 40.0f;
+	const float MaxSegmentLength = 40.0f;
+	const float MaxSlopeToleranceAngle = 45.0f;
+	const float MaxDistanceFromMidPoint = 80.0f; ///< Default of ATriangle
+
+	void PrintUsage()
+	{
+		std::fprintf(stderr,
+			"Usage: gabench [options]\n"
+			"  --sizes=20,200,2000,20000   Population sizes every benchmark is run at\n"
+			"  --nodes=8                   Nodes of every generated path\n"
+			"  --warmup=3                  Samples thrown away before measuring\n"
+			"  --samples=20                Measured samples\n"
+			"  --min-sample-ms=5           Minimum duration of a sample, the kernel is repeated until it is reached\n"
+			"  --seed=1                    Seed of the generated input and of the kernels\n"
+			"  --level=6                   Compression level of the history benchmarks\n"
+			"  --block-size=32768          Block size of the history benchmarks, 0 compresses a single stream\n"
+			"  --filter=<text>             Only runs the benchmarks whose name contains the text\n"
+			"  --json=<file>               Also writes the results as JSON, - writes only the JSON to stdout\n");
+	}
+
+
+
+	/**
+	* Paths of inOptions.mAmountOfNodes nodes from the origin with made up fitness scores,
+	* the kernels under test do not depend on how the scores came about
+	*/
+	void GeneratePopulation(FRandomStream& ioRandomStream, const int32_t inSize, const FOptions& inOptions, std::vector<FPath>& outPopulation)
+	{
+		outPopulation.resize(inSize);
+
+		for (FPath& path : outPopulation)
+		{
+			RandomizePath(ioRandomStream, FVector(), inOptions.mAmountOfNodes, MaxInitialVariation, path);
+			path.mAmountOfNodesFitness = ioRandomStream.FRandRange(0.0f, 10.0f);
+			path.mFitness = path.mAmountOfNodesFitness + ioRandomStream.FRandRange(0.0f, 400.0f);
+		}
+	}
+
+
+
+	float GetTotalFitness(const std::vector<FPath>& inPopulation)
+	{
+		float total_fitness = 0.0f;
+		for (const FPath& path : inPopulation)
+			total_fitness += path.mFitness;
+
+		return total_fitness;
+	}
+
+
+
+	/**
+	* Bounds every generated path fits in, at the default precision of APathManager
+	*/
+	GaHistory::FQuantization GetQuantization(const FOptions& inOptions)
+	{
+		GaHistory::FQuantization quantization;
+		quantization.mIsEnabled = true;
+
+		for (float& extent : quantization.mExtent.mValues)
+			extent = MaxInitialVariation * inOptions.mAmountOfNodes + 1.0f;
+
+		return quantization;
+	}
+
+
+
+	class FPopulationBenchmark : public FBenchmark
+	{
+	public:
+		bool Setup(const int32_t inSize, const FOptions& inOptions) override
+		{
+			mRandomStream = FRandomStream(inOptions.mRandomSeed);
+			GeneratePopulation(mRandomStream, inSize, inOptions, mPopulation);
+			mTotalFitness = GetTotalFitness(mPopulation);
+
+			return inSize > 0 && inOptions.mAmountOfNodes >= 2;
+		}
+
+		int64_t GetItemAmount() const override { return (int64_t)mPopulation.size(); }
+
+	protected:
+		FRandomStream mRandomStream = FRandomStream(0);
+		std::vector<FPath> mPopulation;
+		float mTotalFitness = 0.0f;
+	};
+
+
+
+	class FTriangleFitnessBenchmark : public FBenchmark
+	{
+	public:
+		const char* GetName() const override { return "triangle_fitness"; }
+
+		bool Setup(const int32_t inSize, const FOptions& inOptions) override
+		{
+			FRandomStream random_stream(inOptions.mRandomSeed);
+
+			mTriangles.resize(inSize);
+			for (FTriangle& triangle : mTriangles)
+				RandomizeTriangle(random_stream, MaxDistanceFromMidPoint, triangle);
+
+			return inSize > 0;
+		}
+
+		void Run() override { EvaluateTriangleFitness(mTriangles, mMappedTriangles); }
+
+		int64_t GetItemAmount() const override { return (int64_t)mTriangles.size(); }
+
+	private:
+		std::vector<FTriangle> mTriangles;
+		std::vector<FMappedTriangle> mMappedTriangles;
+	};
+
+
+
+	class FPathGeometryBenchmark : public FPopulationBenchmark
+	{
+	public:
+		const char* GetName() const override { return "path_geometry"; }
+
+		void Run() override
+		{
+			const FGeometryConstraints constraints(true, MaxSegmentLength, true, MaxSlopeToleranceAngle);
+
+			for (FPath& path : mPopulation)
+				path.mLength = EvaluateGenome(path.mGenes.data(), (int32_t)path.mGenes.size(), constraints).mLength;
+		}
+	};
+
+
+
+	class FCrossoverBenchmark : public FPopulationBenchmark
+	{
+	public:
+		FCrossoverBenchmark(const char* inName, const ECrossoverOperator inOperator) : mName(inName), mOperator(inOperator) {}
+
+		const char* GetName() const override { return mName; }
+
+		bool Setup(const int32_t inSize, const FOptions& inOptions) override
+		{
+			if (!FPopulationBenchmark::Setup(inSize, inOptions))
+				return false;
+
+			mMatingIndices.clear();
+			SelectRoulette(mRandomStream, mPopulation, mTotalFitness, inSize, mMatingIndices);
+			mOffspring.assign(mMatingIndices.size(), FPath());
+
+			return true;
+		}
+
+		void Run() override { Crossover(mRandomStream, mOperator, CrossoverProbability, mPopulation, mMatingIndices, mOffspring); }
+
+	private:
+		const char* mName;
+		ECrossoverOperator mOperator;
+		std::vector<int32_t> mMatingIndices;
+		std::vector<FPath> mOffspring;
+	};
+
+
+
+	/**
+	* The genes wander off over the iterations, which does not change the work of a translation
+	*/
+	class FMutationBenchmark : public FPopulationBenchmark
+	{
+	public:
+		FMutationBenchmark(const char* inName, const ETranslationMutationType inTranslationMutationType) : mName(inName), mTranslationMutationType(inTranslationMutationType) {}
+
+		const char* GetName() const override { return mName; }
+
+		void Run() override
+		{
+			for (FPath& path : mPopulation)
+				MutateThroughTranslation(mRandomStream, mTranslationMutationType, MaxTranslationOffset, path);
+		}
+
+	private:
+		const char* mName;
+		ETranslationMutationType mTranslationMutationType;
+	};
+
+
+
+	class FSelectionBenchmark : public FPopulationBenchmark
+	{
+	public:
+		const char* GetName() const override { return "selection/roulette"; }
+
+		void Run() override
+		{
+			mMatingIndices.clear();
+			SelectRoulette(mRandomStream, mPopulation, mTotalFitness, (int32_t)mPopulation.size(), mMatingIndices);
+		}
+
+	private:
+		std::vector<int32_t> mMatingIndices;
+	};
+
+
+
+	/**
+	* Sorting an already sorted population is a different benchmark, so every call starts from the generated order
+	*/
+	class FSortBenchmark : public FPopulationBenchmark
+	{
+	public:
+		const char* GetName() const override { return "sort/fitness"; }
+
+		void Reset() override { mSortedPopulation = mPopulation; }
+		bool IsDestructive() const override { return true; }
+
+		void Run() override { SortByFitness(mSortedPopulation); }
+
+	private:
+		std::vector<FPath> mSortedPopulation;
+	};
+
+
+
+	/**
+	* A keyframe chunk of the generation from the paths to the compressed payload
+	*/
+	class FHistoryEncodeBenchmark : public FPopulationBenchmark
+	{
+	public:
+		const char* GetName() const override { return "history/encode"; }
+
+		bool Setup(const int32_t inSize, const FOptions& inOptions) override
+		{
+			mQuantization = GetQuantization(inOptions);
+			mCompressionLevel = inOptions.mCompressionLevel;
+			mBlockSize = inOptions.mBlockSize;
+
+			return FPopulationBenchmark::Setup(inSize, inOptions);
+		}
+
+		void Run() override
+		{
+			EncodeGeneration(mPopulation, mQuantization, mPayload);
+			CompressPayload(mPayload, mCompressionLevel, mBlockSize, mCompressed);
+		}
+
+	private:
+		GaHistory::FQuantization mQuantization;
+		int32_t mCompressionLevel = 0;
+		int32_t mBlockSize = 0;
+		std::vector<uint8_t> mPayload;
+		std::vector<uint8_t> mCompressed;
+	};
+
+
+
+	/**
+	* The compressed keyframe chunk back to the paths, through the same decoder as gahistory
+	*/
+	class FHistoryDecodeBenchmark : public FPopulationBenchmark
+	{
+	public:
+		const char* GetName() const override { return "history/decode"; }
+
+		bool Setup(const int32_t inSize, const FOptions& inOptions) override
+		{
+			mQuantization = GetQuantization(inOptions);
+			mBlockSize = inOptions.mBlockSize;
+
+			if (!FPopulationBenchmark::Setup(inSize, inOptions))
+				return false;
+
+			std::vector<uint8_t> payload;
+			EncodeGeneration(mPopulation, mQuantization, payload);
+			mUncompressedSize = payload.size();
+
+			if (!CompressPayload(payload, inOptions.mCompressionLevel, mBlockSize, mCompressed) || !Decode())
+				return false;
+
+			// A decoder that got out of step with the encoder would only be timing its own failure
+			if (mGeneration.mPaths.size() != mPopulation.size())
+				return false;
+
+			for (size_t i = 0; i < mPopulation.size(); ++i)
+			{
+				const GaHistory::FPath& decoded_path = mGeneration.mPaths[i];
+				if (decoded_path.mNodeAmount != inOptions.mAmountOfNodes || decoded_path.mGenes.size() != mPopulation[i].mGenes.size())
+					return false;
+
+				for (size_t j = 0; j < decoded_path.mGenes.size(); ++j)
+				{
+					const FVector& gene = mPopulation[i].mGenes[j];
+					const float values[3] = { gene.X, gene.Y, gene.Z };
+
+					for (int32_t axis = 0; axis < 3; ++axis)
+					{
+						if (std::fabs(decoded_path.mGenes[j].mValues[axis] - values[axis]) > mQuantization.mErrorBudget)
+							return false;
+					}
+				}
+			}
+
+			return true;
+		}
+
+		void Run() override { Decode(); }
+
+	private:
+		bool Decode()
+		{
+			if (!InflatePayload(mCompressed, mUncompressedSize, mBlockSize, mPayload))
+				return false;
+
+			GaHistory::FByteReader reader(mPayload.data(), mPayload.size());
+			return GaHistory::DecodeGeneration(reader, GaHistory::LatestVersion, mQuantization, mGeneration);
+		}
+
+		GaHistory::FQuantization mQuantization;
+		int32_t mBlockSize = 0;
+		size_t mUncompressedSize = 0;
+		std::vector<uint8_t> mCompressed;
+		std::vector<uint8_t> mPayload;
+		GaHistory::FGeneration mGeneration;
+	};
+
+
+
+	/**
+	* A generation bred from the population with the crossover and mutation kernels, which the delta chunks are encoded against
+	*/
+	class FHistoryDeltaBenchmark : public FPopulationBenchmark
+	{
+	public:
+		bool Setup(const int32_t inSize, const FOptions& inOptions) override
+		{
+			mQuantization = GetQuantization(inOptions);
+			mCompressionLevel = inOptions.mCompressionLevel;
+			mBlockSize = inOptions.mBlockSize;
+
+			if (!FPopulationBenchmark::Setup(inSize, inOptions))
+				return false;
+
+			std::vector<int32_t> mating_indices;
+			SelectRoulette(mRandomStream, mPopulation, mTotalFitness, inSize, mating_indices);
+
+			mOffspring.assign(mating_indices.size(), FPath());
+			Crossover(mRandomStream, ECrossoverOperator::SinglePoint, CrossoverProbability, mPopulation, mating_indices, mOffspring, &mLineage);
+
+			for (FPath& path : mOffspring)
+			{
+				if (mRandomStream.FRandRange(0.0f, 100.0f) < MutationProbability)
+					MutateThroughTranslation(mRandomStream, ETranslationMutationType::AnyButStart, MaxTranslationOffset, path);
+			}
+
+			return true;
+		}
+
+	protected:
+		GaHistory::FQuantization mQuantization;
+		int32_t mCompressionLevel = 0;
+		int32_t mBlockSize = 0;
+		std::vector<FPath> mOffspring;
+		std::vector<FLineage> mLineage;
+	};
+
+
+
+	/**
+	* A delta chunk of the bred generation from the paths to the compressed payload
+	* Without the lineage every parent is looked up through the hashes, as for generations recorded without one
+	*/
+	class FHistoryDeltaEncodeBenchmark : public FHistoryDeltaBenchmark
+	{
+	public:
+		FHistoryDeltaEncodeBenchmark(const char* inName, const bool inUseLineage) : mName(inName), mUseLineage(inUseLineage) {}
+
+		const char* GetName() const override { return mName; }
+
+		void Run() override
+		{
+			EncodeGenerationDelta(mPopulation, mOffspring, mUseLineage ? &mLineage : nullptr, mDeltas);
+			SerializeGenerationDelta(mDeltas, mQuantization, mPayload);
+			CompressPayload(mPayload, mCompressionLevel, mBlockSize, mCompressed);
+		}
+
+	private:
+		const char* mName;
+		bool mUseLineage;
+		std::vector<FPathDelta> mDeltas;
+		std::vector<uint8_t> mPayload;
+		std::vector<uint8_t> mCompressed;
+	};
+
+
+
+	/**
+	* The compressed delta chunk back to the paths against the decoded parents, through the same decoder as gahistory
+	*/
+	class FHistoryDeltaDecodeBenchmark : public FHistoryDeltaBenchmark
+	{
+	public:
+		const char* GetName() const override { return "history/delta_decode"; }
+
+		bool Setup(const int32_t inSize, const FOptions& inOptions) override
+		{
+			if (!FHistoryDeltaBenchmark::Setup(inSize, inOptions))
+				return false;
+
+			std::vector<uint8_t> payload;
+			EncodeGeneration(mPopulation, mQuantization, payload);
+
+			GaHistory::FByteReader reference_reader(payload.data(), payload.size());
+			if (!GaHistory::DecodeGeneration(reference_reader, GaHistory::LatestVersion, mQuantization, mReference))
+				return false;
+
+			std::vector<FPathDelta> deltas;
+			EncodeGenerationDelta(mPopulation, mOffspring, &mLineage, deltas);
+			SerializeGenerationDelta(deltas, mQuantization, payload);
+			mUncompressedSize = payload.size();
+
+			if (!CompressPayload(payload, mCompressionLevel, mBlockSize, mCompressed) || !Decode())
+				return false;
+
+			// Quantized parents carry their rounding into the decoded offspring, which the error budget covers per gene
+			if (mGeneration.mPaths.size() != mOffspring.size())
+				return false;
+
+			for (size_t i = 0; i < mOffspring.size(); ++i)
+			{
+				const GaHistory::FPath& decoded_path = mGeneration.mPaths[i];
+				if (decoded_path.mGenes.size() != mOffspring[i].mGenes.size())
+					return false;
+
+				for (size_t j = 0; j < decoded_path.mGenes.size(); ++j)
+				{
+					const FVector& gene = mOffspring[i].mGenes[j];
+					const float values[3] = { gene.X, gene.Y, gene.Z };
+
+					for (int32_t axis = 0; axis < 3; ++axis)
+					{
+						if (std::fabs(decoded_path.mGenes[j].mValues[axis] - values[axis]) > mQuantization.mErrorBudget)
+							return false;
+					}
+				}
+			}
+
+			return true;
+		}
+
+		void Run() override { Decode(); }
+
+	private:
+		bool Decode()
+		{
+			if (!InflatePayload(mCompressed, mUncompressedSize, mBlockSize, mPayload))
+				return false;
+
+			GaHistory::FByteReader reader(mPayload.data(), mPayload.size());
+			return GaHistory::DecodeGenerationDelta(reader, GaHistory::LatestVersion, mQuantization, mReference, mGeneration);
+		}
+
+		size_t mUncompressedSize = 0;
+		std::vector<uint8_t> mCompressed;
+		std::vector<uint8_t> mPayload;
+		GaHistory::FGeneration mReference;
+		GaHistory::FGeneration mGeneration;
+	};
+
+
+
+	bool ParseInteger(const char* inText, int32_t& outValue)
+	{
+		char* end = nullptr;
+		const long value = std::strtol(inText, &end, 10);
+		if (end == inText || *end != '\0')
+			return false;
+
+		outValue = (int32_t)value;
+		return true;
+	}
+
+
+
+	bool ParseSizes(const std::string& inText, std::vector<int32_t>& outSizes)
+	{
+		outSizes.clear();
+
+		size_t start = 0;
+		while (start <= inText.size())
+		{
+			const size_t end = std::min(inText.find(',', start), inText.size());
+
+			int32_t size = 0;
+			if (!ParseInteger(inText.substr(start, end - start).c_str(), size) || size <= 0)
+				return false;
+
+			outSizes.push_back(size);
+			start = end + 1;
+		}
+
+		return !outSizes.empty();
+	}
+
+
+
+	bool ParseOptions(const int argc, char** argv, FOptions& outOptions)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string argument = argv[i];
+			const size_t separator = argument.find('=');
+			if (argument.compare(0, 2, "--") != 0 || separator == std::string::npos)
+				return false;
+
+			const std::string name = argument.substr(2, separator - 2);
+			const std::string value = argument.substr(separator + 1);
+
+			bool is_valid = true;
+			if (name == "sizes")
+				is_valid = ParseSizes(value, outOptions.mSizes);
+			else if (name == "nodes")
+				is_valid = ParseInteger(value.c_str(), outOptions.mAmountOfNodes) && outOptions.mAmountOfNodes >= 2;
+			else if (name == "warmup")
+				is_valid = ParseInteger(value.c_str(), outOptions.mWarmupSampleAmount) && outOptions.mWarmupSampleAmount >= 0;
+			else if (name == "samples")
+				is_valid = ParseInteger(value.c_str(), outOptions.mSampleAmount) && outOptions.mSampleAmount > 0;
+			else if (name == "min-sample-ms")
+				is_valid = (outOptions.mMinSampleMilliseconds = std::atof(value.c_str())) >= 0.0;
+			else if (name == "seed")
+				is_valid = ParseInteger(value.c_str(), outOptions.mRandomSeed);
+			else if (name == "level")
+				is_valid = ParseInteger(value.c_str(), outOptions.mCompressionLevel);
+			else if (name == "block-size")
+				is_valid = ParseInteger(value.c_str(), outOptions.mBlockSize) && outOptions.mBlockSize >= 0;
+			else if (name == "filter")
+				outOptions.mFilter = value;
+			else if (name == "json")
+				outOptions.mJsonFilePath = value;
+			else
+				is_valid = false;
+
+			if (!is_valid)
+				return false;
+		}
+
+		return true;
+	}
+}
+
+
+
+int main(int argc, char** argv)
+{
+	FOptions options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return ExitFailure;
+	}
+
+	FHarness harness(options);
+	harness.Add(std::unique_ptr<FBenchmark>(new FTriangleFitnessBenchmark()));
+	harness.Add(std::unique_ptr<FBenchmark>(new FPathGeometryBenchmark()));
+	harness.Add(std::unique_ptr<FBenchmark>(new FCrossoverBenchmark("crossover/single_point", ECrossoverOperator::SinglePoint)));
+	harness.Add(std::unique_ptr<FBenchmark>(new FCrossoverBenchmark("crossover/double_point", ECrossoverOperator::DoublePoint)));
+	harness.Add(std::unique_ptr<FBenchmark>(new FCrossoverBenchmark("crossover/uniform", ECrossoverOperator::Uniform)));
+	harness.Add(std::unique_ptr<FBenchmark>(new FMutationBenchmark("mutation/any_but_start", ETranslationMutationType::AnyButStart)));
+	harness.Add(std::unique_ptr<FBenchmark>(new FMutationBenchmark("mutation/head_only", ETranslationMutationType::HeadOnly)));
+	harness.Add(std::unique_ptr<FBenchmark>(new FMutationBenchmark("mutation/head_falloff", ETranslationMutationType::HeadFalloff)));
+	harness.Add(std::unique_ptr<FBenchmark>(new FMutationBenchmark("mutation/all_at_once", ETranslationMutationType::AllAtOnce)));
+	harness.Add(std::unique_ptr<FBenchmark>(new FSelectionBenchmark()));
+	harness.Add(std::unique_ptr<FBenchmark>(new FSortBenchmark()));
+	harness.Add(std::unique_ptr<FBenchmark>(new FHistoryEncodeBenchmark()));
+	harness.Add(std::unique_ptr<FBenchmark>(new FHistoryDecodeBenchmark()));
+	harness.Add(std::unique_ptr<FBenchmark>(new FHistoryDeltaEncodeBenchmark("history/delta_encode", true)));
+	harness.Add(std::unique_ptr<FBenchmark>(new FHistoryDeltaEncodeBenchmark("history/delta_encode_search", false)));
+	harness.Add(std::unique_ptr<FBenchmark>(new FHistoryDeltaDecodeBenchmark()));
+
+	const bool has_run_all = harness.Run();
+
+	if (options.mJsonFilePath != "-")
+		harness.PrintTable(stdout);
+
+	if (!options.mJsonFilePath.empty() && !harness.WriteJson(options.mJsonFilePath))
+	{
+		std::fprintf(stderr, "Unable to write %s\n", options.mJsonFilePath.c_str());
+		return ExitFailure;
+	}
+
+	return has_run_all ? ExitSuccess : ExitFailure;
+}
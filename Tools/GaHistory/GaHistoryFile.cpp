@@ -0,0 +1,797 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GaHistoryFile.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+namespace GaHistory
+{
+	/**
+	* Compared bit for bit, same as FPathHistoryDelta
+	*/
+	bool FVector3::operator==(const FVector3& inOther) const
+	{
+		return std::memcmp(mValues, inOther.mValues, sizeof(mValues)) == 0;
+	}
+
+
+
+	bool FQuantization::IsActive() const
+	{
+		const float min_extent = std::min(mExtent.mValues[0], std::min(mExtent.mValues[1], mExtent.mValues[2]));
+		const float max_extent = std::max(mExtent.mValues[0], std::max(mExtent.mValues[1], mExtent.mValues[2]));
+
+		return mIsEnabled && mPrecision > 0.0f && min_extent > 0.0f && max_extent / mPrecision < (float)(INT32_MAX / 2);
+	}
+
+
+
+	uint32_t FQuantization::GetStepAmount(const int32_t inAxis) const
+	{
+		return 2 * (uint32_t)(int32_t)std::ceil(mExtent.mValues[inAxis] / mPrecision) + 1;
+	}
+
+
+
+	float FQuantization::Dequantize(const uint32_t inStep, const int32_t inAxis) const
+	{
+		return mOrigin.mValues[inAxis] + (float)((int32_t)inStep - (int32_t)(GetStepAmount(inAxis) / 2)) * mPrecision;
+	}
+
+
+
+	void FByteReader::Read(void* outData, const size_t inSize)
+	{
+		if (mIsError || inSize > GetRemaining())
+		{
+			mIsError = true;
+			std::memset(outData, 0, inSize);
+			return;
+		}
+
+		std::memcpy(outData, mData + mPosition, inSize);
+		mPosition += inSize;
+	}
+
+
+
+	/**
+	* FArchive stores bools as a uint32, anything but zero and one is an error
+	*/
+	bool FByteReader::ReadBool()
+	{
+		const uint32_t value = ReadUInt32();
+		if (value > 1)
+			mIsError = true;
+
+		return value != 0;
+	}
+
+
+
+	FVector3 FByteReader::ReadVector()
+	{
+		FVector3 vector;
+		Read(vector.mValues, sizeof(vector.mValues));
+
+		return vector;
+	}
+
+
+
+	bool FByteReader::ReadVectors(std::vector<FVector3>& outVectors)
+	{
+		const int32_t amount = ReadInt32();
+		if (amount < 0 || (size_t)amount * sizeof(FVector3) > GetRemaining())
+		{
+			mIsError = true;
+			return false;
+		}
+
+		outVectors.resize(amount);
+		Read(outVectors.data(), amount * sizeof(FVector3));
+
+		return !mIsError;
+	}
+
+
+
+	bool FByteReader::ReadInt32s(std::vector<int32_t>& outValues)
+	{
+		const int32_t amount = ReadInt32();
+		if (amount < 0 || (size_t)amount * sizeof(int32_t) > GetRemaining())
+		{
+			mIsError = true;
+			return false;
+		}
+
+		outValues.resize(amount);
+		Read(outValues.data(), amount * sizeof(int32_t));
+
+		return !mIsError;
+	}
+
+
+
+	/**
+	* Quantized genomes are packed the way FBitWriter::SerializeInt packs them, least significant bit first,
+	* and only as many bits of a step as are needed to tell it apart from the steps above it
+	*/
+	bool FByteReader::ReadGenome(const FQuantization& inQuantization, std::vector<FVector3>& outGenome)
+	{
+		if (!inQuantization.IsActive() || ReadUInt8() == 0)
+			return ReadVectors(outGenome);
+
+		const int32_t chromosome_amount = ReadInt32();
+		const int32_t packed_size = ReadInt32();
+
+		if (mIsError || chromosome_amount < 0 || packed_size < 0 || (size_t)packed_size > GetRemaining())
+		{
+			mIsError = true;
+			return false;
+		}
+
+		const uint8_t* packed_steps = mData + mPosition;
+		const int64_t bit_amount = (int64_t)packed_size * 8;
+		int64_t bit_position = 0;
+
+		outGenome.resize(chromosome_amount);
+		for (FVector3& chromosome : outGenome)
+		{
+			for (int32_t axis = 0; axis < 3; ++axis)
+			{
+				const uint32_t step_amount = inQuantization.GetStepAmount(axis);
+
+				uint32_t step = 0;
+				for (uint32_t mask = 1; step + mask < step_amount && mask != 0; mask *= 2, ++bit_position)
+				{
+					if (bit_position >= bit_amount)
+					{
+						mIsError = true;
+						return false;
+					}
+
+					if (packed_steps[bit_position >> 3] & (1 << (bit_position & 7)))
+						step |= mask;
+				}
+
+				chromosome.mValues[axis] = inQuantization.Dequantize(step, axis);
+			}
+		}
+
+		mPosition += packed_size;
+
+		return true;
+	}
+
+
+
+	void DecodeGenerationInfo(FByteReader& ioReader, const int32_t inVersion, FGenerationInfo& outInfo)
+	{
+		outInfo.mGenerationNumber = ioReader.ReadInt32();
+		outInfo.mCrossoverAmount = ioReader.ReadInt32();
+		outInfo.mAmountOfTranslationMutations = ioReader.ReadInt32();
+		outInfo.mAmountOfInsertionMutations = ioReader.ReadInt32();
+		outInfo.mAmountOfDeletionMutations = ioReader.ReadInt32();
+		outInfo.mAverageFitness = ioReader.ReadFloat();
+		outInfo.mMaximumFitness = ioReader.ReadFloat();
+		outInfo.mFitnessFactor = ioReader.ReadFloat();
+		outInfo.mAverageAmountOfNodes = ioReader.ReadFloat();
+		outInfo.mBestFitness = ioReader.ReadFloat();
+		outInfo.mDiversity = ioReader.ReadFloat();
+		outInfo.mFrameCount = ioReader.ReadInt32();
+		outInfo.mImmigrantAmount = ioReader.ReadInt32();
+
+		if (inVersion >= 8)
+		{
+			for (float& phase_timing : outInfo.mPhaseTimings)
+				phase_timing = ioReader.ReadFloat();
+		}
+	}
+
+
+
+	int32_t GetGenerationInfoSize(const int32_t inVersion)
+	{
+		return inVersion >= 8 ? GenerationInfoSize + PhaseTimingsSize : GenerationInfoSize;
+	}
+
+
+
+	bool DecodeGeneration(FByteReader& ioReader, const int32_t inVersion, const FQuantization& inQuantization, FGeneration& outGeneration)
+	{
+		DecodeGenerationInfo(ioReader, inVersion, outGeneration.mInfo);
+
+		const int32_t path_amount = ioReader.ReadInt32();
+		if (path_amount < 0 || (size_t)path_amount > ioReader.GetRemaining())
+			return false;
+
+		outGeneration.mPaths.resize(path_amount);
+		for (FPath& path : outGeneration.mPaths)
+		{
+			path.mNodeAmount = ioReader.ReadInt32();
+			if (!ioReader.ReadGenome(inQuantization, path.mGenes))
+				return false;
+
+			path.mColor = ioReader.ReadUInt32();
+			path.mFittest = ioReader.ReadBool();
+		}
+
+		return !ioReader.IsError();
+	}
+
+
+
+	/**
+	* Same as FPathHistoryDelta::Apply, chromosomes before the crossover index come from the first parent, the rest from the second,
+	* unless they are listed as mutated
+	*/
+	bool DecodeGenerationDelta(FByteReader& ioReader, const int32_t inVersion, const FQuantization& inQuantization, const FGeneration& inReference, FGeneration& outGeneration)
+	{
+		DecodeGenerationInfo(ioReader, inVersion, outGeneration.mInfo);
+
+		const int32_t delta_amount = ioReader.ReadInt32();
+		if (delta_amount < 0 || (size_t)delta_amount > ioReader.GetRemaining())
+			return false;
+
+		const std::vector<FPath>& parents = inReference.mPaths;
+		std::vector<int32_t> mutated_indices;
+		std::vector<FVector3> mutated_chromosomes;
+
+		outGeneration.mPaths.resize(delta_amount);
+		for (FPath& path : outGeneration.mPaths)
+		{
+			int32_t parent_indices[2];
+			parent_indices[0] = ioReader.ReadInt32();
+			parent_indices[1] = ioReader.ReadInt32();
+			const int32_t crossover_index = ioReader.ReadInt32();
+			path.mNodeAmount = ioReader.ReadInt32();
+			path.mColor = ioReader.ReadUInt32();
+			path.mFittest = ioReader.ReadBool();
+
+			if (!ioReader.ReadInt32s(mutated_indices) || !ioReader.ReadGenome(inQuantization, mutated_chromosomes))
+				return false;
+
+			if (path.mNodeAmount < 0 || crossover_index < 0 || mutated_indices.size() != mutated_chromosomes.size())
+				return false;
+
+			path.mGenes.resize(path.mNodeAmount);
+
+			size_t mutation_cursor = 0;
+			for (int32_t j = 0; j < path.mNodeAmount; ++j)
+			{
+				if (mutation_cursor < mutated_indices.size() && mutated_indices[mutation_cursor] == j)
+				{
+					path.mGenes[j] = mutated_chromosomes[mutation_cursor++];
+					continue;
+				}
+
+				const int32_t parent_index = parent_indices[j < crossover_index ? 0 : 1];
+				if (parent_index < 0 || (size_t)parent_index >= parents.size() || (size_t)j >= parents[parent_index].mGenes.size())
+					return false;
+
+				path.mGenes[j] = parents[parent_index].mGenes[j];
+			}
+
+			if (mutation_cursor != mutated_indices.size())
+				return false;
+		}
+
+		return !ioReader.IsError();
+	}
+
+
+
+	FHistoryStream::~FHistoryStream()
+	{
+		Close();
+	}
+
+
+
+	/**
+	* Reads the header and the quantization, the chunks are only read by walking them with NextChunk
+	*/
+	bool FHistoryStream::Open(const std::string& inFilePath, std::string& outError)
+	{
+		Close();
+
+		mFile = std::fopen(inFilePath.c_str(), "rb");
+		if (mFile == nullptr)
+		{
+			outError = "Unable to open " + inFilePath;
+			return false;
+		}
+
+		if (fseeko(mFile, 0, SEEK_END) != 0)
+		{
+			outError = "Unable to seek in " + inFilePath;
+			Close();
+			return false;
+		}
+
+		mFileSize = ftello(mFile);
+
+		uint8_t header_data[HeaderSize];
+		if (!Seek(0) || !ReadExactly(header_data, HeaderSize))
+		{
+			outError = inFilePath + " is too small to be a history file";
+			Close();
+			return false;
+		}
+
+		FByteReader header_reader(header_data, HeaderSize);
+		mHeader.mMagic = header_reader.ReadUInt32();
+		mHeader.mVersion = header_reader.ReadInt32();
+		mHeader.mPopulationCount = header_reader.ReadInt32();
+		mHeader.mIslandCount = header_reader.ReadInt32();
+
+		if (mHeader.mMagic != FileMagic || mHeader.mVersion < 2 || mHeader.mVersion > LatestVersion || mHeader.mIslandCount < 1)
+		{
+			outError = inFilePath + " is not a supported history file, version 1 files have to be converted by the editor first";
+			Close();
+			return false;
+		}
+
+		mFirstChunkOffset = HeaderSize;
+
+		if (mHeader.mVersion >= 5)
+		{
+			uint8_t quantization_data[QuantizationSize];
+			if (!ReadExactly(quantization_data, QuantizationSize))
+			{
+				outError = inFilePath + " ends before its quantization";
+				Close();
+				return false;
+			}
+
+			FByteReader quantization_reader(quantization_data, QuantizationSize);
+			mQuantization.mIsEnabled = quantization_reader.ReadBool();
+			mQuantization.mOrigin = quantization_reader.ReadVector();
+			mQuantization.mExtent = quantization_reader.ReadVector();
+			mQuantization.mPrecision = quantization_reader.ReadFloat();
+			mQuantization.mErrorBudget = quantization_reader.ReadFloat();
+
+			mFirstChunkOffset += QuantizationSize;
+		}
+
+		if (mHeader.mVersion >= 7)
+		{
+			uint8_t compression_data[CompressionSettingsSize];
+			if (!ReadExactly(compression_data, CompressionSettingsSize))
+			{
+				outError = inFilePath + " ends before its compression settings";
+				Close();
+				return false;
+			}
+
+			FByteReader compression_reader(compression_data, CompressionSettingsSize);
+			mCompression.mLevel = compression_reader.ReadInt32();
+			mCompression.mBlockSize = compression_reader.ReadInt32();
+			compression_reader.Read(&mCompression.mUncompressedBytes, sizeof(int64_t));
+			compression_reader.Read(&mCompression.mCompressedBytes, sizeof(int64_t));
+
+			if (mCompression.mBlockSize < 0)
+			{
+				outError = inFilePath + " has a damaged header";
+				Close();
+				return false;
+			}
+
+			mFirstChunkOffset += CompressionSettingsSize;
+		}
+
+		mIslandReferences.resize(mHeader.mIslandCount);
+		mHasIslandReference.assign(mHeader.mIslandCount, false);
+		mCompressedPiece.resize(64 * 1024);
+
+		return true;
+	}
+
+
+
+	void FHistoryStream::Close()
+	{
+		if (mFile != nullptr)
+			std::fclose(mFile);
+
+		mFile = nullptr;
+		mFileSize = 0;
+		mHeader = FHeader();
+		mQuantization = FQuantization();
+		mCompression = FCompressionSettings();
+		mHasChunk = false;
+		mHasReadChunk = false;
+		mHasReachedIndex = false;
+		mError.clear();
+		mIslandReferences.clear();
+		mHasIslandReference.clear();
+	}
+
+
+
+	/**
+	* Moves on to the next chunk and reads its header, returns false once there are no more complete chunks
+	* A generation chunk that was skipped leaves its island without a reference for the deltas after it
+	*/
+	bool FHistoryStream::NextChunk(FChunkHeader& outChunkHeader)
+	{
+		if (mFile == nullptr)
+			return false;
+
+		if (mHasChunk && !mHasReadChunk && mChunkHeader.IsGeneration() && mChunkHeader.mIslandIndex >= 0 && mChunkHeader.mIslandIndex < mHeader.mIslandCount)
+			mHasIslandReference[mChunkHeader.mIslandIndex] = false;
+
+		const int64_t offset = mHasChunk ? mChunkOffset + ChunkHeaderSize + mChunkHeader.mCompressedSize : mFirstChunkOffset;
+		mHasChunk = false;
+
+		uint8_t chunk_header_data[ChunkHeaderSize];
+		if (offset + ChunkHeaderSize > mFileSize || !Seek(offset) || !ReadExactly(chunk_header_data, ChunkHeaderSize))
+			return false;
+
+		FByteReader reader(chunk_header_data, ChunkHeaderSize);
+		FChunkHeader chunk_header;
+		chunk_header.mMagic = reader.ReadUInt32();
+		chunk_header.mGenerationNumber = reader.ReadInt32();
+		chunk_header.mIslandIndex = reader.ReadInt32();
+		chunk_header.mUncompressedSize = reader.ReadInt32();
+		chunk_header.mCompressedSize = reader.ReadInt32();
+		chunk_header.mCrc = reader.ReadUInt32();
+
+		if (chunk_header.mMagic == IndexMagic)
+		{
+			mHasReachedIndex = true;
+			return false;
+		}
+
+		if (!chunk_header.IsGeneration() && !chunk_header.IsLineage())
+			return Fail("Unknown chunk at offset " + std::to_string(offset));
+
+		if (chunk_header.mCompressedSize <= 0 || chunk_header.mUncompressedSize <= 0 || offset + ChunkHeaderSize + chunk_header.mCompressedSize > mFileSize)
+			return Fail("The chunk at offset " + std::to_string(offset) + " was cut short");
+
+		mChunkOffset = offset;
+		mChunkHeader = chunk_header;
+		mHasChunk = true;
+		mHasReadChunk = false;
+
+		outChunkHeader = chunk_header;
+
+		return true;
+	}
+
+
+
+	/**
+	* Only inflates the start of the chunk, which is all it takes for the generation info, the CRC is not checked
+	*/
+	bool FHistoryStream::ReadGenerationInfo(FGenerationInfo& outInfo)
+	{
+		if (!mHasChunk || !mChunkHeader.IsGeneration() || !Inflate(GetGenerationInfoSize(mHeader.mVersion), false))
+			return false;
+
+		FByteReader reader(mScratch.data(), mScratch.size());
+		DecodeGenerationInfo(reader, mHeader.mVersion, outInfo);
+
+		return !reader.IsError();
+	}
+
+
+
+	/**
+	* Decodes the whole generation of the current chunk, which becomes the reference of its island
+	*/
+	bool FHistoryStream::ReadGeneration(FGeneration& outGeneration)
+	{
+		if (!mHasChunk || !mChunkHeader.IsGeneration())
+			return false;
+
+		const int32_t island_index = mChunkHeader.mIslandIndex;
+		if (island_index < 0 || island_index >= mHeader.mIslandCount)
+			return Fail("Generation " + std::to_string(mChunkHeader.mGenerationNumber) + " belongs to island " + std::to_string(island_index) + ", which the file does not have");
+
+		if (mChunkHeader.IsDelta() && !mHasIslandReference[island_index])
+			return Fail("Generation " + std::to_string(mChunkHeader.mGenerationNumber) + " is a delta to a generation that was not read");
+
+		if (!Inflate(mChunkHeader.mUncompressedSize, true))
+			return false;
+
+		FByteReader reader(mScratch.data(), mScratch.size());
+
+		const bool has_decoded = mChunkHeader.IsDelta() ?
+			DecodeGenerationDelta(reader, mHeader.mVersion, mQuantization, mIslandReferences[island_index], outGeneration) :
+			DecodeGeneration(reader, mHeader.mVersion, mQuantization, outGeneration);
+
+		if (!has_decoded)
+			return Fail("Unable to decode generation " + std::to_string(mChunkHeader.mGenerationNumber));
+
+		mIslandReferences[island_index] = outGeneration;
+		mHasIslandReference[island_index] = true;
+		mHasReadChunk = true;
+
+		return true;
+	}
+
+
+
+	/**
+	* A lineage block holds the amount of records of every generation in it, followed by all records back to back
+	*/
+	bool FHistoryStream::ReadLineage(std::vector<int32_t>& outRecordAmounts, std::vector<FLineageRecord>& outRecords)
+	{
+		if (!mHasChunk || !mChunkHeader.IsLineage() || !Inflate(mChunkHeader.mUncompressedSize, true))
+			return false;
+
+		FByteReader reader(mScratch.data(), mScratch.size());
+
+		const int32_t generation_amount = reader.ReadInt32();
+		if (generation_amount < 0 || (size_t)generation_amount * sizeof(int32_t) > reader.GetRemaining())
+			return Fail("The lineage block at offset " + std::to_string(mChunkOffset) + " is damaged");
+
+		outRecordAmounts.resize(generation_amount);
+
+		int64_t total_record_amount = 0;
+		for (int32_t& record_amount : outRecordAmounts)
+		{
+			record_amount = reader.ReadInt32();
+			total_record_amount += std::max(record_amount, 0);
+		}
+
+		if (reader.IsError() || (int64_t)reader.GetRemaining() != total_record_amount * LineageRecordSize)
+			return Fail("The lineage block at offset " + std::to_string(mChunkOffset) + " is damaged");
+
+		outRecords.resize(total_record_amount);
+		for (FLineageRecord& record : outRecords)
+		{
+			record.mParentIndices[0] = reader.ReadInt32();
+			record.mParentIndices[1] = reader.ReadInt32();
+			record.mCrossoverPoints[0] = reader.ReadInt16();
+			record.mCrossoverPoints[1] = reader.ReadInt16();
+			record.mCrossoverOperator = reader.ReadUInt8();
+			record.mMutationFlags = reader.ReadUInt8();
+		}
+
+		return !reader.IsError();
+	}
+
+
+
+	/**
+	* Reads the compressed payload of the current chunk as it is, the CRC has to match
+	*/
+	bool FHistoryStream::ReadRawChunk(std::vector<uint8_t>& outData)
+	{
+		if (!mHasChunk)
+			return false;
+
+		outData.resize(mChunkHeader.mCompressedSize);
+		if (!Seek(mChunkOffset + ChunkHeaderSize) || !ReadExactly(outData.data(), outData.size()))
+			return Fail("Unable to read the chunk at offset " + std::to_string(mChunkOffset));
+
+		if (crc32(0, outData.data(), (uInt)outData.size()) != mChunkHeader.mCrc)
+			return Fail("The chunk at offset " + std::to_string(mChunkOffset) + " is damaged");
+
+		// The island of a skipped generation still loses its reference, the raw chunk is not decoded
+		return true;
+	}
+
+
+
+	/**
+	* Reads the index through the footer at the end of the file, returns false if the file was not closed properly
+	* Unlike the chunks the index is held as a whole, a few bytes per chunk
+	*/
+	bool FHistoryStream::ReadIndex(std::vector<FIndexEntry>& outIndex)
+	{
+		outIndex.clear();
+
+		uint8_t footer_data[FooterSize];
+		if (mFile == nullptr || mFileSize < mFirstChunkOffset + FooterSize || !Seek(mFileSize - FooterSize) || !ReadExactly(footer_data, FooterSize))
+			return false;
+
+		FByteReader footer_reader(footer_data, FooterSize);
+		int64_t index_offset = 0;
+		footer_reader.Read(&index_offset, sizeof(index_offset));
+		const uint32_t footer_magic = footer_reader.ReadUInt32();
+
+		if (footer_magic != FooterMagic || index_offset < mFirstChunkOffset || index_offset + 8 > mFileSize)
+			return false;
+
+		uint8_t index_header_data[8];
+		if (!Seek(index_offset) || !ReadExactly(index_header_data, sizeof(index_header_data)))
+			return false;
+
+		FByteReader index_header_reader(index_header_data, sizeof(index_header_data));
+		const uint32_t index_magic = index_header_reader.ReadUInt32();
+		const int32_t index_entry_amount = index_header_reader.ReadInt32();
+
+		if (index_magic != IndexMagic || index_entry_amount < 0 || index_offset + 8 + (int64_t)index_entry_amount * IndexEntrySize > mFileSize)
+			return false;
+
+		std::vector<uint8_t> index_data((size_t)index_entry_amount * IndexEntrySize);
+		if (!ReadExactly(index_data.data(), index_data.size()))
+			return false;
+
+		FByteReader reader(index_data.data(), index_data.size());
+
+		outIndex.resize(index_entry_amount);
+		for (FIndexEntry& index_entry : outIndex)
+		{
+			reader.Read(&index_entry.mOffset, sizeof(index_entry.mOffset));
+			index_entry.mGenerationNumber = reader.ReadInt32();
+			index_entry.mIslandIndex = reader.ReadInt32();
+		}
+
+		return !reader.IsError();
+	}
+
+
+
+	bool FHistoryStream::Seek(const int64_t inOffset)
+	{
+		return fseeko(mFile, inOffset, SEEK_SET) == 0;
+	}
+
+
+
+	bool FHistoryStream::ReadExactly(void* outData, const size_t inSize)
+	{
+		return std::fread(outData, 1, inSize, mFile) == inSize;
+	}
+
+
+
+	/**
+	* Inflates the payload of the current chunk into the scratch buffer, straight from the file a piece at a time
+	* Stops as soon as inWantedSize bytes are out, unless inVerify is set, which inflates and checks the whole chunk
+	*/
+	bool FHistoryStream::Inflate(const size_t inWantedSize, const bool inVerify)
+	{
+		const size_t uncompressed_size = (size_t)mChunkHeader.mUncompressedSize;
+		const size_t wanted_size = inVerify ? uncompressed_size : std::min(inWantedSize, uncompressed_size);
+
+		if (!Seek(mChunkOffset + ChunkHeaderSize))
+			return Fail("Unable to seek to the chunk at offset " + std::to_string(mChunkOffset));
+
+		mScratch.resize(wanted_size);
+
+		uLong crc = crc32(0, nullptr, 0);
+		bool has_inflated = true;
+
+		if (!mCompression.HasBlocks())
+		{
+			has_inflated = InflatePart(mChunkHeader.mCompressedSize, mScratch.data(), wanted_size, false, inVerify, crc);
+		}
+		else
+		{
+			// The payload starts with the compressed size of every block, which have to add up to the rest of the payload
+			const size_t block_size = (size_t)mCompression.mBlockSize;
+			const size_t block_amount = (uncompressed_size + block_size - 1) / block_size;
+			const int64_t table_size = (int64_t)(block_amount * sizeof(int32_t));
+
+			mBlockSizes.resize(block_amount);
+			if (table_size > mChunkHeader.mCompressedSize || !ReadExactly(mBlockSizes.data(), (size_t)table_size))
+				return Fail("The chunk at offset " + std::to_string(mChunkOffset) + " is damaged");
+
+			crc = crc32(crc, reinterpret_cast<const uint8_t*>(mBlockSizes.data()), (uInt)table_size);
+
+			int64_t total_size = table_size;
+			for (size_t i = 0; i < block_amount; ++i)
+			{
+				const size_t raw_size = std::min(block_size, uncompressed_size - i * block_size);
+				if (mBlockSizes[i] <= 0 || (size_t)mBlockSizes[i] > raw_size)
+					return Fail("The chunk at offset " + std::to_string(mChunkOffset) + " is damaged");
+
+				total_size += mBlockSizes[i];
+			}
+
+			if (total_size != mChunkHeader.mCompressedSize)
+				return Fail("The chunk at offset " + std::to_string(mChunkOffset) + " is damaged");
+
+			for (size_t i = 0; i < block_amount && has_inflated && i * block_size < wanted_size; ++i)
+			{
+				const size_t block_offset = i * block_size;
+				const size_t raw_size = std::min(block_size, uncompressed_size - block_offset);
+
+				// A block as large as its uncompressed data is stored as is
+				has_inflated = InflatePart(mBlockSizes[i], mScratch.data() + block_offset, std::min(raw_size, wanted_size - block_offset), (size_t)mBlockSizes[i] == raw_size, inVerify, crc);
+			}
+		}
+
+		if (!inVerify)
+		{
+			if (!has_inflated)
+				return Fail("Unable to inflate the chunk at offset " + std::to_string(mChunkOffset));
+
+			return true;
+		}
+
+		if (!has_inflated || crc != mChunkHeader.mCrc)
+			return Fail("The chunk of generation " + std::to_string(mChunkHeader.mGenerationNumber) + " at offset " + std::to_string(mChunkOffset) + " is damaged");
+
+		return true;
+	}
+
+
+
+	/**
+	* Inflates a single zlib stream, or copies a stored block, of inCompressedSize bytes from the current position in the file
+	* With inVerify every compressed byte is read and added to the CRC, otherwise reading stops once inSize bytes are out
+	*/
+	bool FHistoryStream::InflatePart(const int64_t inCompressedSize, uint8_t* outData, const size_t inSize, const bool inIsStored, const bool inVerify, uLong& ioCrc)
+	{
+		if (inIsStored)
+		{
+			const size_t read_size = inVerify ? (size_t)inCompressedSize : inSize;
+			if (!ReadExactly(outData, read_size))
+				return false;
+
+			ioCrc = crc32(ioCrc, outData, (uInt)read_size);
+			return read_size >= inSize;
+		}
+
+		z_stream stream;
+		std::memset(&stream, 0, sizeof(stream));
+		if (inflateInit(&stream) != Z_OK)
+			return Fail("Unable to start inflating");
+
+		stream.next_out = outData;
+		stream.avail_out = (uInt)inSize;
+
+		int64_t remaining_size = inCompressedSize;
+		int result = Z_OK;
+
+		while (result != Z_STREAM_END)
+		{
+			if (!inVerify && stream.avail_out == 0)
+				break;
+
+			if (stream.avail_in == 0 && remaining_size > 0)
+			{
+				const size_t piece_size = (size_t)std::min<int64_t>(remaining_size, mCompressedPiece.size());
+				if (!ReadExactly(mCompressedPiece.data(), piece_size))
+					break;
+
+				ioCrc = crc32(ioCrc, mCompressedPiece.data(), (uInt)piece_size);
+				remaining_size -= piece_size;
+
+				stream.next_in = mCompressedPiece.data();
+				stream.avail_in = (uInt)piece_size;
+			}
+
+			result = inflate(&stream, Z_NO_FLUSH);
+			if (result != Z_OK && result != Z_STREAM_END)
+				break;
+		}
+
+		const size_t inflated_size = stream.total_out;
+		inflateEnd(&stream);
+
+		if (!inVerify)
+			return inflated_size == inSize;
+
+		// Whatever follows the end of the stream still counts towards the CRC
+		while (remaining_size > 0)
+		{
+			const size_t piece_size = (size_t)std::min<int64_t>(remaining_size, mCompressedPiece.size());
+			if (!ReadExactly(mCompressedPiece.data(), piece_size))
+				break;
+
+			ioCrc = crc32(ioCrc, mCompressedPiece.data(), (uInt)piece_size);
+			remaining_size -= piece_size;
+		}
+
+		return result == Z_STREAM_END && inflated_size == inSize && remaining_size == 0;
+	}
+
+
+
+	bool FHistoryStream::Fail(const std::string& inError)
+	{
+		mError = inError;
+		return false;
+	}
+}
@@ -0,0 +1,263 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+/**
+* Reads .ga history files without the engine, mirroring FPathHistoryFile, FPathHistoryDelta and FPathQuantization
+*
+* Files of version 2 and up are supported, version 1 files have to be converted by the editor first
+* Everything is little endian, bools are 4 bytes and colors are a single uint32 with blue in the lowest byte, same as FArchive
+* Nothing but the chunk that is being read and the previous generation of every island is kept in memory,
+* so files of any length are read in constant memory
+*/
+namespace GaHistory
+{
+	const uint32_t FileMagic = 0x46484147; // "GAHF"
+	const uint32_t ChunkMagic = 0x4B484347; // "GCHK"
+	const uint32_t DeltaChunkMagic = 0x544C4447; // "GDLT"
+	const uint32_t LineageChunkMagic = 0x4E494C47; // "GLIN"
+	const uint32_t IndexMagic = 0x58444947; // "GIDX"
+	const uint32_t FooterMagic = 0x444E4547; // "GEND"
+	const int32_t LatestVersion = 8;
+
+	const int32_t HeaderSize = 16;
+	const int32_t QuantizationSize = 36;
+	const int32_t CompressionSettingsSize = 24;
+	const int32_t ChunkHeaderSize = 24;
+	const int32_t IndexEntrySize = 16;
+	const int32_t FooterSize = 12;
+	const int32_t GenerationInfoSize = 52;
+	const int32_t PhaseTimingsSize = 20; ///< Follows the generation info since version 8
+	const int32_t LineageRecordSize = 14;
+
+	const int32_t IndexNone = -1;
+
+	struct FVector3
+	{
+		float mValues[3] = { 0.0f, 0.0f, 0.0f };
+
+		bool operator==(const FVector3& inOther) const;
+		bool operator!=(const FVector3& inOther) const { return !(*this == inOther); }
+	};
+
+	struct FHeader
+	{
+		uint32_t mMagic = 0;
+		int32_t mVersion = 0;
+		int32_t mPopulationCount = 0;
+		int32_t mIslandCount = 1;
+	};
+
+	/**
+	* Only stored by version 7 files and up, the payloads of older files are a single zlib stream
+	* The totals are zero for files that were never closed
+	*/
+	struct FCompressionSettings
+	{
+		int32_t mLevel = 6;
+		int32_t mBlockSize = 0; ///< Uncompressed bytes per independently compressed block, 0 for a single stream
+		int64_t mUncompressedBytes = 0;
+		int64_t mCompressedBytes = 0;
+
+		bool HasBlocks() const { return mBlockSize > 0; }
+	};
+
+	struct FChunkHeader
+	{
+		uint32_t mMagic = 0;
+		int32_t mGenerationNumber = 0;
+		int32_t mIslandIndex = 0; ///< -1 - island for lineage chunks
+		int32_t mUncompressedSize = 0;
+		int32_t mCompressedSize = 0;
+		uint32_t mCrc = 0;
+
+		bool IsGeneration() const { return mMagic == ChunkMagic || mMagic == DeltaChunkMagic; }
+		bool IsDelta() const { return mMagic == DeltaChunkMagic; }
+		bool IsLineage() const { return mMagic == LineageChunkMagic; }
+		int32_t GetIslandIndex() const { return IsLineage() ? -1 - mIslandIndex : mIslandIndex; }
+	};
+
+	struct FIndexEntry
+	{
+		int64_t mOffset = 0;
+		int32_t mGenerationNumber = 0;
+		int32_t mIslandIndex = 0;
+	};
+
+	/**
+	* Same as FGenerationInfo, without the island info which is never stored
+	*/
+	struct FGenerationInfo
+	{
+		int32_t mGenerationNumber = 0;
+		int32_t mCrossoverAmount = 0;
+		int32_t mAmountOfTranslationMutations = 0;
+		int32_t mAmountOfInsertionMutations = 0;
+		int32_t mAmountOfDeletionMutations = 0;
+		float mAverageFitness = 0.0f;
+		float mMaximumFitness = 0.0f;
+		float mFitnessFactor = 0.0f;
+		float mAverageAmountOfNodes = 0.0f;
+		float mBestFitness = 0.0f;
+		float mDiversity = 0.0f;
+		int32_t mFrameCount = 1;
+		int32_t mImmigrantAmount = 0;
+		float mPhaseTimings[5] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f }; ///< Milliseconds spent evaluating parents, selecting, crossing over, mutating and evaluating offspring
+	};
+
+	struct FPath
+	{
+		int32_t mNodeAmount = 0;
+		std::vector<FVector3> mGenes;
+		uint32_t mColor = 0;
+		bool mFittest = false;
+	};
+
+	struct FGeneration
+	{
+		FGenerationInfo mInfo;
+		std::vector<FPath> mPaths;
+	};
+
+	struct FLineageRecord
+	{
+		int32_t mParentIndices[2] = { IndexNone, IndexNone };
+		int16_t mCrossoverPoints[2] = { IndexNone, IndexNone };
+		uint8_t mCrossoverOperator = 0xFF;
+		uint8_t mMutationFlags = 0;
+	};
+
+	/**
+	* Fixed point encoding of the genomes, only stored by version 5 files and up
+	*/
+	struct FQuantization
+	{
+		bool mIsEnabled = false;
+		FVector3 mOrigin;
+		FVector3 mExtent;
+		float mPrecision = 1.0f;
+		float mErrorBudget = 0.5f;
+
+		bool IsActive() const;
+		uint32_t GetStepAmount(const int32_t inAxis) const;
+		float Dequantize(const uint32_t inStep, const int32_t inAxis) const;
+	};
+
+
+
+	/**
+	* Reads little endian values from a buffer, reading past its end sets the error and returns zeros from then on
+	*/
+	class FByteReader
+	{
+	public:
+		FByteReader(const uint8_t* inData, const size_t inSize) : mData(inData), mSize(inSize) {}
+
+		void Read(void* outData, const size_t inSize);
+
+		int32_t ReadInt32() { int32_t value = 0; Read(&value, sizeof(value)); return value; }
+		uint32_t ReadUInt32() { uint32_t value = 0; Read(&value, sizeof(value)); return value; }
+		int16_t ReadInt16() { int16_t value = 0; Read(&value, sizeof(value)); return value; }
+		uint8_t ReadUInt8() { uint8_t value = 0; Read(&value, sizeof(value)); return value; }
+		float ReadFloat() { float value = 0.0f; Read(&value, sizeof(value)); return value; }
+		bool ReadBool();
+
+		FVector3 ReadVector();
+		bool ReadVectors(std::vector<FVector3>& outVectors);
+		bool ReadInt32s(std::vector<int32_t>& outValues);
+		bool ReadGenome(const FQuantization& inQuantization, std::vector<FVector3>& outGenome);
+
+		size_t GetRemaining() const { return mSize - mPosition; }
+		bool IsError() const { return mIsError; }
+		void SetError() { mIsError = true; }
+
+	private:
+		const uint8_t* mData = nullptr;
+		size_t mSize = 0;
+		size_t mPosition = 0;
+		bool mIsError = false;
+	};
+
+
+
+	/**
+	* Walks the chunks of a .ga file in the order they were written, reading the payload of a chunk only when asked to
+	*
+	* Payloads are inflated straight from the file in small pieces, the compressed data is never held as a whole
+	* The blocks of a payload are inflated one after the other, the editor inflates them in parallel
+	* Delta chunks are applied to the previous generation of their island, so generations have to be read in file order
+	* Generation chunks that are skipped leave the island without a reference, until its next keyframe
+	* The walk ends at the index, at the first damaged chunk, or at a chunk that was cut short
+	*/
+	class FHistoryStream
+	{
+	public:
+		FHistoryStream() = default;
+		~FHistoryStream();
+
+		bool Open(const std::string& inFilePath, std::string& outError);
+		void Close();
+
+		bool NextChunk(FChunkHeader& outChunkHeader);
+		bool ReadGenerationInfo(FGenerationInfo& outInfo);
+		bool ReadGeneration(FGeneration& outGeneration);
+		bool ReadLineage(std::vector<int32_t>& outRecordAmounts, std::vector<FLineageRecord>& outRecords);
+		bool ReadRawChunk(std::vector<uint8_t>& outData);
+		const FChunkHeader& GetChunkHeader() const { return mChunkHeader; }
+
+		bool ReadIndex(std::vector<FIndexEntry>& outIndex);
+
+		const FHeader& GetHeader() const { return mHeader; }
+		const FQuantization& GetQuantization() const { return mQuantization; }
+		const FCompressionSettings& GetCompression() const { return mCompression; }
+		int64_t GetFileSize() const { return mFileSize; }
+		int64_t GetChunkOffset() const { return mChunkOffset; }
+		int64_t GetFirstChunkOffset() const { return mFirstChunkOffset; }
+		bool HasReachedIndex() const { return mHasReachedIndex; } ///< Only known once NextChunk has returned false
+		const std::string& GetError() const { return mError; }
+
+	private:
+		FHistoryStream(const FHistoryStream&) = delete;
+		FHistoryStream& operator=(const FHistoryStream&) = delete;
+
+		bool Seek(const int64_t inOffset);
+		bool ReadExactly(void* outData, const size_t inSize);
+		bool Inflate(const size_t inWantedSize, const bool inVerify);
+		bool InflatePart(const int64_t inCompressedSize, uint8_t* outData, const size_t inSize, const bool inIsStored, const bool inVerify, uLong& ioCrc);
+		bool Fail(const std::string& inError);
+
+	private:
+		FILE* mFile = nullptr;
+		int64_t mFileSize = 0;
+		int64_t mFirstChunkOffset = 0;
+		int64_t mChunkOffset = 0; ///< Of the current chunk header
+		FHeader mHeader;
+		FQuantization mQuantization;
+		FCompressionSettings mCompression;
+		FChunkHeader mChunkHeader;
+		bool mHasChunk = false;
+		bool mHasReadChunk = false; ///< The generation of the current chunk has been decoded
+		bool mHasReachedIndex = false;
+		std::string mError;
+
+		std::vector<uint8_t> mCompressedPiece;
+		std::vector<int32_t> mBlockSizes; ///< Compressed size of every block of the current chunk
+		std::vector<uint8_t> mScratch; ///< Uncompressed payload of the current chunk
+		std::vector<FGeneration> mIslandReferences; ///< Previous generation of every island, delta chunks are applied to it
+		std::vector<bool> mHasIslandReference;
+	};
+
+
+
+	bool DecodeGeneration(FByteReader& ioReader, const int32_t inVersion, const FQuantization& inQuantization, FGeneration& outGeneration);
+	bool DecodeGenerationDelta(FByteReader& ioReader, const int32_t inVersion, const FQuantization& inQuantization, const FGeneration& inReference, FGeneration& outGeneration);
+	void DecodeGenerationInfo(FByteReader& ioReader, const int32_t inVersion, FGenerationInfo& outInfo);
+	int32_t GetGenerationInfoSize(const int32_t inVersion);
+}
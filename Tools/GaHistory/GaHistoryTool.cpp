@@ -0,0 +1,727 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GaHistoryFile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+/**
+* Command line tool for .ga history files, see PrintUsage
+* Every command streams the file from start to end, in constant memory
+*/
+namespace
+{
+	using namespace GaHistory;
+
+	const int32_t ExitSuccess = 0;
+	const int32_t ExitDifferent = 1; ///< Only returned by diff
+	const int32_t ExitFailure = 2;
+
+	const uint32_t StatisticsFileMagic = 0x54534147; // "GAST", same layout as FPathStatisticsWriter
+	const uint32_t StatisticsVersion = 1;
+	const int32_t StatisticsBlockRowAmount = 1024;
+
+	void PrintUsage()
+	{
+		std::fprintf(stderr,
+			"Usage: gahistory <command> ...\n"
+			"  summary <file.ga>                              Header, chunk counts and the course of the run\n"
+			"  dump <file.ga> <first>[-<last>] [island]       Every path of the stored generations in the range of generation numbers\n"
+			"  stats <file.ga> [out.csv]                      Generation info of every stored generation, without decoding any genome\n"
+			"  diff <a.ga> <b.ga>                             Compares two runs generation by generation, exits with 1 when they differ\n"
+			"  convert <file.ga> columnar <out.gastats>       Generation info in the columnar statistics format\n"
+			"  convert <file.ga> indexed <out.ga>             Copies the complete chunks and appends a fresh index, repairs runs that were cut short\n");
+	}
+
+
+
+	bool OpenStream(FHistoryStream& outStream, const std::string& inFilePath)
+	{
+		std::string error;
+		if (outStream.Open(inFilePath, error))
+			return true;
+
+		std::fprintf(stderr, "%s\n", error.c_str());
+		return false;
+	}
+
+
+
+	/**
+	* A walk that did not end at the index either hit a damaged chunk or a file that was cut short, which is only worth a warning
+	*/
+	void ReportEndOfStream(const FHistoryStream& inStream)
+	{
+		if (inStream.HasReachedIndex())
+			return;
+
+		if (!inStream.GetError().empty())
+			std::fprintf(stderr, "Warning: %s, the chunks after it were not read\n", inStream.GetError().c_str());
+		else
+			std::fprintf(stderr, "Warning: the file has no index, the run did not finish cleanly\n");
+	}
+
+
+
+	/**
+	* Moves on to the next generation chunk, of the given island unless it is IndexNone
+	*/
+	bool NextGenerationChunk(FHistoryStream& ioStream, const int32_t inIslandIndex, FChunkHeader& outChunkHeader)
+	{
+		while (ioStream.NextChunk(outChunkHeader))
+		{
+			if (outChunkHeader.IsGeneration() && (inIslandIndex == IndexNone || outChunkHeader.mIslandIndex == inIslandIndex))
+				return true;
+		}
+
+		return false;
+	}
+
+
+
+	void PrintInfo(const FGenerationInfo& inInfo)
+	{
+		std::printf("  crossovers %d, mutations %d/%d/%d (translation/insertion/deletion)\n",
+			inInfo.mCrossoverAmount, inInfo.mAmountOfTranslationMutations, inInfo.mAmountOfInsertionMutations, inInfo.mAmountOfDeletionMutations);
+		std::printf("  average fitness %.9g of %.9g, fitness factor %.9g, best fitness %.9g\n",
+			inInfo.mAverageFitness, inInfo.mMaximumFitness, inInfo.mFitnessFactor, inInfo.mBestFitness);
+		std::printf("  average nodes %.9g, diversity %.9g, frames %d, immigrants %d\n",
+			inInfo.mAverageAmountOfNodes, inInfo.mDiversity, inInfo.mFrameCount, inInfo.mImmigrantAmount);
+
+		const float* timings = inInfo.mPhaseTimings;
+		if (timings[0] + timings[1] + timings[2] + timings[3] + timings[4] > 0.0f)
+			std::printf("  phases %.3f/%.3f/%.3f/%.3f/%.3f ms (evaluate parents/selection/crossover/mutation/evaluate offspring)\n",
+				timings[0], timings[1], timings[2], timings[3], timings[4]);
+	}
+
+
+
+	int32_t RunSummary(const std::string& inFilePath)
+	{
+		FHistoryStream stream;
+		if (!OpenStream(stream, inFilePath))
+			return ExitFailure;
+
+		const FHeader& header = stream.GetHeader();
+		const FQuantization& quantization = stream.GetQuantization();
+
+		std::printf("File: %s (%lld bytes)\n", inFilePath.c_str(), (long long)stream.GetFileSize());
+		std::printf("Version: %d, population: %d, islands: %d\n", header.mVersion, header.mPopulationCount, header.mIslandCount);
+
+		if (quantization.IsActive())
+		{
+			std::printf("Quantized: precision %.9g, extent %.9g %.9g %.9g around %.9g %.9g %.9g\n", quantization.mPrecision,
+				quantization.mExtent.mValues[0], quantization.mExtent.mValues[1], quantization.mExtent.mValues[2],
+				quantization.mOrigin.mValues[0], quantization.mOrigin.mValues[1], quantization.mOrigin.mValues[2]);
+		}
+
+		const FCompressionSettings& compression = stream.GetCompression();
+		if (compression.HasBlocks())
+		{
+			std::printf("Compression: level %d, blocks of %d bytes", compression.mLevel, compression.mBlockSize);
+			if (compression.mUncompressedBytes > 0)
+				std::printf(", ratio %.4f\n", (double)compression.mCompressedBytes / (double)compression.mUncompressedBytes);
+			else
+				std::printf(", ratio unknown until the run is closed\n");
+		}
+
+		int64_t keyframe_amount = 0;
+		int64_t delta_amount = 0;
+		int64_t lineage_block_amount = 0;
+		int64_t compressed_size = 0;
+		int64_t uncompressed_size = 0;
+
+		int32_t first_generation_number = INT32_MAX;
+		int32_t last_generation_number = IndexNone;
+		float best_fitness = -INFINITY;
+		int32_t best_fitness_generation = IndexNone;
+		FGenerationInfo last_info;
+
+		FChunkHeader chunk_header;
+		while (stream.NextChunk(chunk_header))
+		{
+			compressed_size += chunk_header.mCompressedSize;
+			uncompressed_size += chunk_header.mUncompressedSize;
+
+			if (chunk_header.IsLineage())
+			{
+				++lineage_block_amount;
+				continue;
+			}
+
+			if (chunk_header.IsDelta())
+				++delta_amount;
+			else
+				++keyframe_amount;
+
+			FGenerationInfo info;
+			if (!stream.ReadGenerationInfo(info))
+				break;
+
+			first_generation_number = std::min(first_generation_number, info.mGenerationNumber);
+			if (info.mGenerationNumber >= last_generation_number)
+			{
+				last_generation_number = info.mGenerationNumber;
+				last_info = info;
+			}
+
+			if (info.mBestFitness > best_fitness)
+			{
+				best_fitness = info.mBestFitness;
+				best_fitness_generation = info.mGenerationNumber;
+			}
+		}
+
+		std::printf("Chunks: %lld keyframes, %lld deltas, %lld lineage blocks\n", (long long)keyframe_amount, (long long)delta_amount, (long long)lineage_block_amount);
+		std::printf("Payload: %lld bytes compressed, %lld bytes uncompressed\n", (long long)compressed_size, (long long)uncompressed_size);
+		std::printf("Index: %s\n", stream.HasReachedIndex() ? "present" : "missing");
+
+		if (last_generation_number != IndexNone)
+		{
+			std::printf("Generations: %d to %d\n", first_generation_number, last_generation_number);
+			std::printf("Best fitness: %.9g in generation %d\n", best_fitness, best_fitness_generation);
+			std::printf("Last stored generation:\n");
+			PrintInfo(last_info);
+		}
+
+		ReportEndOfStream(stream);
+
+		return ExitSuccess;
+	}
+
+
+
+	/**
+	* Deltas need the generation before them, so every generation up to the end of the range is decoded, only the range is printed
+	*/
+	int32_t RunDump(const std::string& inFilePath, const int32_t inFirstGenerationNumber, const int32_t inLastGenerationNumber, const int32_t inIslandIndex)
+	{
+		FHistoryStream stream;
+		if (!OpenStream(stream, inFilePath))
+			return ExitFailure;
+
+		std::vector<bool> has_finished_island(stream.GetHeader().mIslandCount, false);
+		int32_t finished_island_amount = inIslandIndex == IndexNone ? 0 : stream.GetHeader().mIslandCount - 1;
+
+		FGeneration generation;
+		FChunkHeader chunk_header;
+		while (finished_island_amount < stream.GetHeader().mIslandCount && NextGenerationChunk(stream, inIslandIndex, chunk_header))
+		{
+			const int32_t island_index = chunk_header.mIslandIndex;
+			if (island_index < 0 || island_index >= stream.GetHeader().mIslandCount || has_finished_island[island_index])
+				continue;
+
+			if (chunk_header.mGenerationNumber > inLastGenerationNumber)
+			{
+				has_finished_island[island_index] = true;
+				++finished_island_amount;
+				continue;
+			}
+
+			if (!stream.ReadGeneration(generation))
+				break;
+
+			if (chunk_header.mGenerationNumber < inFirstGenerationNumber)
+				continue;
+
+			std::printf("Generation %d, island %d, %zu paths%s\n", generation.mInfo.mGenerationNumber, island_index, generation.mPaths.size(), chunk_header.IsDelta() ? "" : ", keyframe");
+			PrintInfo(generation.mInfo);
+
+			for (size_t i = 0; i < generation.mPaths.size(); ++i)
+			{
+				const FPath& path = generation.mPaths[i];
+
+				// Colors are stored with blue in the lowest byte
+				std::printf("  path %zu: %d nodes, color #%02X%02X%02X%02X%s\n", i, path.mNodeAmount,
+					(path.mColor >> 16) & 0xFF, (path.mColor >> 8) & 0xFF, path.mColor & 0xFF, (path.mColor >> 24) & 0xFF, path.mFittest ? ", fittest" : "");
+
+				for (const FVector3& chromosome : path.mGenes)
+					std::printf("    %.9g %.9g %.9g\n", chromosome.mValues[0], chromosome.mValues[1], chromosome.mValues[2]);
+			}
+		}
+
+		if (finished_island_amount < stream.GetHeader().mIslandCount)
+			ReportEndOfStream(stream);
+
+		return stream.GetError().empty() ? ExitSuccess : ExitFailure;
+	}
+
+
+
+	int32_t RunStats(const std::string& inFilePath, const std::string& inOutputFilePath)
+	{
+		FHistoryStream stream;
+		if (!OpenStream(stream, inFilePath))
+			return ExitFailure;
+
+		FILE* output = inOutputFilePath.empty() ? stdout : std::fopen(inOutputFilePath.c_str(), "w");
+		if (output == nullptr)
+		{
+			std::fprintf(stderr, "Unable to create %s\n", inOutputFilePath.c_str());
+			return ExitFailure;
+		}
+
+		std::fprintf(output, "Island,Generation,Crossovers,TranslationMutations,InsertionMutations,DeletionMutations,AverageFitness,MaximumFitness,FitnessFactor,AverageNodeAmount,BestFitness,Diversity,FrameCount,ImmigrantAmount\n");
+
+		FGenerationInfo info;
+		FChunkHeader chunk_header;
+		while (NextGenerationChunk(stream, IndexNone, chunk_header))
+		{
+			if (!stream.ReadGenerationInfo(info))
+				break;
+
+			std::fprintf(output, "%d,%d,%d,%d,%d,%d,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%d,%d\n", chunk_header.mIslandIndex, info.mGenerationNumber,
+				info.mCrossoverAmount, info.mAmountOfTranslationMutations, info.mAmountOfInsertionMutations, info.mAmountOfDeletionMutations,
+				info.mAverageFitness, info.mMaximumFitness, info.mFitnessFactor, info.mAverageAmountOfNodes, info.mBestFitness, info.mDiversity,
+				info.mFrameCount, info.mImmigrantAmount);
+		}
+
+		if (output != stdout)
+			std::fclose(output);
+
+		ReportEndOfStream(stream);
+
+		return stream.GetError().empty() ? ExitSuccess : ExitFailure;
+	}
+
+
+
+	/**
+	* The phase timings are wall time and differ between any two runs, so they are left out
+	*/
+	bool IsSameInfo(const FGenerationInfo& inLhs, const FGenerationInfo& inRhs)
+	{
+		return std::memcmp(&inLhs, &inRhs, offsetof(FGenerationInfo, mPhaseTimings)) == 0;
+	}
+
+
+
+	/**
+	* Islands are compared one at a time, as the chunks of the islands may be interleaved differently in both files
+	* Every island is a pass over both files, which keeps the memory constant
+	*/
+	int32_t RunDiff(const std::string& inFilePathA, const std::string& inFilePathB)
+	{
+		const int32_t max_reported_amount = 20;
+
+		FHistoryStream stream_a;
+		FHistoryStream stream_b;
+		if (!OpenStream(stream_a, inFilePathA) || !OpenStream(stream_b, inFilePathB))
+			return ExitFailure;
+
+		const FHeader& header_a = stream_a.GetHeader();
+		const FHeader& header_b = stream_b.GetHeader();
+
+		int64_t different_amount = 0;
+
+		if (header_a.mPopulationCount != header_b.mPopulationCount || header_a.mIslandCount != header_b.mIslandCount)
+		{
+			std::printf("Headers differ: population %d vs %d, islands %d vs %d\n", header_a.mPopulationCount, header_b.mPopulationCount, header_a.mIslandCount, header_b.mIslandCount);
+			++different_amount;
+		}
+
+		const int32_t island_count = std::min(header_a.mIslandCount, header_b.mIslandCount);
+
+		int64_t compared_amount = 0;
+		int32_t first_different_generation = INT32_MAX;
+
+		FGeneration generation_a;
+		FGeneration generation_b;
+
+		for (int32_t island_index = 0; island_index < island_count; ++island_index)
+		{
+			if (island_index > 0 && (!OpenStream(stream_a, inFilePathA) || !OpenStream(stream_b, inFilePathB)))
+				return ExitFailure;
+
+			FChunkHeader chunk_header_a;
+			FChunkHeader chunk_header_b;
+
+			while (true)
+			{
+				const bool has_chunk_a = NextGenerationChunk(stream_a, island_index, chunk_header_a) && stream_a.ReadGeneration(generation_a);
+				const bool has_chunk_b = NextGenerationChunk(stream_b, island_index, chunk_header_b) && stream_b.ReadGeneration(generation_b);
+
+				if (has_chunk_a != has_chunk_b)
+				{
+					std::printf("Island %d: %s stores more generations, from generation %d on\n", island_index, has_chunk_a ? "a" : "b",
+						has_chunk_a ? generation_a.mInfo.mGenerationNumber : generation_b.mInfo.mGenerationNumber);
+					++different_amount;
+				}
+
+				if (!has_chunk_a || !has_chunk_b)
+					break;
+
+				++compared_amount;
+
+				const std::vector<FPath>& paths_a = generation_a.mPaths;
+				const std::vector<FPath>& paths_b = generation_b.mPaths;
+
+				int32_t different_path_amount = std::abs((int32_t)paths_a.size() - (int32_t)paths_b.size());
+				float max_deviation = 0.0f;
+
+				for (size_t i = 0; i < std::min(paths_a.size(), paths_b.size()); ++i)
+				{
+					const FPath& path_a = paths_a[i];
+					const FPath& path_b = paths_b[i];
+
+					if (path_a.mGenes.size() != path_b.mGenes.size())
+					{
+						++different_path_amount;
+						continue;
+					}
+
+					bool is_same_path = path_a.mColor == path_b.mColor && path_a.mFittest == path_b.mFittest;
+					for (size_t j = 0; j < path_a.mGenes.size(); ++j)
+					{
+						if (path_a.mGenes[j] == path_b.mGenes[j])
+							continue;
+
+						is_same_path = false;
+						for (int32_t axis = 0; axis < 3; ++axis)
+							max_deviation = std::max(max_deviation, std::fabs(path_a.mGenes[j].mValues[axis] - path_b.mGenes[j].mValues[axis]));
+					}
+
+					if (!is_same_path)
+						++different_path_amount;
+				}
+
+				const bool is_same_info = IsSameInfo(generation_a.mInfo, generation_b.mInfo);
+				if (is_same_info && different_path_amount == 0)
+					continue;
+
+				if (different_amount < max_reported_amount)
+				{
+					std::printf("Island %d, generation %d vs %d: %s, %d paths differ, largest chromosome deviation %.9g\n", island_index,
+						generation_a.mInfo.mGenerationNumber, generation_b.mInfo.mGenerationNumber, is_same_info ? "same info" : "info differs",
+						different_path_amount, max_deviation);
+				}
+
+				first_different_generation = std::min(first_different_generation, generation_a.mInfo.mGenerationNumber);
+				++different_amount;
+			}
+
+			if (!stream_a.GetError().empty() || !stream_b.GetError().empty())
+			{
+				std::fprintf(stderr, "%s\n", !stream_a.GetError().empty() ? stream_a.GetError().c_str() : stream_b.GetError().c_str());
+				return ExitFailure;
+			}
+		}
+
+		std::printf("Compared %lld stored generations, %lld differences", (long long)compared_amount, (long long)different_amount);
+		if (first_different_generation != INT32_MAX)
+			std::printf(", the runs part ways at generation %d", first_different_generation);
+		std::printf("\n");
+
+		return different_amount == 0 ? ExitSuccess : ExitDifferent;
+	}
+
+
+
+	/**
+	* Writes the columnar statistics format of FPathStatisticsWriter, with the columns the history file knows about
+	*/
+	class FColumnarWriter
+	{
+	public:
+		struct FColumn
+		{
+			const char* mName;
+			uint8_t mType; ///< 0 int32, 1 float
+			std::vector<uint32_t> mValues;
+		};
+
+		~FColumnarWriter() { Close(); }
+
+		bool Open(const std::string& inFilePath)
+		{
+			const char* names[] = { "Island", "Generation", "Crossovers", "TranslationMutations", "InsertionMutations", "DeletionMutations",
+				"AverageFitness", "MaximumFitness", "FitnessFactor", "AverageNodeAmount", "BestFitness", "Diversity", "ImmigrantAmount", "FrameCount" };
+			const uint8_t types[] = { 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 0, 0 };
+
+			mFile = std::fopen(inFilePath.c_str(), "wb");
+			if (mFile == nullptr)
+				return false;
+
+			mColumns.clear();
+			for (size_t i = 0; i < sizeof(types); ++i)
+				mColumns.push_back(FColumn{ names[i], types[i], {} });
+
+			const int32_t column_amount = (int32_t)mColumns.size();
+			std::fwrite(&StatisticsFileMagic, sizeof(uint32_t), 1, mFile);
+			std::fwrite(&StatisticsVersion, sizeof(uint32_t), 1, mFile);
+			std::fwrite(&column_amount, sizeof(int32_t), 1, mFile);
+
+			for (const FColumn& column : mColumns)
+			{
+				const uint8_t name_length = (uint8_t)std::strlen(column.mName);
+				std::fwrite(&column.mType, 1, 1, mFile);
+				std::fwrite(&name_length, 1, 1, mFile);
+				std::fwrite(column.mName, 1, name_length, mFile);
+			}
+
+			return true;
+		}
+
+		void Append(const int32_t inIslandIndex, const FGenerationInfo& inInfo)
+		{
+			const int32_t integers[] = { inIslandIndex, inInfo.mGenerationNumber, inInfo.mCrossoverAmount, inInfo.mAmountOfTranslationMutations,
+				inInfo.mAmountOfInsertionMutations, inInfo.mAmountOfDeletionMutations };
+			const float floats[] = { inInfo.mAverageFitness, inInfo.mMaximumFitness, inInfo.mFitnessFactor, inInfo.mAverageAmountOfNodes, inInfo.mBestFitness, inInfo.mDiversity };
+
+			size_t column_index = 0;
+			for (const int32_t value : integers)
+				mColumns[column_index++].mValues.push_back((uint32_t)value);
+
+			for (const float value : floats)
+			{
+				uint32_t raw_value;
+				std::memcpy(&raw_value, &value, sizeof(float));
+				mColumns[column_index++].mValues.push_back(raw_value);
+			}
+
+			mColumns[column_index++].mValues.push_back((uint32_t)inInfo.mImmigrantAmount);
+			mColumns[column_index++].mValues.push_back((uint32_t)inInfo.mFrameCount);
+
+			if (mColumns[0].mValues.size() >= (size_t)StatisticsBlockRowAmount)
+				FlushBlock();
+		}
+
+		bool Close()
+		{
+			if (mFile == nullptr)
+				return true;
+
+			FlushBlock();
+
+			const bool has_closed = std::ferror(mFile) == 0;
+			std::fclose(mFile);
+			mFile = nullptr;
+
+			return has_closed;
+		}
+
+	private:
+		void FlushBlock()
+		{
+			const int32_t row_amount = (int32_t)mColumns[0].mValues.size();
+			if (row_amount == 0)
+				return;
+
+			std::fwrite(&row_amount, sizeof(int32_t), 1, mFile);
+			for (FColumn& column : mColumns)
+			{
+				std::fwrite(column.mValues.data(), sizeof(uint32_t), column.mValues.size(), mFile);
+				column.mValues.clear();
+			}
+		}
+
+	private:
+		FILE* mFile = nullptr;
+		std::vector<FColumn> mColumns;
+	};
+
+
+
+	int32_t RunConvertColumnar(const std::string& inFilePath, const std::string& inOutputFilePath)
+	{
+		FHistoryStream stream;
+		if (!OpenStream(stream, inFilePath))
+			return ExitFailure;
+
+		FColumnarWriter writer;
+		if (!writer.Open(inOutputFilePath))
+		{
+			std::fprintf(stderr, "Unable to create %s\n", inOutputFilePath.c_str());
+			return ExitFailure;
+		}
+
+		int64_t row_amount = 0;
+
+		FGenerationInfo info;
+		FChunkHeader chunk_header;
+		while (NextGenerationChunk(stream, IndexNone, chunk_header) && stream.ReadGenerationInfo(info))
+		{
+			writer.Append(chunk_header.mIslandIndex, info);
+			++row_amount;
+		}
+
+		if (!writer.Close())
+		{
+			std::fprintf(stderr, "Unable to write %s\n", inOutputFilePath.c_str());
+			return ExitFailure;
+		}
+
+		ReportEndOfStream(stream);
+		std::printf("Wrote %lld rows to %s\n", (long long)row_amount, inOutputFilePath.c_str());
+
+		return ExitSuccess;
+	}
+
+
+
+	/**
+	* Copies the header and every complete chunk as they are, then appends the index and the footer the way FPathHistoryWriter::Close does
+	* The payloads are never decompressed, only their CRC is checked
+	*/
+	int32_t RunConvertIndexed(const std::string& inFilePath, const std::string& inOutputFilePath)
+	{
+		FHistoryStream stream;
+		if (!OpenStream(stream, inFilePath))
+			return ExitFailure;
+
+		FILE* input = std::fopen(inFilePath.c_str(), "rb");
+		FILE* output = std::fopen(inOutputFilePath.c_str(), "wb");
+		if (input == nullptr || output == nullptr)
+		{
+			std::fprintf(stderr, "Unable to create %s\n", inOutputFilePath.c_str());
+			if (input != nullptr)
+				std::fclose(input);
+			if (output != nullptr)
+				std::fclose(output);
+			return ExitFailure;
+		}
+
+		// The header and the quantization are taken over as they are
+		std::vector<uint8_t> data(stream.GetFirstChunkOffset());
+		const bool has_copied_header = std::fread(data.data(), 1, data.size(), input) == data.size();
+		std::fclose(input);
+
+		if (!has_copied_header)
+		{
+			std::fclose(output);
+			return ExitFailure;
+		}
+
+		std::fwrite(data.data(), 1, data.size(), output);
+
+		std::vector<FIndexEntry> index;
+		int64_t offset = stream.GetFirstChunkOffset();
+		int64_t totals[2] = { 0, 0 }; ///< Uncompressed and compressed payload bytes
+
+		FChunkHeader chunk_header;
+		while (stream.NextChunk(chunk_header) && stream.ReadRawChunk(data))
+		{
+			const int32_t header_values[] = { chunk_header.mGenerationNumber, chunk_header.mIslandIndex, chunk_header.mUncompressedSize, chunk_header.mCompressedSize };
+			std::fwrite(&chunk_header.mMagic, sizeof(uint32_t), 1, output);
+			std::fwrite(header_values, sizeof(int32_t), 4, output);
+			std::fwrite(&chunk_header.mCrc, sizeof(uint32_t), 1, output);
+			std::fwrite(data.data(), 1, data.size(), output);
+
+			FIndexEntry index_entry;
+			index_entry.mOffset = offset;
+			index_entry.mGenerationNumber = chunk_header.mGenerationNumber;
+			index_entry.mIslandIndex = chunk_header.mIslandIndex;
+			index.push_back(index_entry);
+
+			totals[0] += chunk_header.mUncompressedSize;
+			totals[1] += chunk_header.mCompressedSize;
+			offset += ChunkHeaderSize + chunk_header.mCompressedSize;
+		}
+
+		const int32_t index_entry_amount = (int32_t)index.size();
+		std::fwrite(&IndexMagic, sizeof(uint32_t), 1, output);
+		std::fwrite(&index_entry_amount, sizeof(int32_t), 1, output);
+
+		for (const FIndexEntry& index_entry : index)
+		{
+			std::fwrite(&index_entry.mOffset, sizeof(int64_t), 1, output);
+			std::fwrite(&index_entry.mGenerationNumber, sizeof(int32_t), 1, output);
+			std::fwrite(&index_entry.mIslandIndex, sizeof(int32_t), 1, output);
+		}
+
+		std::fwrite(&offset, sizeof(int64_t), 1, output);
+		std::fwrite(&FooterMagic, sizeof(uint32_t), 1, output);
+
+		// The totals of a run that was cut short are still zero, they are written over with those of the copied chunks
+		if (stream.GetHeader().mVersion >= 7 && fseeko(output, HeaderSize + QuantizationSize + 2 * sizeof(int32_t), SEEK_SET) == 0)
+			std::fwrite(totals, sizeof(int64_t), 2, output);
+
+		const bool has_written = std::ferror(output) == 0;
+		std::fclose(output);
+
+		if (!has_written)
+		{
+			std::fprintf(stderr, "Unable to write %s\n", inOutputFilePath.c_str());
+			return ExitFailure;
+		}
+
+		ReportEndOfStream(stream);
+		std::printf("Wrote %d chunks to %s\n", index_entry_amount, inOutputFilePath.c_str());
+
+		return ExitSuccess;
+	}
+
+
+
+	bool ParseInteger(const char* inText, int32_t& outValue)
+	{
+		char* end = nullptr;
+		const long value = std::strtol(inText, &end, 10);
+		if (end == inText || *end != '\0' || value < INT32_MIN || value > INT32_MAX)
+			return false;
+
+		outValue = (int32_t)value;
+		return true;
+	}
+
+
+
+	/**
+	* A single generation number, or an inclusive range of them
+	*/
+	bool ParseRange(const std::string& inText, int32_t& outFirst, int32_t& outLast)
+	{
+		const size_t separator = inText.find('-', 1);
+		if (separator == std::string::npos)
+			return ParseInteger(inText.c_str(), outFirst) && ParseInteger(inText.c_str(), outLast);
+
+		return ParseInteger(inText.substr(0, separator).c_str(), outFirst) && ParseInteger(inText.substr(separator + 1).c_str(), outLast) && outFirst <= outLast;
+	}
+}
+
+
+
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		PrintUsage();
+		return ExitFailure;
+	}
+
+	const std::string command = argv[1];
+
+	if (command == "summary" && argc == 3)
+		return RunSummary(argv[2]);
+
+	if (command == "dump" && (argc == 4 || argc == 5))
+	{
+		int32_t first_generation_number = 0;
+		int32_t last_generation_number = 0;
+		int32_t island_index = IndexNone;
+
+		if (ParseRange(argv[3], first_generation_number, last_generation_number) && (argc == 4 || ParseInteger(argv[4], island_index)))
+			return RunDump(argv[2], first_generation_number, last_generation_number, island_index);
+	}
+
+	if (command == "stats" && (argc == 3 || argc == 4))
+		return RunStats(argv[2], argc == 4 ? argv[3] : "");
+
+	if (command == "diff" && argc == 4)
+		return RunDiff(argv[2], argv[3]);
+
+	if (command == "convert" && argc == 5)
+	{
+		const std::string format = argv[3];
+		if (format == "columnar")
+			return RunConvertColumnar(argv[2], argv[4]);
+		if (format == "indexed")
+			return RunConvertIndexed(argv[2], argv[4]);
+	}
+
+	PrintUsage();
+	return ExitFailure;
+}